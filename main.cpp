@@ -1,11 +1,31 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QTimer>
 #include "src/core/pomodoro/pomodorotimer.h"
+#include "src/core/pomodoro/sessionlog.h"
+#include "src/core/timers/timerlistmodel.h"
+#include "src/core/audio/audiocueengine.h"
+#include "src/core/stats/studyrollup.h"
+#include "src/core/archive/historyarchive.h"
+#include "src/core/planner/studyplanner.h"
+#include "src/core/flashcards/flashcardmanager.h"
+#include "src/core/reminders/reminderservice.h"
+#include "src/core/nextup/nextupservice.h"
+#include "src/core/palette/quickswitcher.h"
+#include "src/core/tags/tagmanager.h"
 #include "src/core/todo/todo.h"
 #include "src/core/database/databasemanager.h"
+#include "src/core/database/databasewatcher.h"
 #include "src/core/todo/todomanager.h"
+#include "src/core/todo/todosortfiltermodel.h"
+#include "src/core/todo/smartviews.h"
+#include "src/core/todo/todotreemodel.h"
+#include "src/core/todo/todolistsmodel.h"
 #include "src/core/streaks/streaksmanager.h"
+#include "src/core/streaks/streakanalytics.h"
+#include "src/ui/heatmap/heatmapcalendar.h"
+#include "src/core/sync/syncengine.h"
 
 int main(int argc, char *argv[])
 {
@@ -25,28 +45,186 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    if (!dbManager.createSearchIndex()) {
+        qDebug() << "Failed to create todo search index!";
+        return -1;
+    }
+
     if (!dbManager.createStreaksTable()) {
         qDebug() << "Failed to create streaks table!";
         return -1;
     }
 
+    if (!dbManager.createSessionsTable()) {
+        qDebug() << "Failed to create pomodoro sessions table!";
+        return -1;
+    }
+
+    if (!dbManager.createRollupTables()) {
+        qDebug() << "Failed to create study rollup tables!";
+        return -1;
+    }
+
+    if (!dbManager.createPlannerTables()) {
+        qDebug() << "Failed to create planner tables!";
+        return -1;
+    }
+
+    if (!dbManager.createFlashcardTables()) {
+        qDebug() << "Failed to create flashcard tables!";
+        return -1;
+    }
+
+    if (!dbManager.createTagTables()) {
+        qDebug() << "Failed to create tag tables!";
+        return -1;
+    }
+
     // Register QML types
     qmlRegisterType<PomodoroTimer>("MyPomodoro", 1, 0, "PomodoroTimer");
     qmlRegisterType<TodoItem>("MyTodo", 1, 0, "TodoItem");
     qmlRegisterType<todoManager>("MyTodo", 1, 0, "TodoManager");
+    qmlRegisterType<TodoSortFilterModel>("MyTodo", 1, 0, "TodoSortFilterModel");
     qmlRegisterType<streaksManager>("com.lemonStudys", 1, 0, "StreaksManager");
+    qmlRegisterType<HeatmapCalendar>("com.lemonStudys", 1, 0, "HeatmapCalendar");
+    qmlRegisterUncreatableType<NamedTimer>("com.lemonStudys", 1, 0, "NamedTimer",
+                                           "NamedTimer instances come from timersModel");
 
     // Create model instances
     todoManager *todoModel = new todoManager(&app);
     streaksManager *streaksModel = new streaksManager(&app);
+    StreakAnalytics *streakAnalytics = new StreakAnalytics(streaksModel, &app);
     PomodoroTimer *pomodoroTimer = new PomodoroTimer(&app);
+    SessionLog *sessionLog = new SessionLog(pomodoroTimer, &app);
+    TimerListModel *timersModel = new TimerListModel(&app);
+
+    // Keep per-day and per-week summaries current as things happen
+    StudyRollup *studyRollup = new StudyRollup(&app);
+    QObject::connect(sessionLog, &SessionLog::intervalLogged,
+                     studyRollup, &StudyRollup::recordFocus);
+    QObject::connect(todoModel, &todoManager::completionChanged,
+                     studyRollup, &StudyRollup::recordTodoCompletion);
+    QObject::connect(streaksModel, &streaksManager::streakCheckedIn,
+                     studyRollup, &StudyRollup::recordHabitCheckin);
+
+    // Overdue / Due Today / This Week / High Priority lists and badges
+    SmartViews *smartViews = new SmartViews(todoModel, &app);
+
+    // Named lists; each list's todos load when it is opened
+    TodoListsModel *todoLists = new TodoListsModel(todoModel, &app);
+    QObject::connect(todoLists, &TodoListsModel::completionChanged,
+                     studyRollup, &StudyRollup::recordTodoCompletion);
+    QObject::connect(&app, &QGuiApplication::applicationStateChanged, todoLists,
+                     [todoLists](Qt::ApplicationState state) {
+                         if (state == Qt::ApplicationSuspended || state == Qt::ApplicationHidden) {
+                             todoLists->releaseMemory();
+                         }
+                     });
+
+    // Subtasks under each todo, loaded as they are expanded
+    TodoTreeModel *todoTree = new TodoTreeModel(todoModel, &app);
+
+    // Lay open todos out over the study windows, off the GUI thread
+    StudyPlanner *studyPlanner = new StudyPlanner(todoModel, &app);
+
+    // Reviewing any flashcards keeps the "Flashcard reviews" streak going
+    FlashcardManager *flashcards = new FlashcardManager(&app);
+    QObject::connect(flashcards, &FlashcardManager::studiedOn, streaksModel,
+                     [streaksModel]() { streaksModel->recordActivity("Flashcard reviews"); });
+
+    // Due-date and at-risk habit reminders on one timer wheel
+    ReminderService *reminders = new ReminderService(todoModel, streaksModel, &app);
+
+    // "What to work on now" ranking for the main menu and Pomodoro start
+    NextUpService *nextUp = new NextUpService(todoModel, &app);
+
+    // Ctrl+K palette over todos, streaks and the main views
+    QuickSwitcher *quickSwitcher = new QuickSwitcher(todoModel, streaksModel, &app);
+    quickSwitcher->addCommand("todo.qml", "Open To-Do List");
+    quickSwitcher->addCommand("streaks.qml", "Open Streaks");
+    quickSwitcher->addCommand("PomodoroView.qml", "Open Pomodoro Timer");
+
+    // Course/exam tags on todos and streaks, with boolean tag filters
+    TagManager *tagManager = new TagManager(todoModel, streaksModel, &app);
+
+    // Columnar copy of the full history for long-range charts. Catching up
+    // can read every session, so it waits until the event loop is running.
+    HistoryArchive *historyArchive = new HistoryArchive(&app);
+    QTimer::singleShot(0, historyArchive, [historyArchive]() {
+        if (historyArchive->open("lemonstudys.archive")) {
+            historyArchive->refreshFromDatabase();
+        }
+    });
+
+    // Decode UI sounds once up front so playback starts without delay
+    AudioCueEngine *audioCues = new AudioCueEngine(&app);
+    audioCues->registerCue("hover", ":/qt/qml/lemonStudys/assets/sounds/water_drop_sped_up.wav");
+    audioCues->registerCue("transition", ":/qt/qml/lemonStudys/assets/sounds/water_drop.wav");
+    QObject::connect(pomodoroTimer, &PomodoroTimer::stateChanged, audioCues,
+                     [audioCues](PomodoroTimer::State state) {
+                         if (state != PomodoroTimer::Idle) {
+                             audioCues->play("transition");
+                         }
+                     });
+    QObject::connect(pomodoroTimer, &PomodoroTimer::sessionEnded, audioCues,
+                     [audioCues]() { audioCues->play("transition"); });
+    QObject::connect(streaksModel, &streaksManager::streakCheckedIn, audioCues,
+                     [audioCues]() { audioCues->play("hover"); });
+    QObject::connect(reminders, &ReminderService::reminderDue, audioCues,
+                     [audioCues]() { audioCues->play("transition"); });
+
+    // Pick up commits made by other instances or scripts
+    DatabaseWatcher *dbWatcher = new DatabaseWatcher(&app);
+    QObject::connect(dbWatcher, &DatabaseWatcher::todoListsChanged,
+                     todoLists, &TodoListsModel::reload);
+    QObject::connect(dbWatcher, &DatabaseWatcher::todosChanged,
+                     todoModel, &todoManager::applyExternalChanges);
+    QObject::connect(dbWatcher, &DatabaseWatcher::todosChanged,
+                     todoLists, &TodoListsModel::applyExternalChanges);
+    QObject::connect(dbWatcher, &DatabaseWatcher::streaksChanged,
+                     streaksModel, &streaksManager::applyExternalChanges);
+    QObject::connect(dbWatcher, &DatabaseWatcher::streakCheckinsChanged,
+                     streakAnalytics, &StreakAnalytics::reloadHistories);
+    QObject::connect(dbWatcher, &DatabaseWatcher::resyncRequired,
+                     todoModel, &todoManager::reloadFromDatabase);
+    QObject::connect(dbWatcher, &DatabaseWatcher::resyncRequired,
+                     streaksModel, &streaksManager::reloadFromDatabase);
+
+    // Merge changes from other machines through a shared folder
+    SyncEngine *syncEngine = new SyncEngine(&app);
+    QObject::connect(syncEngine, &SyncEngine::todoListsChanged,
+                     todoLists, &TodoListsModel::reload);
+    QObject::connect(syncEngine, &SyncEngine::todosChanged,
+                     todoModel, &todoManager::applyExternalChanges);
+    QObject::connect(syncEngine, &SyncEngine::todosChanged,
+                     todoLists, &TodoListsModel::applyExternalChanges);
+    QObject::connect(syncEngine, &SyncEngine::streaksChanged,
+                     streaksModel, &streaksManager::applyExternalChanges);
+    QObject::connect(syncEngine, &SyncEngine::streakCheckinsChanged,
+                     streakAnalytics, &StreakAnalytics::reloadHistories);
 
     QQmlApplicationEngine engine;
 
     // Expose models to QML
     engine.rootContext()->setContextProperty("todoModelInstance", todoModel);
     engine.rootContext()->setContextProperty("streaksModelInstance", streaksModel);
+    engine.rootContext()->setContextProperty("streakAnalyticsInstance", streakAnalytics);
     engine.rootContext()->setContextProperty("pomodoroTimer",pomodoroTimer);
+    engine.rootContext()->setContextProperty("syncEngine", syncEngine);
+    engine.rootContext()->setContextProperty("sessionLog", sessionLog);
+    engine.rootContext()->setContextProperty("timersModel", timersModel);
+    engine.rootContext()->setContextProperty("audioCues", audioCues);
+    engine.rootContext()->setContextProperty("studyRollup", studyRollup);
+    engine.rootContext()->setContextProperty("historyArchive", historyArchive);
+    engine.rootContext()->setContextProperty("studyPlanner", studyPlanner);
+    engine.rootContext()->setContextProperty("flashcards", flashcards);
+    engine.rootContext()->setContextProperty("reminders", reminders);
+    engine.rootContext()->setContextProperty("nextUp", nextUp);
+    engine.rootContext()->setContextProperty("quickSwitcher", quickSwitcher);
+    engine.rootContext()->setContextProperty("smartViews", smartViews);
+    engine.rootContext()->setContextProperty("todoTree", todoTree);
+    engine.rootContext()->setContextProperty("todoLists", todoLists);
+    engine.rootContext()->setContextProperty("tagManager", tagManager);
 
     // Handle creation failures
     QObject::connect(
@@ -2,10 +2,10 @@ import QtQuick
 import QtQuick.Controls
 import QtQuick.Layouts
 import Qt5Compat.GraphicalEffects
-import QtMultimedia 6.2
 import QtQuick.Controls.Material
 import QtQuick.Effects
 import QtQuick.Controls 2.15
+import QtQuick.Dialogs
 
 ApplicationWindow {
     visible: true
@@ -13,12 +13,184 @@ ApplicationWindow {
     height: 720
     title: "LemonStudy"
 
+    // Lets the timer stop its per-second UI updates while minimized
+    onVisibilityChanged: pomodoroTimer.windowVisible = visibility !== Window.Minimized
+                                                      && visibility !== Window.Hidden
+
     StackView {
         id: mainStack
         anchors.fill: parent
         initialItem: mainMenu
     }
 
+    // Reminder banner, shown over whichever view is open
+    Rectangle {
+        id: reminderBanner
+        property string message: ""
+        z: 10
+        visible: opacity > 0
+        opacity: 0
+        width: reminderText.implicitWidth + 40
+        height: 48
+        radius: 24
+        color: "#FFF9F1"
+        border.color: "#333333"
+        border.width: 1
+        anchors.horizontalCenter: parent.horizontalCenter
+        anchors.bottom: parent.bottom
+        anchors.bottomMargin: 24
+
+        Behavior on opacity { NumberAnimation { duration: 200 } }
+
+        Text {
+            id: reminderText
+            text: reminderBanner.message
+            anchors.centerIn: parent
+            font.pixelSize: 18
+            color: "#333333"
+            font.family: fredoka.name
+        }
+
+        Timer {
+            id: reminderHideTimer
+            interval: 6000
+            onTriggered: reminderBanner.opacity = 0
+        }
+
+        MouseArea {
+            anchors.fill: parent
+            onClicked: reminderBanner.opacity = 0
+        }
+
+        Connections {
+            target: reminders
+            function onReminderDue(kind, id, title, dueAt, leadMinutes) {
+                const lead = leadMinutes >= 60 ? Math.round(leadMinutes / 60) + " h" : leadMinutes + " min"
+                reminderBanner.message = kind === "habit"
+                        ? "\"" + title + "\" streak ends in " + lead
+                        : "\"" + title + "\" is due in " + lead
+                reminderBanner.opacity = 1
+                reminderHideTimer.restart()
+            }
+        }
+    }
+
+    // Quick switcher: fuzzy-find any todo, streak or view and jump to it
+    Shortcut {
+        sequences: ["Ctrl+K", "Ctrl+P"]
+        onActivated: quickSwitcherPopup.open()
+    }
+
+    Popup {
+        id: quickSwitcherPopup
+        z: 20
+        width: 560
+        height: Math.min(420, 72 + resultsList.contentHeight)
+        x: (parent.width - width) / 2
+        y: 80
+        modal: true
+        focus: true
+        padding: 12
+
+        background: Rectangle {
+            color: "#FFF9F1"
+            radius: 15
+            border.color: "#333333"
+            border.width: 1
+        }
+
+        onOpened: {
+            switcherInput.text = ""
+            switcherInput.forceActiveFocus()
+        }
+
+        function activate(row) {
+            const item = quickSwitcher.get(row)
+            if (item.kind === undefined) {
+                return
+            }
+            close()
+            if (mainStack.depth > 1) {
+                mainStack.pop(null)
+            }
+            if (item.kind === "todo") {
+                mainStack.push("todo.qml", { "focusTodoId": item.itemId })
+            } else if (item.kind === "streak") {
+                mainStack.push("streaks.qml", { "focusRow": item.row })
+            } else {
+                mainStack.push(item.command)
+            }
+        }
+
+        ColumnLayout {
+            anchors.fill: parent
+            spacing: 8
+
+            TextField {
+                id: switcherInput
+                Layout.fillWidth: true
+                placeholderText: "Jump to a task, streak or view..."
+                font.family: fredoka.name
+                font.pixelSize: 18
+                Material.accent: "#333333"
+                onTextChanged: {
+                    quickSwitcher.query = text
+                    resultsList.currentIndex = 0
+                }
+                Keys.onDownPressed: resultsList.incrementCurrentIndex()
+                Keys.onUpPressed: resultsList.decrementCurrentIndex()
+                Keys.onEscapePressed: quickSwitcherPopup.close()
+                onAccepted: quickSwitcherPopup.activate(resultsList.currentIndex)
+            }
+
+            ListView {
+                id: resultsList
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                clip: true
+                model: quickSwitcher
+                highlightMoveDuration: 0
+
+                delegate: Rectangle {
+                    width: resultsList.width
+                    height: 40
+                    radius: 8
+                    color: ListView.isCurrentItem ? "#FFDE59" : "transparent"
+
+                    RowLayout {
+                        anchors.fill: parent
+                        anchors.leftMargin: 10
+                        anchors.rightMargin: 10
+
+                        Text {
+                            Layout.fillWidth: true
+                            text: model.highlightedTitle
+                            textFormat: Text.StyledText
+                            elide: Text.ElideRight
+                            font.family: fredoka.name
+                            font.pixelSize: 16
+                            color: "#333333"
+                        }
+
+                        Text {
+                            text: model.kind === "todo" ? "Task" : model.kind === "streak" ? "Streak" : "View"
+                            font.family: fredoka.name
+                            font.pixelSize: 12
+                            color: "#777777"
+                        }
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        onEntered: resultsList.currentIndex = index
+                        onClicked: quickSwitcherPopup.activate(index)
+                    }
+                }
+            }
+        }
+    }
+
     // Fontloader to load a custom font.
     FontLoader {
         id: fredoka
@@ -30,11 +202,13 @@ ApplicationWindow {
         source: "../assets/fonts/FredokaOne.ttf"
     }
 
-    SoundEffect {
+    // Hover cue, decoded once and mixed in C++ (see AudioCueEngine)
+    // Source: https://freesound.org/people/deleted_user_2104797/sounds/166322/
+    QtObject {
         id: hoversound
-        source: "../assets/sounds/water_drop_sped_up.wav"
-        // Source: https://freesound.org/people/deleted_user_2104797/sounds/166322/
-        volume: 0.5
+        function play() {
+            audioCues.play("hover", 0.5)
+        }
     }
 
     Component {
@@ -62,6 +236,18 @@ ApplicationWindow {
                 anchors.topMargin: 50
             }
 
+            // Live study counter, fed by the pomodoro session log
+            Text {
+                id: studiedTodayText
+                text: sessionLog.minutesStudiedToday + " min studied today"
+                font.pixelSize: 24
+                color: "#333333"
+                font.family: fredoka.name
+                anchors.horizontalCenter: parent.horizontalCenter
+                anchors.top: titleText.bottom
+                anchors.topMargin: 8
+            }
+
             // Vertical column for buttons
             Column {
                 anchors.centerIn: parent
@@ -203,6 +389,45 @@ ApplicationWindow {
                     Behavior on scale {
                         NumberAnimation { duration: 100 }
                     }
+
+                    // Smart view badges; each opens the todo list on that view
+                    Row {
+                        z: 1
+                        anchors.right: parent.right
+                        anchors.rightMargin: 36
+                        anchors.verticalCenter: parent.verticalCenter
+                        spacing: 6
+
+                        Repeater {
+                            model: [
+                                { view: 1, label: "overdue", color: "#e74c3c", count: smartViews.overdue.count },
+                                { view: 2, label: "today", color: "#FFDE59", count: smartViews.dueToday.count }
+                            ]
+
+                            delegate: Rectangle {
+                                visible: modelData.count > 0
+                                width: badgeText.implicitWidth + 16
+                                height: 26
+                                radius: 13
+                                color: modelData.color
+
+                                Text {
+                                    id: badgeText
+                                    anchors.centerIn: parent
+                                    text: modelData.count + " " + modelData.label
+                                    font.pixelSize: 14
+                                    font.family: fredoka.name
+                                    color: modelData.view === 1 ? "white" : "#333333"
+                                }
+
+                                MouseArea {
+                                    anchors.fill: parent
+                                    cursorShape: Qt.PointingHandCursor
+                                    onClicked: mainStack.push("todo.qml", { "initialView": modelData.view })
+                                }
+                            }
+                        }
+                    }
                 }
 
                 // Block button
@@ -251,6 +476,167 @@ ApplicationWindow {
                 }
             }
 
+            // "Next up" card: the best few open todos, ranked in C++ (see NextUpService)
+            Rectangle {
+                visible: nextUp.openCount > 0
+                width: 300
+                height: nextUpColumn.implicitHeight + 32
+                radius: 15
+                color: "#FFF9F1"
+                border.color: "#333333"
+                border.width: 2
+                anchors.left: parent.left
+                anchors.leftMargin: 40
+                anchors.verticalCenter: parent.verticalCenter
+
+                layer.enabled: true
+                layer.effect: DropShadow {
+                    horizontalOffset: 0
+                    verticalOffset: 3
+                    radius: 8
+                    samples: 17
+                    color: "#40000000"
+                }
+
+                Column {
+                    id: nextUpColumn
+                    anchors.fill: parent
+                    anchors.margins: 16
+                    spacing: 10
+
+                    Text {
+                        text: "Next up"
+                        font.pixelSize: 24
+                        font.family: fredoka.name
+                        color: "#333333"
+                    }
+
+                    Repeater {
+                        model: nextUp.topItems
+
+                        delegate: Rectangle {
+                            width: nextUpColumn.width
+                            height: 52
+                            radius: 10
+                            color: index === 0 ? "#FFDE59" : "transparent"
+
+                            Column {
+                                anchors.left: parent.left
+                                anchors.right: parent.right
+                                anchors.verticalCenter: parent.verticalCenter
+                                anchors.leftMargin: 10
+                                anchors.rightMargin: 10
+
+                                Text {
+                                    width: parent.width
+                                    text: modelData.title
+                                    elide: Text.ElideRight
+                                    font.pixelSize: 18
+                                    font.family: fredoka.name
+                                    color: "#333333"
+                                }
+
+                                Text {
+                                    text: modelData.reason
+                                    font.pixelSize: 13
+                                    font.family: fredoka.name
+                                    color: "#777777"
+                                }
+                            }
+
+                            MouseArea {
+                                anchors.fill: parent
+                                cursorShape: Qt.PointingHandCursor
+                                onClicked: mainStack.push("todo.qml", { "focusTodoId": modelData.todoId })
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Study tools card: the smaller pages, each with a live count
+            Rectangle {
+                width: 300
+                height: toolsColumn.implicitHeight + 32
+                radius: 15
+                color: "#FFF9F1"
+                border.color: "#333333"
+                border.width: 2
+                anchors.right: parent.right
+                anchors.rightMargin: 40
+                anchors.verticalCenter: parent.verticalCenter
+
+                layer.enabled: true
+                layer.effect: DropShadow {
+                    horizontalOffset: 0
+                    verticalOffset: 3
+                    radius: 8
+                    samples: 17
+                    color: "#40000000"
+                }
+
+                Column {
+                    id: toolsColumn
+                    anchors.fill: parent
+                    anchors.margins: 16
+                    spacing: 10
+
+                    Text {
+                        text: "Study tools"
+                        font.pixelSize: 24
+                        font.family: fredoka.name
+                        color: "#333333"
+                    }
+
+                    Repeater {
+                        model: [
+                            { page: "flashcards.qml", title: "Flashcards", detail: flashcards.dueCount + " due today" },
+                            { page: "timers.qml", title: "Timers", detail: timersModel.runningCount + " running" },
+                            { page: "stats.qml", title: "Stats", detail: sessionLog.minutesStudiedToday + " min today" },
+                            { page: "planner.qml", title: "Study plan", detail: studyPlanner.plannedCount + " todos planned" }
+                        ]
+
+                        delegate: Rectangle {
+                            width: toolsColumn.width
+                            height: 52
+                            radius: 10
+                            color: toolArea.containsMouse ? "#FFDE59" : "transparent"
+
+                            Column {
+                                anchors.left: parent.left
+                                anchors.right: parent.right
+                                anchors.verticalCenter: parent.verticalCenter
+                                anchors.leftMargin: 10
+                                anchors.rightMargin: 10
+
+                                Text {
+                                    text: modelData.title
+                                    font.pixelSize: 18
+                                    font.family: fredoka.name
+                                    color: "#333333"
+                                }
+
+                                Text {
+                                    text: modelData.detail
+                                    font.pixelSize: 13
+                                    font.family: fredoka.name
+                                    color: "#777777"
+                                }
+                            }
+
+                            MouseArea {
+                                id: toolArea
+                                anchors.fill: parent
+                                cursorShape: Qt.PointingHandCursor
+                                hoverEnabled: true
+                                onEntered: hoversound.play()
+                                onClicked: mainStack.push(modelData.page)
+                            }
+                        }
+                    }
+                }
+            }
+
             Row {
                 anchors.right: parent.right
                 anchors.bottom: parent.bottom
@@ -332,6 +718,58 @@ ApplicationWindow {
 
                 }
 
+                // sync folder button
+                Rectangle {
+                    id: syncButton
+                    width: 50
+                    height: 50
+                    radius: 25
+                    color: syncEngine.syncDirectory !== "" ? "#E8F5E9" : "#FFF9F1"
+                    border.color: "#333333"
+                    border.width: 1
+
+                    layer.enabled: true
+                    layer.effect: DropShadow {
+                        horizontalOffset: 0
+                        verticalOffset: 3
+                        radius: 8
+                        samples: 17
+                        color: "#40000000"
+                    }
+
+                    Text {
+                        text: "\u21C5"
+                        anchors.centerIn: parent
+                        font.pixelSize: 22
+                        color: "#333333"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        cursorShape: Qt.PointingHandCursor
+                        hoverEnabled: true
+                        onEntered: {
+                            syncButton.scale = 1.02
+                            hoversound.play()
+                        }
+                        onExited: syncButton.scale = 1.0
+                        onClicked: {
+                            if (syncEngine.syncDirectory === "") {
+                                syncFolderDialog.open()
+                            } else {
+                                syncEngine.syncNow()
+                            }
+                        }
+                        onPressAndHold: syncFolderDialog.open()
+                    }
+
+                    FolderDialog {
+                        id: syncFolderDialog
+                        title: "Choose a shared folder to sync through"
+                        onAccepted: syncEngine.setSyncDirectoryUrl(selectedFolder)
+                    }
+                }
+
             }
         }
     }
@@ -21,13 +21,12 @@ Page {
     Material.primary: Material.Amber
     Material.accent: Material.Yellow
 
-    function formatTime(seconds) {
-        let m = Math.floor(seconds / 60);
-        let s = seconds % 60;
-        let mm = m < 10 ? "0" + m : m;
-        let ss = s < 10 ? "0" + s : s;
-        return mm + ":" + ss;
-    }
+    // The timer only sends per-second updates while a view is attached
+    Component.onCompleted: pomodoroTimer.attachView()
+    Component.onDestruction: pomodoroTimer.detachView()
+
+    // The todo suggested for the current focus session, picked as it starts
+    property var sessionTask: null
 
     background: Rectangle {
         gradient: Gradient {
@@ -82,7 +81,7 @@ Page {
                 anchors.centerIn: parent
                 font.pixelSize: 72
                 font.weight: Font.Medium
-                text: pomodoroView.formatTime(pomodoroTimer.timeRemaining)
+                text: pomodoroTimer.displayText
                 color: "#333333"
                 font.family: fredoka.name
 
@@ -91,14 +90,17 @@ Page {
 
         Connections {
             target: pomodoroTimer
-            function onTimeRemainingChanged() {
-                timerText.text = pomodoroView.formatTime(pomodoroTimer.timeRemaining)
-            }
-
             function onSessionEnded() {
                 console.log("Pomodoro session ended!");
             }
 
+            function onStateChanged(newState) {
+                if (newState === PomodoroTimer.Working) {
+                    const best = nextUp.topItems
+                    pomodoroView.sessionTask = best.length > 0 ? best[0] : null
+                }
+            }
+
             function onClosePomodorotimer() {
                 console.log("received closed signal");
                 if(pomodoroView.StackView.view){
@@ -126,6 +128,54 @@ Page {
 
         }
 
+        // "Next up" suggestion: live while idle, fixed once a focus session starts
+        Pane {
+            id: nextUpCard
+            readonly property var task: pomodoroTimer.currentState === PomodoroTimer.Working
+                                        ? pomodoroView.sessionTask
+                                        : nextUp.topItems[0]
+            visible: pomodoroTimer.currentState !== PomodoroTimer.OnBreak && task !== undefined && task !== null
+            Layout.preferredWidth: parent.width * 0.65
+            Layout.alignment: Qt.AlignHCenter
+            Material.elevation: 2
+            Material.roundedScale: Material.MediumScale
+
+            background: Rectangle {
+                color: "#FFF9F1"
+                radius: 15
+                border.color: "#333333"
+                border.width: 1
+            }
+
+            ColumnLayout {
+                anchors.fill: parent
+                spacing: 2
+
+                Label {
+                    text: pomodoroTimer.currentState === PomodoroTimer.Working ? "Working on" : "Next up"
+                    font.pixelSize: 14
+                    color: "#777777"
+                    font.family: fredoka.name
+                }
+
+                Label {
+                    Layout.fillWidth: true
+                    text: nextUpCard.task ? nextUpCard.task.title : ""
+                    elide: Text.ElideRight
+                    font.pixelSize: 22
+                    color: "#333333"
+                    font.family: fredoka.name
+                }
+
+                Label {
+                    text: nextUpCard.task ? nextUpCard.task.reason : ""
+                    font.pixelSize: 14
+                    color: "#777777"
+                    font.family: fredoka.name
+                }
+            }
+        }
+
         // Primary action buttons
         RowLayout {
             spacing: 16
@@ -0,0 +1,329 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtQuick.Controls.Material
+import QtQuick.Effects
+
+Page {
+    id: flashcardsPage
+    title: "Flashcards"
+
+    // Deck list with card and due counts; decks() is a query, so reload it after changes
+    property var deckList: flashcards.decks()
+    // Whether the back of the current card is showing
+    property bool answerShown: false
+
+    function reloadDecks() {
+        deckList = flashcards.decks()
+    }
+
+    Connections {
+        target: flashcards
+        function onDueCountChanged() {
+            flashcardsPage.reloadDecks()
+        }
+        function onCurrentCardChanged() {
+            flashcardsPage.answerShown = false
+        }
+    }
+
+    FontLoader {
+        id: fredoka
+        source: "../assets/fonts/Fredoka.ttf"
+    }
+
+    // Background
+    Rectangle {
+        anchors.fill: parent
+        gradient: Gradient {
+            GradientStop { position: 0.0; color: "#FFDE59" }
+            GradientStop { position: 1.0; color: "#FFF8DC" }
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 20
+        spacing: 15
+
+        // Header Stats Card
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 20
+
+                Column {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Due Today"
+                        font.pixelSize: 14
+                        color: "#666"
+                        font.family: fredoka.name
+                    }
+                    Label {
+                        text: flashcards.dueCount
+                        font.pixelSize: 28
+                        font.bold: true
+                        color: "#2c3e50"
+                        font.family: fredoka.name
+                    }
+                }
+
+                Rectangle {
+                    width: 1
+                    Layout.fillHeight: true
+                    color: "#e0e0e0"
+                }
+
+                Column {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Reviewed Today"
+                        font.pixelSize: 14
+                        color: "#666"
+                        font.family: fredoka.name
+                    }
+                    Label {
+                        text: flashcards.reviewedToday
+                        font.pixelSize: 28
+                        font.bold: true
+                        color: "#27ae60"
+                        font.family: fredoka.name
+                    }
+                }
+
+                Rectangle {
+                    width: 1
+                    Layout.fillHeight: true
+                    color: "#e0e0e0"
+                }
+
+                Button {
+                    text: "←"
+                    flat: true
+                    Material.foreground: "grey"
+                    Layout.preferredWidth: 80
+
+                    onClicked: {
+                        if (flashcardsPage.StackView.view) {
+                            flashcardsPage.StackView.view.pop()
+                        }
+                    }
+                }
+            }
+        }
+
+        // Add a deck or a card
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 130
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            ColumnLayout {
+                anchors.fill: parent
+                anchors.margins: 10
+                spacing: 6
+
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 10
+
+                    ComboBox {
+                        id: deckBox
+                        Layout.preferredWidth: 220
+                        model: flashcardsPage.deckList
+                        textRole: "title"
+                        valueRole: "id"
+                        font.family: fredoka.name
+                    }
+
+                    TextField {
+                        id: newDeckInput
+                        Layout.fillWidth: true
+                        placeholderText: "New deck name..."
+                        font.family: fredoka.name
+                        font.pixelSize: 14
+                        Material.accent: "#333333"
+                    }
+
+                    Button {
+                        text: "Add Deck"
+                        enabled: newDeckInput.text.length > 0
+                        Material.background: "#FFF9F1"
+                        Material.foreground: "#333333"
+                        font.family: fredoka.name
+
+                        onClicked: {
+                            flashcards.addDeck(newDeckInput.text)
+                            newDeckInput.text = ""
+                            flashcardsPage.reloadDecks()
+                        }
+                    }
+                }
+
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 10
+
+                    TextField {
+                        id: frontInput
+                        Layout.fillWidth: true
+                        placeholderText: "Question"
+                        font.family: fredoka.name
+                        font.pixelSize: 14
+                        Material.accent: "#333333"
+                    }
+
+                    TextField {
+                        id: backInput
+                        Layout.fillWidth: true
+                        placeholderText: "Answer"
+                        font.family: fredoka.name
+                        font.pixelSize: 14
+                        Material.accent: "#333333"
+                    }
+
+                    Button {
+                        text: "Add Card"
+                        enabled: deckBox.currentIndex >= 0 && frontInput.text.length > 0 && backInput.text.length > 0
+                        Material.background: "#FFDE59"
+                        Material.foreground: "#333333"
+                        font.family: fredoka.name
+
+                        onClicked: {
+                            flashcards.addCard(deckBox.currentValue, frontInput.text, backInput.text)
+                            frontInput.text = ""
+                            backInput.text = ""
+                        }
+                    }
+                }
+            }
+        }
+
+        // Review card: question first, then the answer and the SM-2 grades
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            Label {
+                anchors.centerIn: parent
+                visible: flashcards.currentCard.id === undefined
+                text: "Nothing left to review today"
+                font.pixelSize: 24
+                color: "#7f8c8d"
+                font.family: fredoka.name
+            }
+
+            ColumnLayout {
+                anchors.fill: parent
+                anchors.margins: 30
+                spacing: 20
+                visible: flashcards.currentCard.id !== undefined
+
+                Label {
+                    Layout.fillWidth: true
+                    text: flashcards.currentCard.front || ""
+                    wrapMode: Text.WordWrap
+                    horizontalAlignment: Text.AlignHCenter
+                    font.pixelSize: 32
+                    color: "#333333"
+                    font.family: fredoka.name
+                }
+
+                Rectangle {
+                    Layout.fillWidth: true
+                    height: 1
+                    color: "#e0e0e0"
+                    visible: flashcardsPage.answerShown
+                }
+
+                Label {
+                    Layout.fillWidth: true
+                    Layout.fillHeight: true
+                    visible: flashcardsPage.answerShown
+                    text: flashcards.currentCard.back || ""
+                    wrapMode: Text.WordWrap
+                    horizontalAlignment: Text.AlignHCenter
+                    font.pixelSize: 24
+                    color: "#2c3e50"
+                    font.family: fredoka.name
+                }
+
+                Item {
+                    Layout.fillHeight: true
+                    visible: !flashcardsPage.answerShown
+                }
+
+                Button {
+                    Layout.alignment: Qt.AlignHCenter
+                    visible: !flashcardsPage.answerShown
+                    text: "Show Answer"
+                    Material.background: "#FFDE59"
+                    Material.foreground: "#333333"
+                    font.family: fredoka.name
+                    onClicked: flashcardsPage.answerShown = true
+                }
+
+                RowLayout {
+                    Layout.alignment: Qt.AlignHCenter
+                    visible: flashcardsPage.answerShown
+                    spacing: 10
+
+                    Repeater {
+                        model: [
+                            { label: "Again", quality: 1, color: "#e74c3c" },
+                            { label: "Hard", quality: 3, color: "#FFF9F1" },
+                            { label: "Good", quality: 4, color: "#FFDE59" },
+                            { label: "Easy", quality: 5, color: "#27ae60" }
+                        ]
+
+                        delegate: Button {
+                            text: modelData.label
+                            Material.background: modelData.color
+                            Material.foreground: modelData.quality === 3 || modelData.quality === 4 ? "#333333" : "white"
+                            font.family: fredoka.name
+                            onClicked: flashcards.answer(modelData.quality)
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,278 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtQuick.Controls.Material
+import QtQuick.Effects
+
+Page {
+    id: plannerPage
+    title: "Study Plan"
+
+    // Day shown in the slot list: today plus the selected tab's offset
+    property date selectedDay: new Date()
+    property var daySlots: []
+
+    function reloadSlots() {
+        daySlots = studyPlanner.slotsOn(selectedDay)
+    }
+
+    function clock(minutes) {
+        return String(Math.floor(minutes / 60)).padStart(2, "0") + ":" + String(minutes % 60).padStart(2, "0")
+    }
+
+    // "Mon 17:00–21:00, Sat 10:00–13:00, ..." from the weekly study windows
+    function windowsText() {
+        const names = ["", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"]
+        return studyPlanner.windows().map(w => names[w.weekday] + " " + clock(w.startMinute)
+                                               + "–" + clock(w.endMinute)).join(", ")
+    }
+
+    onSelectedDayChanged: reloadSlots()
+    Component.onCompleted: reloadSlots()
+
+    Connections {
+        target: studyPlanner
+        function onPlanChanged() {
+            plannerPage.reloadSlots()
+        }
+    }
+
+    FontLoader {
+        id: fredoka
+        source: "../assets/fonts/Fredoka.ttf"
+    }
+
+    // Background
+    Rectangle {
+        anchors.fill: parent
+        gradient: Gradient {
+            GradientStop { position: 0.0; color: "#FFDE59" }
+            GradientStop { position: 1.0; color: "#FFF8DC" }
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 20
+        spacing: 15
+
+        // Header Stats Card
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 20
+
+                Repeater {
+                    model: [
+                        { label: "Planned", value: studyPlanner.plannedCount, color: "#27ae60" },
+                        { label: "Late", value: studyPlanner.lateCount, color: "#e74c3c" },
+                        { label: "No Room", value: studyPlanner.unplannedCount, color: "#2c3e50" }
+                    ]
+
+                    delegate: Column {
+                        Layout.fillWidth: true
+
+                        Label {
+                            text: modelData.label
+                            font.pixelSize: 14
+                            color: "#666"
+                            font.family: fredoka.name
+                        }
+                        Label {
+                            text: modelData.value
+                            font.pixelSize: 28
+                            font.bold: true
+                            color: modelData.color
+                            font.family: fredoka.name
+                        }
+                    }
+                }
+
+                BusyIndicator {
+                    running: studyPlanner.planning
+                    Layout.preferredWidth: 40
+                    Layout.preferredHeight: 40
+                }
+
+                Button {
+                    text: "←"
+                    flat: true
+                    Material.foreground: "grey"
+                    Layout.preferredWidth: 80
+
+                    onClicked: {
+                        if (plannerPage.StackView.view) {
+                            plannerPage.StackView.view.pop()
+                        }
+                    }
+                }
+            }
+        }
+
+        // Session lengths and study windows the plan is built from
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 10
+                spacing: 10
+
+                Label {
+                    text: "Focus"
+                    font.family: fredoka.name
+                    color: "#666"
+                }
+                SpinBox {
+                    from: 5
+                    to: 120
+                    value: studyPlanner.workMinutes
+                    font.family: fredoka.name
+                    onValueModified: studyPlanner.workMinutes = value
+                }
+
+                Label {
+                    text: "Break"
+                    font.family: fredoka.name
+                    color: "#666"
+                }
+                SpinBox {
+                    from: 0
+                    to: 60
+                    value: studyPlanner.breakMinutes
+                    font.family: fredoka.name
+                    onValueModified: studyPlanner.breakMinutes = value
+                }
+
+                Label {
+                    Layout.fillWidth: true
+                    text: plannerPage.windowsText()
+                    elide: Text.ElideRight
+                    font.pixelSize: 13
+                    color: "#7f8c8d"
+                    font.family: fredoka.name
+                }
+
+                Button {
+                    text: "Replan"
+                    Material.background: "#FFDE59"
+                    Material.foreground: "#333333"
+                    font.family: fredoka.name
+                    onClicked: studyPlanner.replan()
+                }
+            }
+        }
+
+        // One tab per day of the coming week
+        TabBar {
+            id: dayTabs
+            Layout.fillWidth: true
+            font.family: fredoka.name
+
+            Repeater {
+                model: 7
+
+                TabButton {
+                    text: index === 0 ? "Today"
+                                      : index === 1 ? "Tomorrow"
+                                                    : Qt.formatDate(new Date(Date.now() + index * 86400000), "ddd d")
+                }
+            }
+
+            onCurrentIndexChanged: {
+                const now = new Date()
+                plannerPage.selectedDay = new Date(now.getFullYear(), now.getMonth(), now.getDate() + currentIndex)
+            }
+        }
+
+        // Slots on the selected day
+        ListView {
+            id: slotList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            spacing: 10
+            model: plannerPage.daySlots
+
+            Label {
+                anchors.centerIn: parent
+                visible: slotList.count === 0
+                text: "Nothing planned for this day"
+                font.pixelSize: 18
+                color: "#7f8c8d"
+                font.family: fredoka.name
+            }
+
+            delegate: Rectangle {
+                width: slotList.width
+                height: 60
+                radius: 15
+                color: "white"
+                border.color: modelData.late ? "#e74c3c" : "transparent"
+                border.width: 2
+
+                RowLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 15
+
+                    Label {
+                        text: Qt.formatTime(modelData.start, "hh:mm") + "–" + Qt.formatTime(modelData.end, "hh:mm")
+                        font.pixelSize: 16
+                        color: "#666"
+                        font.family: fredoka.name
+                    }
+
+                    Label {
+                        Layout.fillWidth: true
+                        text: modelData.title
+                        elide: Text.ElideRight
+                        font.pixelSize: 18
+                        color: "#2c3e50"
+                        font.family: fredoka.name
+                    }
+
+                    Label {
+                        visible: modelData.late
+                        text: "Past due"
+                        font.pixelSize: 13
+                        color: "#e74c3c"
+                        font.family: fredoka.name
+                    }
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    cursorShape: Qt.PointingHandCursor
+                    onClicked: plannerPage.StackView.view.push("todo.qml", { "focusTodoId": modelData.todoId })
+                }
+            }
+        }
+    }
+}
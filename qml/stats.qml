@@ -0,0 +1,258 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtQuick.Controls.Material
+import QtQuick.Effects
+import com.lemonStudys 1.0
+
+Page {
+    id: statsPage
+    title: "Study Stats"
+
+    // Rollup rows for today and the last eight ISO weeks
+    property var today: ({})
+    property var weeks: []
+    // Longest week in the list, for scaling the bars
+    property int weekMax: 1
+
+    function reload() {
+        const now = new Date()
+        const from = new Date(now.getFullYear(), now.getMonth(), now.getDate() - 7 * 7)
+        today = studyRollup.daySummary(now)
+        weeks = studyRollup.weeklySummaries(from, now)
+        weekMax = Math.max(1, ...weeks.map(week => week.focusMinutes))
+    }
+
+    // The past year of focus, scanned from the columnar archive
+    function reloadHistory() {
+        const minutes = historyArchive.dailyMinutes(yearHeatmap.startDate, yearHeatmap.endDate)
+        yearHeatmap.values = minutes
+        yearTotal.minutes = minutes.reduce((sum, value) => sum + value, 0)
+    }
+
+    Component.onCompleted: {
+        reload()
+        // Pull in sessions logged since startup before reading the archive
+        historyArchive.refreshFromDatabase()
+        reloadHistory()
+    }
+
+    Connections {
+        target: studyRollup
+        function onRollupChanged(day) {
+            statsPage.reload()
+        }
+    }
+
+    Connections {
+        target: historyArchive
+        function onArchiveChanged() {
+            statsPage.reloadHistory()
+        }
+    }
+
+    FontLoader {
+        id: fredoka
+        source: "../assets/fonts/Fredoka.ttf"
+    }
+
+    // Background
+    Rectangle {
+        anchors.fill: parent
+        gradient: Gradient {
+            GradientStop { position: 0.0; color: "#FFDE59" }
+            GradientStop { position: 1.0; color: "#FFF8DC" }
+        }
+    }
+
+    ColumnLayout {
+        id: statsColumn
+        anchors.fill: parent
+        anchors.margins: 20
+        spacing: 15
+
+        // Header Stats Card: today so far
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 20
+
+                Repeater {
+                    model: [
+                        { label: "Focus Today", value: (statsPage.today.focusMinutes || 0) + " min", color: "#2c3e50" },
+                        { label: "Sessions", value: statsPage.today.sessions || 0, color: "#2c3e50" },
+                        { label: "Todos Done", value: statsPage.today.todosCompleted || 0, color: "#27ae60" },
+                        { label: "Habits Checked", value: statsPage.today.habitsChecked || 0, color: "#27ae60" }
+                    ]
+
+                    delegate: Column {
+                        Layout.fillWidth: true
+
+                        Label {
+                            text: modelData.label
+                            font.pixelSize: 14
+                            color: "#666"
+                            font.family: fredoka.name
+                        }
+                        Label {
+                            text: modelData.value
+                            font.pixelSize: 28
+                            font.bold: true
+                            color: modelData.color
+                            font.family: fredoka.name
+                        }
+                    }
+                }
+
+                Button {
+                    text: "←"
+                    flat: true
+                    Material.foreground: "grey"
+                    Layout.preferredWidth: 80
+
+                    onClicked: {
+                        if (statsPage.StackView.view) {
+                            statsPage.StackView.view.pop()
+                        }
+                    }
+                }
+            }
+        }
+
+        // Focus minutes per week
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: weeksColumn.implicitHeight + 30
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            Column {
+                id: weeksColumn
+                anchors.fill: parent
+                anchors.margins: 15
+                spacing: 6
+
+                Label {
+                    text: "Last 8 weeks"
+                    font.pixelSize: 18
+                    color: "#2c3e50"
+                    font.family: fredoka.name
+                }
+
+                Label {
+                    visible: statsPage.weeks.length === 0
+                    text: "No study time logged yet"
+                    font.pixelSize: 14
+                    color: "#7f8c8d"
+                    font.family: fredoka.name
+                }
+
+                Repeater {
+                    model: statsPage.weeks
+
+                    delegate: Row {
+                        width: weeksColumn.width
+                        height: 24
+                        spacing: 10
+
+                        Label {
+                            width: 90
+                            anchors.verticalCenter: parent.verticalCenter
+                            text: modelData.week
+                            font.pixelSize: 13
+                            color: "#666"
+                            font.family: fredoka.name
+                        }
+
+                        Rectangle {
+                            anchors.verticalCenter: parent.verticalCenter
+                            width: Math.max(2, (weeksColumn.width - 320) * modelData.focusMinutes / statsPage.weekMax)
+                            height: 14
+                            radius: 7
+                            color: "#FFDE59"
+                            border.color: "#333333"
+                            border.width: 1
+                        }
+
+                        Label {
+                            anchors.verticalCenter: parent.verticalCenter
+                            text: modelData.focusMinutes + " min · " + modelData.sessions + " sessions · "
+                                  + modelData.todosCompleted + " todos"
+                            font.pixelSize: 13
+                            color: "#7f8c8d"
+                            font.family: fredoka.name
+                        }
+                    }
+                }
+            }
+        }
+
+        // Focus minutes per day over the past year
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 190
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            Column {
+                anchors.fill: parent
+                anchors.margins: 15
+                spacing: 6
+
+                Label {
+                    id: yearTotal
+                    property int minutes: 0
+                    text: "Past year: " + Math.round(minutes / 60) + " hours of focus"
+                    font.pixelSize: 18
+                    color: "#2c3e50"
+                    font.family: fredoka.name
+                }
+
+                HeatmapCalendar {
+                    id: yearHeatmap
+                    width: parent.width
+                    height: 130
+                    weeks: 52
+                    cellSpacing: 2
+                    maxValue: 120
+                }
+            }
+        }
+
+        Item {
+            Layout.fillHeight: true
+        }
+    }
+}
@@ -4,12 +4,15 @@ import QtQuick.Layouts
 import QtQuick.Controls.Material
 import QtQuick.Effects
 import QtMultimedia 6.2
+import com.lemonStudys 1.0
 
 
 
 Page {
     id: streaksPage
     title: "Habit Streaks"
+    // Set by the quick switcher to jump to one streak
+    property int focusRow: -1
 
     Connections {
         target: streaksModelInstance
@@ -178,6 +181,116 @@ Page {
                         newStreakInput.text = ""
                     }
                 }
+
+                TextField {
+                    id: tagFilterField
+                    Layout.preferredWidth: 200
+                    placeholderText: "Tags: exam AND NOT done"
+                    font.family: fredoka.name
+                    font.pixelSize: 14
+                    Material.accent: "#333333"
+                    onTextChanged: tagManager.streakQuery = text
+                }
+            }
+        }
+
+        // Streak Insights
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 170
+            radius: 15
+            color: "white"
+            visible: insightsList.count > 0
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            ListView {
+                id: insightsList
+                anchors.fill: parent
+                anchors.margins: 10
+                orientation: ListView.Horizontal
+                spacing: 10
+                clip: true
+                model: streakAnalyticsInstance
+
+                delegate: Rectangle {
+                    width: 300
+                    height: insightsList.height
+                    radius: 10
+                    color: "#FFF9F1"
+                    border.color: "#e0e0e0"
+
+                    Column {
+                        anchors.fill: parent
+                        anchors.margins: 8
+                        spacing: 2
+
+                        Label {
+                            width: parent.width
+                            text: model.title
+                            font.pixelSize: 14
+                            font.bold: true
+                            color: "#2c3e50"
+                            elide: Text.ElideRight
+                            font.family: fredoka.name
+                        }
+
+                        Label {
+                            text: "Consistency (30d): " + Math.round(model.consistency * 100) + "%"
+                            font.pixelSize: 12
+                            color: "#27ae60"
+                            font.family: fredoka.name
+                        }
+
+                        Label {
+                            text: "Avg run: " + model.meanRun.toFixed(1) + " · Median: " + model.medianRun.toFixed(1)
+                            font.pixelSize: 12
+                            color: "#7f8c8d"
+                            font.family: fredoka.name
+                        }
+
+                        Label {
+                            text: "Runs: " + model.runCount + " · Longest gap: " + model.longestGap + " days"
+                            font.pixelSize: 12
+                            color: "#7f8c8d"
+                            font.family: fredoka.name
+                        }
+
+                        // Last half-year of check-ins, one cell per day
+                        HeatmapCalendar {
+                            id: heatmap
+                            width: parent.width
+                            height: 60
+                            weeks: 26
+                            cellSpacing: 1.5
+
+                            Component.onCompleted: {
+                                values = streakAnalyticsInstance.dayValues(index, startDate, cellCount)
+                            }
+                        }
+                    }
+
+                    Connections {
+                        target: streakAnalyticsInstance
+                        function onCheckInAdded(row, day) {
+                            if (row === index) {
+                                heatmap.setDayValue(day, 1)
+                            }
+                        }
+                        function onHistoryReset(row) {
+                            if (row === index) {
+                                heatmap.values = streakAnalyticsInstance.dayValues(index, heatmap.startDate, heatmap.cellCount)
+                            }
+                        }
+                    }
+                }
             }
         }
 
@@ -199,12 +312,22 @@ Page {
 
             ListView {
                 id: streaksList
+
+                // Row to scroll to and select when opened from the quick switcher
+                Component.onCompleted: {
+                    if (streaksPage.focusRow >= 0) {
+                        currentIndex = streaksPage.focusRow
+                        positionViewAtIndex(streaksPage.focusRow, ListView.Center)
+                    }
+                }
                 model: streaksModelInstance
                 spacing: 10
 
                 delegate: Rectangle {
                     width: streaksList.width
-                    height: 100
+                    // Hidden by the tag filter
+                    visible: tagManager.streakQuery, tagManager.streakVisible(model.streakId)
+                    height: visible ? 100 : 0
                     radius: 15
                     color: "white"
 
@@ -304,6 +427,17 @@ Page {
                                     font.family: fredoka.name
 
                                 }
+
+                                Repeater {
+                                    model: tagManager.revision, tagManager.streakTags(model.streakId)
+
+                                    Label {
+                                        text: "#" + modelData
+                                        font.pixelSize: 12
+                                        color: "#2980b9"
+                                        font.family: fredoka.name
+                                    }
+                                }
                             }
 
                             Label {
@@ -364,6 +498,25 @@ Page {
 
                             }
 
+                            Button {
+                                text: "#"
+                                Material.background: Material.Indigo
+                                Material.foreground: "white"
+                                Layout.preferredWidth: 50
+
+                                ToolTip.visible: hovered
+                                ToolTip.text: "Tags"
+
+                                onClicked: {
+                                    streakTagDialog.streakId = model.streakId
+                                    streakTagDialog.streakTitle = model.title
+                                    streakTagField.text = ""
+                                    streakTagDialog.open()
+                                }
+                                font.family: fredoka.name
+
+                            }
+
                             Button {
                                 text: "X"
                                 Material.background: Material.Red
@@ -388,6 +541,51 @@ Page {
         }
     }
 
+    // Tags on one habit: add by name, click a tag to remove it
+    Dialog {
+        id: streakTagDialog
+        property int streakId: -1
+        property string streakTitle: ""
+
+        title: "Tags for '" + streakTitle + "'"
+        standardButtons: Dialog.Close
+        width: Math.min(streaksPage.width * 0.7, 450)
+        anchors.centerIn: parent
+        modal: true
+        font.family: fredoka.name
+        Material.accent: "#333333"
+
+        contentItem: ColumnLayout {
+            spacing: 10
+
+            Flow {
+                Layout.fillWidth: true
+                spacing: 6
+
+                Repeater {
+                    model: tagManager.revision, tagManager.streakTags(streakTagDialog.streakId)
+
+                    Button {
+                        text: "#" + modelData + "  ✕"
+                        flat: true
+                        onClicked: tagManager.untagStreak(streakTagDialog.streakId, modelData)
+                    }
+                }
+            }
+
+            TextField {
+                id: streakTagField
+                Layout.fillWidth: true
+                placeholderText: "Add a tag and press Enter"
+                onAccepted: {
+                    if (tagManager.tagStreak(streakTagDialog.streakId, text)) {
+                        text = ""
+                    }
+                }
+            }
+        }
+    }
+
     // Reset Confirmation Dialog
     Dialog {
         id: resetDialog
@@ -0,0 +1,264 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtQuick.Controls.Material
+import QtQuick.Effects
+import com.lemonStudys 1.0
+
+Page {
+    id: timersPage
+    title: "Timers"
+
+    function formatSeconds(total) {
+        const hours = Math.floor(total / 3600)
+        const minutes = Math.floor(total % 3600 / 60)
+        const seconds = total % 60
+        const mmss = String(minutes).padStart(2, "0") + ":" + String(seconds).padStart(2, "0")
+        return hours > 0 ? hours + ":" + mmss : mmss
+    }
+
+    FontLoader {
+        id: fredoka
+        source: "../assets/fonts/Fredoka.ttf"
+    }
+
+    // Background
+    Rectangle {
+        anchors.fill: parent
+        gradient: Gradient {
+            GradientStop { position: 0.0; color: "#FFDE59" }
+            GradientStop { position: 1.0; color: "#FFF8DC" }
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 20
+        spacing: 15
+
+        // Header Stats Card
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 20
+
+                Column {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Timers"
+                        font.pixelSize: 14
+                        color: "#666"
+                        font.family: fredoka.name
+                    }
+                    Label {
+                        text: timersList.count
+                        font.pixelSize: 28
+                        font.bold: true
+                        color: "#2c3e50"
+                        font.family: fredoka.name
+                    }
+                }
+
+                Rectangle {
+                    width: 1
+                    Layout.fillHeight: true
+                    color: "#e0e0e0"
+                }
+
+                Column {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Running"
+                        font.pixelSize: 14
+                        color: "#666"
+                        font.family: fredoka.name
+                    }
+                    Label {
+                        text: timersModel.runningCount
+                        font.pixelSize: 28
+                        font.bold: true
+                        color: "#27ae60"
+                        font.family: fredoka.name
+                    }
+                }
+
+                Rectangle {
+                    width: 1
+                    Layout.fillHeight: true
+                    color: "#e0e0e0"
+                }
+
+                Button {
+                    text: "←"
+                    flat: true
+                    Material.foreground: "grey"
+                    Layout.preferredWidth: 80
+
+                    onClicked: {
+                        if (timersPage.StackView.view) {
+                            timersPage.StackView.view.pop()
+                        }
+                    }
+                }
+            }
+        }
+
+        // Add New Timer Section
+        Rectangle {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 80
+            radius: 15
+            color: "white"
+
+            layer.enabled: true
+            layer.effect: MultiEffect {
+                shadowEnabled: true
+                shadowColor: "#50000000"
+                shadowBlur: 1.5
+                shadowHorizontalOffset: 0
+                shadowVerticalOffset: 6
+            }
+
+            RowLayout {
+                anchors.fill: parent
+                anchors.margins: 10
+                spacing: 10
+
+                TextField {
+                    id: newTimerName
+                    Layout.fillWidth: true
+                    placeholderText: "Timer name, e.g. Chemistry lab"
+                    font.family: fredoka.name
+                    font.pixelSize: 14
+                    Material.accent: "#333333"
+                }
+
+                SpinBox {
+                    id: newTimerMinutes
+                    from: 1
+                    to: 600
+                    value: 25
+                    editable: true
+                    font.family: fredoka.name
+                }
+
+                Button {
+                    text: "Add Countdown"
+                    enabled: newTimerName.text.length > 0
+                    Material.background: "#FFDE59"
+                    Material.foreground: "#333333"
+                    font.family: fredoka.name
+
+                    onClicked: {
+                        timersModel.addCountdown(newTimerName.text, newTimerMinutes.value * 60)
+                        newTimerName.text = ""
+                    }
+                }
+
+                Button {
+                    text: "Add Stopwatch"
+                    enabled: newTimerName.text.length > 0
+                    Material.background: "#FFF9F1"
+                    Material.foreground: "#333333"
+                    font.family: fredoka.name
+
+                    onClicked: {
+                        timersModel.addStopwatch(newTimerName.text)
+                        newTimerName.text = ""
+                    }
+                }
+            }
+        }
+
+        // Timers List
+        ListView {
+            id: timersList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            spacing: 10
+            model: timersModel
+
+            delegate: Rectangle {
+                width: timersList.width
+                height: 80
+                radius: 15
+                color: "white"
+                border.color: model.timerState === NamedTimer.Finished ? "#27ae60" : "transparent"
+                border.width: 2
+
+                RowLayout {
+                    anchors.fill: parent
+                    anchors.margins: 15
+                    spacing: 10
+
+                    Column {
+                        Layout.fillWidth: true
+
+                        Label {
+                            text: model.name
+                            font.pixelSize: 18
+                            color: "#2c3e50"
+                            font.family: fredoka.name
+                        }
+                        Label {
+                            text: model.mode === NamedTimer.Countdown
+                                  ? "Countdown · " + Math.round(model.durationSeconds / 60) + " min"
+                                  : "Stopwatch"
+                            font.pixelSize: 12
+                            color: "#7f8c8d"
+                            font.family: fredoka.name
+                        }
+                    }
+
+                    Label {
+                        text: timersPage.formatSeconds(model.seconds)
+                        font.pixelSize: 32
+                        color: "#333333"
+                        font.family: fredoka.name
+                    }
+
+                    Button {
+                        text: model.timerState === NamedTimer.Running ? "Pause" : "Start"
+                        enabled: model.timerState !== NamedTimer.Finished
+                        Material.background: "#FFDE59"
+                        Material.foreground: "#333333"
+                        font.family: fredoka.name
+                        onClicked: model.timerState === NamedTimer.Running ? timersModel.pause(index)
+                                                                          : timersModel.start(index)
+                    }
+
+                    Button {
+                        text: "Reset"
+                        flat: true
+                        font.family: fredoka.name
+                        onClicked: timersModel.reset(index)
+                    }
+
+                    Button {
+                        text: "✕"
+                        flat: true
+                        Material.foreground: "grey"
+                        onClicked: timersModel.removeTimer(index)
+                    }
+                }
+            }
+        }
+    }
+}
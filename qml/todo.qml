@@ -4,6 +4,7 @@ import QtQuick.Layouts
 import QtQuick.Controls.Material
 import QtQuick.Effects
 import MyPomodoro 1.0
+import MyTodo 1.0
 
 
 Page {
@@ -15,8 +16,44 @@ Page {
         source: "../assets/fonts/Fredoka.ttf"
     }
 
-    // Define the property and immediately access the context property
-    property var todoModel: todoModelInstance
+    // Todos of the list picked in the list selector
+    property var todoModel: todoLists.currentModel
+    // Set by the quick switcher and the Next up card to jump to one todo
+    property int focusTodoId: -1
+    // Tab to open on: 0 all tasks, then the smart views in tab order
+    property int initialView: 0
+    // The list behind the selected tab
+    property var listModel: [todoProxy, smartViews.overdue, smartViews.dueToday,
+                             smartViews.thisWeek, smartViews.highPriority][viewTabs.currentIndex]
+    // Model the list's rows map to: the open list, or every list for the smart views
+    property var rowModel: listModel.sourceModel
+    // Bumped on every todo change so window-based bindings re-evaluate
+    property int todoRevision: 0
+
+    Connections {
+        target: todoModelInstance
+        function onTodoAdded() { todoView.todoRevision++ }
+        function onTodoRemoved() { todoView.todoRevision++ }
+        function onTodoUpdated() { todoView.todoRevision++ }
+    }
+
+    // "2w" -> "every 2 weeks"
+    function repeatText(rule) {
+        if (!rule) return ""
+        const every = parseInt(rule)
+        const unit = {"d": "day", "w": "week", "m": "month"}[rule.slice(-1)]
+        return every === 1 ? "every " + unit : "every " + every + " " + unit + "s"
+    }
+
+    // What the list shows: sorted and filtered by the controls below
+    TodoSortFilterModel {
+        id: todoProxy
+        sourceModel: todoModel
+        sortMode: sortSelector.currentIndex
+        hideCompleted: hideCompletedCheck.checked
+        // Combo order is High, Medium, Low; TodoItem priorities are 2, 1, 0
+        priorityFilter: priorityCombo.currentIndex > 0 ? 3 - priorityCombo.currentIndex : -1
+    }
 
     // Connection to handle the close signal
     Connections {
@@ -181,6 +218,53 @@ Page {
                 anchors.margins: 10
                 spacing: 10
 
+                // Lists with their open counts; only the picked one is loaded
+                ComboBox {
+                    id: listSelector
+                    model: todoLists
+                    textRole: "name"
+                    valueRole: "listId"
+                    Layout.preferredWidth: 170
+                    font.family: fredoka.name
+                    Material.accent: "#333333"
+                    Component.onCompleted: currentIndex = todoLists.rowForList(todoLists.currentListId)
+                    onActivated: todoLists.currentListId = currentValue
+
+                    Connections {
+                        target: todoLists
+                        function onCurrentListChanged() {
+                            listSelector.currentIndex = todoLists.rowForList(todoLists.currentListId)
+                        }
+                    }
+
+                    delegate: ItemDelegate {
+                        width: listSelector.width
+                        text: model.name + " (" + model.openCount + ")"
+                        font.family: fredoka.name
+                        highlighted: listSelector.highlightedIndex === index
+                    }
+                }
+
+                Button {
+                    text: "+"
+                    flat: true
+                    Layout.preferredWidth: 40
+                    font.family: fredoka.name
+                    ToolTip.visible: hovered
+                    ToolTip.text: "New list"
+                    onClicked: newListDialog.open()
+                }
+
+                Button {
+                    text: "🗑"
+                    flat: true
+                    Layout.preferredWidth: 40
+                    enabled: listSelector.count > 1
+                    ToolTip.visible: hovered
+                    ToolTip.text: "Delete this list"
+                    onClicked: deleteListDialog.open()
+                }
+
                 TextField {
                     id: newTaskInput
                     Layout.fillWidth: true
@@ -215,6 +299,44 @@ Page {
             }
         }
 
+        // All tasks or one of the smart views
+        TabBar {
+            id: viewTabs
+            Layout.fillWidth: true
+            currentIndex: todoView.initialView
+            font.family: fredoka.name
+            Material.accent: "#333333"
+
+            TabButton { text: "All Tasks" }
+            TabButton { text: "Overdue (" + smartViews.overdue.count + ")" }
+            TabButton { text: "Due Today (" + smartViews.dueToday.count + ")" }
+            TabButton { text: "This Week (" + smartViews.thisWeek.count + ")" }
+            TabButton { text: "High Priority (" + smartViews.highPriority.count + ")" }
+        }
+
+        // Repeating todos over the next 7 days, worked out for this window only
+        Flow {
+            Layout.fillWidth: true
+            spacing: 8
+            visible: viewTabs.currentIndex === 3 && upcomingRepeats.count > 0
+
+            Repeater {
+                id: upcomingRepeats
+                model: {
+                    todoView.todoRevision
+                    const now = new Date()
+                    return todoModelInstance.occurrences(now, new Date(now.getTime() + 7 * 24 * 3600 * 1000))
+                }
+
+                Label {
+                    text: "↻ " + modelData.title + " · " + new Date(modelData.dueDate).toLocaleDateString(Qt.locale(), "ddd d MMM")
+                    font.pixelSize: 12
+                    color: "#8e44ad"
+                    font.family: fredoka.name
+                }
+            }
+        }
+
         // Filter controls
         Rectangle {
             Layout.fillWidth: true
@@ -237,7 +359,7 @@ Page {
                 spacing: 10
 
                 ComboBox {
-                    id: priorityFilter
+                    id: priorityCombo
                     model: ["All Priorities", "High", "Medium", "Low"]
                     Layout.preferredWidth: 150
                     font.family: fredoka.name
@@ -245,15 +367,41 @@ Page {
 
                 }
 
+                ComboBox {
+                    id: sortSelector
+                    // Same order as TodoSortFilterModel.SortMode
+                    model: ["Newest", "Priority", "Due Date", "Title", "My Order"]
+                    currentIndex: TodoSortFilterModel.Manual
+                    Layout.preferredWidth: 130
+                    font.family: fredoka.name
+                    Material.accent: "#333333"
+                }
+
                 CheckBox {
-                    id: hideCompleted
+                    id: hideCompletedCheck
                     text: "Hide Completed"
                     font.family: fredoka.name
                     Material.accent: "#FFDE59"
 
                 }
 
-                Item { Layout.fillWidth: true }
+                TextField {
+                    id: searchField
+                    Layout.fillWidth: true
+                    placeholderText: "Search tasks..."
+                    font.family: fredoka.name
+                    Material.accent: "#333333"
+                    onTextChanged: todoModel.search(text)
+                }
+
+                TextField {
+                    id: tagFilterField
+                    Layout.preferredWidth: 200
+                    placeholderText: "Tags: math AND NOT done"
+                    font.family: fredoka.name
+                    Material.accent: "#333333"
+                    onTextChanged: tagManager.filterTodos(todoProxy, text)
+                }
 
                 Button {
                     text: "Clear Completed"
@@ -268,10 +416,65 @@ Page {
             }
         }
 
+        // Search results
+        ListView {
+            id: searchList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            visible: searchField.text.trim().length > 0
+            clip: true
+            spacing: 10
+            model: todoModel.searchResults
+
+            delegate: Rectangle {
+                width: searchList.width
+                height: 70
+                color: "white"
+                radius: 15
+                border.color: model.completed ? "#27ae60" : "transparent"
+                border.width: 2
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: 12
+                    spacing: 4
+
+                    Text {
+                        Layout.fillWidth: true
+                        text: model.highlightedTitle
+                        textFormat: Text.StyledText
+                        font.family: fredoka.name
+                        font.pixelSize: 18
+                        color: "#333333"
+                        elide: Text.ElideRight
+                    }
+
+                    Text {
+                        Layout.fillWidth: true
+                        text: model.snippet
+                        textFormat: Text.StyledText
+                        font.family: fredoka.name
+                        font.pixelSize: 13
+                        color: "#777777"
+                        elide: Text.ElideRight
+                    }
+                }
+            }
+
+            Text {
+                anchors.centerIn: parent
+                visible: searchList.count === 0
+                text: "No matching tasks"
+                font.family: fredoka.name
+                color: "#777777"
+            }
+        }
+
         // Todo list
         ScrollView {
             Layout.fillWidth: true
             Layout.fillHeight: true
+            visible: !searchList.visible
             clip: true
 
             layer.enabled: true
@@ -285,7 +488,21 @@ Page {
 
             ListView {
                 id: todoList
-                model: todoModel
+
+                // Todo to scroll to and select when opened from the quick switcher
+                Component.onCompleted: {
+                    if (todoView.focusTodoId < 0) {
+                        return
+                    }
+                    // Open the todo's list, then find its row there
+                    todoLists.currentListId = todoLists.listOf(todoView.focusTodoId)
+                    const row = todoProxy.mapFromSource(todoModel.rowForId(todoView.focusTodoId))
+                    if (row >= 0) {
+                        currentIndex = row
+                        positionViewAtIndex(row, ListView.Center)
+                    }
+                }
+                model: todoView.listModel
                 spacing: 10
 
                 delegate: Rectangle {
@@ -298,23 +515,6 @@ Page {
                     border.color: model.completed ? "#27ae60" : "transparent"
                     border.width: 2
 
-                    // Filter logic
-                    visible: {
-                        if (hideCompleted.checked && model.completed) return false;
-
-                        if (priorityFilter.currentIndex > 0) {
-                            let filterPriority;
-                            switch (priorityFilter.currentIndex) {
-                                case 1: filterPriority = 2; break; // High
-                                case 2: filterPriority = 1; break; // Medium
-                                case 3: filterPriority = 0; break; // Low
-                            }
-                            if (model.priority !== filterPriority) return false;
-                        }
-
-                        return true;
-                    }
-
                     // Shadow effect
                     MultiEffect {
                         anchors.fill: parent
@@ -339,6 +539,32 @@ Page {
                         anchors.margins: 15
                         spacing: 15
 
+                        // Drag handle; drop on another task to take its place
+                        Label {
+                            id: dragHandle
+                            text: "⠿"
+                            visible: todoView.listModel === todoProxy
+                                     && todoProxy.sortMode === TodoSortFilterModel.Manual
+                            font.pixelSize: 24
+                            color: handleArea.pressed ? "#333333" : "#95a5a6"
+
+                            MouseArea {
+                                id: handleArea
+                                anchors.fill: parent
+                                anchors.margins: -8
+                                cursorShape: pressed ? Qt.ClosedHandCursor : Qt.OpenHandCursor
+                                preventStealing: true
+                                onReleased: (mouse) => {
+                                    const point = mapToItem(todoList.contentItem, mouse.x, mouse.y)
+                                    const target = todoList.indexAt(point.x, point.y)
+                                    if (target >= 0 && target !== index) {
+                                        todoModel.moveTodo(todoProxy.mapToSource(index),
+                                                           todoProxy.mapToSource(target))
+                                    }
+                                }
+                            }
+                        }
+
                         // Priority indicator circle
                         Rectangle {
                             width: 50
@@ -441,6 +667,25 @@ Page {
                                     font.family: fredoka.name
 
                                 }
+
+                                Label {
+                                    text: "↻ " + todoView.repeatText(model.recurrence)
+                                    visible: !!model.recurrence
+                                    font.pixelSize: 12
+                                    color: "#8e44ad"
+                                    font.family: fredoka.name
+                                }
+
+                                Repeater {
+                                    model: tagManager.revision, tagManager.todoTags(model.todoId)
+
+                                    Label {
+                                        text: "#" + modelData
+                                        font.pixelSize: 12
+                                        color: "#2980b9"
+                                        font.family: fredoka.name
+                                    }
+                                }
                             }
                         }
 
@@ -456,10 +701,12 @@ Page {
                                 Layout.preferredWidth: 50
 
                                 ToolTip.visible: hovered
-                                ToolTip.text: model.completed ? "Mark as incomplete" : "Mark as complete"
+                                ToolTip.text: model.completed ? "Mark as incomplete"
+                                                              : model.recurrence ? "Done for now; moves to the next date"
+                                                                                 : "Mark as complete"
 
                                 onClicked: {
-                                    todoModel.markAsCompleted(index, !model.completed)
+                                    todoView.rowModel.markAsCompleted(todoView.listModel.mapToSource(index), !model.completed)
                                 }
                                 font.family: fredoka.name
 
@@ -474,7 +721,35 @@ Page {
                                 ToolTip.visible: hovered
                                 ToolTip.text: "Edit task"
 
-                                onClicked: editDialog.open(index, model.title, model.description, model.dueDate, model.priority)
+                                onClicked: editDialog.open(todoView.listModel.mapToSource(index), model.todoId, model.title, model.description, model.dueDate, model.priority, model.recurrence)
+                                font.family: fredoka.name
+
+                            }
+
+                            Button {
+                                text: "#"
+                                Material.background: Material.Indigo
+                                Material.foreground: "white"
+                                Layout.preferredWidth: 50
+
+                                ToolTip.visible: hovered
+                                ToolTip.text: "Tags"
+
+                                onClicked: tagDialog.open(model.todoId, model.title)
+                                font.family: fredoka.name
+
+                            }
+
+                            Button {
+                                text: "☰"
+                                Material.background: Material.Teal
+                                Material.foreground: "white"
+                                Layout.preferredWidth: 50
+
+                                ToolTip.visible: hovered
+                                ToolTip.text: "Subtasks"
+
+                                onClicked: subtasksDialog.open(model.todoId, model.title)
                                 font.family: fredoka.name
 
                             }
@@ -489,7 +764,7 @@ Page {
                                 ToolTip.text: "Delete task"
 
                                 onClicked: {
-                                    deleteDialog.taskIndex = index
+                                    deleteDialog.taskIndex = todoView.listModel.mapToSource(index)
                                     deleteDialog.taskTitle = model.title
                                     deleteDialog.open()
                                 }
@@ -503,6 +778,206 @@ Page {
         }
     }
 
+    // Tags on one todo: add by name (new names create the tag), click to remove
+    Dialog {
+        id: tagDialog
+        title: "Tags for '" + todoTitle + "'"
+        standardButtons: Dialog.Close
+        width: Math.min(todoView.width * 0.7, 450)
+        anchors.centerIn: Overlay.overlay
+        modal: true
+        font.family: fredoka.name
+        Material.accent: "#333333"
+
+        property int todoId: -1
+        property string todoTitle: ""
+
+        function open(id, title) {
+            todoId = id
+            todoTitle = title
+            tagField.text = ""
+            visible = true
+        }
+
+        contentItem: ColumnLayout {
+            spacing: 10
+
+            Flow {
+                Layout.fillWidth: true
+                spacing: 6
+
+                Repeater {
+                    model: tagManager.revision, tagManager.todoTags(tagDialog.todoId)
+
+                    Button {
+                        text: "#" + modelData + "  ✕"
+                        flat: true
+                        ToolTip.visible: hovered
+                        ToolTip.text: "Remove tag"
+                        onClicked: tagManager.untagTodo(tagDialog.todoId, modelData)
+                    }
+                }
+            }
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: 10
+
+                TextField {
+                    id: tagField
+                    Layout.fillWidth: true
+                    placeholderText: "Add a tag, e.g. math"
+                    onAccepted: addTagButton.clicked()
+                }
+
+                Button {
+                    id: addTagButton
+                    text: "Add"
+                    enabled: tagField.text.trim().length > 0
+                    onClicked: {
+                        if (tagManager.tagTodo(tagDialog.todoId, tagField.text)) {
+                            tagField.text = ""
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Subtasks: the todo tree, opened on one todo. Nodes load their
+    // children from the database as they are expanded.
+    Dialog {
+        id: subtasksDialog
+        title: "Subtasks of '" + rootTitle + "'"
+        standardButtons: Dialog.Close
+        width: Math.min(todoView.width * 0.8, 600)
+        height: Math.min(todoView.height * 0.9, 600)
+        anchors.centerIn: Overlay.overlay
+        modal: true
+        font.family: fredoka.name
+        Material.accent: "#333333"
+
+        property int rootId: -1
+        property string rootTitle: ""
+        // New subtasks go under this todo; picked by clicking a row
+        property int targetId: -1
+        property string targetTitle: ""
+
+        function open(todoId, title) {
+            rootId = todoId
+            rootTitle = title
+            targetId = todoId
+            targetTitle = title
+            subtaskField.text = ""
+            visible = true
+
+            const index = todoTree.indexForId(todoId)
+            subtaskTree.expandToIndex(index)
+            const row = subtaskTree.rowAtIndex(index)
+            subtaskTree.expand(row)
+            subtaskTree.positionViewAtRow(row, TableView.AlignTop)
+        }
+
+        contentItem: ColumnLayout {
+            spacing: 10
+
+            TreeView {
+                id: subtaskTree
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                clip: true
+                model: todoTree
+
+                delegate: TreeViewDelegate {
+                    id: treeDelegate
+                    implicitWidth: subtaskTree.width
+                    highlighted: model.todoId === subtasksDialog.targetId
+
+                    onClicked: {
+                        subtasksDialog.targetId = model.todoId
+                        subtasksDialog.targetTitle = model.title
+                    }
+
+                    contentItem: RowLayout {
+                        spacing: 8
+
+                        CheckBox {
+                            checked: model.completed
+                            onToggled: todoTree.setCompleted(model.todoId, checked)
+                        }
+
+                        Label {
+                            Layout.fillWidth: true
+                            text: model.title
+                            elide: Text.ElideRight
+                            font.strikeout: model.completed
+                            color: model.completed ? "#7f8c8d" : "#2c3e50"
+                        }
+
+                        Label {
+                            text: model.completedSubtaskCount + "/" + model.subtaskCount
+                                  + " (" + Math.round(model.progress * 100) + "%)"
+                            visible: model.subtaskCount > 0
+                            font.pixelSize: 12
+                            color: model.progress === 1 ? "#27ae60" : "#7f8c8d"
+                        }
+
+                        // Up a level: under its parent's parent
+                        ToolButton {
+                            text: "⇤"
+                            visible: model.parentId > 0
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Move up a level"
+                            onClicked: todoTree.moveSubtree(model.todoId, todoTree.parentIdOf(model.parentId))
+                        }
+
+                        // Down a level: under the subtask chosen for new items
+                        ToolButton {
+                            text: "⇥"
+                            visible: model.parentId > 0 && subtasksDialog.targetId !== model.todoId
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Move under '" + subtasksDialog.targetTitle + "'"
+                            onClicked: todoTree.moveSubtree(model.todoId, subtasksDialog.targetId)
+                        }
+
+                        ToolButton {
+                            text: "✕"
+                            visible: model.parentId > 0
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Delete subtask"
+                            onClicked: todoTree.removeTodo(model.todoId)
+                        }
+                    }
+                }
+            }
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: 10
+
+                TextField {
+                    id: subtaskField
+                    Layout.fillWidth: true
+                    placeholderText: "Add a subtask to '" + subtasksDialog.targetTitle + "'"
+                    onAccepted: addSubtaskButton.clicked()
+                }
+
+                Button {
+                    id: addSubtaskButton
+                    text: "Add"
+                    enabled: subtaskField.text.trim().length > 0
+                    onClicked: {
+                        if (todoTree.addSubtask(subtasksDialog.targetId, subtaskField.text.trim()) >= 0) {
+                            const index = todoTree.indexForId(subtasksDialog.targetId)
+                            subtaskTree.expand(subtaskTree.rowAtIndex(index))
+                            subtaskField.text = ""
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     // Delete Confirmation Dialog
     Dialog {
         id: deleteDialog
@@ -520,11 +995,58 @@ Page {
 
         onAccepted: {
             if (taskIndex >= 0) {
-                todoModel.removeTodo(taskIndex)
+                todoView.rowModel.removeTodo(taskIndex)
+            }
+        }
+        font.family: fredoka.name
+
+    }
+
+    Dialog {
+        id: newListDialog
+        title: "New List"
+        standardButtons: Dialog.Ok | Dialog.Cancel
+        anchors.centerIn: parent
+        modal: true
+        font.family: fredoka.name
+        Material.accent: "#333333"
+
+        onOpened: {
+            newListName.text = ""
+            newListName.forceActiveFocus()
+        }
+
+        TextField {
+            id: newListName
+            width: 250
+            placeholderText: "e.g. Calculus"
+            font.family: fredoka.name
+            onAccepted: newListDialog.accept()
+        }
+
+        onAccepted: {
+            const listId = todoLists.createList(newListName.text)
+            if (listId >= 0) {
+                todoLists.currentListId = listId
             }
         }
+    }
+
+    Dialog {
+        id: deleteListDialog
+        title: "Delete List?"
+        standardButtons: Dialog.Yes | Dialog.No
+        anchors.centerIn: parent
+        modal: true
         font.family: fredoka.name
+        Material.accent: "#333333"
+
+        Label {
+            text: "Delete '" + listSelector.currentText + "' and all of its tasks?\nThis action cannot be undone."
+            font.family: fredoka.name
+        }
 
+        onAccepted: todoLists.deleteList(todoLists.currentListId)
     }
 
     // Dialog for editing tasks
@@ -540,10 +1062,18 @@ Page {
         Material.accent: "#333333"
 
         property int currentIndex: -1
+        property int todoId: -1
         property date selectedDate: new Date()
 
-        function open(index, title, description, dueDate, priority) {
+        property string recurrence: ""
+
+        function open(index, id, title, description, dueDate, priority, rule) {
             currentIndex = index;
+            todoId = id;
+            recurrence = rule || "";
+            editRepeat.currentIndex = recurrence ? "dwm".indexOf(recurrence.slice(-1)) + 1 : 0;
+            editRepeatEvery.value = recurrence ? parseInt(recurrence) : 1;
+            editList.currentIndex = todoLists.rowForList(todoLists.listOf(id));
             editTitle.text = title;
             editDescription.text = description || "";
             editPriority.currentIndex = priority;
@@ -701,6 +1231,53 @@ Page {
                     Layout.fillWidth: true
                     model: ["Low", "Medium", "High"]
                 }
+
+                Label {
+                    text: "Repeat:"
+                    font.bold: true
+                    font.family: fredoka.name
+                }
+
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 10
+
+                    ComboBox {
+                        id: editRepeat
+                        Layout.fillWidth: true
+                        model: ["Never", "Daily", "Weekly", "Monthly"]
+                        font.family: fredoka.name
+                    }
+
+                    Label {
+                        text: "every"
+                        visible: editRepeat.currentIndex > 0
+                        font.family: fredoka.name
+                    }
+
+                    SpinBox {
+                        id: editRepeatEvery
+                        from: 1
+                        to: 999
+                        visible: editRepeat.currentIndex > 0
+                        font.family: fredoka.name
+                    }
+                }
+
+                Label {
+                    text: "List:"
+                    font.bold: true
+                    font.family: fredoka.name
+                }
+
+                ComboBox {
+                    id: editList
+                    Layout.fillWidth: true
+                    model: todoLists
+                    textRole: "name"
+                    valueRole: "listId"
+                    font.family: fredoka.name
+                }
             }
         }
 
@@ -719,13 +1296,23 @@ Page {
             if (editTitle.text.trim() === "") return;
             updateSelectedDate();
 
-            todoModel.updateTodo(
+            todoView.rowModel.updateTodo(
                 currentIndex,
                 editTitle.text,
                 editDescription.text,
                 selectedDate,
                 editPriority.currentIndex
             );
+
+            const rule = editRepeat.currentIndex > 0
+                    ? editRepeatEvery.value + "dwm".charAt(editRepeat.currentIndex - 1) : "";
+            if (rule !== recurrence) {
+                todoView.rowModel.setRecurrence(currentIndex, rule)
+            }
+
+            if (editList.currentIndex >= 0 && editList.currentValue !== todoLists.listOf(todoId)) {
+                todoLists.moveTodoToList(todoId, editList.currentValue)
+            }
         }
     }
 
@@ -0,0 +1,517 @@
+#include "historyarchive.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QtConcurrent/QtConcurrent>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const char kFileMagic[8] = {'L', 'S', 'H', 'I', 'S', 'T', '0', '1'};
+const qint64 kFileHeaderBytes = 16;
+const quint32 kSegmentMagic = 0x4753534C;   // "LSSG"
+const quint32 kTrailerMagic = 0x4553534C;   // "LSSE"
+const qint64 kSegmentHeaderBytes = 32;
+const qint64 kTrailerBytes = 8;
+
+// Rows per unit of parallel work; smaller archives are scanned inline.
+const qint64 kChunkRows = 1 << 16;
+
+qint64 padded(qint64 bytes)
+{
+    return (bytes + 7) & ~qint64(7);
+}
+
+struct RangePartial {
+    qint64 minutes = 0;
+    qint64 count = 0;
+};
+
+} // namespace
+
+void ArchiveBatch::append(const QDate &day, qint32 minutes, const QString &category)
+{
+    days.append(qint32(day.toJulianDay()));
+    this->minutes.append(minutes);
+    categories.append(category);
+}
+
+HistoryArchive::HistoryArchive(QObject *parent)
+    : QObject(parent),
+    m_map(nullptr),
+    m_rowCount(0),
+    m_lastSessionId(0),
+    m_lastCheckinId(0),
+    m_sealedBytes(0)
+{
+}
+
+HistoryArchive::~HistoryArchive()
+{
+    close();
+}
+
+bool HistoryArchive::open(const QString &path)
+{
+    close();
+    m_path = path;
+
+    if (!QFile::exists(path)) {
+        // An empty archive is just the header.
+        QStringList dictionary;
+        if (!appendSegment(path, ArchiveBatch(), dictionary)) {
+            return false;
+        }
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Error opening history archive:" << m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < kFileHeaderBytes) {
+        qDebug() << "History archive is truncated:" << path;
+        m_file.close();
+        return false;
+    }
+
+    m_map = m_file.map(0, size);
+    if (!m_map || std::memcmp(m_map, kFileMagic, sizeof(kFileMagic)) != 0) {
+        qDebug() << "Not a history archive:" << path;
+        close();
+        return false;
+    }
+
+    return mapSegments(size);
+}
+
+void HistoryArchive::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_segments.clear();
+    m_dictionary.clear();
+    m_codes.clear();
+    m_rowCount = 0;
+    m_lastSessionId = 0;
+    m_lastCheckinId = 0;
+    m_sealedBytes = 0;
+}
+
+bool HistoryArchive::isOpen() const
+{
+    return m_map != nullptr;
+}
+
+qint64 HistoryArchive::rowCount() const
+{
+    return m_rowCount;
+}
+
+int HistoryArchive::segmentCount() const
+{
+    return m_segments.size();
+}
+
+QStringList HistoryArchive::categories() const
+{
+    return m_dictionary;
+}
+
+int HistoryArchive::categoryCode(const QString &category) const
+{
+    return m_codes.value(category, -1);
+}
+
+qint64 HistoryArchive::lastSessionId() const
+{
+    return m_lastSessionId;
+}
+
+qint64 HistoryArchive::lastCheckinId() const
+{
+    return m_lastCheckinId;
+}
+
+qint64 HistoryArchive::sealedBytes() const
+{
+    return m_sealedBytes;
+}
+
+qint64 HistoryArchive::totalMinutes(const QDate &from, const QDate &to, int categoryCode) const
+{
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+
+    auto kernel = [lo, hi, categoryCode](const Chunk &chunk) {
+        RangePartial partial;
+        // Branch-free so the compiler can vectorise the loop.
+        if (categoryCode < 0) {
+            for (qint64 i = 0; i < chunk.rows; i++) {
+                const qint64 in = (chunk.days[i] >= lo) & (chunk.days[i] <= hi);
+                partial.minutes += in * chunk.minutes[i];
+                partial.count += in;
+            }
+        } else {
+            const quint32 code = quint32(categoryCode);
+            for (qint64 i = 0; i < chunk.rows; i++) {
+                const qint64 in = (chunk.days[i] >= lo) & (chunk.days[i] <= hi) & (chunk.categories[i] == code);
+                partial.minutes += in * chunk.minutes[i];
+                partial.count += in;
+            }
+        }
+        return partial;
+    };
+    auto merge = [](RangePartial &total, const RangePartial &partial) {
+        total.minutes += partial.minutes;
+        total.count += partial.count;
+    };
+
+    const QVector<Chunk> work = chunks();
+    if (work.size() <= 1) {
+        return work.isEmpty() ? 0 : kernel(work.first()).minutes;
+    }
+    return QtConcurrent::blockingMappedReduced<RangePartial>(work, kernel, merge).minutes;
+}
+
+qint64 HistoryArchive::eventCount(const QDate &from, const QDate &to, int categoryCode) const
+{
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+    const quint32 code = quint32(categoryCode);
+    const bool anyCategory = categoryCode < 0;
+
+    auto kernel = [lo, hi, code, anyCategory](const Chunk &chunk) {
+        qint64 count = 0;
+        for (qint64 i = 0; i < chunk.rows; i++) {
+            count += (chunk.days[i] >= lo) & (chunk.days[i] <= hi) & (anyCategory | (chunk.categories[i] == code));
+        }
+        return count;
+    };
+    auto merge = [](qint64 &total, qint64 partial) { total += partial; };
+
+    const QVector<Chunk> work = chunks();
+    if (work.size() <= 1) {
+        return work.isEmpty() ? 0 : kernel(work.first());
+    }
+    return QtConcurrent::blockingMappedReduced<qint64>(work, kernel, merge);
+}
+
+QVector<qint64> HistoryArchive::minutesPerDay(const QDate &from, const QDate &to) const
+{
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+    const qint64 span = qMax<qint64>(0, qint64(hi) - lo + 1);
+    if (span == 0) {
+        return {};
+    }
+
+    auto kernel = [lo, span](const Chunk &chunk) {
+        QVector<qint64> histogram(span, 0);
+        for (qint64 i = 0; i < chunk.rows; i++) {
+            // Unsigned compare folds both range checks into one.
+            const quint64 offset = quint64(qint64(chunk.days[i]) - lo);
+            if (offset < quint64(span)) {
+                histogram[offset] += chunk.minutes[i];
+            }
+        }
+        return histogram;
+    };
+    auto merge = [span](QVector<qint64> &total, const QVector<qint64> &partial) {
+        if (total.isEmpty()) {
+            total = partial;
+            return;
+        }
+        for (qint64 i = 0; i < span; i++) {
+            total[i] += partial[i];
+        }
+    };
+
+    const QVector<Chunk> work = chunks();
+    QVector<qint64> result;
+    if (work.size() <= 1) {
+        result = work.isEmpty() ? QVector<qint64>() : kernel(work.first());
+    } else {
+        result = QtConcurrent::blockingMappedReduced<QVector<qint64>>(work, kernel, merge);
+    }
+    if (result.isEmpty()) {
+        result.fill(0, span);
+    }
+    return result;
+}
+
+QHash<QString, qint64> HistoryArchive::minutesByCategory(const QDate &from, const QDate &to) const
+{
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+    const qint64 codes = m_dictionary.size();
+
+    auto kernel = [lo, hi, codes](const Chunk &chunk) {
+        QVector<qint64> totals(codes, 0);
+        for (qint64 i = 0; i < chunk.rows; i++) {
+            const qint64 in = (chunk.days[i] >= lo) & (chunk.days[i] <= hi);
+            totals[chunk.categories[i]] += in * chunk.minutes[i];
+        }
+        return totals;
+    };
+    auto merge = [codes](QVector<qint64> &total, const QVector<qint64> &partial) {
+        if (total.isEmpty()) {
+            total = partial;
+            return;
+        }
+        for (qint64 i = 0; i < codes; i++) {
+            total[i] += partial[i];
+        }
+    };
+
+    const QVector<Chunk> work = chunks();
+    QVector<qint64> totals;
+    if (work.size() <= 1) {
+        totals = work.isEmpty() ? QVector<qint64>() : kernel(work.first());
+    } else {
+        totals = QtConcurrent::blockingMappedReduced<QVector<qint64>>(work, kernel, merge);
+    }
+
+    QHash<QString, qint64> byCategory;
+    for (int code = 0; code < totals.size(); code++) {
+        if (totals.at(code) != 0) {
+            byCategory.insert(m_dictionary.at(code), totals.at(code));
+        }
+    }
+    return byCategory;
+}
+
+QVariantList HistoryArchive::dailyMinutes(const QDate &from, const QDate &to) const
+{
+    QVariantList list;
+    const QVector<qint64> days = minutesPerDay(from, to);
+    list.reserve(days.size());
+    for (qint64 minutes : days) {
+        list.append(minutes);
+    }
+    return list;
+}
+
+QVariantMap HistoryArchive::categoryMinutes(const QDate &from, const QDate &to) const
+{
+    QVariantMap map;
+    const QHash<QString, qint64> totals = minutesByCategory(from, to);
+    for (auto it = totals.cbegin(); it != totals.cend(); ++it) {
+        map.insert(it.key(), it.value());
+    }
+    return map;
+}
+
+bool HistoryArchive::appendSegment(const QString &path, const ArchiveBatch &batch, QStringList &dictionary,
+                                   qint64 sealedBytes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Error opening history archive for append:" << file.errorString();
+        return false;
+    }
+
+    // Readers stop at the first torn segment, so anything written after
+    // one would never be seen.
+    if (sealedBytes >= 0 && file.size() > sealedBytes && !file.resize(sealedBytes)) {
+        qDebug() << "Error truncating torn history archive segment:" << file.errorString();
+        return false;
+    }
+    file.seek(file.size());
+
+    QByteArray out;
+    if (file.size() == 0) {
+        out.append(kFileMagic, sizeof(kFileMagic));
+        out.append(QByteArray(kFileHeaderBytes - sizeof(kFileMagic), '\0'));
+        qToLittleEndian<quint32>(1, out.data() + 8);   // format version
+    }
+
+    const qint64 rows = batch.size();
+    if (rows > 0) {
+        // Dictionary-encode categories; new strings travel with this segment.
+        QHash<QString, quint32> codes;
+        for (int i = 0; i < dictionary.size(); i++) {
+            codes.insert(dictionary.at(i), quint32(i));
+        }
+        const int knownCategories = dictionary.size();
+        QVector<quint32> categoryColumn(rows);
+        for (qint64 i = 0; i < rows; i++) {
+            auto it = codes.constFind(batch.categories.at(i));
+            if (it == codes.cend()) {
+                it = codes.insert(batch.categories.at(i), quint32(dictionary.size()));
+                dictionary.append(batch.categories.at(i));
+            }
+            categoryColumn[i] = *it;
+        }
+
+        QByteArray additions;
+        for (int i = knownCategories; i < dictionary.size(); i++) {
+            const QByteArray utf8 = dictionary.at(i).toUtf8();
+            char length[4];
+            qToLittleEndian<quint32>(quint32(utf8.size()), length);
+            additions.append(length, 4);
+            additions.append(utf8);
+        }
+        additions.append(QByteArray(padded(additions.size()) - additions.size(), '\0'));
+
+        const qint64 columnBytes = padded(rows * 4);
+        const qint64 segmentBytes = kSegmentHeaderBytes + 3 * columnBytes + additions.size() + kTrailerBytes;
+
+        QByteArray segment(segmentBytes, '\0');
+        char *p = segment.data();
+        qToLittleEndian<quint32>(kSegmentMagic, p);
+        qToLittleEndian<quint32>(quint32(rows), p + 4);
+        qToLittleEndian<quint32>(quint32(dictionary.size() - knownCategories), p + 8);
+        qToLittleEndian<quint32>(quint32(additions.size()), p + 12);
+        qToLittleEndian<qint64>(batch.lastSessionId, p + 16);
+        qToLittleEndian<qint64>(batch.lastCheckinId, p + 24);
+
+        char *column = p + kSegmentHeaderBytes;
+        for (qint64 i = 0; i < rows; i++) {
+            qToLittleEndian<qint32>(batch.days.at(i), column + i * 4);
+            qToLittleEndian<qint32>(batch.minutes.at(i), column + columnBytes + i * 4);
+            qToLittleEndian<quint32>(categoryColumn.at(i), column + 2 * columnBytes + i * 4);
+        }
+        std::memcpy(column + 3 * columnBytes, additions.constData(), additions.size());
+
+        // The trailer goes last: a segment without it was never sealed.
+        qToLittleEndian<quint32>(quint32(segmentBytes), p + segmentBytes - 8);
+        qToLittleEndian<quint32>(kTrailerMagic, p + segmentBytes - 4);
+        out.append(segment);
+    }
+
+    if (out.isEmpty()) {
+        return true;
+    }
+    if (file.write(out) != out.size() || !file.flush()) {
+        qDebug() << "Error writing history archive:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool HistoryArchive::refreshFromDatabase()
+{
+    if (m_path.isEmpty()) {
+        return false;
+    }
+
+    ArchiveBatch batch;
+    batch.lastSessionId = m_lastSessionId;
+    batch.lastCheckinId = m_lastCheckinId;
+
+    QSqlQuery query;
+    query.prepare("SELECT id, session_day, duration_ms FROM pomodoro_sessions "
+                  "WHERE id > :id AND kind = 'work' ORDER BY id");
+    query.bindValue(":id", m_lastSessionId);
+    if (!query.exec()) {
+        qDebug() << "Error reading sessions for archive:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        batch.append(QDate::fromString(query.value(1).toString(), Qt::ISODate),
+                     qint32((query.value(2).toLongLong() + 30000) / 60000),
+                     "focus");
+        batch.lastSessionId = query.value(0).toLongLong();
+    }
+
+    query.prepare("SELECT c.id, c.checkin_date, COALESCE(s.title, '') FROM streak_checkins c "
+                  "LEFT JOIN streaks s ON s.id = c.streak_id WHERE c.id > :id ORDER BY c.id");
+    query.bindValue(":id", m_lastCheckinId);
+    if (!query.exec()) {
+        qDebug() << "Error reading check-ins for archive:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        batch.append(QDate::fromString(query.value(1).toString(), Qt::ISODate), 0,
+                     "habit: " + query.value(2).toString());
+        batch.lastCheckinId = query.value(0).toLongLong();
+    }
+
+    if (batch.size() == 0) {
+        return true;
+    }
+
+    // Unmap before growing the file; some platforms refuse to extend a mapped file.
+    const QString path = m_path;
+    const qint64 sealed = m_sealedBytes;
+    QStringList dictionary = m_dictionary;
+    close();
+    const bool written = appendSegment(path, batch, dictionary, sealed);
+    const bool reopened = open(path);
+    if (written && reopened) {
+        emit archiveChanged();
+    }
+    return written && reopened;
+}
+
+bool HistoryArchive::mapSegments(qint64 size)
+{
+    qint64 position = kFileHeaderBytes;
+
+    while (position + kSegmentHeaderBytes + kTrailerBytes <= size) {
+        const uchar *segment = m_map + position;
+        if (qFromLittleEndian<quint32>(segment) != kSegmentMagic) {
+            break;
+        }
+
+        const qint64 rows = qFromLittleEndian<quint32>(segment + 4);
+        const int additions = int(qFromLittleEndian<quint32>(segment + 8));
+        const qint64 dictionaryBytes = qFromLittleEndian<quint32>(segment + 12);
+        const qint64 columnBytes = padded(rows * 4);
+        const qint64 segmentBytes = kSegmentHeaderBytes + 3 * columnBytes + dictionaryBytes + kTrailerBytes;
+
+        if (position + segmentBytes > size) {
+            break;   // torn append
+        }
+        const uchar *trailer = segment + segmentBytes - kTrailerBytes;
+        if (qFromLittleEndian<quint32>(trailer) != quint32(segmentBytes)
+            || qFromLittleEndian<quint32>(trailer + 4) != kTrailerMagic) {
+            break;
+        }
+
+        // Columns are 8-byte aligned in the file and the mapping is page
+        // aligned, so they can be read in place (the format is little-endian).
+        const uchar *columns = segment + kSegmentHeaderBytes;
+        m_segments.append({reinterpret_cast<const qint32 *>(columns),
+                           reinterpret_cast<const qint32 *>(columns + columnBytes),
+                           reinterpret_cast<const quint32 *>(columns + 2 * columnBytes),
+                           rows});
+        m_rowCount += rows;
+        m_lastSessionId = qFromLittleEndian<qint64>(segment + 16);
+        m_lastCheckinId = qFromLittleEndian<qint64>(segment + 24);
+
+        const uchar *entry = columns + 3 * columnBytes;
+        for (int i = 0; i < additions; i++) {
+            const quint32 length = qFromLittleEndian<quint32>(entry);
+            const QString category = QString::fromUtf8(reinterpret_cast<const char *>(entry + 4), length);
+            m_codes.insert(category, m_dictionary.size());
+            m_dictionary.append(category);
+            entry += 4 + length;
+        }
+
+        position += segmentBytes;
+    }
+    m_sealedBytes = position;
+    return true;
+}
+
+QVector<HistoryArchive::Chunk> HistoryArchive::chunks() const
+{
+    QVector<Chunk> work;
+    for (const Segment &segment : m_segments) {
+        for (qint64 begin = 0; begin < segment.rows; begin += kChunkRows) {
+            const qint64 rows = qMin(kChunkRows, segment.rows - begin);
+            work.append({segment.days + begin, segment.minutes + begin, segment.categories + begin, rows});
+        }
+    }
+    return work;
+}
@@ -0,0 +1,112 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include <QObject>
+#include <QFile>
+#include <QDate>
+#include <QHash>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QVector>
+
+// Rows waiting to be sealed into the archive as one segment.
+struct ArchiveBatch
+{
+    QVector<qint32> days;       // Julian day numbers
+    QVector<qint32> minutes;
+    QVector<QString> categories;
+    qint64 lastSessionId = 0;   // high-water marks in the live database
+    qint64 lastCheckinId = 0;
+
+    void append(const QDate &day, qint32 minutes, const QString &category);
+    int size() const { return days.size(); }
+};
+
+// Read-only columnar history of every focus session and habit check-in.
+// Each row has a category: "focus" for a work session (breaks are not
+// study time and are left out) or "habit: <title>" for a check-in.
+//
+// The file is a header followed by sealed, append-only segments. Each
+// segment stores its rows as three fixed-width columns (Julian day,
+// minutes, category code) plus the category strings first seen in it, so
+// the category dictionary is global without ever rewriting old data. The
+// whole file is memory-mapped and scanned in place: aggregations split the
+// rows into chunks, run a tight branch-free loop per chunk on the thread
+// pool and merge the partial results. A segment whose trailer is missing
+// (a torn append) is ignored, and cut off before the next append.
+class HistoryArchive : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qint64 rowCount READ rowCount NOTIFY archiveChanged)
+
+public:
+    explicit HistoryArchive(QObject *parent = nullptr);
+    ~HistoryArchive() override;
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const;
+
+    qint64 rowCount() const;
+    int segmentCount() const;
+    QStringList categories() const;
+    int categoryCode(const QString &category) const;
+    qint64 lastSessionId() const;
+    qint64 lastCheckinId() const;
+    // Where the last sealed segment ends; anything after it is torn.
+    qint64 sealedBytes() const;
+
+    // categoryCode -1 means every category.
+    qint64 totalMinutes(const QDate &from, const QDate &to, int categoryCode = -1) const;
+    qint64 eventCount(const QDate &from, const QDate &to, int categoryCode = -1) const;
+    QVector<qint64> minutesPerDay(const QDate &from, const QDate &to) const;
+    QHash<QString, qint64> minutesByCategory(const QDate &from, const QDate &to) const;
+
+    Q_INVOKABLE QVariantList dailyMinutes(const QDate &from, const QDate &to) const;
+    Q_INVOKABLE QVariantMap categoryMinutes(const QDate &from, const QDate &to) const;
+
+    // Seals a batch as a new segment at the end of the file, assigning
+    // codes to categories not yet in dictionary (which is updated). With
+    // sealedBytes, a torn tail past that offset is truncated first.
+    static bool appendSegment(const QString &path, const ArchiveBatch &batch, QStringList &dictionary,
+                              qint64 sealedBytes = -1);
+
+public slots:
+    // Appends everything the live database gained since the last segment.
+    bool refreshFromDatabase();
+
+signals:
+    void archiveChanged();
+
+private:
+    struct Segment {
+        const qint32 *days;
+        const qint32 *minutes;
+        const quint32 *categories;
+        qint64 rows;
+    };
+
+    struct Chunk {
+        const qint32 *days;
+        const qint32 *minutes;
+        const quint32 *categories;
+        qint64 rows;
+    };
+
+    QString m_path;
+    QFile m_file;
+    uchar *m_map;
+    QVector<Segment> m_segments;
+    QStringList m_dictionary;
+    QHash<QString, int> m_codes;
+    qint64 m_rowCount;
+    qint64 m_lastSessionId;
+    qint64 m_lastCheckinId;
+    qint64 m_sealedBytes;
+
+    bool mapSegments(qint64 size);
+    QVector<Chunk> chunks() const;
+};
+
+#endif // HISTORYARCHIVE_H
@@ -0,0 +1,132 @@
+#include "audiocueengine.h"
+#include "audiomixer.h"
+#include "../clock/clock.h"
+
+#include <QAudioSink>
+#include <QAudioDevice>
+#include <QMediaDevices>
+#include <QDebug>
+
+namespace {
+
+// Output buffer length: short enough that a cue starts promptly.
+const int kBufferMs = 40;
+const int kIdleSuspendMs = 3000;
+
+} // namespace
+
+AudioCueEngine::AudioCueEngine(QObject *parent)
+    : QObject(parent),
+    m_mixer(nullptr),
+    m_sink(nullptr),
+    m_idleTimer(Clock::instance()->createTimer(this)),
+    m_muted(false)
+{
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+
+    QAudioFormat format;
+    format.setSampleRate(48000);
+    format.setChannelCount(2);
+    format.setSampleFormat(QAudioFormat::Int16);
+    if (!device.isNull() && !device.isFormatSupported(format)) {
+        format.setSampleRate(device.preferredFormat().sampleRate());
+        format.setChannelCount(qBound(1, device.preferredFormat().channelCount(), 2));
+    }
+
+    // Cues are converted to the sink's format up front, never per playback.
+    m_pool.reset(format.sampleRate(), format.channelCount());
+    m_mixer = new AudioMixer(&m_pool, this);
+    // Unbuffered: QIODevice read-ahead would mix cues into audio queued long before they play.
+    m_mixer->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    if (device.isNull()) {
+        qDebug() << "No audio output device; cues are disabled";
+    } else {
+        m_sink = new QAudioSink(device, format, this);
+        m_sink->setBufferSize(format.bytesForDuration(kBufferMs * 1000));
+    }
+
+    m_idleTimer->setSingleShot(true);
+    connect(m_idleTimer, &ClockTimer::timeout, this, &AudioCueEngine::suspendIfIdle);
+
+    // Open the device now so its start-up cost is not paid by the first cue.
+    if (m_sink) {
+        m_sink->start(m_mixer);
+        m_idleTimer->start(kIdleSuspendMs);
+    }
+}
+
+AudioCueEngine::~AudioCueEngine()
+{
+    if (m_sink) {
+        m_sink->stop();
+    }
+}
+
+bool AudioCueEngine::registerCue(const QString &name, const QString &path)
+{
+    return m_pool.addCue(name, path);
+}
+
+void AudioCueEngine::play(const QString &name, qreal volume)
+{
+    if (m_muted || !m_sink) {
+        return;
+    }
+
+    const int cue = m_pool.cueId(name);
+    if (cue < 0) {
+        qDebug() << "Unknown audio cue:" << name;
+        return;
+    }
+
+    if (m_mixer->play(cue, volume)) {
+        ensureRunning();
+    }
+}
+
+bool AudioCueEngine::isMuted() const
+{
+    return m_muted;
+}
+
+void AudioCueEngine::setMuted(bool muted)
+{
+    if (m_muted == muted) {
+        return;
+    }
+
+    m_muted = muted;
+    if (m_muted) {
+        m_mixer->stopAll();
+    }
+    emit mutedChanged();
+}
+
+void AudioCueEngine::ensureRunning()
+{
+    switch (m_sink->state()) {
+    case QAudio::SuspendedState:
+        m_sink->resume();
+        break;
+    case QAudio::StoppedState:
+        m_sink->start(m_mixer);
+        break;
+    default:
+        break;
+    }
+
+    // Check back once the sounds queued so far have had time to finish.
+    m_idleTimer->start(kIdleSuspendMs);
+}
+
+void AudioCueEngine::suspendIfIdle()
+{
+    if (m_mixer->activeVoices() > 0) {
+        m_idleTimer->start(kIdleSuspendMs);
+        return;
+    }
+    if (m_sink && m_sink->state() == QAudio::ActiveState) {
+        m_sink->suspend();
+    }
+}
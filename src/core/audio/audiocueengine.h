@@ -0,0 +1,49 @@
+#ifndef AUDIOCUEENGINE_H
+#define AUDIOCUEENGINE_H
+
+#include <QObject>
+#include <QString>
+
+#include "audiocuepool.h"
+
+class AudioMixer;
+class QAudioSink;
+class ClockTimer;
+
+// Short UI sounds with minimal latency. Cues are decoded once into an
+// AudioCuePool when registered, and a single sink stays open on the
+// mixer; it is only suspended after a few idle seconds, so play() is an
+// append to the voice list rather than a decode and device open.
+class AudioCueEngine : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool muted READ isMuted WRITE setMuted NOTIFY mutedChanged)
+
+public:
+    explicit AudioCueEngine(QObject *parent = nullptr);
+    ~AudioCueEngine() override;
+
+    bool registerCue(const QString &name, const QString &path);
+
+    Q_INVOKABLE void play(const QString &name, qreal volume = 1.0);
+
+    bool isMuted() const;
+    void setMuted(bool muted);
+
+signals:
+    void mutedChanged();
+
+private slots:
+    void suspendIfIdle();
+
+private:
+    AudioCuePool m_pool;
+    AudioMixer *m_mixer;
+    QAudioSink *m_sink;
+    ClockTimer *m_idleTimer;
+    bool m_muted;
+
+    void ensureRunning();
+};
+
+#endif // AUDIOCUEENGINE_H
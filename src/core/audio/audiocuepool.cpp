@@ -0,0 +1,206 @@
+#include "audiocuepool.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+
+AudioCuePool::AudioCuePool(int sampleRate, int channels)
+    : m_sampleRate(sampleRate),
+    m_channels(channels)
+{
+}
+
+void AudioCuePool::reset(int sampleRate, int channels)
+{
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_pool.clear();
+    m_slices.clear();
+    m_ids.clear();
+}
+
+bool AudioCuePool::addCue(const QString &name, const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Error opening audio cue" << path << ":" << file.errorString();
+        return false;
+    }
+    return addCueFromWav(name, file.readAll());
+}
+
+bool AudioCuePool::addCueFromWav(const QString &name, const QByteArray &wav)
+{
+    QVector<qint16> decoded;
+    int rate = 0;
+    int channels = 0;
+    if (!decodeWav(wav, decoded, rate, channels)) {
+        qDebug() << "Unsupported audio cue format for" << name;
+        return false;
+    }
+
+    const QVector<qint16> converted = convert(decoded, rate, channels);
+
+    // Re-registering a name points it at the new data; the old slice stays
+    // in the pool until reset().
+    m_ids.insert(name, m_slices.size());
+    m_slices.append({m_pool.size(), converted.size() / m_channels});
+    m_pool += converted;
+    return true;
+}
+
+int AudioCuePool::cueId(const QString &name) const
+{
+    return m_ids.value(name, -1);
+}
+
+int AudioCuePool::cueCount() const
+{
+    return m_ids.size();
+}
+
+const qint16 *AudioCuePool::samples(int cueId) const
+{
+    if (cueId < 0 || cueId >= m_slices.size()) {
+        return nullptr;
+    }
+    return m_pool.constData() + m_slices.at(cueId).offset;
+}
+
+qint64 AudioCuePool::frameCount(int cueId) const
+{
+    if (cueId < 0 || cueId >= m_slices.size()) {
+        return 0;
+    }
+    return m_slices.at(cueId).frames;
+}
+
+int AudioCuePool::sampleRate() const
+{
+    return m_sampleRate;
+}
+
+int AudioCuePool::channels() const
+{
+    return m_channels;
+}
+
+qint64 AudioCuePool::totalBytes() const
+{
+    return qint64(m_pool.size()) * qint64(sizeof(qint16));
+}
+
+bool AudioCuePool::decodeWav(const QByteArray &data, QVector<qint16> &samples, int &sampleRate, int &channels)
+{
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    const qint64 size = data.size();
+
+    if (size < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    quint16 format = 0;
+    int bits = 0;
+    channels = 0;
+    sampleRate = 0;
+    const uchar *pcm = nullptr;
+    qint64 pcmBytes = 0;
+
+    // Walk the chunks; anything but fmt and data (bext, LIST, ...) is skipped.
+    qint64 position = 12;
+    while (position + 8 <= size) {
+        const uchar *chunk = bytes + position;
+        const qint64 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const qint64 available = qMin(chunkSize, size - position - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = qFromLittleEndian<quint16>(chunk + 8);
+            channels = qFromLittleEndian<quint16>(chunk + 10);
+            sampleRate = qFromLittleEndian<quint32>(chunk + 12);
+            bits = qFromLittleEndian<quint16>(chunk + 22);
+            if (format == 0xFFFE && available >= 26) {
+                // WAVE_FORMAT_EXTENSIBLE: the real format leads the sub-format GUID.
+                format = qFromLittleEndian<quint16>(chunk + 32);
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            pcmBytes = available;
+        }
+
+        position += 8 + chunkSize + (chunkSize & 1);   // chunks are word aligned
+    }
+
+    const bool integerPcm = format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    const bool floatPcm = format == 3 && bits == 32;
+    if (!pcm || channels <= 0 || sampleRate <= 0 || (!integerPcm && !floatPcm)) {
+        return false;
+    }
+
+    const int bytesPerSample = bits / 8;
+    const qint64 count = pcmBytes / bytesPerSample / channels * channels;
+    samples.resize(count);
+
+    for (qint64 i = 0; i < count; i++) {
+        const uchar *sample = pcm + i * bytesPerSample;
+        qint16 value = 0;
+        if (floatPcm) {
+            float f;
+            const quint32 raw = qFromLittleEndian<quint32>(sample);
+            std::memcpy(&f, &raw, sizeof(f));
+            value = qint16(qBound(-1.0f, f, 1.0f) * 32767.0f);
+        } else if (bits == 8) {
+            value = qint16((int(sample[0]) - 128) << 8);   // 8-bit WAV is unsigned
+        } else if (bits == 16) {
+            value = qFromLittleEndian<qint16>(sample);
+        } else if (bits == 24) {
+            value = qint16((sample[1]) | (sample[2] << 8));
+        } else {
+            value = qint16(qFromLittleEndian<qint32>(sample) >> 16);
+        }
+        samples[i] = value;
+    }
+    return true;
+}
+
+QVector<qint16> AudioCuePool::convert(const QVector<qint16> &input, int inputRate, int inputChannels) const
+{
+    const qint64 inputFrames = input.size() / inputChannels;
+    if (inputFrames == 0) {
+        return {};
+    }
+
+    const qint64 outputFrames = inputRate == m_sampleRate
+        ? inputFrames
+        : qint64(std::ceil(double(inputFrames) * m_sampleRate / inputRate));
+    const double step = double(inputRate) / m_sampleRate;
+
+    auto inputSample = [&](qint64 frame, int channel) -> double {
+        if (m_channels == 1 && inputChannels > 1) {
+            // Downmix to mono by averaging every input channel.
+            double sum = 0;
+            for (int c = 0; c < inputChannels; c++) {
+                sum += input.at(frame * inputChannels + c);
+            }
+            return sum / inputChannels;
+        }
+        return input.at(frame * inputChannels + qMin(channel, inputChannels - 1));
+    };
+
+    // Linear interpolation is plenty for short UI cues.
+    QVector<qint16> output(outputFrames * m_channels);
+    for (qint64 frame = 0; frame < outputFrames; frame++) {
+        const double source = frame * step;
+        const qint64 index = qMin<qint64>(qint64(source), inputFrames - 1);
+        const qint64 next = qMin<qint64>(index + 1, inputFrames - 1);
+        const double fraction = source - index;
+
+        for (int channel = 0; channel < m_channels; channel++) {
+            const double a = inputSample(index, channel);
+            const double b = inputSample(next, channel);
+            output[frame * m_channels + channel] = qint16(qRound(a + (b - a) * fraction));
+        }
+    }
+    return output;
+}
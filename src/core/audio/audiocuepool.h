@@ -0,0 +1,52 @@
+#ifndef AUDIOCUEPOOL_H
+#define AUDIOCUEPOOL_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+
+// Decoded cues, all converted once to the output's interleaved 16-bit
+// format and packed back to back in one shared buffer. Playback only ever
+// reads slices of it, so triggering a cue never decodes, allocates or
+// touches the disk.
+class AudioCuePool
+{
+public:
+    explicit AudioCuePool(int sampleRate = 48000, int channels = 2);
+
+    // Drops every cue; cue ids handed out before are invalid afterwards.
+    void reset(int sampleRate, int channels);
+
+    bool addCue(const QString &name, const QString &path);
+    bool addCueFromWav(const QString &name, const QByteArray &wav);
+
+    int cueId(const QString &name) const;
+    int cueCount() const;
+    const qint16 *samples(int cueId) const;
+    qint64 frameCount(int cueId) const;
+
+    int sampleRate() const;
+    int channels() const;
+    qint64 totalBytes() const;
+
+    // Decodes PCM (8/16/24/32-bit integer or 32-bit float) WAV data into
+    // interleaved 16-bit samples.
+    static bool decodeWav(const QByteArray &data, QVector<qint16> &samples, int &sampleRate, int &channels);
+
+private:
+    struct Slice {
+        qint64 offset;   // in samples
+        qint64 frames;
+    };
+
+    int m_sampleRate;
+    int m_channels;
+    QVector<qint16> m_pool;
+    QVector<Slice> m_slices;
+    QHash<QString, int> m_ids;
+
+    QVector<qint16> convert(const QVector<qint16> &input, int inputRate, int inputChannels) const;
+};
+
+#endif // AUDIOCUEPOOL_H
@@ -0,0 +1,99 @@
+#include "audiomixer.h"
+#include "audiocuepool.h"
+
+#include <QMutexLocker>
+#include <cstring>
+
+AudioMixer::AudioMixer(const AudioCuePool *pool, QObject *parent)
+    : QIODevice(parent),
+    m_pool(pool)
+{
+    m_voices.reserve(kMaxVoices);
+}
+
+bool AudioMixer::play(int cueId, qreal volume)
+{
+    if (m_pool->frameCount(cueId) == 0) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_voices.size() >= kMaxVoices) {
+        return false;
+    }
+    m_voices.append({cueId, 0, int(qBound(0.0, volume, 1.0) * 256)});
+    return true;
+}
+
+void AudioMixer::stopAll()
+{
+    QMutexLocker locker(&m_mutex);
+    m_voices.clear();
+}
+
+int AudioMixer::activeVoices() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_voices.size();
+}
+
+bool AudioMixer::isSequential() const
+{
+    return true;
+}
+
+qint64 AudioMixer::bytesAvailable() const
+{
+    // An endless stream: there is always another buffer of (possibly silent) audio.
+    return QIODevice::bytesAvailable() + 4096;
+}
+
+qint64 AudioMixer::readData(char *data, qint64 maxSize)
+{
+    const int channels = m_pool->channels();
+    const qint64 frames = maxSize / (channels * qint64(sizeof(qint16)));
+    const qint64 count = frames * channels;
+    if (frames <= 0) {
+        return 0;
+    }
+
+    qint16 *out = reinterpret_cast<qint16 *>(data);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_voices.isEmpty()) {
+        std::memset(out, 0, count * sizeof(qint16));
+        return count * qint64(sizeof(qint16));
+    }
+
+    if (m_accumulator.size() < count) {
+        m_accumulator.resize(count);
+    }
+    std::fill_n(m_accumulator.begin(), count, 0);
+
+    for (int v = m_voices.size() - 1; v >= 0; v--) {
+        Voice &voice = m_voices[v];
+        const qint16 *source = m_pool->samples(voice.cueId) + voice.frame * channels;
+        const qint64 todo = qMin(frames, m_pool->frameCount(voice.cueId) - voice.frame);
+
+        for (qint64 i = 0; i < todo * channels; i++) {
+            m_accumulator[i] += (source[i] * voice.gain) >> 8;
+        }
+
+        voice.frame += todo;
+        if (voice.frame >= m_pool->frameCount(voice.cueId)) {
+            m_voices.removeAt(v);
+        }
+    }
+
+    for (qint64 i = 0; i < count; i++) {
+        out[i] = qint16(qBound(-32768, m_accumulator.at(i), 32767));
+    }
+    return count * qint64(sizeof(qint16));
+}
+
+qint64 AudioMixer::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
@@ -0,0 +1,46 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QIODevice>
+#include <QMutex>
+#include <QVector>
+
+class AudioCuePool;
+
+// Pull-mode source for an audio sink. Every play() adds a voice reading
+// from the shared cue pool; readData() sums all voices into the output, so
+// overlapping cues mix instead of cutting each other off. Idle output is
+// silence, which keeps the sink primed for the next cue.
+class AudioMixer : public QIODevice
+{
+public:
+    explicit AudioMixer(const AudioCuePool *pool, QObject *parent = nullptr);
+
+    // volume is 0.0-1.0. Returns false if the cue is unknown or every voice is busy.
+    bool play(int cueId, qreal volume = 1.0);
+    void stopAll();
+    int activeVoices() const;
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+
+    static constexpr int kMaxVoices = 16;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    struct Voice {
+        int cueId;
+        qint64 frame;
+        int gain;   // 1/256 steps
+    };
+
+    const AudioCuePool *m_pool;
+    QVector<Voice> m_voices;
+    QVector<qint32> m_accumulator;
+    mutable QMutex m_mutex;
+};
+
+#endif // AUDIOMIXER_H
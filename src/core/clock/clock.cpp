@@ -0,0 +1,83 @@
+#include "clock.h"
+
+#include <QTimer>
+#include <QElapsedTimer>
+
+#ifdef Q_OS_LINUX
+#include <time.h>
+#endif
+
+namespace {
+
+Clock *s_instance = nullptr;
+
+class SystemTimer : public ClockTimer
+{
+public:
+    explicit SystemTimer(QObject *parent)
+        : ClockTimer(parent),
+        m_timer(new QTimer(this))
+    {
+        connect(m_timer, &QTimer::timeout, this, &ClockTimer::timeout);
+    }
+
+    void start(int msec) override { m_timer->start(msec); }
+    void start() override { m_timer->start(); }
+    void stop() override { m_timer->stop(); }
+    bool isActive() const override { return m_timer->isActive(); }
+    void setInterval(int msec) override { m_timer->setInterval(msec); }
+    int interval() const override { return m_timer->interval(); }
+    void setSingleShot(bool singleShot) override { m_timer->setSingleShot(singleShot); }
+    void setTimerType(Qt::TimerType type) override { m_timer->setTimerType(type); }
+    int remainingTime() const override { return m_timer->remainingTime(); }
+
+private:
+    QTimer *m_timer;
+};
+
+} // namespace
+
+Clock *Clock::instance()
+{
+    static SystemClock systemClock;
+    return s_instance ? s_instance : &systemClock;
+}
+
+void Clock::setInstance(Clock *clock)
+{
+    // Passing nullptr restores the system clock.
+    s_instance = clock;
+}
+
+QDate Clock::today() const
+{
+    return now().date();
+}
+
+QDateTime SystemClock::now() const
+{
+    return QDateTime::currentDateTime();
+}
+
+qint64 SystemClock::monotonicMs() const
+{
+#if defined(Q_OS_LINUX) && defined(CLOCK_BOOTTIME)
+    // Unlike CLOCK_MONOTONIC this keeps counting while the machine sleeps,
+    // so deadlines set before a suspend are still honoured after it.
+    timespec ts;
+    if (clock_gettime(CLOCK_BOOTTIME, &ts) == 0) {
+        return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    }
+#endif
+    static QElapsedTimer elapsed = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return elapsed.elapsed();
+}
+
+ClockTimer *SystemClock::createTimer(QObject *parent)
+{
+    return new SystemTimer(parent);
+}
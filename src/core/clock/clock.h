@@ -0,0 +1,58 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QDate>
+
+// Timer created by a Clock. Mirrors the subset of QTimer the app uses so
+// the same code runs on wall-clock time or on a VirtualClock in tests.
+class ClockTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+
+    virtual void start(int msec) = 0;
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool isActive() const = 0;
+    virtual void setInterval(int msec) = 0;
+    virtual int interval() const = 0;
+    virtual void setSingleShot(bool singleShot) = 0;
+    virtual void setTimerType(Qt::TimerType type) = 0;
+    virtual int remainingTime() const = 0;
+
+signals:
+    void timeout();
+};
+
+// Source of "now" for everything that depends on dates or elapsed time.
+// Defaults to the system clock; tests install a VirtualClock.
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    static Clock *instance();
+    static void setInstance(Clock *clock);
+
+    virtual QDateTime now() const = 0;
+    // Milliseconds from an arbitrary origin; never jumps with wall-clock
+    // changes. Use for deadlines and durations.
+    virtual qint64 monotonicMs() const = 0;
+    virtual ClockTimer *createTimer(QObject *parent = nullptr) = 0;
+
+    QDate today() const;
+};
+
+class SystemClock : public Clock
+{
+public:
+    QDateTime now() const override;
+    qint64 monotonicMs() const override;
+    ClockTimer *createTimer(QObject *parent = nullptr) override;
+};
+
+#endif // CLOCK_H
@@ -0,0 +1,191 @@
+#include "virtualclock.h"
+
+#include <algorithm>
+
+VirtualClock::VirtualClock(const QDateTime &start)
+    : m_start(start),
+    m_elapsed(0),
+    m_nextSequence(0)
+{
+}
+
+VirtualClock::~VirtualClock()
+{
+    // Timers may outlive the clock (they are owned by their QObject parent).
+    for (VirtualTimer *timer : std::as_const(m_timers)) {
+        timer->m_clock = nullptr;
+    }
+
+    if (Clock::instance() == this) {
+        Clock::setInstance(nullptr);
+    }
+}
+
+QDateTime VirtualClock::now() const
+{
+    return m_start.addMSecs(m_elapsed);
+}
+
+qint64 VirtualClock::monotonicMs() const
+{
+    return m_elapsed;
+}
+
+ClockTimer *VirtualClock::createTimer(QObject *parent)
+{
+    return new VirtualTimer(this, parent);
+}
+
+void VirtualClock::advance(qint64 msec)
+{
+    if (msec < 0) {
+        return;
+    }
+
+    const qint64 target = m_elapsed + msec;
+
+    while (VirtualTimer *timer = nextDue(target)) {
+        m_elapsed = timer->m_deadline;
+        timer->fire();
+    }
+
+    m_elapsed = target;
+}
+
+void VirtualClock::advanceTo(const QDateTime &target)
+{
+    advance(now().msecsTo(target));
+}
+
+void VirtualClock::advanceDays(int days)
+{
+    // Calendar days: across a DST change this is 23 or 25 hours of elapsed time.
+    advanceTo(now().addDays(days));
+}
+
+void VirtualClock::advanceWeeks(int weeks)
+{
+    advanceDays(weeks * 7);
+}
+
+int VirtualClock::pendingTimers() const
+{
+    return std::count_if(m_timers.cbegin(), m_timers.cend(),
+                         [](const VirtualTimer *timer) { return timer->m_active; });
+}
+
+void VirtualClock::registerTimer(VirtualTimer *timer)
+{
+    m_timers.append(timer);
+}
+
+void VirtualClock::unregisterTimer(VirtualTimer *timer)
+{
+    m_timers.removeOne(timer);
+}
+
+VirtualTimer *VirtualClock::nextDue(qint64 limit) const
+{
+    VirtualTimer *next = nullptr;
+    for (VirtualTimer *timer : m_timers) {
+        if (!timer->m_active || timer->m_deadline > limit) {
+            continue;
+        }
+        if (!next
+            || timer->m_deadline < next->m_deadline
+            || (timer->m_deadline == next->m_deadline && timer->m_sequence < next->m_sequence)) {
+            next = timer;
+        }
+    }
+    return next;
+}
+
+VirtualTimer::VirtualTimer(VirtualClock *clock, QObject *parent)
+    : ClockTimer(parent),
+    m_clock(clock),
+    m_interval(0),
+    m_singleShot(false),
+    m_active(false),
+    m_deadline(0),
+    m_sequence(0)
+{
+    m_clock->registerTimer(this);
+}
+
+VirtualTimer::~VirtualTimer()
+{
+    if (m_clock) {
+        m_clock->unregisterTimer(this);
+    }
+}
+
+void VirtualTimer::start(int msec)
+{
+    m_interval = msec;
+    start();
+}
+
+void VirtualTimer::start()
+{
+    if (!m_clock) {
+        return;
+    }
+
+    m_active = true;
+    m_deadline = m_clock->m_elapsed + std::max(m_interval, 1);
+    m_sequence = m_clock->m_nextSequence++;
+}
+
+void VirtualTimer::stop()
+{
+    m_active = false;
+}
+
+bool VirtualTimer::isActive() const
+{
+    return m_active;
+}
+
+void VirtualTimer::setInterval(int msec)
+{
+    m_interval = msec;
+    if (m_active) {
+        start();
+    }
+}
+
+int VirtualTimer::interval() const
+{
+    return m_interval;
+}
+
+void VirtualTimer::setSingleShot(bool singleShot)
+{
+    m_singleShot = singleShot;
+}
+
+void VirtualTimer::setTimerType(Qt::TimerType type)
+{
+    // Virtual time is exact; the accuracy hint has no effect.
+    Q_UNUSED(type);
+}
+
+int VirtualTimer::remainingTime() const
+{
+    if (!m_active || !m_clock) {
+        return -1;
+    }
+    return int(std::max<qint64>(0, m_deadline - m_clock->m_elapsed));
+}
+
+void VirtualTimer::fire()
+{
+    if (m_singleShot) {
+        m_active = false;
+    } else {
+        m_deadline += std::max(m_interval, 1);
+        m_sequence = m_clock->m_nextSequence++;
+    }
+
+    emit timeout();
+}
@@ -0,0 +1,76 @@
+#ifndef VIRTUALCLOCK_H
+#define VIRTUALCLOCK_H
+
+#include "clock.h"
+
+#include <QVector>
+
+class VirtualTimer;
+
+// Clock whose time only moves when told to. Advancing fires every due
+// VirtualTimer in deadline order, with now() set to each deadline as it
+// fires, so a year of hourly timers runs in milliseconds.
+//
+// Wall-clock time is derived from the start QDateTime plus elapsed
+// milliseconds, so a start time carrying a QTimeZone crosses DST
+// transitions exactly like real time would.
+class VirtualClock : public Clock
+{
+public:
+    explicit VirtualClock(const QDateTime &start = QDateTime(QDate(2025, 1, 1), QTime(9, 0)));
+    ~VirtualClock() override;
+
+    QDateTime now() const override;
+    qint64 monotonicMs() const override;
+    ClockTimer *createTimer(QObject *parent = nullptr) override;
+
+    void advance(qint64 msec);
+    void advanceTo(const QDateTime &target);
+    void advanceDays(int days);
+    void advanceWeeks(int weeks);
+
+    int pendingTimers() const;
+
+private:
+    friend class VirtualTimer;
+
+    QDateTime m_start;
+    qint64 m_elapsed;
+    quint64 m_nextSequence;
+    QVector<VirtualTimer *> m_timers;
+
+    void registerTimer(VirtualTimer *timer);
+    void unregisterTimer(VirtualTimer *timer);
+    VirtualTimer *nextDue(qint64 limit) const;
+};
+
+class VirtualTimer : public ClockTimer
+{
+public:
+    VirtualTimer(VirtualClock *clock, QObject *parent);
+    ~VirtualTimer() override;
+
+    void start(int msec) override;
+    void start() override;
+    void stop() override;
+    bool isActive() const override;
+    void setInterval(int msec) override;
+    int interval() const override;
+    void setSingleShot(bool singleShot) override;
+    void setTimerType(Qt::TimerType type) override;
+    int remainingTime() const override;
+
+private:
+    friend class VirtualClock;
+
+    VirtualClock *m_clock;
+    int m_interval;
+    bool m_singleShot;
+    bool m_active;
+    qint64 m_deadline;
+    quint64 m_sequence;   // tie-breaker: equal deadlines fire in arm order
+
+    void fire();
+};
+
+#endif // VIRTUALCLOCK_H
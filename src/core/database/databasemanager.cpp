@@ -5,6 +5,8 @@
 #include <QDateTime>      // ← Add this line
 #include <QVariant>       // ← Add this too
 #include <QVariantMap>    // ← And this
+#include <QStringList>
+#include <QPair>
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
@@ -52,6 +54,76 @@ bool DatabaseManager::createTables()
         return false;
     }
 
+    // Added after the first release; the planner sizes work in Pomodoros.
+    if (!addColumnIfMissing("todos", "estimated_pomodoros", "INTEGER NOT NULL DEFAULT 1")) {
+        return false;
+    }
+
+    // Manual order: fractional keys, so a move rewrites one row.
+    if (!addColumnIfMissing("todos", "sort_key", "TEXT")) {
+        return false;
+    }
+
+    // Subtasks point at their parent todo; top-level todos leave it NULL.
+    if (!addColumnIfMissing("todos", "parent_id", "INTEGER")) {
+        return false;
+    }
+
+    // Repeating todos keep their rule and the date the series counts from;
+    // the row itself is always the next occurrence.
+    if (!addColumnIfMissing("todos", "recurrence", "TEXT")
+        || !addColumnIfMissing("todos", "recurrence_start", "DATETIME")) {
+        return false;
+    }
+
+    // Named lists (one per course, ...). Every todo belongs to one; rows
+    // written without a list (older builds, sync) go to the first list.
+    if (!addColumnIfMissing("todos", "list_id", "INTEGER")) {
+        return false;
+    }
+
+    const QStringList listStatements = {
+        "CREATE TABLE IF NOT EXISTS todo_lists ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "name TEXT NOT NULL,"
+        "created_date DATETIME DEFAULT CURRENT_TIMESTAMP"
+        ")",
+        "INSERT INTO todo_lists (name) SELECT 'Inbox' WHERE NOT EXISTS (SELECT 1 FROM todo_lists)",
+        "UPDATE todos SET list_id = (SELECT MIN(id) FROM todo_lists) WHERE list_id IS NULL",
+        "CREATE TRIGGER IF NOT EXISTS todos_default_list AFTER INSERT ON todos "
+        "WHEN NEW.list_id IS NULL BEGIN "
+        "UPDATE todos SET list_id = (SELECT MIN(id) FROM todo_lists) WHERE id = NEW.id; END",
+        // Opening a list and counting it stay inside one index range.
+        "CREATE INDEX IF NOT EXISTS idx_todos_list ON todos (list_id, parent_id, completed)"
+    };
+
+    for (const QString &statement : listStatements) {
+        if (!query.exec(statement)) {
+            qDebug() << "Error creating todo lists:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if (!createChangeTriggers("todo_lists", "id")) {
+        return false;
+    }
+
+    // Children are fetched per parent in manual order when a node expands.
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_todos_parent ON todos (parent_id, sort_key)")) {
+        qDebug() << "Error creating todos parent index:" << query.lastError().text();
+        return false;
+    }
+
+    // Reminder rebuilds range-scan open todos by due date.
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_todos_open_due ON todos (due_date) WHERE completed = 0")) {
+        qDebug() << "Error creating todos due-date index:" << query.lastError().text();
+        return false;
+    }
+
+    if (!createChangeTriggers("todos", "id")) {
+        return false;
+    }
+
     qDebug() << "Tables created successfully";
     return true;
 }
@@ -79,6 +151,69 @@ bool DatabaseManager::createStreaksTable()
         qDebug() << "Error creating streaks table:" << query.lastError().text();
         return false;
     }
+
+    // One row per day a streak was checked in; the unique constraint doubles
+    // as the (streak_id, checkin_date) index used by the analytics loader.
+    QString createCheckins = R"(
+        CREATE TABLE IF NOT EXISTS streak_checkins (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            streak_id INTEGER NOT NULL,
+            checkin_date DATE NOT NULL,
+            UNIQUE(streak_id, checkin_date)
+        )
+    )";
+
+    if (!query.exec(createCheckins)) {
+        qDebug() << "Error creating streak_checkins table:" << query.lastError().text();
+        return false;
+    }
+
+    // Check-ins are reported per streak so watchers reload one history.
+    return createChangeTriggers("streaks", "id")
+           && createChangeTriggers("streak_checkins", "streak_id");
+}
+
+bool DatabaseManager::createChangeLogTable()
+{
+    QSqlQuery query;
+    QString createTable = R"(
+        CREATE TABLE IF NOT EXISTS change_log (
+            seq INTEGER PRIMARY KEY AUTOINCREMENT,
+            table_name TEXT NOT NULL,
+            row_id INTEGER NOT NULL
+        )
+    )";
+
+    if (!query.exec(createTable)) {
+        qDebug() << "Error creating change_log table:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::createChangeTriggers(const QString &table, const QString &idColumn)
+{
+    if (!createChangeLogTable()) {
+        return false;
+    }
+
+    // Triggers live in the database file, so writes from other processes and
+    // scripts are logged as well as our own.
+    const QStringList events = {"INSERT", "UPDATE", "DELETE"};
+    QSqlQuery query;
+
+    for (const QString &event : events) {
+        const QString row = event == "DELETE" ? "OLD" : "NEW";
+        const QString sql = QString(
+            "CREATE TRIGGER IF NOT EXISTS %1_log_%2 AFTER %3 ON %1 "
+            "BEGIN INSERT INTO change_log (table_name, row_id) VALUES ('%1', %4.%5); END")
+            .arg(table, event.toLower(), event, row, idColumn);
+
+        if (!query.exec(sql)) {
+            qDebug() << "Error creating change trigger on" << table << ":" << query.lastError().text();
+            return false;
+        }
+    }
     return true;
 }
 
@@ -99,6 +234,117 @@ bool DatabaseManager::saveStreak(const QString &title, int streakDuration, int b
     return true;
 }
 
+bool DatabaseManager::createSyncTables()
+{
+    QSqlQuery query;
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS sync_meta ("
+        "key TEXT PRIMARY KEY,"
+        "value TEXT"
+        ")",
+        // Last-writer-wins register per synced field: the HLC and JSON value
+        // of the newest write we know of, local or remote.
+        "CREATE TABLE IF NOT EXISTS sync_fields ("
+        "entity TEXT NOT NULL,"
+        "uid TEXT NOT NULL,"
+        "field TEXT NOT NULL,"
+        "hlc TEXT NOT NULL,"
+        "value TEXT,"
+        "PRIMARY KEY (entity, uid, field)"
+        ")",
+        "CREATE TABLE IF NOT EXISTS sync_cursors ("
+        "device TEXT NOT NULL,"
+        "segment TEXT NOT NULL,"
+        "byte_offset INTEGER NOT NULL,"
+        "PRIMARY KEY (device, segment)"
+        ")",
+        "CREATE TABLE IF NOT EXISTS sync_tombstones ("
+        "entity TEXT NOT NULL,"
+        "uid TEXT NOT NULL,"
+        "PRIMARY KEY (entity, uid)"
+        ")"
+    };
+
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            qDebug() << "Error creating sync tables:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // Local integer ids differ between machines; synced rows are matched by uid.
+    const QList<QPair<QString, QString>> entities = {
+        {"todo_lists", "todo_list"}, {"todos", "todo"}, {"streaks", "streak"}
+    };
+    for (const auto &entity : entities) {
+        const QString &table = entity.first;
+        if (!addColumnIfMissing(table, "uid", "TEXT")) {
+            return false;
+        }
+
+        QStringList uidStatements;
+        if (table == "todo_lists") {
+            // Every device starts with its own default list; give it the same
+            // uid everywhere so the first sync doesn't make two of them.
+            uidStatements << "UPDATE todo_lists SET uid = 'inbox' "
+                             "WHERE uid IS NULL AND id = (SELECT MIN(id) FROM todo_lists) "
+                             "AND NOT EXISTS (SELECT 1 FROM todo_lists WHERE uid = 'inbox')";
+        }
+        uidStatements << QStringList{
+            QString("UPDATE %1 SET uid = lower(hex(randomblob(16))) WHERE uid IS NULL").arg(table),
+            QString("CREATE UNIQUE INDEX IF NOT EXISTS idx_%1_uid ON %1(uid)").arg(table),
+            QString("CREATE TRIGGER IF NOT EXISTS %1_assign_uid AFTER INSERT ON %1 "
+                    "WHEN NEW.uid IS NULL BEGIN "
+                    "UPDATE %1 SET uid = lower(hex(randomblob(16))) WHERE id = NEW.id; END").arg(table),
+            QString("CREATE TRIGGER IF NOT EXISTS %1_tombstone AFTER DELETE ON %1 "
+                    "WHEN OLD.uid IS NOT NULL BEGIN "
+                    "INSERT OR REPLACE INTO sync_tombstones (entity, uid) VALUES ('%2', OLD.uid); END")
+                .arg(table, entity.second)
+        };
+
+        for (const QString &statement : uidStatements) {
+            if (!query.exec(statement)) {
+                qDebug() << "Error preparing" << table << "for sync:" << query.lastError().text();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::addColumnIfMissing(const QString &table, const QString &column, const QString &declaration)
+{
+    QSqlQuery query(QString("PRAGMA table_info(%1)").arg(table));
+    while (query.next()) {
+        if (query.value(1).toString() == column) {
+            return true;
+        }
+    }
+
+    if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, declaration))) {
+        qDebug() << "Error adding column" << column << "to" << table << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QVariantMap DatabaseManager::loadStreak(int id)
+{
+    QVariantMap streak;
+    QSqlQuery query;
+    query.prepare("SELECT id, title, streak_duration, best_streak, last_activity FROM streaks WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (query.exec() && query.next()) {
+        streak["id"] = query.value(0).toInt();
+        streak["title"] = query.value(1).toString();
+        streak["streakDuration"] = query.value(2).toInt();
+        streak["bestStreak"] = query.value(3).toInt();
+        streak["lastActivity"] = query.value(4).toDateTime();
+    }
+    return streak;
+}
+
 QVector<QVariantMap> DatabaseManager::loadAllStreaks()
 {
     QVector<QVariantMap> streaks;
@@ -134,7 +380,361 @@ bool DatabaseManager::updateStreak(int id, const QString &title, int streakDurat
 bool DatabaseManager::deleteStreak(int id)
 {
     QSqlQuery query;
+    query.prepare("DELETE FROM streak_checkins WHERE streak_id = :id");
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error deleting streak check-ins:" << query.lastError().text();
+    }
+
     query.prepare("DELETE FROM streaks WHERE id = :id");
     query.bindValue(":id", id);
     return query.exec();
 }
+
+bool DatabaseManager::recordStreakCheckin(int streakId, const QDate &day, bool *inserted)
+{
+    QSqlQuery query;
+    query.prepare("INSERT OR IGNORE INTO streak_checkins (streak_id, checkin_date) "
+                  "VALUES (:streak_id, :checkin_date)");
+    query.bindValue(":streak_id", streakId);
+    query.bindValue(":checkin_date", day.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qDebug() << "Error recording streak check-in:" << query.lastError().text();
+        return false;
+    }
+    if (inserted) {
+        *inserted = query.numRowsAffected() > 0;   // 0 when already checked in that day
+    }
+    return true;
+}
+
+QVector<QDate> DatabaseManager::loadStreakCheckins(int streakId)
+{
+    QVector<QDate> days;
+    QSqlQuery query;
+    query.prepare("SELECT checkin_date FROM streak_checkins "
+                  "WHERE streak_id = :streak_id ORDER BY checkin_date");
+    query.bindValue(":streak_id", streakId);
+
+    if (!query.exec()) {
+        qDebug() << "Error loading streak check-ins:" << query.lastError().text();
+        return days;
+    }
+
+    while (query.next()) {
+        days.append(QDate::fromString(query.value(0).toString(), Qt::ISODate));
+    }
+    return days;
+}
+
+bool DatabaseManager::createSessionsTable()
+{
+    QSqlQuery query;
+    QString createTable = R"(
+        CREATE TABLE IF NOT EXISTS pomodoro_sessions (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            kind TEXT NOT NULL,
+            session_day DATE NOT NULL,
+            started_at DATETIME NOT NULL,
+            duration_ms INTEGER NOT NULL,
+            planned_seconds INTEGER DEFAULT 0,
+            end_reason TEXT NOT NULL
+        )
+    )";
+
+    if (!query.exec(createTable)) {
+        qDebug() << "Error creating pomodoro_sessions table:" << query.lastError().text();
+        return false;
+    }
+
+    // Covers the per-day totals entirely, so they never touch the table rows.
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_pomodoro_sessions_day "
+                    "ON pomodoro_sessions (session_day, kind, duration_ms)")) {
+        qDebug() << "Error creating pomodoro_sessions index:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::insertPomodoroSession(const QString &kind, const QDateTime &startedAt, qint64 durationMs,
+                                            int plannedSeconds, const QString &endReason)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO pomodoro_sessions (kind, session_day, started_at, duration_ms, planned_seconds, end_reason) "
+                  "VALUES (:kind, :session_day, :started_at, :duration_ms, :planned_seconds, :end_reason)");
+    query.bindValue(":kind", kind);
+    query.bindValue(":session_day", startedAt.date().toString(Qt::ISODate));
+    query.bindValue(":started_at", startedAt);
+    query.bindValue(":duration_ms", durationMs);
+    query.bindValue(":planned_seconds", plannedSeconds);
+    query.bindValue(":end_reason", endReason);
+
+    if (!query.exec()) {
+        qDebug() << "Error recording pomodoro session:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+qint64 DatabaseManager::studiedMs(const QDate &from, const QDate &to)
+{
+    QSqlQuery query;
+    query.prepare("SELECT COALESCE(SUM(duration_ms), 0) FROM pomodoro_sessions "
+                  "WHERE session_day BETWEEN :from AND :to AND kind = 'work'");
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":to", to.toString(Qt::ISODate));
+
+    if (!query.exec() || !query.next()) {
+        qDebug() << "Error summing study time:" << query.lastError().text();
+        return 0;
+    }
+    return query.value(0).toLongLong();
+}
+
+QMap<QDate, qint64> DatabaseManager::studiedMsPerDay(const QDate &from, const QDate &to)
+{
+    QMap<QDate, qint64> totals;
+    QSqlQuery query;
+    query.prepare("SELECT session_day, SUM(duration_ms) FROM pomodoro_sessions "
+                  "WHERE session_day BETWEEN :from AND :to AND kind = 'work' GROUP BY session_day");
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":to", to.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qDebug() << "Error loading daily study time:" << query.lastError().text();
+        return totals;
+    }
+
+    while (query.next()) {
+        totals.insert(QDate::fromString(query.value(0).toString(), Qt::ISODate), query.value(1).toLongLong());
+    }
+    return totals;
+}
+
+bool DatabaseManager::createRollupTables()
+{
+    QSqlQuery query;
+
+    // Raw completion events: todos can be cleared, their history stays.
+    QString createCompletions = R"(
+        CREATE TABLE IF NOT EXISTS todo_completions (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            todo_id INTEGER NOT NULL,
+            completed_day DATE NOT NULL,
+            completed_at DATETIME NOT NULL
+        )
+    )";
+
+    if (!query.exec(createCompletions)) {
+        qDebug() << "Error creating todo_completions table:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_todo_completions_todo ON todo_completions (todo_id)")
+        || !query.exec("CREATE INDEX IF NOT EXISTS idx_todo_completions_day ON todo_completions (completed_day)")) {
+        qDebug() << "Error creating todo_completions indexes:" << query.lastError().text();
+        return false;
+    }
+
+    const QString summaryColumns =
+        "focus_ms INTEGER NOT NULL DEFAULT 0,"
+        "sessions INTEGER NOT NULL DEFAULT 0,"
+        "todos_completed INTEGER NOT NULL DEFAULT 0,"
+        "habits_checked INTEGER NOT NULL DEFAULT 0";
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS study_rollup_daily (day DATE PRIMARY KEY, " + summaryColumns + ")")) {
+        qDebug() << "Error creating study_rollup_daily table:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS study_rollup_weekly (week TEXT PRIMARY KEY, " + summaryColumns + ")")) {
+        qDebug() << "Error creating study_rollup_weekly table:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::recordTodoCompletion(int todoId, const QDateTime &completedAt)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todo_completions (todo_id, completed_day, completed_at) "
+                  "VALUES (:todo_id, :completed_day, :completed_at)");
+    query.bindValue(":todo_id", todoId);
+    query.bindValue(":completed_day", completedAt.date().toString(Qt::ISODate));
+    query.bindValue(":completed_at", completedAt);
+
+    if (!query.exec()) {
+        qDebug() << "Error recording todo completion:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QDate DatabaseManager::removeTodoCompletion(int todoId)
+{
+    // Un-completing retracts the most recent completion of that todo.
+    QSqlQuery query;
+    query.prepare("SELECT id, completed_day FROM todo_completions "
+                  "WHERE todo_id = :todo_id ORDER BY id DESC LIMIT 1");
+    query.bindValue(":todo_id", todoId);
+
+    if (!query.exec() || !query.next()) {
+        return QDate();
+    }
+
+    const int id = query.value(0).toInt();
+    const QDate day = QDate::fromString(query.value(1).toString(), Qt::ISODate);
+
+    query.prepare("DELETE FROM todo_completions WHERE id = :id");
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error removing todo completion:" << query.lastError().text();
+        return QDate();
+    }
+    return day;
+}
+
+bool DatabaseManager::createPlannerTables()
+{
+    QSqlQuery query;
+
+    // Weekly availability: minutes after midnight on a Qt weekday (1 = Monday).
+    QString createWindows = R"(
+        CREATE TABLE IF NOT EXISTS study_windows (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            weekday INTEGER NOT NULL,
+            start_minute INTEGER NOT NULL,
+            end_minute INTEGER NOT NULL
+        )
+    )";
+
+    if (!query.exec(createWindows)) {
+        qDebug() << "Error creating study_windows table:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::createFlashcardTables()
+{
+    QSqlQuery query;
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS decks ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "title TEXT NOT NULL,"
+        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+        ")",
+        // SM-2 state lives on the card; due_day is when it next comes up.
+        "CREATE TABLE IF NOT EXISTS cards ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "deck_id INTEGER NOT NULL,"
+        "front TEXT NOT NULL,"
+        "back TEXT,"
+        "ease REAL NOT NULL DEFAULT 2.5,"
+        "interval_days INTEGER NOT NULL DEFAULT 0,"
+        "repetitions INTEGER NOT NULL DEFAULT 0,"
+        "lapses INTEGER NOT NULL DEFAULT 0,"
+        "due_day DATE NOT NULL,"
+        "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
+        ")",
+        // The due queue: range scans in due order, across or within decks.
+        "CREATE INDEX IF NOT EXISTS idx_cards_due ON cards (due_day, id)",
+        "CREATE INDEX IF NOT EXISTS idx_cards_deck_due ON cards (deck_id, due_day, id)",
+        "CREATE TABLE IF NOT EXISTS card_reviews ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "card_id INTEGER NOT NULL,"
+        "review_day DATE NOT NULL,"
+        "reviewed_at DATETIME NOT NULL,"
+        "quality INTEGER NOT NULL,"
+        "interval_days INTEGER NOT NULL"
+        ")",
+        "CREATE INDEX IF NOT EXISTS idx_card_reviews_day ON card_reviews (review_day)"
+    };
+
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            qDebug() << "Error creating flashcard tables:" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::createTagTables()
+{
+    QSqlQuery query;
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS tags ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "name TEXT NOT NULL UNIQUE COLLATE NOCASE"
+        ")",
+        "CREATE TABLE IF NOT EXISTS todo_tags ("
+        "todo_id INTEGER NOT NULL,"
+        "tag_id INTEGER NOT NULL,"
+        "PRIMARY KEY (todo_id, tag_id)"
+        ") WITHOUT ROWID",
+        "CREATE TABLE IF NOT EXISTS streak_tags ("
+        "streak_id INTEGER NOT NULL,"
+        "tag_id INTEGER NOT NULL,"
+        "PRIMARY KEY (streak_id, tag_id)"
+        ") WITHOUT ROWID",
+        // Deleting a tag drops its assignments by tag.
+        "CREATE INDEX IF NOT EXISTS idx_todo_tags_tag ON todo_tags (tag_id)",
+        "CREATE INDEX IF NOT EXISTS idx_streak_tags_tag ON streak_tags (tag_id)",
+        // Foreign keys are off, so deleted todos and streaks are cleaned up here.
+        "CREATE TRIGGER IF NOT EXISTS todo_tags_cleanup AFTER DELETE ON todos BEGIN "
+        "DELETE FROM todo_tags WHERE todo_id = OLD.id; END",
+        "CREATE TRIGGER IF NOT EXISTS streak_tags_cleanup AFTER DELETE ON streaks BEGIN "
+        "DELETE FROM streak_tags WHERE streak_id = OLD.id; END",
+        "CREATE TRIGGER IF NOT EXISTS tags_cleanup AFTER DELETE ON tags BEGIN "
+        "DELETE FROM todo_tags WHERE tag_id = OLD.id; "
+        "DELETE FROM streak_tags WHERE tag_id = OLD.id; END"
+    };
+
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            qDebug() << "Error creating tag tables:" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::createSearchIndex()
+{
+    QSqlQuery query;
+    query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'todos_fts'");
+    const bool existed = query.next();
+
+    // External-content FTS5 index: the text stays in todos, the index holds
+    // only tokens. Prefix indexes keep short "as you type" prefixes fast.
+    const QStringList statements = {
+        "CREATE VIRTUAL TABLE IF NOT EXISTS todos_fts USING fts5("
+        "title, description, content='todos', content_rowid='id', "
+        "tokenize='unicode61 remove_diacritics 2', prefix='2 3')",
+        "CREATE TRIGGER IF NOT EXISTS todos_fts_insert AFTER INSERT ON todos BEGIN "
+        "INSERT INTO todos_fts (rowid, title, description) VALUES (NEW.id, NEW.title, NEW.description); END",
+        "CREATE TRIGGER IF NOT EXISTS todos_fts_delete AFTER DELETE ON todos BEGIN "
+        "INSERT INTO todos_fts (todos_fts, rowid, title, description) "
+        "VALUES ('delete', OLD.id, OLD.title, OLD.description); END",
+        "CREATE TRIGGER IF NOT EXISTS todos_fts_update AFTER UPDATE OF title, description ON todos BEGIN "
+        "INSERT INTO todos_fts (todos_fts, rowid, title, description) "
+        "VALUES ('delete', OLD.id, OLD.title, OLD.description); "
+        "INSERT INTO todos_fts (rowid, title, description) VALUES (NEW.id, NEW.title, NEW.description); END"
+    };
+
+    for (const QString &statement : statements) {
+        if (!query.exec(statement)) {
+            qDebug() << "Error creating todo search index:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // First run on an existing database: index the todos already there.
+    if (!existed && !query.exec("INSERT INTO todos_fts (todos_fts) VALUES ('rebuild')")) {
+        qDebug() << "Error building todo search index:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
@@ -7,6 +7,9 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
+#include <QDate>
+#include <QVector>
+#include <QMap>
 
 class DatabaseManager : public QObject
 {
@@ -17,18 +20,42 @@ public:
 
     bool openDatabase();
     bool createTables();
+    bool createSearchIndex();
     QSqlDatabase database() const;
 
     Q_INVOKABLE bool createStreaksTable();
     Q_INVOKABLE bool saveStreak(const QString &title, int streakDuration, int bestStreak, const QDateTime &lastActivity);
     Q_INVOKABLE QVector<QVariantMap> loadAllStreaks();
+    QVariantMap loadStreak(int id);
+
+    bool createSyncTables();
     Q_INVOKABLE bool updateStreak(int id, const QString &title, int streakDuration, int bestStreak, const QDateTime &lastActivity);
     Q_INVOKABLE bool deleteStreak(int id);
+    bool recordStreakCheckin(int streakId, const QDate &day, bool *inserted = nullptr);
+    QVector<QDate> loadStreakCheckins(int streakId);
+
+    bool createSessionsTable();
+    bool insertPomodoroSession(const QString &kind, const QDateTime &startedAt, qint64 durationMs,
+                               int plannedSeconds, const QString &endReason);
+    qint64 studiedMs(const QDate &from, const QDate &to);
+    QMap<QDate, qint64> studiedMsPerDay(const QDate &from, const QDate &to);
+
+    bool createRollupTables();
+    bool recordTodoCompletion(int todoId, const QDateTime &completedAt);
+    QDate removeTodoCompletion(int todoId);
+
+    bool createPlannerTables();
+    bool createFlashcardTables();
+    bool createTagTables();
 
 private:
     explicit DatabaseManager(QObject *parent = nullptr);
     QSqlDatabase m_database;
 
+    bool createChangeLogTable();
+    bool createChangeTriggers(const QString &table, const QString &idColumn);
+    bool addColumnIfMissing(const QString &table, const QString &column, const QString &declaration);
+
 
 
 
@@ -0,0 +1,130 @@
+#include "databasewatcher.h"
+#include "../clock/clock.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// Entries kept in change_log for instances that poll less often than us.
+const qint64 kRetainedChanges = 10000;
+
+} // namespace
+
+DatabaseWatcher::DatabaseWatcher(QObject *parent)
+    : QObject(parent),
+    m_timer(Clock::instance()->createTimer(this)),
+    m_dataVersion(readDataVersion()),
+    m_lastSequence(readMaxSequence())
+{
+    connect(m_timer, &ClockTimer::timeout, this, &DatabaseWatcher::poll);
+    m_timer->start(1000);
+
+    // Our own writes are logged too; trim the backlog once per start-up.
+    QSqlQuery minQuery("SELECT COALESCE(MIN(seq), 0) FROM change_log");
+    if (minQuery.next() && m_lastSequence - minQuery.value(0).toLongLong() > 2 * kRetainedChanges) {
+        pruneChangeLog();
+    }
+}
+
+void DatabaseWatcher::setInterval(int msec)
+{
+    m_timer->setInterval(msec);
+}
+
+qint64 DatabaseWatcher::lastSequence() const
+{
+    return m_lastSequence;
+}
+
+void DatabaseWatcher::poll()
+{
+    const qint64 version = readDataVersion();
+    if (version == m_dataVersion) {
+        return;
+    }
+    m_dataVersion = version;
+
+    // Another instance pruned entries we never saw; incremental apply is unsafe.
+    QSqlQuery minQuery("SELECT COALESCE(MIN(seq), 0) FROM change_log");
+    const qint64 oldestSequence = minQuery.next() ? minQuery.value(0).toLongLong() : 0;
+    if (oldestSequence > m_lastSequence + 1) {
+        m_lastSequence = readMaxSequence();
+        emit resyncRequired();
+        return;
+    }
+
+    QSqlQuery query;
+    query.prepare("SELECT table_name, row_id, MAX(seq) FROM change_log "
+                  "WHERE seq > :seq GROUP BY table_name, row_id");
+    query.bindValue(":seq", m_lastSequence);
+
+    if (!query.exec()) {
+        qDebug() << "Error reading change log:" << query.lastError().text();
+        return;
+    }
+
+    bool listsChanged = false;
+    QVector<int> todoIds;
+    QVector<int> streakIds;
+    QVector<int> checkinStreakIds;
+
+    while (query.next()) {
+        const QString table = query.value(0).toString();
+        const int rowId = query.value(1).toInt();
+        m_lastSequence = std::max(m_lastSequence, query.value(2).toLongLong());
+
+        if (table == "todo_lists") {
+            listsChanged = true;
+        } else if (table == "todos") {
+            todoIds.append(rowId);
+        } else if (table == "streaks") {
+            streakIds.append(rowId);
+        } else if (table == "streak_checkins") {
+            checkinStreakIds.append(rowId);
+        }
+    }
+
+    if (listsChanged) {
+        emit todoListsChanged();
+    }
+    if (!todoIds.isEmpty()) {
+        emit todosChanged(todoIds);
+    }
+    if (!streakIds.isEmpty()) {
+        emit streaksChanged(streakIds);
+    }
+    if (!checkinStreakIds.isEmpty()) {
+        emit streakCheckinsChanged(checkinStreakIds);
+    }
+
+    // Prune in large batches only: each delete is a commit that wakes
+    // every other watcher.
+    if (oldestSequence > 0 && m_lastSequence - oldestSequence > 2 * kRetainedChanges) {
+        pruneChangeLog();
+    }
+}
+
+qint64 DatabaseWatcher::readDataVersion() const
+{
+    QSqlQuery query("PRAGMA data_version");
+    return query.next() ? query.value(0).toLongLong() : -1;
+}
+
+qint64 DatabaseWatcher::readMaxSequence() const
+{
+    QSqlQuery query("SELECT COALESCE(MAX(seq), 0) FROM change_log");
+    return query.next() ? query.value(0).toLongLong() : 0;
+}
+
+void DatabaseWatcher::pruneChangeLog()
+{
+    QSqlQuery query;
+    query.prepare("DELETE FROM change_log WHERE seq <= :cutoff");
+    query.bindValue(":cutoff", m_lastSequence - kRetainedChanges);
+    if (!query.exec()) {
+        qDebug() << "Error pruning change log:" << query.lastError().text();
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef DATABASEWATCHER_H
+#define DATABASEWATCHER_H
+
+#include <QObject>
+#include <QVector>
+
+class ClockTimer;
+
+// Notices commits made to the database by other connections (a second app
+// instance, a script) and reports which rows they touched.
+//
+// Polling PRAGMA data_version is a single page read and only changes when
+// another connection commits; the row ids then come from change_log, which
+// is filled by triggers created in DatabaseManager.
+class DatabaseWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseWatcher(QObject *parent = nullptr);
+
+    void setInterval(int msec);
+    qint64 lastSequence() const;
+
+public slots:
+    void poll();
+
+signals:
+    void todoListsChanged();
+    void todosChanged(const QVector<int> &ids);
+    void streaksChanged(const QVector<int> &ids);
+    void streakCheckinsChanged(const QVector<int> &streakIds);
+    void resyncRequired();
+
+private:
+    ClockTimer *m_timer;
+    qint64 m_dataVersion;
+    qint64 m_lastSequence;
+
+    qint64 readDataVersion() const;
+    qint64 readMaxSequence() const;
+    void pruneChangeLog();
+};
+
+#endif // DATABASEWATCHER_H
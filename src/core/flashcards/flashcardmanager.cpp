@@ -0,0 +1,359 @@
+#include "flashcardmanager.h"
+#include "../clock/clock.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+// Cards fetched per queue refill.
+const int kQueueBatch = 50;
+
+} // namespace
+
+FlashcardManager::FlashcardManager(QObject *parent)
+    : QObject(parent),
+    m_midnightTimer(Clock::instance()->createTimer(this)),
+    m_dueCount(0),
+    m_reviewedToday(0)
+{
+    DatabaseManager::instance().createFlashcardTables();
+
+    m_midnightTimer->setSingleShot(true);
+    m_midnightTimer->setTimerType(Qt::CoarseTimer);
+    connect(m_midnightTimer, &ClockTimer::timeout, this, &FlashcardManager::refreshDay);
+
+    refreshDay();
+}
+
+Sm2State FlashcardManager::schedule(const Sm2State &state, int quality)
+{
+    Sm2State next = state;
+
+    if (quality < 3) {
+        // Forgotten: start the repetitions over, ease unchanged.
+        next.repetitions = 0;
+        next.intervalDays = 1;
+        next.lapses++;
+        return next;
+    }
+
+    next.repetitions++;
+    if (next.repetitions == 1) {
+        next.intervalDays = 1;
+    } else if (next.repetitions == 2) {
+        next.intervalDays = 6;
+    } else {
+        next.intervalDays = int(std::lround(state.intervalDays * state.ease));
+    }
+
+    const int miss = 5 - quality;
+    next.ease = qMax(1.3, state.ease + 0.1 - miss * (0.08 + miss * 0.02));
+    return next;
+}
+
+int FlashcardManager::dueCount() const
+{
+    return m_dueCount;
+}
+
+int FlashcardManager::reviewedToday() const
+{
+    return m_reviewedToday;
+}
+
+QVariantMap FlashcardManager::currentCard() const
+{
+    return m_queue.isEmpty() ? QVariantMap() : m_queue.first();
+}
+
+int FlashcardManager::addDeck(const QString &title)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO decks (title) VALUES (:title)");
+    query.bindValue(":title", title);
+
+    if (!query.exec()) {
+        qDebug() << "Error adding deck:" << query.lastError().text();
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+bool FlashcardManager::removeDeck(int deckId)
+{
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+
+    QSqlQuery query;
+    query.prepare("DELETE FROM cards WHERE deck_id = :deck_id");
+    query.bindValue(":deck_id", deckId);
+    bool ok = query.exec();
+    if (ok) {
+        query.prepare("DELETE FROM decks WHERE id = :id");
+        query.bindValue(":id", deckId);
+        ok = query.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qDebug() << "Error removing deck:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    // Rare and possibly large: recount rather than track each card.
+    refreshDay();
+    return true;
+}
+
+QVariantList FlashcardManager::decks() const
+{
+    QVariantList list;
+    QSqlQuery query;
+    query.prepare("SELECT d.id, d.title, "
+                  "(SELECT COUNT(*) FROM cards c WHERE c.deck_id = d.id), "
+                  "(SELECT COUNT(*) FROM cards c WHERE c.deck_id = d.id AND c.due_day <= :today) "
+                  "FROM decks d ORDER BY d.title");
+    query.bindValue(":today", m_today.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qDebug() << "Error loading decks:" << query.lastError().text();
+        return list;
+    }
+
+    while (query.next()) {
+        QVariantMap deck;
+        deck["id"] = query.value(0).toInt();
+        deck["title"] = query.value(1).toString();
+        deck["cardCount"] = query.value(2).toInt();
+        deck["dueCount"] = query.value(3).toInt();
+        list.append(deck);
+    }
+    return list;
+}
+
+int FlashcardManager::addCard(int deckId, const QString &front, const QString &back)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO cards (deck_id, front, back, due_day) "
+                  "VALUES (:deck_id, :front, :back, :due_day)");
+    query.bindValue(":deck_id", deckId);
+    query.bindValue(":front", front);
+    query.bindValue(":back", back);
+    query.bindValue(":due_day", m_today.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qDebug() << "Error adding card:" << query.lastError().text();
+        return -1;
+    }
+
+    // New cards are due straight away.
+    const int id = query.lastInsertId().toInt();
+    setDueCount(m_dueCount + 1);
+    if (m_queue.size() < kQueueBatch) {
+        const bool wasEmpty = m_queue.isEmpty();
+        m_queue.append({{"id", id}, {"deckId", deckId}, {"front", front}, {"back", back}});
+        if (wasEmpty) {
+            emit currentCardChanged();
+        }
+    }
+    return id;
+}
+
+bool FlashcardManager::removeCard(int cardId)
+{
+    QSqlQuery query;
+    query.prepare("SELECT due_day FROM cards WHERE id = :id");
+    query.bindValue(":id", cardId);
+    if (!query.exec() || !query.next()) {
+        return false;
+    }
+    const QDate due = QDate::fromString(query.value(0).toString(), Qt::ISODate);
+
+    query.prepare("DELETE FROM cards WHERE id = :id");
+    query.bindValue(":id", cardId);
+    if (!query.exec()) {
+        qDebug() << "Error removing card:" << query.lastError().text();
+        return false;
+    }
+
+    if (due <= m_today) {
+        setDueCount(m_dueCount - 1);
+    }
+    for (int i = 0; i < m_queue.size(); i++) {
+        if (m_queue.at(i).value("id").toInt() == cardId) {
+            m_queue.removeAt(i);
+            if (i == 0) {
+                refillQueue();
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+QVariantList FlashcardManager::dueCards(int limit, int deckId) const
+{
+    QVariantList list;
+    QSqlQuery query;
+    if (deckId < 0) {
+        query.prepare("SELECT id, deck_id, front, back FROM cards "
+                      "WHERE due_day <= :today ORDER BY due_day, id LIMIT :limit");
+    } else {
+        query.prepare("SELECT id, deck_id, front, back FROM cards "
+                      "WHERE deck_id = :deck_id AND due_day <= :today ORDER BY due_day, id LIMIT :limit");
+        query.bindValue(":deck_id", deckId);
+    }
+    query.bindValue(":today", m_today.toString(Qt::ISODate));
+    query.bindValue(":limit", limit);
+
+    if (!query.exec()) {
+        qDebug() << "Error loading due cards:" << query.lastError().text();
+        return list;
+    }
+
+    while (query.next()) {
+        QVariantMap card;
+        card["id"] = query.value(0).toInt();
+        card["deckId"] = query.value(1).toInt();
+        card["front"] = query.value(2).toString();
+        card["back"] = query.value(3).toString();
+        list.append(card);
+    }
+    return list;
+}
+
+bool FlashcardManager::answer(int quality)
+{
+    if (m_queue.isEmpty()) {
+        return false;
+    }
+    return answerCard(m_queue.first().value("id").toInt(), quality);
+}
+
+bool FlashcardManager::answerCard(int cardId, int quality)
+{
+    if (quality < 0 || quality > 5) {
+        return false;
+    }
+    if (Clock::instance()->today() != m_today) {
+        refreshDay();
+    }
+
+    QSqlQuery query;
+    query.prepare("SELECT ease, interval_days, repetitions, lapses, due_day FROM cards WHERE id = :id");
+    query.bindValue(":id", cardId);
+    if (!query.exec() || !query.next()) {
+        qDebug() << "Error loading card" << cardId << ":" << query.lastError().text();
+        return false;
+    }
+
+    Sm2State state;
+    state.ease = query.value(0).toDouble();
+    state.intervalDays = query.value(1).toInt();
+    state.repetitions = query.value(2).toInt();
+    state.lapses = query.value(3).toInt();
+    const QDate previousDue = QDate::fromString(query.value(4).toString(), Qt::ISODate);
+
+    const Sm2State next = schedule(state, quality);
+    const QDateTime now = Clock::instance()->now();
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+
+    query.prepare("UPDATE cards SET ease = :ease, interval_days = :interval_days, "
+                  "repetitions = :repetitions, lapses = :lapses, due_day = :due_day WHERE id = :id");
+    query.bindValue(":ease", next.ease);
+    query.bindValue(":interval_days", next.intervalDays);
+    query.bindValue(":repetitions", next.repetitions);
+    query.bindValue(":lapses", next.lapses);
+    query.bindValue(":due_day", m_today.addDays(next.intervalDays).toString(Qt::ISODate));
+    query.bindValue(":id", cardId);
+    bool ok = query.exec();
+
+    if (ok) {
+        query.prepare("INSERT INTO card_reviews (card_id, review_day, reviewed_at, quality, interval_days) "
+                      "VALUES (:card_id, :review_day, :reviewed_at, :quality, :interval_days)");
+        query.bindValue(":card_id", cardId);
+        query.bindValue(":review_day", m_today.toString(Qt::ISODate));
+        query.bindValue(":reviewed_at", now);
+        query.bindValue(":quality", quality);
+        query.bindValue(":interval_days", next.intervalDays);
+        ok = query.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qDebug() << "Error recording review:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    // Every interval is at least a day, so the card leaves today's queue.
+    if (previousDue <= m_today) {
+        setDueCount(m_dueCount - 1);
+    }
+    for (int i = 0; i < m_queue.size(); i++) {
+        if (m_queue.at(i).value("id").toInt() == cardId) {
+            m_queue.removeAt(i);
+            if (i == 0) {
+                refillQueue();
+            }
+            break;
+        }
+    }
+
+    m_reviewedToday++;
+    emit reviewedTodayChanged();
+    emit cardReviewed(cardId, quality, m_today);
+    if (m_reviewedToday == 1) {
+        emit studiedOn(m_today);
+    }
+    return true;
+}
+
+void FlashcardManager::refreshDay()
+{
+    m_today = Clock::instance()->today();
+
+    QSqlQuery query;
+    query.prepare("SELECT COUNT(*) FROM cards WHERE due_day <= :today");
+    query.bindValue(":today", m_today.toString(Qt::ISODate));
+    if (query.exec() && query.next()) {
+        setDueCount(query.value(0).toInt());
+    }
+
+    query.prepare("SELECT COUNT(*) FROM card_reviews WHERE review_day = :today");
+    query.bindValue(":today", m_today.toString(Qt::ISODate));
+    if (query.exec() && query.next() && query.value(0).toInt() != m_reviewedToday) {
+        m_reviewedToday = query.value(0).toInt();
+        emit reviewedTodayChanged();
+    }
+
+    m_queue.clear();
+    refillQueue();
+
+    const QDateTime now = Clock::instance()->now();
+    m_midnightTimer->start(int(now.msecsTo(m_today.addDays(1).startOfDay())));
+}
+
+void FlashcardManager::refillQueue()
+{
+    if (m_queue.isEmpty()) {
+        const QVariantList cards = dueCards(kQueueBatch);
+        for (const QVariant &card : cards) {
+            m_queue.append(card.toMap());
+        }
+    }
+    emit currentCardChanged();
+}
+
+void FlashcardManager::setDueCount(int count)
+{
+    if (m_dueCount != count) {
+        m_dueCount = count;
+        emit dueCountChanged();
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef FLASHCARDMANAGER_H
+#define FLASHCARDMANAGER_H
+
+#include <QObject>
+#include <QDate>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QVector>
+
+class ClockTimer;
+
+// SM-2 scheduling state of one card.
+struct Sm2State
+{
+    double ease = 2.5;
+    int intervalDays = 0;
+    int repetitions = 0;
+    int lapses = 0;
+};
+
+// Decks of question/answer cards reviewed on an SM-2 schedule.
+//
+// Every card carries its next due day, and (due_day, id) is indexed, so
+// the review queue is a range scan that stops after one batch no matter
+// how many cards exist. Answering touches one card by primary key and
+// appends one review row. The due and reviewed-today counters are counted
+// once per day and then kept up to date by each mutation.
+class FlashcardManager : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int dueCount READ dueCount NOTIFY dueCountChanged)
+    Q_PROPERTY(int reviewedToday READ reviewedToday NOTIFY reviewedTodayChanged)
+    Q_PROPERTY(QVariantMap currentCard READ currentCard NOTIFY currentCardChanged)
+
+public:
+    explicit FlashcardManager(QObject *parent = nullptr);
+
+    // quality is the SM-2 grade: 0 (blackout) to 5 (perfect recall).
+    static Sm2State schedule(const Sm2State &state, int quality);
+
+    int dueCount() const;
+    int reviewedToday() const;
+    // The card at the head of today's queue, or an empty map.
+    QVariantMap currentCard() const;
+
+    Q_INVOKABLE int addDeck(const QString &title);
+    Q_INVOKABLE bool removeDeck(int deckId);
+    Q_INVOKABLE QVariantList decks() const;
+
+    Q_INVOKABLE int addCard(int deckId, const QString &front, const QString &back);
+    Q_INVOKABLE bool removeCard(int cardId);
+    Q_INVOKABLE QVariantList dueCards(int limit = 50, int deckId = -1) const;
+
+    Q_INVOKABLE bool answer(int quality);
+    Q_INVOKABLE bool answerCard(int cardId, int quality);
+
+signals:
+    void dueCountChanged();
+    void reviewedTodayChanged();
+    void currentCardChanged();
+    void cardReviewed(int cardId, int quality, const QDate &day);
+    // The first card of the day was answered.
+    void studiedOn(const QDate &day);
+
+private slots:
+    void refreshDay();
+
+private:
+    ClockTimer *m_midnightTimer;
+    QDate m_today;
+    int m_dueCount;
+    int m_reviewedToday;
+    QVector<QVariantMap> m_queue;   // prefetched head of the due queue
+
+    void refillQueue();
+    void setDueCount(int count);
+};
+
+#endif // FLASHCARDMANAGER_H
@@ -0,0 +1,184 @@
+#include "indexedheap.h"
+
+#include <algorithm>
+
+void IndexedHeap::assign(const QVector<Item> &items)
+{
+    clear();
+    m_items.reserve(items.size());
+    m_slots.reserve(items.size());
+    for (const Item &item : items) {
+        const auto existing = m_slots.constFind(item.key);
+        if (existing != m_slots.constEnd()) {
+            m_items[*existing].priority = item.priority;
+            continue;
+        }
+        place(int(m_items.size()), item);
+    }
+
+    // Floyd's bottom-up build
+    for (int slot = int(m_items.size()) / 2 - 1; slot >= 0; slot--) {
+        siftDown(slot);
+    }
+}
+
+void IndexedHeap::clear()
+{
+    m_items.clear();
+    m_slots.clear();
+}
+
+void IndexedHeap::set(quint64 key, qint64 priority)
+{
+    const auto existing = m_slots.constFind(key);
+    if (existing == m_slots.constEnd()) {
+        const int slot = int(m_items.size());
+        place(slot, {key, priority});
+        siftUp(slot);
+        return;
+    }
+
+    const int slot = *existing;
+    const qint64 old = m_items[slot].priority;
+    m_items[slot].priority = priority;
+    if (priority > old) {
+        siftUp(slot);
+    } else if (priority < old) {
+        siftDown(slot);
+    }
+}
+
+bool IndexedHeap::remove(quint64 key)
+{
+    const auto existing = m_slots.constFind(key);
+    if (existing == m_slots.constEnd()) {
+        return false;
+    }
+
+    const int slot = *existing;
+    const int last = int(m_items.size()) - 1;
+    swapSlots(slot, last);
+    m_items.pop_back();
+    m_slots.remove(key);
+
+    // The item moved into the hole may belong higher or lower
+    if (slot < last) {
+        siftUp(slot);
+        siftDown(slot);
+    }
+    return true;
+}
+
+bool IndexedHeap::contains(quint64 key) const
+{
+    return m_slots.contains(key);
+}
+
+qint64 IndexedHeap::priority(quint64 key, qint64 fallback) const
+{
+    const auto existing = m_slots.constFind(key);
+    return existing == m_slots.constEnd() ? fallback : m_items[*existing].priority;
+}
+
+int IndexedHeap::size() const
+{
+    return int(m_items.size());
+}
+
+bool IndexedHeap::isEmpty() const
+{
+    return m_items.empty();
+}
+
+quint64 IndexedHeap::topKey() const
+{
+    return m_items.front().key;
+}
+
+qint64 IndexedHeap::topPriority() const
+{
+    return m_items.front().priority;
+}
+
+QVector<quint64> IndexedHeap::top(int count) const
+{
+    QVector<quint64> keys;
+    if (count <= 0 || m_items.empty()) {
+        return keys;
+    }
+    keys.reserve(count);
+
+    // Best-first walk: the next best is always a child of one already
+    // taken, so only the frontier of candidates is kept ordered.
+    const auto worse = [this](int a, int b) { return above(b, a); };
+    std::vector<int> frontier{0};
+    while (!frontier.empty() && keys.size() < count) {
+        std::pop_heap(frontier.begin(), frontier.end(), worse);
+        const int slot = frontier.back();
+        frontier.pop_back();
+        keys.append(m_items[slot].key);
+
+        for (int child = 2 * slot + 1; child <= 2 * slot + 2 && child < int(m_items.size()); child++) {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), worse);
+        }
+    }
+    return keys;
+}
+
+bool IndexedHeap::above(int a, int b) const
+{
+    const Item &x = m_items[a];
+    const Item &y = m_items[b];
+    return x.priority != y.priority ? x.priority > y.priority : x.key < y.key;
+}
+
+void IndexedHeap::place(int slot, const Item &item)
+{
+    if (slot == int(m_items.size())) {
+        m_items.push_back(item);
+    } else {
+        m_items[slot] = item;
+    }
+    m_slots.insert(item.key, slot);
+}
+
+void IndexedHeap::swapSlots(int a, int b)
+{
+    if (a == b) {
+        return;
+    }
+    std::swap(m_items[a], m_items[b]);
+    m_slots[m_items[a].key] = a;
+    m_slots[m_items[b].key] = b;
+}
+
+void IndexedHeap::siftUp(int slot)
+{
+    while (slot > 0) {
+        const int parent = (slot - 1) / 2;
+        if (!above(slot, parent)) {
+            break;
+        }
+        swapSlots(slot, parent);
+        slot = parent;
+    }
+}
+
+void IndexedHeap::siftDown(int slot)
+{
+    const int size = int(m_items.size());
+    for (;;) {
+        int best = slot;
+        for (int child = 2 * slot + 1; child <= 2 * slot + 2 && child < size; child++) {
+            if (above(child, best)) {
+                best = child;
+            }
+        }
+        if (best == slot) {
+            return;
+        }
+        swapSlots(slot, best);
+        slot = best;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <QHash>
+#include <QVector>
+
+#include <vector>
+
+// Binary max-heap of caller-chosen 64-bit keys with a key -> slot index,
+// so a key's priority can be changed, or the key removed, in O(log n)
+// without searching for it. Equal priorities go to the smaller key.
+// Negate priorities for a min-heap.
+class IndexedHeap
+{
+public:
+    struct Item {
+        quint64 key;
+        qint64 priority;
+    };
+
+    // Replaces the contents, heapifying in O(n).
+    void assign(const QVector<Item> &items);
+    void clear();
+
+    // Inserts key, or moves it to its new priority.
+    void set(quint64 key, qint64 priority);
+    bool remove(quint64 key);
+    bool contains(quint64 key) const;
+    qint64 priority(quint64 key, qint64 fallback = 0) const;
+    int size() const;
+    bool isEmpty() const;
+
+    // Highest first. Undefined when empty.
+    quint64 topKey() const;
+    qint64 topPriority() const;
+    // The count highest keys, best first, in O(count log count) whatever
+    // the size of the heap, which is left as it is.
+    QVector<quint64> top(int count) const;
+
+private:
+    bool above(int a, int b) const;
+    void place(int slot, const Item &item);
+    void swapSlots(int a, int b);
+    void siftUp(int slot);
+    void siftDown(int slot);
+
+    std::vector<Item> m_items;
+    QHash<quint64, int> m_slots;
+};
+
+#endif // INDEXEDHEAP_H
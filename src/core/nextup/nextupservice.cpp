@@ -0,0 +1,309 @@
+#include "nextupservice.h"
+#include "../clock/clock.h"
+#include "../todo/todomanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+
+// Re-check at least this often so wall-clock jumps and suspend are noticed.
+const qint64 kMaxSleepMs = 3600 * 1000;
+
+const qint64 kDayMs = 24 * 3600 * 1000;
+const qint64 kWeekMs = 7 * kDayMs;
+
+const int kPointsPerPriority = 10;
+const int kPointsPerWeekOpen = 2;
+const int kMaxWeeksOpen = 4;
+
+// How many todos the "Next up" cards show
+const int kTopItems = 3;
+
+// Urgency steps by how far ahead of the due date they start, in rising order
+struct UrgencyStep {
+    qint64 leadMs;
+    int points;
+};
+const UrgencyStep kUrgencySteps[] = {
+    {7 * kDayMs, 10},
+    {3 * kDayMs, 20},
+    {kDayMs, 30},
+    {0, 40}     // overdue
+};
+
+} // namespace
+
+NextUpService::NextUpService(todoManager *todos, QObject *parent)
+    : QObject(parent),
+    m_todos(todos),
+    m_timer(Clock::instance()->createTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &ClockTimer::timeout, this, &NextUpService::onWakeup);
+
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &NextUpService::onTodoRowsChanged);
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (!parent.isValid()) {
+                    onTodoRowsChanged(m_todos->index(first, 0), m_todos->index(last, 0));
+                }
+            });
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &NextUpService::onTodoRowsRemoved);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, &NextUpService::rebuild);
+
+    rebuild();
+}
+
+QVariantList NextUpService::top(int count) const
+{
+    const QDateTime now = Clock::instance()->now();
+    QVariantList result;
+    for (quint64 key : m_ranking.top(count)) {
+        const int id = int(key);
+        const Entry entry = m_entries.value(id);
+        QVariantMap item;
+        item["todoId"] = id;
+        item["title"] = entry.title;
+        item["dueDate"] = entry.due;
+        item["priority"] = entry.priority;
+        item["score"] = int(m_ranking.priority(key));
+        item["reason"] = reason(entry, now);
+        result.append(item);
+    }
+    return result;
+}
+
+int NextUpService::scoreOf(int todoId) const
+{
+    return int(m_ranking.priority(quint64(todoId), -1));
+}
+
+int NextUpService::openCount() const
+{
+    return m_ranking.size();
+}
+
+QVariantList NextUpService::topItems() const
+{
+    return top(kTopItems);
+}
+
+int NextUpService::score(int priority, const QDateTime &due, const QDateTime &created,
+                         const QDateTime &now, QDateTime *nextChange)
+{
+    const qint64 nowMs = now.toMSecsSinceEpoch();
+    qint64 next = -1;
+    const auto consider = [nowMs, &next](qint64 atMs) {
+        if (atMs > nowMs && (next < 0 || atMs < next)) {
+            next = atMs;
+        }
+    };
+
+    int points = kPointsPerPriority * (qBound(0, priority, 2) + 1);
+
+    if (due.isValid()) {
+        const qint64 dueMs = due.toMSecsSinceEpoch();
+        int urgency = 0;
+        for (const UrgencyStep &step : kUrgencySteps) {
+            if (nowMs >= dueMs - step.leadMs) {
+                urgency = step.points;
+            } else {
+                consider(dueMs - step.leadMs);
+            }
+        }
+        points += urgency;
+    }
+
+    if (created.isValid()) {
+        const qint64 createdMs = created.toMSecsSinceEpoch();
+        const qint64 weeks = qBound<qint64>(0, (nowMs - createdMs) / kWeekMs, kMaxWeeksOpen);
+        points += int(weeks) * kPointsPerWeekOpen;
+        if (weeks < kMaxWeeksOpen) {
+            consider(createdMs + (weeks + 1) * kWeekMs);
+        }
+    }
+
+    if (nextChange) {
+        *nextChange = next < 0 ? QDateTime() : QDateTime::fromMSecsSinceEpoch(next);
+    }
+    return points;
+}
+
+bool NextUpService::rebuild()
+{
+    const QDateTime now = Clock::instance()->now();
+    m_entries.clear();
+
+    QSqlQuery query;
+    if (!query.exec("SELECT id, title, priority, due_date, strftime('%s', created_date) FROM todos "
+                    "WHERE completed = 0 AND parent_id IS NULL")) {
+        qDebug() << "Error loading next-up todos:" << query.lastError().text();
+        m_ranking.clear();
+        m_changes.clear();
+        arm();
+        changed();
+        return false;
+    }
+
+    // Heapified in one go rather than inserted one by one
+    QVector<IndexedHeap::Item> ranking;
+    QVector<IndexedHeap::Item> changes;
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        const Entry entry{query.value(1).toString(), query.value(2).toInt(), query.value(3).toDateTime(),
+                          query.value(4).isNull() ? now : QDateTime::fromSecsSinceEpoch(query.value(4).toLongLong())};
+        m_entries.insert(id, entry);
+
+        QDateTime next;
+        ranking.append({quint64(id), score(entry.priority, entry.due, entry.created, now, &next)});
+        if (next.isValid()) {
+            changes.append({quint64(id), -next.toMSecsSinceEpoch()});
+        }
+    }
+    m_ranking.assign(ranking);
+    m_changes.assign(changes);
+
+    arm();
+    changed();
+    return true;
+}
+
+void NextUpService::onWakeup()
+{
+    const QDateTime now = Clock::instance()->now();
+    const qint64 nowMs = now.toMSecsSinceEpoch();
+
+    bool rescored = false;
+    while (!m_changes.isEmpty() && -m_changes.topPriority() <= nowMs) {
+        rescore(int(m_changes.topKey()), now);
+        rescored = true;
+    }
+
+    arm();
+    if (rescored) {
+        changed();
+    }
+}
+
+void NextUpService::onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                      const QList<int> &roles)
+{
+    // Reordering, estimates and the like don't move anything
+    static const QList<int> scoredRoles = {todoManager::TitleRole, todoManager::PriorityRole,
+                                           todoManager::DueDateRole, todoManager::CompletedRole};
+    if (!roles.isEmpty() && std::none_of(roles.begin(), roles.end(),
+                                         [](int role) { return scoredRoles.contains(role); })) {
+        return;
+    }
+
+    const QDateTime now = Clock::instance()->now();
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        const int id = index.data(todoManager::IdRole).toInt();
+        if (index.data(todoManager::CompletedRole).toBool()) {
+            drop(id);
+            continue;
+        }
+
+        auto entry = m_entries.find(id);
+        if (entry == m_entries.end()) {
+            entry = m_entries.insert(id, {QString(), 0, QDateTime(), createdAt(id)});
+        }
+        entry->title = index.data(todoManager::TitleRole).toString();
+        entry->priority = index.data(todoManager::PriorityRole).toInt();
+        entry->due = index.data(todoManager::DueDateRole).toDateTime();
+        rescore(id, now);
+    }
+    arm();
+    changed();
+}
+
+void NextUpService::onTodoRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        drop(m_todos->index(row, 0).data(todoManager::IdRole).toInt());
+    }
+    arm();
+    changed();
+}
+
+void NextUpService::rescore(int id, const QDateTime &now)
+{
+    const Entry &entry = m_entries[id];
+    QDateTime next;
+    m_ranking.set(quint64(id), score(entry.priority, entry.due, entry.created, now, &next));
+    if (next.isValid()) {
+        m_changes.set(quint64(id), -next.toMSecsSinceEpoch());
+    } else {
+        m_changes.remove(quint64(id));
+    }
+}
+
+void NextUpService::drop(int id)
+{
+    m_entries.remove(id);
+    m_ranking.remove(quint64(id));
+    m_changes.remove(quint64(id));
+}
+
+QDateTime NextUpService::createdAt(int id) const
+{
+    // created_date is stored in UTC by SQLite's CURRENT_TIMESTAMP
+    QSqlQuery query;
+    query.prepare("SELECT strftime('%s', created_date) FROM todos WHERE id = :id");
+    query.bindValue(":id", id);
+    if (!query.exec() || !query.next() || query.value(0).isNull()) {
+        return Clock::instance()->now();
+    }
+    return QDateTime::fromSecsSinceEpoch(query.value(0).toLongLong());
+}
+
+QString NextUpService::reason(const Entry &entry, const QDateTime &now)
+{
+    if (entry.due.isValid()) {
+        const qint64 left = now.msecsTo(entry.due);
+        if (left <= 0) {
+            return "Overdue";
+        }
+        if (left < kDayMs) {
+            return "Due within a day";
+        }
+        if (left < 3 * kDayMs) {
+            return QString("Due in %1 days").arg((left + kDayMs - 1) / kDayMs);
+        }
+        if (left < kWeekMs) {
+            return "Due this week";
+        }
+    }
+    if (entry.priority >= 2) {
+        return "High priority";
+    }
+    const qint64 weeks = entry.created.isValid() ? entry.created.msecsTo(now) / kWeekMs : 0;
+    if (weeks >= 1) {
+        return weeks == 1 ? QString("Open for a week") : QString("Open for %1 weeks").arg(weeks);
+    }
+    return "Next in line";
+}
+
+void NextUpService::arm()
+{
+    m_timer->stop();
+    if (m_changes.isEmpty()) {
+        return;
+    }
+    const qint64 wait = -m_changes.topPriority() - Clock::instance()->now().toMSecsSinceEpoch();
+    m_timer->setTimerType(Qt::CoarseTimer);
+    m_timer->start(int(qBound<qint64>(0, wait, kMaxSleepMs)));
+}
+
+void NextUpService::changed()
+{
+    emit rankingChanged();
+}
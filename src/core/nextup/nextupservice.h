@@ -0,0 +1,80 @@
+#ifndef NEXTUPSERVICE_H
+#define NEXTUPSERVICE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QVariantList>
+
+#include "indexedheap.h"
+
+class ClockTimer;
+class todoManager;
+
+// "What should I work on now": open top-level todos ranked by priority,
+// how close their due date is and how long they have been waiting. The
+// score is a step function of time (a todo moves up when it comes within
+// a week, three days or a day of its due date, when it goes overdue and
+// for each week it stays open), so the ranking is an IndexedHeap that
+// only changes at those steps. A second heap holds every todo's next step,
+// and a single Clock timer re-scores just the todos whose step has come;
+// the todo model's row signals re-score just the rows that changed. Each
+// update is O(log n) and top() never walks the list.
+class NextUpService : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantList topItems READ topItems NOTIFY rankingChanged)
+    Q_PROPERTY(int openCount READ openCount NOTIFY rankingChanged)
+
+public:
+    explicit NextUpService(todoManager *todos, QObject *parent = nullptr);
+
+    // The best count open todos, best first, as maps with todoId, title,
+    // dueDate, priority, score and a short reason ("Overdue").
+    Q_INVOKABLE QVariantList top(int count = 3) const;
+    // -1 for todos that are not ranked (completed, unknown, subtasks).
+    Q_INVOKABLE int scoreOf(int todoId) const;
+    int openCount() const;
+    // The best three, as top() gives them; QML binds to this.
+    QVariantList topItems() const;
+
+    // Points for a todo at now; nextChange gets the next time they will be
+    // different, or an invalid time if they never will.
+    static int score(int priority, const QDateTime &due, const QDateTime &created,
+                     const QDateTime &now, QDateTime *nextChange = nullptr);
+
+public slots:
+    bool rebuild();
+
+signals:
+    void rankingChanged();
+
+private slots:
+    void onWakeup();
+    void onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                           const QList<int> &roles = QList<int>());
+    void onTodoRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    struct Entry {
+        QString title;
+        int priority;
+        QDateTime due;
+        QDateTime created;
+    };
+
+    todoManager *m_todos;
+    ClockTimer *m_timer;
+    QHash<int, Entry> m_entries;
+    IndexedHeap m_ranking;  // id -> score
+    IndexedHeap m_changes;  // id -> -(ms of its next score change), soonest on top
+
+    void rescore(int id, const QDateTime &now);
+    void drop(int id);
+    QDateTime createdAt(int id) const;
+    static QString reason(const Entry &entry, const QDateTime &now);
+    void arm();
+    void changed();
+};
+
+#endif // NEXTUPSERVICE_H
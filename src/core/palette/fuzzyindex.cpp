@@ -0,0 +1,251 @@
+#include "fuzzyindex.h"
+
+#include <algorithm>
+
+namespace {
+
+// Scoring weights, roughly those of the common fzf-style matchers.
+const int kMatchScore = 16;
+const int kFirstCharBoundaryBonus = 20;
+const int kBoundaryBonus = 10;
+const int kConsecutiveBonus = 8;
+const int kGapStartPenalty = 3;
+const int kMaxGapExtensionPenalty = 12;
+const int kMaxLeadingPenalty = 10;
+
+bool isBoundary(const QString &text, int pos)
+{
+    return pos == 0 || !text.at(pos - 1).isLetterOrNumber();
+}
+
+QString stripSpaces(const QString &text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (const QChar c : text) {
+        if (!c.isSpace()) {
+            out.append(c);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+void FuzzyIndex::upsert(quint64 key, const QString &text)
+{
+    const auto it = m_slots.constFind(key);
+    if (it != m_slots.constEnd()) {
+        const int slot = it.value();
+        if (m_texts.at(slot) == text) {
+            return;
+        }
+        const QString folded = fold(text);
+        m_texts[slot] = text;
+        m_folded[slot] = folded;
+        m_masks[slot] = charMask(folded);
+        return;
+    }
+
+    const QString folded = fold(text);
+    m_slots.insert(key, m_keys.size());
+    m_keys.append(key);
+    m_texts.append(text);
+    m_folded.append(folded);
+    m_masks.push_back(charMask(folded));
+}
+
+void FuzzyIndex::remove(quint64 key)
+{
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd()) {
+        return;
+    }
+    const int slot = it.value();
+    const int last = m_keys.size() - 1;
+    m_slots.erase(it);
+
+    if (slot != last) {
+        m_keys[slot] = m_keys.at(last);
+        m_texts[slot] = m_texts.at(last);
+        m_folded[slot] = m_folded.at(last);
+        m_masks[slot] = m_masks[last];
+        m_slots[m_keys.at(slot)] = slot;
+    }
+    m_keys.removeLast();
+    m_texts.removeLast();
+    m_folded.removeLast();
+    m_masks.pop_back();
+}
+
+void FuzzyIndex::clear()
+{
+    m_masks.clear();
+    m_keys.clear();
+    m_texts.clear();
+    m_folded.clear();
+    m_slots.clear();
+}
+
+int FuzzyIndex::size() const
+{
+    return m_keys.size();
+}
+
+bool FuzzyIndex::contains(quint64 key) const
+{
+    return m_slots.contains(key);
+}
+
+QString FuzzyIndex::text(quint64 key) const
+{
+    const auto it = m_slots.constFind(key);
+    return it == m_slots.constEnd() ? QString() : m_texts.at(it.value());
+}
+
+QVector<FuzzyIndex::Match> FuzzyIndex::search(const QString &query, int limit) const
+{
+    QVector<Match> matches;
+    const QString needle = stripSpaces(fold(query));
+    if (needle.isEmpty() || limit < 1) {
+        return matches;
+    }
+
+    // Prefilter: no branches or calls in the loop body, one byte out per entry.
+    const quint64 needleMask = charMask(needle);
+    const size_t n = m_masks.size();
+    const quint64 *masks = m_masks.data();
+    std::vector<quint8> candidate(n);
+    for (size_t i = 0; i < n; i++) {
+        candidate[i] = (masks[i] & needleMask) == needleMask;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (!candidate[i]) {
+            continue;
+        }
+        const int s = score(needle, m_folded.at(int(i)));
+        if (s >= 0) {
+            matches.append({m_keys.at(int(i)), s, {}});
+        }
+    }
+
+    // Higher score, then the shorter title, then insertion-independent key order.
+    const auto better = [this](const Match &a, const Match &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        const int lengthA = m_texts.at(m_slots.value(a.key)).size();
+        const int lengthB = m_texts.at(m_slots.value(b.key)).size();
+        if (lengthA != lengthB) {
+            return lengthA < lengthB;
+        }
+        return a.key < b.key;
+    };
+    const int kept = qMin(limit, int(matches.size()));
+    std::partial_sort(matches.begin(), matches.begin() + kept, matches.end(), better);
+    matches.resize(kept);
+
+    for (Match &match : matches) {
+        score(needle, m_folded.at(m_slots.value(match.key)), &match.positions);
+    }
+    return matches;
+}
+
+QString FuzzyIndex::fold(const QString &text)
+{
+    QString folded(text.size(), Qt::Uninitialized);
+    for (int i = 0; i < text.size(); i++) {
+        QChar c = text.at(i);
+        // "é" -> "e"; keeps one output character per input character
+        if (c.decompositionTag() == QChar::Canonical) {
+            const QString decomposed = c.decomposition();
+            if (!decomposed.isEmpty()) {
+                c = decomposed.at(0);
+            }
+        }
+        folded[i] = c.toCaseFolded();
+    }
+    return folded;
+}
+
+quint64 FuzzyIndex::charMask(const QString &folded)
+{
+    // Bits 0-25 letters, 26-35 digits, the rest a hash of anything else.
+    quint64 mask = 0;
+    for (const QChar c : folded) {
+        const char16_t u = c.unicode();
+        int bit;
+        if (u >= 'a' && u <= 'z') {
+            bit = u - 'a';
+        } else if (u >= '0' && u <= '9') {
+            bit = 26 + (u - '0');
+        } else if (c.isSpace()) {
+            continue;
+        } else {
+            bit = 36 + u % 28;
+        }
+        mask |= quint64(1) << bit;
+    }
+    return mask;
+}
+
+int FuzzyIndex::score(const QString &query, const QString &text, QVector<int> *positions)
+{
+    if (query.isEmpty() || query.size() > text.size()) {
+        return -1;
+    }
+
+    // Forward pass finds where the earliest complete match ends...
+    int q = 0;
+    int end = -1;
+    for (int i = 0; i < text.size(); i++) {
+        if (text.at(i) == query.at(q) && ++q == query.size()) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0) {
+        return -1;
+    }
+
+    // ...a backward pass from there finds the shortest window ending there...
+    QVector<int> matched(query.size());
+    q = query.size() - 1;
+    for (int i = end; q >= 0; i--) {
+        if (text.at(i) == query.at(q)) {
+            matched[q--] = i;
+        }
+    }
+
+    // ...and matching forward inside it keeps runs together ("eco" in "economie").
+    q = 0;
+    for (int i = matched.first(); q < query.size(); i++) {
+        if (text.at(i) == query.at(q)) {
+            matched[q++] = i;
+        }
+    }
+
+    int total = 0;
+    for (int k = 0; k < matched.size(); k++) {
+        const int pos = matched.at(k);
+        total += kMatchScore;
+        if (isBoundary(text, pos)) {
+            total += k == 0 ? kFirstCharBoundaryBonus : kBoundaryBonus;
+        }
+        if (k > 0) {
+            const int gap = pos - matched.at(k - 1) - 1;
+            if (gap == 0) {
+                total += kConsecutiveBonus;
+            } else {
+                total -= kGapStartPenalty + qMin(gap - 1, kMaxGapExtensionPenalty);
+            }
+        }
+    }
+    total -= qMin(matched.first(), kMaxLeadingPenalty);
+
+    if (positions) {
+        *positions = matched;
+    }
+    return qMax(total, 0);
+}
@@ -0,0 +1,49 @@
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+// In-memory fuzzy matcher for short titles. Each entry keeps a 64-bit mask
+// of the characters it contains in a flat array, so a query first rejects
+// every entry missing one of its characters with a branch-free AND/compare
+// pass the compiler can vectorise; only the survivors get the subsequence
+// scorer. Entries are keyed by the caller and can be added, renamed and
+// removed one at a time.
+class FuzzyIndex
+{
+public:
+    struct Match {
+        quint64 key;
+        int score;
+        QVector<int> positions;  // matched character offsets into the text
+    };
+
+    void upsert(quint64 key, const QString &text);
+    void remove(quint64 key);
+    void clear();
+    int size() const;
+    bool contains(quint64 key) const;
+    QString text(quint64 key) const;
+
+    // Best matches first; whitespace in the query is ignored.
+    QVector<Match> search(const QString &query, int limit) const;
+
+    // Case- and accent-folded copy with the same length as text.
+    static QString fold(const QString &text);
+    static quint64 charMask(const QString &folded);
+    // Score of folded query as a subsequence of folded text, or -1.
+    static int score(const QString &query, const QString &text, QVector<int> *positions = nullptr);
+
+private:
+    // Parallel arrays; removal swaps the last entry into the hole.
+    std::vector<quint64> m_masks;
+    QVector<quint64> m_keys;
+    QVector<QString> m_texts;
+    QVector<QString> m_folded;
+    QHash<quint64, int> m_slots;
+};
+
+#endif // FUZZYINDEX_H
@@ -0,0 +1,270 @@
+#include "quickswitcher.h"
+#include "../todo/todomanager.h"
+#include "../streaks/streaksmanager.h"
+
+namespace {
+
+QString highlight(const QString &title, const QVector<int> &positions)
+{
+    QString html;
+    int next = 0;
+    bool open = false;
+    for (int i = 0; i < title.size(); i++) {
+        const bool hit = next < positions.size() && positions.at(next) == i;
+        if (hit != open) {
+            html += hit ? "<b>" : "</b>";
+            open = hit;
+        }
+        if (hit) {
+            next++;
+        }
+        html += QString(title.at(i)).toHtmlEscaped();
+    }
+    if (open) {
+        html += "</b>";
+    }
+    return html;
+}
+
+} // namespace
+
+QuickSwitcher::QuickSwitcher(todoManager *todos, streaksManager *streaks, QObject *parent)
+    : QAbstractListModel(parent),
+    m_todos(todos),
+    m_streaks(streaks),
+    m_limit(20)
+{
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &QuickSwitcher::onTodoRowsChanged);
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (!parent.isValid()) {
+                    onTodoRowsChanged(m_todos->index(first, 0), m_todos->index(last, 0));
+                }
+            });
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QuickSwitcher::onTodoRowsRemoved);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, &QuickSwitcher::rebuild);
+
+    connect(m_streaks, &QAbstractItemModel::dataChanged, this, &QuickSwitcher::onStreakRowsChanged);
+    connect(m_streaks, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (!parent.isValid()) {
+                    onStreakRowsChanged(m_streaks->index(first, 0), m_streaks->index(last, 0));
+                }
+            });
+    connect(m_streaks, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QuickSwitcher::onStreakRowsRemoved);
+    connect(m_streaks, &QAbstractItemModel::modelReset, this, &QuickSwitcher::rebuild);
+
+    rebuild();
+}
+
+int QuickSwitcher::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_results.size();
+}
+
+QVariant QuickSwitcher::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_results.size())
+        return QVariant();
+
+    const Result &result = m_results.at(index.row());
+
+    switch (role) {
+    case KindRole:
+        return result.kind == TodoItemKind ? "todo" : result.kind == StreakItemKind ? "streak" : "command";
+    case ItemIdRole:
+        return result.kind == CommandKind ? -1 : result.id;
+    case CommandRole:
+        return result.kind == CommandKind ? m_commands.at(result.id) : QString();
+    case TitleRole:
+        return result.title;
+    case HighlightedTitleRole:
+        return result.highlightedTitle;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> QuickSwitcher::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[KindRole] = "kind";
+    roles[ItemIdRole] = "itemId";
+    roles[CommandRole] = "command";
+    roles[TitleRole] = "title";
+    roles[HighlightedTitleRole] = "highlightedTitle";
+    return roles;
+}
+
+QString QuickSwitcher::query() const
+{
+    return m_query;
+}
+
+void QuickSwitcher::setQuery(const QString &query)
+{
+    if (m_query == query) {
+        return;
+    }
+    m_query = query;
+    emit queryChanged();
+    refresh();
+}
+
+int QuickSwitcher::limit() const
+{
+    return m_limit;
+}
+
+void QuickSwitcher::setLimit(int limit)
+{
+    if (m_limit == limit || limit < 1) {
+        return;
+    }
+    m_limit = limit;
+    emit limitChanged();
+    refresh();
+}
+
+void QuickSwitcher::addCommand(const QString &command, const QString &title)
+{
+    int id = m_commands.indexOf(command);
+    if (id < 0) {
+        id = m_commands.size();
+        m_commands.append(command);
+        m_commandTitles.append(title);
+    } else {
+        m_commandTitles[id] = title;
+    }
+    m_index.upsert(keyFor(CommandKind, id), title);
+    refresh();
+}
+
+QVariantMap QuickSwitcher::get(int row) const
+{
+    QVariantMap item;
+    if (row < 0 || row >= m_results.size()) {
+        return item;
+    }
+
+    const Result &result = m_results.at(row);
+    const QModelIndex index = this->index(row, 0);
+    item["kind"] = data(index, KindRole);
+    item["itemId"] = data(index, ItemIdRole);
+    item["command"] = data(index, CommandRole);
+    item["title"] = result.title;
+
+    // Rows shift as items come and go, so look the row up at activation.
+    int modelRow = -1;
+    if (result.kind == TodoItemKind) {
+        for (int r = 0; r < m_todos->rowCount() && modelRow < 0; r++) {
+            if (m_todos->index(r, 0).data(todoManager::IdRole).toInt() == result.id) {
+                modelRow = r;
+            }
+        }
+    } else if (result.kind == StreakItemKind) {
+        for (int r = 0; r < m_streaks->rowCount() && modelRow < 0; r++) {
+            if (m_streaks->index(r, 0).data(streaksManager::IdRole).toInt() == result.id) {
+                modelRow = r;
+            }
+        }
+    }
+    item["row"] = modelRow;
+    return item;
+}
+
+void QuickSwitcher::refresh()
+{
+    QVector<Result> results;
+    const QVector<FuzzyIndex::Match> matches = m_index.search(m_query, m_limit);
+    results.reserve(matches.size());
+    for (const FuzzyIndex::Match &match : matches) {
+        const QString title = m_index.text(match.key);
+        results.append({Kind(match.key >> 32), int(quint32(match.key)), title,
+                        highlight(title, match.positions)});
+    }
+
+    const bool countChanging = results.size() != m_results.size();
+    beginResetModel();
+    m_results = results;
+    endResetModel();
+    if (countChanging) {
+        emit countChanged();
+    }
+}
+
+void QuickSwitcher::rebuild()
+{
+    m_index.clear();
+    for (int row = 0; row < m_todos->rowCount(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        m_index.upsert(keyFor(TodoItemKind, index.data(todoManager::IdRole).toInt()),
+                       index.data(todoManager::TitleRole).toString());
+    }
+    for (int row = 0; row < m_streaks->rowCount(); row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        m_index.upsert(keyFor(StreakItemKind, index.data(streaksManager::IdRole).toInt()),
+                       index.data(streaksManager::TitleRole).toString());
+    }
+    for (int id = 0; id < m_commands.size(); id++) {
+        m_index.upsert(keyFor(CommandKind, id), m_commandTitles.at(id));
+    }
+    refresh();
+}
+
+void QuickSwitcher::onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        m_index.upsert(keyFor(TodoItemKind, index.data(todoManager::IdRole).toInt()),
+                       index.data(todoManager::TitleRole).toString());
+    }
+    if (!m_query.isEmpty()) {
+        refresh();
+    }
+}
+
+void QuickSwitcher::onTodoRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        m_index.remove(keyFor(TodoItemKind, m_todos->index(row, 0).data(todoManager::IdRole).toInt()));
+    }
+    if (!m_query.isEmpty()) {
+        refresh();
+    }
+}
+
+void QuickSwitcher::onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        m_index.upsert(keyFor(StreakItemKind, index.data(streaksManager::IdRole).toInt()),
+                       index.data(streaksManager::TitleRole).toString());
+    }
+    if (!m_query.isEmpty()) {
+        refresh();
+    }
+}
+
+void QuickSwitcher::onStreakRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        m_index.remove(keyFor(StreakItemKind, m_streaks->index(row, 0).data(streaksManager::IdRole).toInt()));
+    }
+    if (!m_query.isEmpty()) {
+        refresh();
+    }
+}
+
+quint64 QuickSwitcher::keyFor(Kind kind, int id)
+{
+    return (quint64(kind) << 32) | quint64(quint32(id));
+}
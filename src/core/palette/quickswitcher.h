@@ -0,0 +1,87 @@
+#ifndef QUICKSWITCHER_H
+#define QUICKSWITCHER_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "fuzzyindex.h"
+
+class todoManager;
+class streaksManager;
+
+// Results model behind the Ctrl+K palette. Todo titles, streak titles and
+// registered commands share one FuzzyIndex that follows the todo and
+// streak models' row signals, so adding, renaming or removing an item
+// touches only that entry. Each query re-scores the index synchronously.
+class QuickSwitcher : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum SwitcherRoles {
+        KindRole = Qt::UserRole + 1,
+        ItemIdRole,
+        CommandRole,
+        TitleRole,
+        HighlightedTitleRole
+    };
+
+    explicit QuickSwitcher(todoManager *todos, streaksManager *streaks, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString query() const;
+    void setQuery(const QString &query);
+    int limit() const;
+    void setLimit(int limit);
+
+    // command is what the UI acts on, title what the user types against.
+    Q_INVOKABLE void addCommand(const QString &command, const QString &title);
+    // kind ("todo", "streak", "command"), itemId/command and the current
+    // model row of the todo or streak, for jumping to it.
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+public slots:
+    void refresh();
+    void rebuild();
+
+signals:
+    void queryChanged();
+    void limitChanged();
+    void countChanged();
+
+private slots:
+    void onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onTodoRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onStreakRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    enum Kind { TodoItemKind = 1, StreakItemKind = 2, CommandKind = 3 };
+
+    struct Result {
+        Kind kind;
+        int id;
+        QString title;
+        QString highlightedTitle;
+    };
+
+    static quint64 keyFor(Kind kind, int id);
+
+    todoManager *m_todos;
+    streaksManager *m_streaks;
+    FuzzyIndex m_index;
+    QStringList m_commands;
+    QStringList m_commandTitles;
+    QString m_query;
+    int m_limit;
+    QVector<Result> m_results;
+};
+
+#endif // QUICKSWITCHER_H
@@ -0,0 +1,181 @@
+#include "planengine.h"
+
+#include <algorithm>
+
+namespace {
+
+// Nothing is planned further out than this.
+const int kHorizonDays = 730;
+
+const int kClean = std::numeric_limits<int>::max();
+
+} // namespace
+
+PlanEngine::PlanEngine()
+    : m_workMs(25 * 60000),
+    m_breakMs(5 * 60000),
+    m_pomodoros(0),
+    m_nextFreeMs(0),
+    m_dirtyFrom(kClean)
+{
+}
+
+void PlanEngine::setTimeline(const QDateTime &from, const QVector<StudyWindow> &windows,
+                             int workMinutes, int breakMinutes)
+{
+    m_from = from;
+    m_windows = windows;
+    std::sort(m_windows.begin(), m_windows.end(), [](const StudyWindow &a, const StudyWindow &b) {
+        return a.weekday != b.weekday ? a.weekday < b.weekday : a.startMinute < b.startMinute;
+    });
+    m_workMs = qint64(qMax(1, workMinutes)) * 60000;
+    m_breakMs = qint64(qMax(0, breakMinutes)) * 60000;
+
+    m_slotStarts.clear();
+    m_nextDay = from.date();
+    m_nextFreeMs = from.toMSecsSinceEpoch();
+    m_plan.clear();
+    markDirty(0);
+}
+
+void PlanEngine::reset(const QVector<PlanTask> &tasks)
+{
+    m_tasks.clear();
+    m_order.clear();
+    m_pomodoros = 0;
+    for (const PlanTask &task : tasks) {
+        if (task.pomodoros > 0 && !m_tasks.contains(task.id)) {
+            m_tasks.insert(task.id, task);
+            m_order.append(task);
+            m_pomodoros += task.pomodoros;
+        }
+    }
+    std::sort(m_order.begin(), m_order.end(), before);
+    markDirty(0);
+}
+
+void PlanEngine::upsert(const PlanTask &task)
+{
+    auto it = m_tasks.find(task.id);
+    if (it != m_tasks.end()) {
+        if (*it == task) {
+            return;
+        }
+        const int position = positionOf(*it);
+        m_order.remove(position);
+        m_pomodoros -= it->pomodoros;
+        markDirty(position);
+        m_tasks.erase(it);
+    }
+
+    if (task.pomodoros <= 0) {
+        return;
+    }
+
+    const int position = positionOf(task);
+    m_order.insert(position, task);
+    m_tasks.insert(task.id, task);
+    m_pomodoros += task.pomodoros;
+    markDirty(position);
+}
+
+void PlanEngine::remove(int id)
+{
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end()) {
+        return;
+    }
+    const int position = positionOf(*it);
+    m_order.remove(position);
+    m_pomodoros -= it->pomodoros;
+    m_tasks.erase(it);
+    markDirty(position);
+}
+
+const QVector<PlannedSlot> &PlanEngine::plan()
+{
+    if (m_dirtyFrom == kClean) {
+        return m_plan;
+    }
+
+    // Everything before the first dirty position kept its slots.
+    const int first = qMin(m_dirtyFrom, int(m_order.size()));
+    int slot = first == 0 ? 0 : m_firstSlot.at(first - 1) + m_order.at(first - 1).pomodoros;
+    m_firstSlot.resize(m_order.size());
+    m_plan.resize(qMin(qsizetype(slot), m_plan.size()));
+
+    for (int i = first; i < m_order.size(); i++) {
+        const PlanTask &task = m_order.at(i);
+        m_firstSlot[i] = slot;
+        for (int n = 0; n < task.pomodoros; n++, slot++) {
+            if (m_plan.size() == slot && ensureSlots(slot + 1)) {
+                const qint64 start = m_slotStarts.at(slot);
+                m_plan.append({task.id, start, start + m_workMs, start + m_workMs > task.dueMs});
+            }
+        }
+    }
+
+    m_dirtyFrom = kClean;
+    return m_plan;
+}
+
+int PlanEngine::taskCount() const
+{
+    return m_order.size();
+}
+
+int PlanEngine::unplannedCount()
+{
+    return m_pomodoros - plan().size();
+}
+
+bool PlanEngine::before(const PlanTask &a, const PlanTask &b)
+{
+    if (a.dueMs != b.dueMs) {
+        return a.dueMs < b.dueMs;
+    }
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.id < b.id;
+}
+
+int PlanEngine::positionOf(const PlanTask &task) const
+{
+    return int(std::lower_bound(m_order.cbegin(), m_order.cend(), task, before) - m_order.cbegin());
+}
+
+void PlanEngine::markDirty(int position)
+{
+    m_dirtyFrom = qMin(m_dirtyFrom, position);
+}
+
+bool PlanEngine::ensureSlots(int count)
+{
+    if (m_windows.isEmpty() || !m_from.isValid()) {
+        return false;
+    }
+
+    const QDate horizon = m_from.date().addDays(kHorizonDays);
+    while (m_slotStarts.size() < count && m_nextDay < horizon) {
+        const QDateTime midnight = m_nextDay.startOfDay();
+        const int weekday = m_nextDay.dayOfWeek();
+
+        for (const StudyWindow &window : std::as_const(m_windows)) {
+            if (window.weekday != weekday) {
+                continue;
+            }
+            const qint64 end = midnight.addSecs(qint64(window.endMinute) * 60).toMSecsSinceEpoch();
+            qint64 start = qMax(midnight.addSecs(qint64(window.startMinute) * 60).toMSecsSinceEpoch(),
+                                m_nextFreeMs);
+            // Overlapping windows continue after the previous slot's break.
+            while (start + m_workMs <= end) {
+                m_slotStarts.append(start);
+                start += m_workMs + m_breakMs;
+                m_nextFreeMs = start;
+            }
+        }
+        m_nextDay = m_nextDay.addDays(1);
+    }
+    return m_slotStarts.size() >= count;
+}
@@ -0,0 +1,92 @@
+#ifndef PLANENGINE_H
+#define PLANENGINE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QVector>
+#include <limits>
+
+struct PlanTask
+{
+    int id = -1;
+    qint64 dueMs = std::numeric_limits<qint64>::max();   // no due date sorts last
+    int priority = 1;
+    int pomodoros = 1;
+
+    bool operator==(const PlanTask &other) const
+    {
+        return id == other.id && dueMs == other.dueMs && priority == other.priority
+               && pomodoros == other.pomodoros;
+    }
+};
+
+// A weekly availability window, in minutes after midnight (weekday 1 = Monday).
+struct StudyWindow
+{
+    int weekday = 1;
+    int startMinute = 0;
+    int endMinute = 0;
+};
+
+struct PlannedSlot
+{
+    int todoId = -1;
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    bool late = false;   // ends after the todo's due date
+};
+
+// Earliest-due-date scheduler: open todos, ordered by due date then
+// priority, take consecutive Pomodoro slots cut from the availability
+// windows. Unit-length jobs on a single timeline make EDF order optimal
+// for meeting due dates, so the plan is a prefix sum over the sorted
+// tasks. Edits move one task within the sorted order and only the slots
+// from the first affected position onwards are recomputed; slot start
+// times are generated lazily and kept across edits.
+//
+// Plain data with no QObject or database access, so it can be driven
+// from a worker thread.
+class PlanEngine
+{
+public:
+    PlanEngine();
+
+    void setTimeline(const QDateTime &from, const QVector<StudyWindow> &windows,
+                     int workMinutes, int breakMinutes);
+
+    void reset(const QVector<PlanTask> &tasks);
+    void upsert(const PlanTask &task);
+    void remove(int id);
+
+    // Brings the plan up to date and returns it, ordered by start time.
+    const QVector<PlannedSlot> &plan();
+
+    int taskCount() const;
+    // Pomodoros that did not fit before the planning horizon.
+    int unplannedCount();
+
+private:
+    static bool before(const PlanTask &a, const PlanTask &b);
+    int positionOf(const PlanTask &task) const;
+    void markDirty(int position);
+    bool ensureSlots(int count);
+
+    QDateTime m_from;
+    QVector<StudyWindow> m_windows;
+    qint64 m_workMs;
+    qint64 m_breakMs;
+
+    QVector<PlanTask> m_order;
+    QHash<int, PlanTask> m_tasks;
+    int m_pomodoros;
+
+    QVector<int> m_firstSlot;      // per position in m_order
+    QVector<qint64> m_slotStarts;  // generated on demand
+    QDate m_nextDay;
+    qint64 m_nextFreeMs;
+
+    QVector<PlannedSlot> m_plan;
+    int m_dirtyFrom;
+};
+
+#endif // PLANENGINE_H
@@ -0,0 +1,384 @@
+#include "studyplanner.h"
+#include "../clock/clock.h"
+#include "../database/databasemanager.h"
+#include "../todo/todomanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <utility>
+
+StudyPlanner::StudyPlanner(todoManager *todos, QObject *parent)
+    : QObject(parent),
+    m_todos(todos),
+    m_anchorTimer(Clock::instance()->createTimer(this)),
+    m_engine(std::make_shared<PlanEngine>()),
+    m_hasPending(false),
+    m_jobQueued(false),
+    m_workMinutes(25),
+    m_breakMinutes(5),
+    m_lateCount(0),
+    m_unplannedCount(0)
+{
+    DatabaseManager::instance().createPlannerTables();
+    loadWindows();
+
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this, &StudyPlanner::onRowsInserted);
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &StudyPlanner::onRowsAboutToBeRemoved);
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &StudyPlanner::onDataChanged);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, [this]() {
+        queueReset();
+        scheduleJob();
+    });
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, &StudyPlanner::onJobFinished);
+
+    m_anchorTimer->setSingleShot(true);
+    connect(m_anchorTimer, &ClockTimer::timeout, this, &StudyPlanner::replan);
+
+    replan();
+}
+
+StudyPlanner::~StudyPlanner()
+{
+    m_watcher.waitForFinished();
+}
+
+int StudyPlanner::workMinutes() const
+{
+    return m_workMinutes;
+}
+
+void StudyPlanner::setWorkMinutes(int minutes)
+{
+    if (minutes < 1 || minutes == m_workMinutes) {
+        return;
+    }
+    m_workMinutes = minutes;
+    emit settingsChanged();
+    queueRetime();
+    scheduleJob();
+}
+
+int StudyPlanner::breakMinutes() const
+{
+    return m_breakMinutes;
+}
+
+void StudyPlanner::setBreakMinutes(int minutes)
+{
+    if (minutes < 0 || minutes == m_breakMinutes) {
+        return;
+    }
+    m_breakMinutes = minutes;
+    emit settingsChanged();
+    queueRetime();
+    scheduleJob();
+}
+
+bool StudyPlanner::isPlanning() const
+{
+    return m_watcher.isRunning();
+}
+
+QVector<PlannedSlot> StudyPlanner::plan() const
+{
+    return m_plan;
+}
+
+int StudyPlanner::plannedCount() const
+{
+    return m_plan.size();
+}
+
+int StudyPlanner::lateCount() const
+{
+    return m_lateCount;
+}
+
+int StudyPlanner::unplannedCount() const
+{
+    return m_unplannedCount;
+}
+
+QVariantList StudyPlanner::slotsOn(const QDate &day) const
+{
+    QVariantList list;
+    const qint64 dayStart = day.startOfDay().toMSecsSinceEpoch();
+    const qint64 dayEnd = day.addDays(1).startOfDay().toMSecsSinceEpoch();
+
+    // Slots are in time order.
+    auto it = std::lower_bound(m_plan.cbegin(), m_plan.cend(), dayStart,
+                               [](const PlannedSlot &slot, qint64 ms) { return slot.startMs < ms; });
+    if (it == m_plan.cend() || it->startMs >= dayEnd) {
+        return list;
+    }
+
+    QHash<int, QString> titles;
+    for (int row = 0; row < m_todos->rowCount(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        titles.insert(index.data(todoManager::IdRole).toInt(), index.data(todoManager::TitleRole).toString());
+    }
+
+    for (; it != m_plan.cend() && it->startMs < dayEnd; ++it) {
+        QVariantMap slot;
+        slot["todoId"] = it->todoId;
+        slot["title"] = titles.value(it->todoId);
+        slot["start"] = QDateTime::fromMSecsSinceEpoch(it->startMs);
+        slot["end"] = QDateTime::fromMSecsSinceEpoch(it->endMs);
+        slot["late"] = it->late;
+        list.append(slot);
+    }
+    return list;
+}
+
+QVariantList StudyPlanner::windows() const
+{
+    QVariantList list;
+    for (const StudyWindow &window : m_windows) {
+        QVariantMap map;
+        map["weekday"] = window.weekday;
+        map["startMinute"] = window.startMinute;
+        map["endMinute"] = window.endMinute;
+        list.append(map);
+    }
+    return list;
+}
+
+bool StudyPlanner::setWindows(const QVariantList &windows)
+{
+    QVector<StudyWindow> parsed;
+    for (const QVariant &value : windows) {
+        const QVariantMap map = value.toMap();
+        StudyWindow window;
+        window.weekday = map.value("weekday").toInt();
+        window.startMinute = map.value("startMinute").toInt();
+        window.endMinute = map.value("endMinute").toInt();
+        if (window.weekday < 1 || window.weekday > 7 || window.startMinute < 0
+            || window.endMinute > 24 * 60 || window.startMinute >= window.endMinute) {
+            qDebug() << "Ignoring invalid study window:" << map;
+            continue;
+        }
+        parsed.append(window);
+    }
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+    QSqlQuery query;
+    bool ok = query.exec("DELETE FROM study_windows");
+    query.prepare("INSERT INTO study_windows (weekday, start_minute, end_minute) "
+                  "VALUES (:weekday, :start_minute, :end_minute)");
+    for (const StudyWindow &window : parsed) {
+        if (!ok) {
+            break;
+        }
+        query.bindValue(":weekday", window.weekday);
+        query.bindValue(":start_minute", window.startMinute);
+        query.bindValue(":end_minute", window.endMinute);
+        ok = query.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qDebug() << "Error saving study windows:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    m_windows = parsed;
+    queueRetime();
+    scheduleJob();
+    return true;
+}
+
+void StudyPlanner::replan()
+{
+    queueRetime();
+    queueReset();
+    scheduleJob();
+}
+
+void StudyPlanner::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        queueRow(row);
+    }
+    scheduleJob();
+}
+
+void StudyPlanner::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        const int id = m_todos->index(row, 0).data(todoManager::IdRole).toInt();
+        m_pending.upserts.remove(id);
+        m_pending.removals.insert(id);
+    }
+    m_hasPending = true;
+    scheduleJob();
+}
+
+void StudyPlanner::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    static const QList<int> planned = {todoManager::DueDateRole, todoManager::PriorityRole,
+                                       todoManager::CompletedRole, todoManager::EstimatedPomodorosRole};
+    const bool relevant = roles.isEmpty()
+                          || std::any_of(roles.cbegin(), roles.cend(),
+                                         [](int role) { return planned.contains(role); });
+    if (!relevant) {
+        return;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        queueRow(row);
+    }
+    scheduleJob();
+}
+
+void StudyPlanner::onJobFinished()
+{
+    const Result result = m_watcher.result();
+    m_plan = result.slots;
+    m_unplannedCount = result.unplanned;
+
+    // A todo's slots are contiguous, so its last slot decides lateness.
+    m_lateCount = 0;
+    for (int i = 0; i < m_plan.size(); i++) {
+        const bool lastOfTodo = i + 1 == m_plan.size() || m_plan.at(i + 1).todoId != m_plan.at(i).todoId;
+        if (lastOfTodo && m_plan.at(i).late) {
+            m_lateCount++;
+        }
+    }
+
+    // Move the timeline forward once the first planned slot is over.
+    m_anchorTimer->stop();
+    if (!m_plan.isEmpty()) {
+        const qint64 wait = m_plan.first().endMs - Clock::instance()->now().toMSecsSinceEpoch();
+        m_anchorTimer->start(int(qBound<qint64>(0, wait, std::numeric_limits<int>::max())));
+    }
+
+    emit planChanged();
+    if (m_hasPending) {
+        startJob();
+    } else {
+        emit planningChanged();
+    }
+}
+
+void StudyPlanner::startJob()
+{
+    m_jobQueued = false;
+    if (m_watcher.isRunning() || !m_hasPending) {
+        return;
+    }
+
+    Changes changes = std::exchange(m_pending, Changes());
+    m_hasPending = false;
+
+    std::shared_ptr<PlanEngine> engine = m_engine;
+    m_watcher.setFuture(QtConcurrent::run([engine, changes]() {
+        if (changes.retime) {
+            engine->setTimeline(changes.from, changes.windows, changes.workMinutes, changes.breakMinutes);
+        }
+        if (changes.reset) {
+            engine->reset(changes.tasks);
+        }
+        for (int id : changes.removals) {
+            engine->remove(id);
+        }
+        for (const PlanTask &task : changes.upserts) {
+            engine->upsert(task);
+        }
+
+        Result result;
+        result.slots = engine->plan();
+        result.unplanned = engine->unplannedCount();
+        return result;
+    }));
+    emit planningChanged();
+}
+
+void StudyPlanner::loadWindows()
+{
+    m_windows.clear();
+    QSqlQuery query("SELECT weekday, start_minute, end_minute FROM study_windows ORDER BY weekday, start_minute");
+    while (query.next()) {
+        m_windows.append({query.value(0).toInt(), query.value(1).toInt(), query.value(2).toInt()});
+    }
+
+    // Until the user sets their own: weekday evenings and weekend mornings.
+    if (m_windows.isEmpty()) {
+        for (int weekday = 1; weekday <= 5; weekday++) {
+            m_windows.append({weekday, 17 * 60, 21 * 60});
+        }
+        m_windows.append({6, 10 * 60, 13 * 60});
+        m_windows.append({7, 10 * 60, 13 * 60});
+    }
+}
+
+bool StudyPlanner::taskAt(int row, PlanTask &task) const
+{
+    const QModelIndex index = m_todos->index(row, 0);
+    task.id = index.data(todoManager::IdRole).toInt();
+    if (index.data(todoManager::CompletedRole).toBool()) {
+        return false;
+    }
+
+    const QDateTime due = index.data(todoManager::DueDateRole).toDateTime();
+    task.dueMs = due.isValid() ? due.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    task.priority = index.data(todoManager::PriorityRole).toInt();
+    task.pomodoros = qMax(1, index.data(todoManager::EstimatedPomodorosRole).toInt());
+    return true;
+}
+
+void StudyPlanner::queueRow(int row)
+{
+    PlanTask task;
+    if (taskAt(row, task)) {
+        m_pending.removals.remove(task.id);
+        m_pending.upserts.insert(task.id, task);
+    } else {
+        m_pending.upserts.remove(task.id);
+        m_pending.removals.insert(task.id);
+    }
+    m_hasPending = true;
+}
+
+void StudyPlanner::queueReset()
+{
+    m_pending.reset = true;
+    m_pending.tasks.clear();
+    m_pending.upserts.clear();
+    m_pending.removals.clear();
+    for (int row = 0; row < m_todos->rowCount(); row++) {
+        PlanTask task;
+        if (taskAt(row, task)) {
+            m_pending.tasks.append(task);
+        }
+    }
+    m_hasPending = true;
+}
+
+void StudyPlanner::queueRetime()
+{
+    m_pending.retime = true;
+    m_pending.from = Clock::instance()->now();
+    m_pending.windows = m_windows;
+    m_pending.workMinutes = m_workMinutes;
+    m_pending.breakMinutes = m_breakMinutes;
+    m_hasPending = true;
+}
+
+void StudyPlanner::scheduleJob()
+{
+    // Coalesce a burst of row signals (e.g. clearCompleted) into one job.
+    if (!m_jobQueued && !m_watcher.isRunning()) {
+        m_jobQueued = true;
+        QMetaObject::invokeMethod(this, &StudyPlanner::startJob, Qt::QueuedConnection);
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef STUDYPLANNER_H
+#define STUDYPLANNER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QVariantList>
+#include <QVector>
+#include <memory>
+
+#include "planengine.h"
+
+class ClockTimer;
+class todoManager;
+
+// Schedules open todos into Pomodoro slots within the weekly study
+// windows (study_windows). Follows the todo model's row signals and
+// forwards only the rows that changed to a PlanEngine, which runs on the
+// thread pool; edits that arrive while a plan is being computed are merged
+// and sent as one follow-up job. The plan re-anchors to "now" once its
+// first slot has passed.
+class StudyPlanner : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int workMinutes READ workMinutes WRITE setWorkMinutes NOTIFY settingsChanged)
+    Q_PROPERTY(int breakMinutes READ breakMinutes WRITE setBreakMinutes NOTIFY settingsChanged)
+    Q_PROPERTY(bool planning READ isPlanning NOTIFY planningChanged)
+    Q_PROPERTY(int plannedCount READ plannedCount NOTIFY planChanged)
+    Q_PROPERTY(int lateCount READ lateCount NOTIFY planChanged)
+    Q_PROPERTY(int unplannedCount READ unplannedCount NOTIFY planChanged)
+
+public:
+    explicit StudyPlanner(todoManager *todos, QObject *parent = nullptr);
+    ~StudyPlanner() override;
+
+    int workMinutes() const;
+    void setWorkMinutes(int minutes);
+    int breakMinutes() const;
+    void setBreakMinutes(int minutes);
+
+    bool isPlanning() const;
+    QVector<PlannedSlot> plan() const;
+    int plannedCount() const;
+    // Todos whose last planned Pomodoro ends after their due date.
+    int lateCount() const;
+    int unplannedCount() const;
+
+    Q_INVOKABLE QVariantList slotsOn(const QDate &day) const;
+    Q_INVOKABLE QVariantList windows() const;
+    // Maps with weekday, startMinute and endMinute; replaces all windows.
+    Q_INVOKABLE bool setWindows(const QVariantList &windows);
+
+public slots:
+    // Re-anchors the timeline at the current time and plans from scratch.
+    void replan();
+
+signals:
+    void settingsChanged();
+    void planningChanged();
+    void planChanged();
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onJobFinished();
+    void startJob();
+
+private:
+    struct Changes {
+        bool retime = false;
+        bool reset = false;
+        QDateTime from;
+        QVector<StudyWindow> windows;
+        int workMinutes = 25;
+        int breakMinutes = 5;
+        QVector<PlanTask> tasks;          // full task list when reset
+        QHash<int, PlanTask> upserts;
+        QSet<int> removals;
+    };
+
+    struct Result {
+        QVector<PlannedSlot> slots;
+        int unplanned = 0;
+    };
+
+    todoManager *m_todos;
+    ClockTimer *m_anchorTimer;
+    std::shared_ptr<PlanEngine> m_engine;   // only touched by the running job
+    QFutureWatcher<Result> m_watcher;
+    Changes m_pending;
+    bool m_hasPending;
+    bool m_jobQueued;
+
+    QVector<StudyWindow> m_windows;
+    int m_workMinutes;
+    int m_breakMinutes;
+
+    QVector<PlannedSlot> m_plan;
+    int m_lateCount;
+    int m_unplannedCount;
+
+    void loadWindows();
+    bool taskAt(int row, PlanTask &task) const;
+    void queueRow(int row);
+    void queueReset();
+    void queueRetime();
+    void scheduleJob();
+};
+
+#endif // STUDYPLANNER_H
@@ -1,80 +1,193 @@
 #include "pomodorotimer.h"
-#include <QTimer>
+#include "../clock/clock.h"
 #include <QDebug>
 
+namespace {
+
+// Below this, wake with a precise timer so the phase ends on time.
+const qint64 kPreciseWindowMs = 2000;
+
+int secondsFor(qint64 remainingMs)
+{
+    // Round up so "00:01" stays visible until the deadline itself.
+    return remainingMs <= 0 ? 0 : int((remainingMs + 999) / 1000);
+}
+
+} // namespace
+
 PomodoroTimer::PomodoroTimer(QObject *parent)
     : QObject(parent),
-    m_timer(new QTimer(this)),
-    m_timeRemaining(0),
+    m_timer(Clock::instance()->createTimer(this)),
+    m_deadlineMs(0),
+    m_pausedRemainingMs(0),
+    m_intervalStartMs(0),
+    m_shownSeconds(0),
     m_workDuration(0),
     m_breakDuration(0),
-    m_currentState(Idle)
+    m_currentState(Idle),
+    m_paused(false),
+    m_viewCount(0),
+    m_windowVisible(true)
 {
-    connect(m_timer, &QTimer::timeout, this, &PomodoroTimer::onTimerTick);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &ClockTimer::timeout, this, &PomodoroTimer::onTimerTick);
 }
 
 int PomodoroTimer::timeRemaining() const {
-    return m_timeRemaining;
+    // Always read from the clock: notifications may be suspended.
+    return secondsFor(remainingMs());
+}
+
+qint64 PomodoroTimer::remainingMs() const {
+    if (m_currentState == Idle) {
+        return 0;
+    }
+    if (m_paused) {
+        return m_pausedRemainingMs;
+    }
+    return qMax<qint64>(0, m_deadlineMs - Clock::instance()->monotonicMs());
 }
 
 PomodoroTimer::State PomodoroTimer::currentState() const {
     return m_currentState;
 }
 
+bool PomodoroTimer::isPaused() const {
+    return m_paused;
+}
+
+qint64 PomodoroTimer::currentIntervalMs() const {
+    if (m_currentState == Idle || m_paused) {
+        return 0;
+    }
+    return Clock::instance()->monotonicMs() - m_intervalStartMs;
+}
+
+QString PomodoroTimer::displayText() const {
+    const int seconds = timeRemaining();
+    return QString("%1:%2")
+        .arg(seconds / 60, 2, 10, QChar('0'))
+        .arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+bool PomodoroTimer::windowVisible() const {
+    return m_windowVisible;
+}
+
+void PomodoroTimer::setWindowVisible(bool visible) {
+    if (m_windowVisible == visible) {
+        return;
+    }
+    const bool wasActive = notificationsActive();
+    m_windowVisible = visible;
+    emit windowVisibleChanged();
+    if (notificationsActive() != wasActive) {
+        notificationsToggled();
+    }
+}
+
+bool PomodoroTimer::notificationsActive() const {
+    return m_viewCount > 0 && m_windowVisible;
+}
+
+void PomodoroTimer::attachView() {
+    const bool wasActive = notificationsActive();
+    m_viewCount++;
+    if (notificationsActive() != wasActive) {
+        notificationsToggled();
+    }
+}
+
+void PomodoroTimer::detachView() {
+    if (m_viewCount == 0) {
+        return;
+    }
+    const bool wasActive = notificationsActive();
+    m_viewCount--;
+    if (notificationsActive() != wasActive) {
+        notificationsToggled();
+    }
+}
+
 void PomodoroTimer::startSession(int workDurationSeconds, int breakDurationSeconds) {
     stop();
     m_workDuration = workDurationSeconds;
     m_breakDuration = breakDurationSeconds;
-    transitionToWorking();
+    transitionToWorking(Clock::instance()->monotonicMs());
 }
 
 void PomodoroTimer::stop() {
     m_timer->stop();
-    m_timeRemaining = 0;
+    if (m_currentState != Idle && !m_paused) {
+        endInterval("stopped", Clock::instance()->monotonicMs());
+    }
+    if (m_paused) {
+        m_paused = false;
+        emit pausedChanged();
+    }
     transitionToIdle();
-    emit timeRemainingChanged();
+    updateShownSeconds();
 }
 
 void PomodoroTimer::pause() {
-    if (m_currentState == Working || m_currentState == OnBreak) {
+    if ((m_currentState == Working || m_currentState == OnBreak) && !m_paused) {
+        m_pausedRemainingMs = remainingMs();
+        endInterval("paused", Clock::instance()->monotonicMs());
+        m_paused = true;
         m_timer->stop();
+        emit pausedChanged();
     }
 }
 
 void PomodoroTimer::resume() {
-    if ((m_currentState == Working || m_currentState == OnBreak) && m_timeRemaining > 0) {
-        m_timer->start(1000);
+    if ((m_currentState == Working || m_currentState == OnBreak) && m_paused) {
+        const qint64 now = Clock::instance()->monotonicMs();
+        m_deadlineMs = now + m_pausedRemainingMs;
+        beginInterval(now);
+        m_paused = false;
+        emit pausedChanged();
+        scheduleTick();
     }
 }
 
 void PomodoroTimer::onTimerTick() {
-    if (m_timeRemaining > 0) {
-        m_timeRemaining--;
-        emit timeRemainingChanged();
-    } else {
-        if (m_currentState == Working) {
-            transitionToBreak();
-        } else if (m_currentState == OnBreak) {
-            transitionToIdle();
-            emit sessionEnded();
-        }
+    const qint64 now = Clock::instance()->monotonicMs();
+
+    // After a long stall (suspend, blocked event loop) several phases may
+    // have elapsed; each one starts exactly where the previous ended.
+    if (m_currentState == Working && now >= m_deadlineMs) {
+        endInterval("completed", m_deadlineMs);
+        transitionToBreak(m_deadlineMs);
+    }
+    if (m_currentState == OnBreak && now >= m_deadlineMs) {
+        m_timer->stop();
+        endInterval("completed", m_deadlineMs);
+        transitionToIdle();
+        updateShownSeconds();
+        emit sessionEnded();
+        return;
     }
+
+    updateShownSeconds();
+    scheduleTick();
 }
 
-void PomodoroTimer::transitionToWorking() {
+void PomodoroTimer::transitionToWorking(qint64 startMs) {
     m_currentState = Working;
-    m_timeRemaining = m_workDuration;
+    m_deadlineMs = startMs + qint64(m_workDuration) * 1000;
+    beginInterval(startMs);
     emit stateChanged(m_currentState);
-    emit timeRemainingChanged();
-    m_timer->start(1000);
+    updateShownSeconds();
+    scheduleTick();
 }
 
-void PomodoroTimer::transitionToBreak() {
+void PomodoroTimer::transitionToBreak(qint64 startMs) {
     m_currentState = OnBreak;
-    m_timeRemaining = m_breakDuration;
+    m_deadlineMs = startMs + qint64(m_breakDuration) * 1000;
+    beginInterval(startMs);
     emit stateChanged(m_currentState);
-    emit timeRemainingChanged();
-    m_timer->start(1000);
+    updateShownSeconds();
+    scheduleTick();
 }
 
 void PomodoroTimer::transitionToIdle() {
@@ -82,6 +195,65 @@ void PomodoroTimer::transitionToIdle() {
     emit stateChanged(m_currentState);
 }
 
+void PomodoroTimer::beginInterval(qint64 startMs) {
+    m_intervalStartMs = startMs;
+    // Back-date the wall-clock start when catching up on a missed deadline.
+    m_intervalStartedAt = Clock::instance()->now()
+        .addMSecs(startMs - Clock::instance()->monotonicMs());
+}
+
+void PomodoroTimer::endInterval(const QString &reason, qint64 endMs) {
+    const int planned = m_currentState == Working ? m_workDuration : m_breakDuration;
+    emit intervalEnded(m_currentState, m_intervalStartedAt, endMs - m_intervalStartMs, planned, reason);
+}
+
+void PomodoroTimer::scheduleTick() {
+    if (m_currentState == Idle || m_paused) {
+        return;
+    }
+
+    const qint64 remaining = m_deadlineMs - Clock::instance()->monotonicMs();
+    if (!notificationsActive()) {
+        // Nobody is watching: one wakeup at the phase deadline.
+        m_timer->setTimerType(Qt::PreciseTimer);
+        m_timer->start(int(qMax<qint64>(0, remaining)));
+        return;
+    }
+
+    // Wake when the displayed second next changes: the sub-second part of
+    // the remaining time, or a full second when sitting on a boundary.
+    qint64 wait = remaining % 1000;
+    if (wait <= 0) {
+        wait = remaining <= 0 ? 0 : 1000;
+    }
+
+    m_timer->setTimerType(remaining <= kPreciseWindowMs ? Qt::PreciseTimer : Qt::CoarseTimer);
+    m_timer->start(int(wait));
+}
+
+void PomodoroTimer::updateShownSeconds() {
+    if (!notificationsActive()) {
+        return;
+    }
+
+    const int seconds = secondsFor(remainingMs());
+    if (seconds != m_shownSeconds) {
+        m_shownSeconds = seconds;
+        emit timeRemainingChanged();
+        emit displayTextChanged();
+    }
+}
+
+void PomodoroTimer::notificationsToggled() {
+    // Catch the UI up immediately and switch between per-second and
+    // deadline-only wakeups.
+    updateShownSeconds();
+    if (m_currentState != Idle && !m_paused) {
+        m_timer->stop();
+        scheduleTick();
+    }
+}
+
 void PomodoroTimer::killPomodoroView() {
     emit closePomodorotimer();
     qDebug() << "Testing";
@@ -2,13 +2,23 @@
 #define POMODOROTIMER_H
 
 #include <QObject>
+#include <QDateTime>
 
-class QTimer;
+class ClockTimer;
 
+// Countdown driven by an absolute deadline on the monotonic clock. The
+// remaining time is always derived from the clock rather than counted in
+// ticks, so late timer wakeups, pauses and suspend never add drift; the
+// timer only wakes the object when the displayed second changes, and only
+// while a view is attached and the window is visible; otherwise it sleeps
+// until the phase deadline and the UI catches up when it comes back.
 class PomodoroTimer : public QObject {
     Q_OBJECT
     Q_PROPERTY(int timeRemaining READ timeRemaining NOTIFY timeRemainingChanged)
     Q_PROPERTY(State currentState READ currentState NOTIFY stateChanged)
+    Q_PROPERTY(bool paused READ isPaused NOTIFY pausedChanged)
+    Q_PROPERTY(QString displayText READ displayText NOTIFY displayTextChanged)
+    Q_PROPERTY(bool windowVisible READ windowVisible WRITE setWindowVisible NOTIFY windowVisibleChanged)
 
 public:
     enum State { Idle, Working, OnBreak };
@@ -17,7 +27,19 @@ public:
     explicit PomodoroTimer(QObject *parent = nullptr);
 
     int timeRemaining() const;
+    qint64 remainingMs() const;
     State currentState() const;
+    bool isPaused() const;
+    qint64 currentIntervalMs() const;
+    QString displayText() const;
+
+    bool windowVisible() const;
+    void setWindowVisible(bool visible);
+    bool notificationsActive() const;
+
+    // Views showing the countdown register while they exist.
+    Q_INVOKABLE void attachView();
+    Q_INVOKABLE void detachView();
 
     Q_INVOKABLE void startSession(int workDurationSeconds, int breakDurationSeconds);
     Q_INVOKABLE void stop();
@@ -31,6 +53,13 @@ public:
 signals:
     void timeRemainingChanged();
     void stateChanged(State newState);
+    void pausedChanged();
+    void displayTextChanged();
+    void windowVisibleChanged();
+    // A span of uninterrupted running time ended; endReason is "completed",
+    // "paused" or "stopped". Emitted before the matching state change.
+    void intervalEnded(PomodoroTimer::State kind, const QDateTime &startedAt, qint64 durationMs,
+                       int plannedSeconds, const QString &endReason);
     void sessionEnded();
     void closePomodorotimer();
 
@@ -38,15 +67,29 @@ private slots:
     void onTimerTick();
 
 private:
-    QTimer *m_timer;
-    int m_timeRemaining;
+    ClockTimer *m_timer;
+    qint64 m_deadlineMs;      // monotonic ms at which the current phase ends
+    qint64 m_pausedRemainingMs;
+    qint64 m_intervalStartMs;
+    QDateTime m_intervalStartedAt;
+    int m_shownSeconds;
     int m_workDuration;
     int m_breakDuration;
     State m_currentState;
+    bool m_paused;
+    int m_viewCount;
+    bool m_windowVisible;
 
-    void transitionToWorking();
-    void transitionToBreak();
+    void transitionToWorking(qint64 startMs);
+    void transitionToBreak(qint64 startMs);
     void transitionToIdle();
+
+    void beginInterval(qint64 startMs);
+    void endInterval(const QString &reason, qint64 endMs);
+
+    void scheduleTick();
+    void updateShownSeconds();
+    void notificationsToggled();
 };
 
 #endif // POMODOROTIMER_H
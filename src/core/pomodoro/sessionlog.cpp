@@ -0,0 +1,166 @@
+#include "sessionlog.h"
+#include "../clock/clock.h"
+#include "../database/databasemanager.h"
+
+#include <QDebug>
+#include <utility>
+
+SessionLog::SessionLog(PomodoroTimer *timer, QObject *parent)
+    : QObject(parent),
+    m_timer(timer),
+    m_refreshTimer(Clock::instance()->createTimer(this)),
+    m_storedTodayMs(0),
+    m_minutesToday(0)
+{
+    connect(m_timer, &PomodoroTimer::intervalEnded, this, &SessionLog::recordInterval);
+    connect(m_timer, &PomodoroTimer::stateChanged, this, &SessionLog::flush);
+    connect(m_timer, &PomodoroTimer::pausedChanged, this, &SessionLog::flush);
+    connect(m_timer, &PomodoroTimer::stateChanged, this, &SessionLog::refreshToday);
+    connect(m_timer, &PomodoroTimer::pausedChanged, this, &SessionLog::refreshToday);
+
+    // The timer's own ticks stop when no view is showing it, so the counter
+    // wakes itself at each minute boundary while work time is accruing.
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, &ClockTimer::timeout, this, &SessionLog::refreshToday);
+
+    refreshToday();
+}
+
+SessionLog::~SessionLog()
+{
+    flush();
+}
+
+int SessionLog::minutesStudiedToday() const
+{
+    return m_minutesToday;
+}
+
+int SessionLog::pendingCount() const
+{
+    return m_pending.size();
+}
+
+int SessionLog::minutesStudiedOn(const QDate &day)
+{
+    return int((DatabaseManager::instance().studiedMs(day, day) + pendingWorkMs(day, day)) / 60000);
+}
+
+int SessionLog::minutesStudiedInWeek(const QDate &day)
+{
+    const QDate monday = day.addDays(1 - day.dayOfWeek());
+    const QDate sunday = monday.addDays(6);
+    return int((DatabaseManager::instance().studiedMs(monday, sunday) + pendingWorkMs(monday, sunday)) / 60000);
+}
+
+QVariantList SessionLog::dailyMinutes(const QDate &from, int days)
+{
+    QVariantList minutes;
+    if (days <= 0) {
+        return minutes;
+    }
+
+    const QDate to = from.addDays(days - 1);
+    const QMap<QDate, qint64> stored = DatabaseManager::instance().studiedMsPerDay(from, to);
+    minutes.reserve(days);
+    for (int i = 0; i < days; i++) {
+        const QDate day = from.addDays(i);
+        minutes.append(int((stored.value(day) + pendingWorkMs(day, day)) / 60000));
+    }
+    return minutes;
+}
+
+bool SessionLog::flush()
+{
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+
+    for (const Interval &interval : std::as_const(m_pending)) {
+        if (!DatabaseManager::instance().insertPomodoroSession(interval.kind, interval.startedAt, interval.durationMs,
+                                                               interval.plannedSeconds, interval.endReason)) {
+            db.rollback();
+            return false;   // keep the buffer and retry on the next transition
+        }
+    }
+
+    if (!db.commit()) {
+        qDebug() << "Error committing pomodoro sessions:" << db.lastError().text();
+        return false;
+    }
+
+    m_storedTodayMs += pendingWorkMs(m_today, m_today);
+    const QVector<Interval> written = std::exchange(m_pending, {});
+    for (const Interval &interval : written) {
+        emit intervalLogged(interval.kind, interval.startedAt, interval.durationMs, interval.endReason);
+    }
+    return true;
+}
+
+void SessionLog::recordInterval(PomodoroTimer::State kind, const QDateTime &startedAt, qint64 durationMs,
+                                int plannedSeconds, const QString &endReason)
+{
+    if (durationMs <= 0) {
+        return;
+    }
+
+    const QString kindName = kind == PomodoroTimer::OnBreak ? "break" : "work";
+
+    // Totals are per calendar day, so split intervals that run past midnight.
+    // Only the last part ends the way the interval did; the earlier ones are
+    // "split", so a session is not counted once per day it touches.
+    QDateTime start = startedAt;
+    qint64 remaining = durationMs;
+    while (remaining > 0) {
+        const QDateTime midnight(start.date().addDays(1), QTime(0, 0), start.timeZone());
+        const qint64 part = qMin(remaining, start.msecsTo(midnight));
+        m_pending.append({kindName, start, part, plannedSeconds, part < remaining ? QString("split") : endReason});
+        remaining -= part;
+        start = midnight;
+    }
+
+    refreshToday();
+}
+
+void SessionLog::refreshToday()
+{
+    const QDate today = Clock::instance()->today();
+    if (today != m_today) {
+        m_today = today;
+        m_storedTodayMs = DatabaseManager::instance().studiedMs(today, today);
+    }
+
+    qint64 total = m_storedTodayMs + pendingWorkMs(today, today);
+    if (m_timer->currentState() == PomodoroTimer::Working) {
+        // Count only the part of the running interval that falls on today.
+        const QDateTime now = Clock::instance()->now();
+        total += qMin(m_timer->currentIntervalMs(), QDateTime(today, QTime(0, 0), now.timeZone()).msecsTo(now));
+    }
+
+    const int minutes = int(total / 60000);
+    if (minutes != m_minutesToday) {
+        m_minutesToday = minutes;
+        emit minutesStudiedTodayChanged();
+    }
+
+    if (m_timer->currentState() == PomodoroTimer::Working && !m_timer->isPaused()) {
+        m_refreshTimer->start(int(60000 - total % 60000));
+    } else {
+        m_refreshTimer->stop();
+    }
+}
+
+qint64 SessionLog::pendingWorkMs(const QDate &from, const QDate &to) const
+{
+    qint64 total = 0;
+    for (const Interval &interval : m_pending) {
+        const QDate day = interval.startedAt.date();
+        if (interval.kind == "work" && day >= from && day <= to) {
+            total += interval.durationMs;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QVariantList>
+#include <QVector>
+
+#include "pomodorotimer.h"
+
+// Records every running interval of a PomodoroTimer in pomodoro_sessions.
+// Intervals are buffered in memory and written in one transaction when the
+// timer changes state, and the buffer is counted in totals until then, so
+// the live "studied today" figure is exact without a write per tick.
+class ClockTimer;
+
+class SessionLog : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int minutesStudiedToday READ minutesStudiedToday NOTIFY minutesStudiedTodayChanged)
+
+public:
+    explicit SessionLog(PomodoroTimer *timer, QObject *parent = nullptr);
+    ~SessionLog() override;
+
+    int minutesStudiedToday() const;
+    int pendingCount() const;
+
+    Q_INVOKABLE int minutesStudiedOn(const QDate &day);
+    // Monday-to-Sunday week containing day.
+    Q_INVOKABLE int minutesStudiedInWeek(const QDate &day);
+    Q_INVOKABLE QVariantList dailyMinutes(const QDate &from, int days);
+
+public slots:
+    bool flush();
+
+signals:
+    void minutesStudiedTodayChanged();
+    // One per row written by flush(), after the commit. Every part of an
+    // interval split at midnight but the last has endReason "split".
+    void intervalLogged(const QString &kind, const QDateTime &startedAt, qint64 durationMs,
+                        const QString &endReason);
+
+private slots:
+    void recordInterval(PomodoroTimer::State kind, const QDateTime &startedAt, qint64 durationMs,
+                        int plannedSeconds, const QString &endReason);
+    void refreshToday();
+
+private:
+    struct Interval {
+        QString kind;
+        QDateTime startedAt;
+        qint64 durationMs;
+        int plannedSeconds;
+        QString endReason;
+    };
+
+    PomodoroTimer *m_timer;
+    ClockTimer *m_refreshTimer;
+    QVector<Interval> m_pending;
+    QDate m_today;
+    qint64 m_storedTodayMs;   // work time already in the database for m_today
+    int m_minutesToday;
+
+    qint64 pendingWorkMs(const QDate &from, const QDate &to) const;
+};
+
+#endif // SESSIONLOG_H
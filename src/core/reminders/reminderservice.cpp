@@ -0,0 +1,247 @@
+#include "reminderservice.h"
+#include "../clock/clock.h"
+#include "../todo/todomanager.h"
+#include "../streaks/streaksmanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+
+// Re-check at least this often so wall-clock jumps and suspend are noticed.
+const qint64 kMaxSleepMs = 3600 * 1000;
+
+} // namespace
+
+ReminderService::ReminderService(todoManager *todos, streaksManager *streaks, QObject *parent)
+    : QObject(parent),
+    m_todos(todos),
+    m_streaks(streaks),
+    m_timer(Clock::instance()->createTimer(this)),
+    m_wheel(Clock::instance()->now().toMSecsSinceEpoch()),
+    m_todoLeads({24 * 60, 60}),
+    m_habitLead(3 * 60)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &ClockTimer::timeout, this, &ReminderService::onWakeup);
+
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &ReminderService::onTodoRowsChanged);
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (!parent.isValid()) {
+                    onTodoRowsChanged(m_todos->index(first, 0), m_todos->index(last, 0));
+                }
+            });
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ReminderService::onTodoRowsRemoved);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, &ReminderService::rebuild);
+
+    connect(m_streaks, &QAbstractItemModel::dataChanged, this, &ReminderService::onStreakRowsChanged);
+    connect(m_streaks, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &parent, int first, int last) {
+                if (!parent.isValid()) {
+                    onStreakRowsChanged(m_streaks->index(first, 0), m_streaks->index(last, 0));
+                }
+            });
+    connect(m_streaks, &QAbstractItemModel::rowsAboutToBeRemoved, this, &ReminderService::onStreakRowsRemoved);
+    connect(m_streaks, &QAbstractItemModel::modelReset, this, &ReminderService::rebuild);
+
+    rebuild();
+}
+
+QList<int> ReminderService::todoLeadMinutes() const
+{
+    return m_todoLeads;
+}
+
+void ReminderService::setTodoLeadMinutes(const QList<int> &minutes)
+{
+    if (m_todoLeads == minutes) {
+        return;
+    }
+    m_todoLeads = minutes;
+    emit settingsChanged();
+    rebuild();
+}
+
+int ReminderService::habitLeadMinutes() const
+{
+    return m_habitLead;
+}
+
+void ReminderService::setHabitLeadMinutes(int minutes)
+{
+    if (m_habitLead == minutes) {
+        return;
+    }
+    m_habitLead = minutes;
+    emit settingsChanged();
+    rebuild();
+}
+
+int ReminderService::pendingCount() const
+{
+    return m_wheel.size();
+}
+
+bool ReminderService::rebuild()
+{
+    const QDateTime now = Clock::instance()->now();
+    m_wheel = TimerWheel(now.toMSecsSinceEpoch());
+    m_reminders.clear();
+
+    // Uses the partial index idx_todos_open_due: only open, not yet due todos.
+    // Subtasks are left out; their edits never reach the todo model's signals.
+    QSqlQuery query;
+    query.prepare("SELECT id, title, due_date FROM todos "
+                  "WHERE completed = 0 AND parent_id IS NULL AND due_date > :now ORDER BY due_date");
+    query.bindValue(":now", now);
+    if (!query.exec()) {
+        qDebug() << "Error loading todo reminders:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        scheduleTodo(query.value(0).toInt(), query.value(1).toString(), query.value(2).toDateTime());
+    }
+
+    if (!query.exec("SELECT id, title, last_activity, streak_duration FROM streaks WHERE streak_duration > 0")) {
+        qDebug() << "Error loading habit reminders:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        scheduleHabit(query.value(0).toInt(), query.value(1).toString(),
+                      query.value(2).toDateTime(), query.value(3).toInt());
+    }
+
+    arm();
+    emit pendingCountChanged();
+    return true;
+}
+
+void ReminderService::onWakeup()
+{
+    const QVector<quint64> expired = m_wheel.advance(Clock::instance()->now().toMSecsSinceEpoch());
+    for (quint64 key : expired) {
+        const Reminder reminder = m_reminders.take(key);
+        emit reminderDue(reminder.kind == TodoReminder ? "todo" : "habit", reminder.id,
+                         reminder.title, reminder.dueAt, reminder.leadMinutes);
+    }
+
+    arm();
+    if (!expired.isEmpty()) {
+        emit pendingCountChanged();
+    }
+}
+
+void ReminderService::onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        const int id = index.data(todoManager::IdRole).toInt();
+        cancel(TodoReminder, id);
+        if (!index.data(todoManager::CompletedRole).toBool()) {
+            scheduleTodo(id, index.data(todoManager::TitleRole).toString(),
+                         index.data(todoManager::DueDateRole).toDateTime());
+        }
+    }
+    arm();
+    emit pendingCountChanged();
+}
+
+void ReminderService::onTodoRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        cancel(TodoReminder, m_todos->index(row, 0).data(todoManager::IdRole).toInt());
+    }
+    arm();
+    emit pendingCountChanged();
+}
+
+void ReminderService::onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        const int id = index.data(streaksManager::IdRole).toInt();
+        cancel(HabitReminder, id);
+        scheduleHabit(id, index.data(streaksManager::TitleRole).toString(),
+                      index.data(streaksManager::LastActivityRole).toDateTime(),
+                      index.data(streaksManager::StreakDurationRole).toInt());
+    }
+    arm();
+    emit pendingCountChanged();
+}
+
+void ReminderService::onStreakRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        cancel(HabitReminder, m_streaks->index(row, 0).data(streaksManager::IdRole).toInt());
+    }
+    arm();
+    emit pendingCountChanged();
+}
+
+quint64 ReminderService::keyFor(Kind kind, int lead, int id)
+{
+    return (quint64(kind) << 56) | (quint64(quint8(lead)) << 40) | quint64(quint32(id));
+}
+
+void ReminderService::scheduleTodo(int id, const QString &title, const QDateTime &due)
+{
+    if (!due.isValid()) {
+        return;
+    }
+    for (int lead = 0; lead < m_todoLeads.size(); lead++) {
+        add({TodoReminder, id, title, due, m_todoLeads.at(lead)}, lead,
+            due.addSecs(-qint64(m_todoLeads.at(lead)) * 60));
+    }
+}
+
+void ReminderService::scheduleHabit(int id, const QString &title, const QDateTime &lastActivity, int streakDuration)
+{
+    if (streakDuration <= 0 || !lastActivity.isValid()) {
+        return;
+    }
+    // A streak breaks once a full calendar day passes without a check-in.
+    const QDateTime breaksAt = lastActivity.date().addDays(2).startOfDay();
+    add({HabitReminder, id, title, breaksAt, m_habitLead}, 0, breaksAt.addSecs(-qint64(m_habitLead) * 60));
+}
+
+void ReminderService::cancel(Kind kind, int id)
+{
+    const int leads = kind == TodoReminder ? m_todoLeads.size() : 1;
+    for (int lead = 0; lead < leads; lead++) {
+        const quint64 key = keyFor(kind, lead, id);
+        if (m_wheel.cancel(key)) {
+            m_reminders.remove(key);
+        }
+    }
+}
+
+void ReminderService::add(const Reminder &reminder, int lead, const QDateTime &fireAt)
+{
+    // Reminders whose moment has passed are dropped, not fired late.
+    if (fireAt <= Clock::instance()->now()) {
+        return;
+    }
+    const quint64 key = keyFor(reminder.kind, lead, reminder.id);
+    m_wheel.insert(key, fireAt.toMSecsSinceEpoch());
+    m_reminders.insert(key, reminder);
+}
+
+void ReminderService::arm()
+{
+    m_timer->stop();
+    const qint64 wake = m_wheel.nextWakeMs();
+    if (wake < 0) {
+        return;
+    }
+    const qint64 wait = wake - Clock::instance()->now().toMSecsSinceEpoch();
+    m_timer->setTimerType(Qt::CoarseTimer);
+    m_timer->start(int(qBound<qint64>(0, wait, kMaxSleepMs)));
+}
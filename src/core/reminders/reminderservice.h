@@ -0,0 +1,81 @@
+#ifndef REMINDERSERVICE_H
+#define REMINDERSERVICE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+
+#include "timerwheel.h"
+
+class ClockTimer;
+class todoManager;
+class streaksManager;
+
+// Lead-time reminders for open todos ("due in an hour") and for habits
+// whose streak breaks at the end of today. Every reminder lives in one
+// TimerWheel woken by a single Clock timer, and the todo and streak
+// models' row signals cancel and re-insert only the rows that changed.
+// On start the wheel is rebuilt from a range scan of the partial index on
+// open todos' due dates; reminders whose time passed while the app was
+// closed are not replayed.
+class ReminderService : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QList<int> todoLeadMinutes READ todoLeadMinutes WRITE setTodoLeadMinutes NOTIFY settingsChanged)
+    Q_PROPERTY(int habitLeadMinutes READ habitLeadMinutes WRITE setHabitLeadMinutes NOTIFY settingsChanged)
+    Q_PROPERTY(int pendingCount READ pendingCount NOTIFY pendingCountChanged)
+
+public:
+    explicit ReminderService(todoManager *todos, streaksManager *streaks, QObject *parent = nullptr);
+
+    QList<int> todoLeadMinutes() const;
+    void setTodoLeadMinutes(const QList<int> &minutes);
+    int habitLeadMinutes() const;
+    void setHabitLeadMinutes(int minutes);
+    int pendingCount() const;
+
+public slots:
+    bool rebuild();
+
+signals:
+    void settingsChanged();
+    void pendingCountChanged();
+    // kind is "todo" or "habit"; dueAt is the deadline itself.
+    void reminderDue(const QString &kind, int id, const QString &title, const QDateTime &dueAt, int leadMinutes);
+
+private slots:
+    void onWakeup();
+    void onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onTodoRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onStreakRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    enum Kind { TodoReminder = 1, HabitReminder = 2 };
+
+    struct Reminder {
+        Kind kind;
+        int id;
+        QString title;
+        QDateTime dueAt;
+        int leadMinutes;
+    };
+
+    todoManager *m_todos;
+    streaksManager *m_streaks;
+    ClockTimer *m_timer;
+    TimerWheel m_wheel;
+    QHash<quint64, Reminder> m_reminders;
+    QList<int> m_todoLeads;
+    int m_habitLead;
+
+    static quint64 keyFor(Kind kind, int lead, int id);
+    void scheduleTodo(int id, const QString &title, const QDateTime &due);
+    void scheduleHabit(int id, const QString &title, const QDateTime &lastActivity, int streakDuration);
+    void cancel(Kind kind, int id);
+    void add(const Reminder &reminder, int lead, const QDateTime &fireAt);
+    void arm();
+};
+
+#endif // REMINDERSERVICE_H
@@ -0,0 +1,156 @@
+#include "timerwheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+TimerWheel::TimerWheel(qint64 nowMs, qint64 tickMs)
+    : m_tickMs(qMax<qint64>(1, tickMs)),
+    m_current(nowMs / m_tickMs),
+    m_slots(kLevels * kSlots)
+{
+}
+
+void TimerWheel::insert(quint64 key, qint64 deadlineMs)
+{
+    cancel(key);
+    // Round up so nothing fires before its deadline.
+    place(key, (deadlineMs + m_tickMs - 1) / m_tickMs);
+}
+
+bool TimerWheel::cancel(quint64 key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    if (it->slot < 0) {
+        m_due.remove(key);
+    } else {
+        m_slots[it->slot].remove(key);
+    }
+    m_entries.erase(it);
+    return true;
+}
+
+bool TimerWheel::contains(quint64 key) const
+{
+    return m_entries.contains(key);
+}
+
+int TimerWheel::size() const
+{
+    return m_entries.size();
+}
+
+QVector<quint64> TimerWheel::advance(qint64 nowMs)
+{
+    const qint64 target = nowMs / m_tickMs;
+
+    QVector<QPair<qint64, quint64>> expired;
+    auto takeDue = [this, &expired]() {
+        for (quint64 key : std::as_const(m_due)) {
+            expired.append({m_entries.value(key).tick, key});
+            m_entries.remove(key);
+        }
+        m_due.clear();
+    };
+    takeDue();
+
+    while (m_current < target) {
+        const qint64 next = nextEventTick();
+        if (next > target) {
+            m_current = target;
+            break;
+        }
+        m_current = next;
+
+        // Coarse levels first: their entries may land in the slot below.
+        for (int level = kLevels - 1; level > 0; level--) {
+            if ((m_current & ((qint64(1) << (kSlotBits * level)) - 1)) == 0) {
+                cascade(level);
+            }
+        }
+        // Entries cascaded exactly onto the current tick are due now.
+        takeDue();
+
+        QSet<quint64> &slot = m_slots[int(m_current & (kSlots - 1))];
+        for (quint64 key : std::as_const(slot)) {
+            expired.append({m_entries.value(key).tick, key});
+            m_entries.remove(key);
+        }
+        slot.clear();
+    }
+
+    std::sort(expired.begin(), expired.end());
+    QVector<quint64> keys;
+    keys.reserve(expired.size());
+    for (const auto &entry : std::as_const(expired)) {
+        keys.append(entry.second);
+    }
+    return keys;
+}
+
+qint64 TimerWheel::nextWakeMs() const
+{
+    if (!m_due.isEmpty()) {
+        return m_current * m_tickMs;
+    }
+    const qint64 tick = nextEventTick();
+    return tick == std::numeric_limits<qint64>::max() ? -1 : tick * m_tickMs;
+}
+
+void TimerWheel::place(quint64 key, qint64 tick)
+{
+    if (tick <= m_current) {
+        m_entries.insert(key, {tick, -1});
+        m_due.insert(key);
+        return;
+    }
+
+    // Level of the highest 6-bit group where the deadline differs from now.
+    const quint64 diff = quint64(tick ^ m_current);
+    int level = 0;
+    while (level < kLevels - 1 && (diff >> (kSlotBits * (level + 1))) != 0) {
+        level++;
+    }
+
+    const int slot = level * kSlots + int((tick >> (kSlotBits * level)) & (kSlots - 1));
+    m_entries.insert(key, {tick, slot});
+    m_slots[slot].insert(key);
+}
+
+void TimerWheel::cascade(int level)
+{
+    const int slot = level * kSlots + int((m_current >> (kSlotBits * level)) & (kSlots - 1));
+    const QSet<quint64> keys = std::exchange(m_slots[slot], QSet<quint64>());
+    for (quint64 key : keys) {
+        const qint64 tick = m_entries.value(key).tick;
+        m_entries.remove(key);
+        place(key, tick);
+    }
+}
+
+qint64 TimerWheel::nextEventTick() const
+{
+    qint64 best = std::numeric_limits<qint64>::max();
+
+    for (int level = 0; level < kLevels; level++) {
+        const int shift = kSlotBits * level;
+        const qint64 span = qint64(1) << (shift + kSlotBits);
+        const qint64 base = (m_current >> (shift + kSlotBits)) << (shift + kSlotBits);
+
+        for (int index = 0; index < kSlots; index++) {
+            if (m_slots.at(level * kSlots + index).isEmpty()) {
+                continue;
+            }
+            // When the current tick next enters this slot's range.
+            qint64 tick = base + (qint64(index) << shift);
+            if (tick <= m_current) {
+                tick += span;
+            }
+            best = qMin(best, tick);
+        }
+    }
+    return best;
+}
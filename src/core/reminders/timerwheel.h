@@ -0,0 +1,54 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+// Hierarchical timing wheel keyed by caller-chosen 64-bit ids.
+//
+// Five levels of 64 slots over a fixed tick (one second by default) cover
+// about 34 years. An entry sits on the level of the highest 6-bit group in
+// which its deadline tick differs from the current tick; when the current
+// tick reaches that group the slot is cascaded into finer levels, and
+// level 0 slots expire. Insert and cancel are a hash lookup plus a set
+// insert/remove, independent of how many entries are pending, and
+// advance() jumps straight over empty stretches of time.
+class TimerWheel
+{
+public:
+    explicit TimerWheel(qint64 nowMs = 0, qint64 tickMs = 1000);
+
+    // Schedules key at deadlineMs, replacing any earlier deadline for it.
+    void insert(quint64 key, qint64 deadlineMs);
+    bool cancel(quint64 key);
+    bool contains(quint64 key) const;
+    int size() const;
+
+    // Moves time forward and returns the keys that expired, in deadline order.
+    QVector<quint64> advance(qint64 nowMs);
+    // The time advance() next has work to do, or -1 when empty.
+    qint64 nextWakeMs() const;
+
+private:
+    static const int kLevels = 5;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+
+    struct Entry {
+        qint64 tick;
+        int slot;   // index into m_slots, -1 when already due
+    };
+
+    qint64 m_tickMs;
+    qint64 m_current;   // current tick
+    QHash<quint64, Entry> m_entries;
+    QVector<QSet<quint64>> m_slots;   // kLevels * kSlots
+    QSet<quint64> m_due;              // deadline already reached at insert
+
+    void place(quint64 key, qint64 tick);
+    void cascade(int level);
+    qint64 nextEventTick() const;
+};
+
+#endif // TIMERWHEEL_H
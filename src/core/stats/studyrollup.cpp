@@ -0,0 +1,217 @@
+#include "studyrollup.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QMap>
+#include <QDebug>
+
+StudyRollup::StudyRollup(QObject *parent)
+    : QObject(parent)
+{
+    DatabaseManager::instance().createRollupTables();
+
+    // First run on an existing database: seed the rollups from history.
+    QSqlQuery query("SELECT COUNT(*) FROM study_rollup_daily");
+    if (query.next() && query.value(0).toInt() == 0) {
+        rebuild();
+    }
+}
+
+QString StudyRollup::weekKey(const QDate &day)
+{
+    int year = 0;
+    const int week = day.weekNumber(&year);
+    return QString("%1-W%2").arg(year).arg(week, 2, 10, QChar('0'));
+}
+
+QVariantMap StudyRollup::daySummary(const QDate &day) const
+{
+    const QVariantList rows = dailySummaries(day, day);
+    if (!rows.isEmpty()) {
+        return rows.first().toMap();
+    }
+
+    QVariantMap empty;
+    empty["day"] = day.toString(Qt::ISODate);
+    empty["focusMinutes"] = 0;
+    empty["sessions"] = 0;
+    empty["todosCompleted"] = 0;
+    empty["habitsChecked"] = 0;
+    return empty;
+}
+
+QVariantList StudyRollup::dailySummaries(const QDate &from, const QDate &to) const
+{
+    return loadRows("study_rollup_daily", "day", from.toString(Qt::ISODate), to.toString(Qt::ISODate));
+}
+
+QVariantList StudyRollup::weeklySummaries(const QDate &from, const QDate &to) const
+{
+    // Week keys are zero-padded, so they sort and compare as plain text.
+    return loadRows("study_rollup_weekly", "week", weekKey(from), weekKey(to));
+}
+
+bool StudyRollup::rebuild()
+{
+    QMap<QDate, Delta> days;
+
+    QSqlQuery query;
+    if (query.exec("SELECT session_day, SUM(duration_ms), "
+                   "SUM(CASE WHEN end_reason = 'completed' THEN 1 ELSE 0 END) "
+                   "FROM pomodoro_sessions WHERE kind = 'work' GROUP BY session_day")) {
+        while (query.next()) {
+            Delta &delta = days[QDate::fromString(query.value(0).toString(), Qt::ISODate)];
+            delta.focusMs = query.value(1).toLongLong();
+            delta.sessions = query.value(2).toInt();
+        }
+    }
+
+    if (query.exec("SELECT completed_day, COUNT(*) FROM todo_completions GROUP BY completed_day")) {
+        while (query.next()) {
+            days[QDate::fromString(query.value(0).toString(), Qt::ISODate)].todosCompleted = query.value(1).toInt();
+        }
+    }
+
+    if (query.exec("SELECT checkin_date, COUNT(*) FROM streak_checkins GROUP BY checkin_date")) {
+        while (query.next()) {
+            days[QDate::fromString(query.value(0).toString(), Qt::ISODate)].habitsChecked = query.value(1).toInt();
+        }
+    }
+
+    // ISO weeks are folded here rather than in SQL: strftime has no portable ISO week.
+    QMap<QString, Delta> weeks;
+    for (auto it = days.cbegin(); it != days.cend(); ++it) {
+        Delta &week = weeks[weekKey(it.key())];
+        week.focusMs += it->focusMs;
+        week.sessions += it->sessions;
+        week.todosCompleted += it->todosCompleted;
+        week.habitsChecked += it->habitsChecked;
+    }
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+    query.exec("DELETE FROM study_rollup_daily");
+    query.exec("DELETE FROM study_rollup_weekly");
+
+    auto insertRows = [&query](const QString &table, const QString &keyColumn, const QString &key, const Delta &delta) {
+        query.prepare(QString("INSERT INTO %1 (%2, focus_ms, sessions, todos_completed, habits_checked) "
+                              "VALUES (:key, :focus_ms, :sessions, :todos_completed, :habits_checked)")
+                          .arg(table, keyColumn));
+        query.bindValue(":key", key);
+        query.bindValue(":focus_ms", delta.focusMs);
+        query.bindValue(":sessions", delta.sessions);
+        query.bindValue(":todos_completed", delta.todosCompleted);
+        query.bindValue(":habits_checked", delta.habitsChecked);
+        return query.exec();
+    };
+
+    for (auto it = days.cbegin(); it != days.cend(); ++it) {
+        if (!it.key().isValid() || !insertRows("study_rollup_daily", "day", it.key().toString(Qt::ISODate), *it)) {
+            qDebug() << "Error rebuilding daily rollup:" << query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+    for (auto it = weeks.cbegin(); it != weeks.cend(); ++it) {
+        if (!insertRows("study_rollup_weekly", "week", it.key(), *it)) {
+            qDebug() << "Error rebuilding weekly rollup:" << query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+void StudyRollup::recordFocus(const QString &kind, const QDateTime &startedAt, qint64 durationMs, const QString &endReason)
+{
+    if (kind != "work") {
+        return;
+    }
+
+    Delta delta;
+    delta.focusMs = durationMs;
+    delta.sessions = endReason == "completed" ? 1 : 0;
+    applyDelta(startedAt.date(), delta);
+}
+
+void StudyRollup::recordTodoCompletion(const QDate &day, int delta)
+{
+    Delta change;
+    change.todosCompleted = delta;
+    applyDelta(day, change);
+}
+
+void StudyRollup::recordHabitCheckin(int streakId, const QDate &day)
+{
+    Q_UNUSED(streakId);
+    Delta delta;
+    delta.habitsChecked = 1;
+    applyDelta(day, delta);
+}
+
+void StudyRollup::applyDelta(const QDate &day, const Delta &delta)
+{
+    if (!day.isValid()) {
+        return;
+    }
+
+    // Upsert one daily and one weekly row; both are single-key lookups.
+    auto upsert = [&delta](const QString &table, const QString &keyColumn, const QString &key) {
+        QSqlQuery query;
+        query.prepare(QString(
+            "INSERT INTO %1 (%2, focus_ms, sessions, todos_completed, habits_checked) "
+            "VALUES (:key, :focus_ms, :sessions, :todos_completed, :habits_checked) "
+            "ON CONFLICT(%2) DO UPDATE SET "
+            "focus_ms = focus_ms + excluded.focus_ms, "
+            "sessions = sessions + excluded.sessions, "
+            "todos_completed = todos_completed + excluded.todos_completed, "
+            "habits_checked = habits_checked + excluded.habits_checked").arg(table, keyColumn));
+        query.bindValue(":key", key);
+        query.bindValue(":focus_ms", delta.focusMs);
+        query.bindValue(":sessions", delta.sessions);
+        query.bindValue(":todos_completed", delta.todosCompleted);
+        query.bindValue(":habits_checked", delta.habitsChecked);
+
+        if (!query.exec()) {
+            qDebug() << "Error updating study rollup:" << query.lastError().text();
+            return false;
+        }
+        return true;
+    };
+
+    if (!upsert("study_rollup_daily", "day", day.toString(Qt::ISODate))
+        || !upsert("study_rollup_weekly", "week", weekKey(day))) {
+        return;
+    }
+
+    emit rollupChanged(day);
+}
+
+QVariantList StudyRollup::loadRows(const QString &table, const QString &keyColumn,
+                                   const QString &from, const QString &to) const
+{
+    QVariantList rows;
+    QSqlQuery query;
+    query.prepare(QString("SELECT %2, focus_ms, sessions, todos_completed, habits_checked FROM %1 "
+                          "WHERE %2 BETWEEN :from AND :to ORDER BY %2").arg(table, keyColumn));
+    query.bindValue(":from", from);
+    query.bindValue(":to", to);
+
+    if (!query.exec()) {
+        qDebug() << "Error loading study rollup:" << query.lastError().text();
+        return rows;
+    }
+
+    while (query.next()) {
+        QVariantMap row;
+        row[keyColumn] = query.value(0).toString();
+        row["focusMinutes"] = int(query.value(1).toLongLong() / 60000);
+        row["sessions"] = query.value(2).toInt();
+        row["todosCompleted"] = query.value(3).toInt();
+        row["habitsChecked"] = query.value(4).toInt();
+        rows.append(row);
+    }
+    return rows;
+}
@@ -0,0 +1,53 @@
+#ifndef STUDYROLLUP_H
+#define STUDYROLLUP_H
+
+#include <QObject>
+#include <QDate>
+#include <QDateTime>
+#include <QVariantList>
+#include <QVariantMap>
+
+// Per-day and per-ISO-week study summaries (focus time, completed focus
+// sessions, todos completed, habits checked) kept in study_rollup_daily
+// and study_rollup_weekly. Each mutation adds its delta to one daily and
+// one weekly row, so statistics screens read a few hundred rows per year
+// instead of aggregating raw events; rebuild() recomputes both tables
+// from pomodoro_sessions, todo_completions and streak_checkins.
+class StudyRollup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StudyRollup(QObject *parent = nullptr);
+
+    Q_INVOKABLE QVariantMap daySummary(const QDate &day) const;
+    Q_INVOKABLE QVariantList dailySummaries(const QDate &from, const QDate &to) const;
+    Q_INVOKABLE QVariantList weeklySummaries(const QDate &from, const QDate &to) const;
+
+    // "2025-W07" style key of the ISO week containing day.
+    static QString weekKey(const QDate &day);
+
+public slots:
+    bool rebuild();
+
+    void recordFocus(const QString &kind, const QDateTime &startedAt, qint64 durationMs, const QString &endReason);
+    void recordTodoCompletion(const QDate &day, int delta);
+    void recordHabitCheckin(int streakId, const QDate &day);
+
+signals:
+    void rollupChanged(const QDate &day);
+
+private:
+    struct Delta {
+        qint64 focusMs = 0;
+        int sessions = 0;
+        int todosCompleted = 0;
+        int habitsChecked = 0;
+    };
+
+    void applyDelta(const QDate &day, const Delta &delta);
+    QVariantList loadRows(const QString &table, const QString &keyColumn,
+                          const QString &from, const QString &to) const;
+};
+
+#endif // STUDYROLLUP_H
@@ -0,0 +1,243 @@
+#include "streakanalytics.h"
+#include "streaksmanager.h"
+#include "../database/databasemanager.h"
+#include "../clock/clock.h"
+
+#include <QVariantMap>
+#include <algorithm>
+
+StreakAnalytics::StreakAnalytics(streaksManager *source, QObject *parent)
+    : QAbstractListModel(parent),
+    m_source(source)
+{
+    connect(m_source, &QAbstractItemModel::rowsInserted,
+            this, &StreakAnalytics::onRowsInserted);
+    connect(m_source, &QAbstractItemModel::rowsAboutToBeRemoved,
+            this, &StreakAnalytics::onRowsAboutToBeRemoved);
+    connect(m_source, &QAbstractItemModel::dataChanged,
+            this, &StreakAnalytics::onSourceDataChanged);
+    connect(m_source, &QAbstractItemModel::modelReset,
+            this, &StreakAnalytics::reload);
+    connect(m_source, &streaksManager::streakCheckedIn,
+            this, &StreakAnalytics::onStreakCheckedIn);
+
+    reload();
+}
+
+int StreakAnalytics::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_entries.size();
+}
+
+QVariant StreakAnalytics::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_entries.at(index.row());
+    const StreakHistory &history = entry.history;
+
+    switch (role) {
+    case StreakIdRole:
+        return entry.streakId;
+    case TitleRole:
+        return m_source->data(m_source->index(index.row(), 0), streaksManager::TitleRole);
+    case TotalCheckInsRole:
+        return history.totalCheckIns();
+    case RunCountRole:
+        return history.runCount();
+    case LongestRunRole:
+        return history.longestRun();
+    case MeanRunRole:
+        return history.meanRun();
+    case MedianRunRole:
+        return history.medianRun();
+    case LongestGapRole:
+        return history.longestGap();
+    case ConsistencyRole:
+        return history.consistency(Clock::instance()->today());
+    case HistogramRole:
+        return histogram(index.row());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StreakAnalytics::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[StreakIdRole] = "streakId";
+    roles[TitleRole] = "title";
+    roles[TotalCheckInsRole] = "totalCheckIns";
+    roles[RunCountRole] = "runCount";
+    roles[LongestRunRole] = "longestRun";
+    roles[MeanRunRole] = "meanRun";
+    roles[MedianRunRole] = "medianRun";
+    roles[LongestGapRole] = "longestGap";
+    roles[ConsistencyRole] = "consistency";
+    roles[HistogramRole] = "histogram";
+    return roles;
+}
+
+int StreakAnalytics::rowForStreak(int streakId) const
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).streakId == streakId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QVariantList StreakAnalytics::histogram(int row) const
+{
+    QVariantList buckets;
+    if (row < 0 || row >= m_entries.size()) {
+        return buckets;
+    }
+
+    const QMap<int, int> counts = m_entries.at(row).history.histogram();
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) {
+        QVariantMap bucket;
+        bucket["length"] = it.key();
+        bucket["count"] = it.value();
+        buckets.append(bucket);
+    }
+    return buckets;
+}
+
+QVariantList StreakAnalytics::dayValues(int row, const QDate &startDate, int days) const
+{
+    QVariantList values;
+    if (row < 0 || row >= m_entries.size() || !startDate.isValid() || days <= 0) {
+        return values;
+    }
+
+    // Expand only the runs that overlap the requested window.
+    const qint64 first = startDate.toJulianDay();
+    const qint64 last = first + days - 1;
+    QVector<int> flags(days, 0);
+
+    for (const StreakRun &run : m_entries.at(row).history.runs()) {
+        if (run.endDay() < first) {
+            continue;
+        }
+        if (run.startDay > last) {
+            break;
+        }
+        for (qint64 jd = std::max(run.startDay, first); jd <= std::min(run.endDay(), last); ++jd) {
+            flags[int(jd - first)] = 1;
+        }
+    }
+
+    values.reserve(days);
+    for (int flag : std::as_const(flags)) {
+        values.append(flag);
+    }
+    return values;
+}
+
+const StreakHistory *StreakAnalytics::history(int streakId) const
+{
+    const int row = rowForStreak(streakId);
+    return row < 0 ? nullptr : &m_entries.at(row).history;
+}
+
+void StreakAnalytics::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), first, last);
+    for (int row = first; row <= last; ++row) {
+        m_entries.insert(row, loadEntry(row));
+    }
+    endInsertRows();
+}
+
+void StreakAnalytics::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), first, last);
+    m_entries.remove(first, last - first + 1);
+    endRemoveRows();
+}
+
+void StreakAnalytics::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    // Only the title is mirrored from the source; metrics change via check-ins.
+    emit dataChanged(index(topLeft.row(), 0), index(bottomRight.row(), 0),
+                     QVector<int>() << TitleRole);
+}
+
+void StreakAnalytics::onStreakCheckedIn(int streakId, const QDate &day)
+{
+    const int row = rowForStreak(streakId);
+    if (row < 0) {
+        return;
+    }
+
+    if (m_entries[row].history.addCheckIn(day)) {
+        QModelIndex modelIndex = index(row, 0);
+        emit dataChanged(modelIndex, modelIndex);
+        emit checkInAdded(row, day);
+    }
+}
+
+void StreakAnalytics::reloadHistories(const QVector<int> &streakIds)
+{
+    // Check-ins written by another connection; re-read just those streaks.
+    for (int streakId : streakIds) {
+        const int row = rowForStreak(streakId);
+        if (row < 0) {
+            continue;
+        }
+
+        m_entries[row] = loadEntry(row);
+        QModelIndex modelIndex = index(row, 0);
+        emit dataChanged(modelIndex, modelIndex);
+        emit historyReset(row);
+    }
+}
+
+void StreakAnalytics::reload()
+{
+    beginResetModel();
+    m_entries.clear();
+    for (int row = 0; row < m_source->rowCount(); ++row) {
+        m_entries.append(loadEntry(row));
+    }
+    endResetModel();
+}
+
+StreakAnalytics::Entry StreakAnalytics::loadEntry(int sourceRow) const
+{
+    const QModelIndex sourceIndex = m_source->index(sourceRow, 0);
+
+    Entry entry;
+    entry.streakId = m_source->data(sourceIndex, streaksManager::IdRole).toInt();
+
+    QVector<QDate> days = DatabaseManager::instance().loadStreakCheckins(entry.streakId);
+
+    // Streaks created before check-ins were logged only know their current run.
+    if (days.isEmpty()) {
+        const int duration = m_source->data(sourceIndex, streaksManager::StreakDurationRole).toInt();
+        const QDate lastDay = m_source->data(sourceIndex, streaksManager::LastActivityRole).toDateTime().date();
+        if (duration > 0 && lastDay.isValid()) {
+            for (int i = duration - 1; i >= 0; --i) {
+                days.append(lastDay.addDays(-i));
+            }
+        }
+    }
+
+    entry.history.setCheckIns(days);
+    return entry;
+}
@@ -0,0 +1,71 @@
+#ifndef STREAKANALYTICS_H
+#define STREAKANALYTICS_H
+
+#include <QAbstractListModel>
+#include <QObject>
+#include <QVector>
+#include <QDate>
+
+#include "streakhistory.h"
+
+class streaksManager;
+
+// Per-streak run-length analytics, one row per row of the streaks model.
+// Histories are loaded once and then updated in place on each check-in.
+class StreakAnalytics : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit StreakAnalytics(streaksManager *source, QObject *parent = nullptr);
+
+    enum AnalyticsRoles {
+        StreakIdRole = Qt::UserRole + 1,
+        TitleRole,
+        TotalCheckInsRole,
+        RunCountRole,
+        LongestRunRole,
+        MeanRunRole,
+        MedianRunRole,
+        LongestGapRole,
+        ConsistencyRole,
+        HistogramRole
+    };
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE int rowForStreak(int streakId) const;
+    Q_INVOKABLE QVariantList histogram(int row) const;
+    Q_INVOKABLE QVariantList dayValues(int row, const QDate &startDate, int days) const;
+
+    const StreakHistory *history(int streakId) const;
+
+public slots:
+    void reloadHistories(const QVector<int> &streakIds);
+
+signals:
+    void checkInAdded(int row, const QDate &day);
+    void historyReset(int row);
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onStreakCheckedIn(int streakId, const QDate &day);
+    void reload();
+
+private:
+    struct Entry {
+        int streakId;
+        StreakHistory history;
+    };
+
+    streaksManager *m_source;
+    QVector<Entry> m_entries;
+
+    Entry loadEntry(int sourceRow) const;
+};
+
+#endif // STREAKANALYTICS_H
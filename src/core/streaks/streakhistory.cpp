@@ -0,0 +1,232 @@
+#include "streakhistory.h"
+
+#include <algorithm>
+
+StreakHistory::StreakHistory()
+    : m_totalCheckIns(0),
+    m_longestGap(0)
+{
+}
+
+void StreakHistory::clear()
+{
+    m_runs.clear();
+    m_histogram.clear();
+    m_totalCheckIns = 0;
+    m_longestGap = 0;
+}
+
+void StreakHistory::setCheckIns(const QVector<QDate> &days)
+{
+    QVector<qint64> julianDays;
+    julianDays.reserve(days.size());
+    for (const QDate &day : days) {
+        if (day.isValid()) {
+            julianDays.append(day.toJulianDay());
+        }
+    }
+    rebuild(julianDays);
+}
+
+bool StreakHistory::addCheckIn(const QDate &day)
+{
+    if (!day.isValid()) {
+        return false;
+    }
+
+    const qint64 jd = day.toJulianDay();
+
+    if (m_runs.isEmpty()) {
+        m_runs.append({jd, 1});
+        addRunLength(1);
+        m_totalCheckIns = 1;
+        return true;
+    }
+
+    StreakRun &last = m_runs.last();
+
+    // Common case: today's check-in extends or follows the latest run.
+    if (jd >= last.startDay) {
+        if (jd <= last.endDay()) {
+            return false;
+        }
+
+        if (jd == last.endDay() + 1) {
+            removeRunLength(last.length);
+            last.length++;
+            addRunLength(last.length);
+        } else {
+            m_longestGap = std::max(m_longestGap, int(jd - last.endDay() - 1));
+            m_runs.append({jd, 1});
+            addRunLength(1);
+        }
+
+        m_totalCheckIns++;
+        return true;
+    }
+
+    // Back-dated check-in (e.g. merged from another device): rare, so rebuild.
+    if (contains(day)) {
+        return false;
+    }
+
+    QVector<qint64> days;
+    days.reserve(m_totalCheckIns + 1);
+    for (const StreakRun &run : std::as_const(m_runs)) {
+        for (int i = 0; i < run.length; ++i) {
+            days.append(run.startDay + i);
+        }
+    }
+    days.append(jd);
+    rebuild(days);
+    return true;
+}
+
+bool StreakHistory::contains(const QDate &day) const
+{
+    if (!day.isValid()) {
+        return false;
+    }
+
+    const qint64 jd = day.toJulianDay();
+    auto it = std::upper_bound(m_runs.cbegin(), m_runs.cend(), jd,
+                               [](qint64 value, const StreakRun &run) {
+                                   return value < run.startDay;
+                               });
+    if (it == m_runs.cbegin()) {
+        return false;
+    }
+    --it;
+    return jd <= it->endDay();
+}
+
+const QVector<StreakRun> &StreakHistory::runs() const
+{
+    return m_runs;
+}
+
+QMap<int, int> StreakHistory::histogram() const
+{
+    return m_histogram;
+}
+
+int StreakHistory::totalCheckIns() const
+{
+    return m_totalCheckIns;
+}
+
+int StreakHistory::runCount() const
+{
+    return m_runs.size();
+}
+
+int StreakHistory::longestRun() const
+{
+    return m_histogram.isEmpty() ? 0 : m_histogram.lastKey();
+}
+
+int StreakHistory::longestGap() const
+{
+    return m_longestGap;
+}
+
+double StreakHistory::meanRun() const
+{
+    if (m_runs.isEmpty()) {
+        return 0.0;
+    }
+    return double(m_totalCheckIns) / m_runs.size();
+}
+
+double StreakHistory::medianRun() const
+{
+    const int runCount = m_runs.size();
+    if (runCount == 0) {
+        return 0.0;
+    }
+
+    // Walk the histogram instead of sorting run lengths.
+    const int lowerRank = (runCount - 1) / 2;
+    const int upperRank = runCount / 2;
+    int lower = 0;
+    int upper = 0;
+    int seen = 0;
+
+    for (auto it = m_histogram.cbegin(); it != m_histogram.cend(); ++it) {
+        const int next = seen + it.value();
+        if (lowerRank >= seen && lowerRank < next) {
+            lower = it.key();
+        }
+        if (upperRank >= seen && upperRank < next) {
+            upper = it.key();
+            break;
+        }
+        seen = next;
+    }
+
+    return (lower + upper) / 2.0;
+}
+
+double StreakHistory::consistency(const QDate &today, int windowDays) const
+{
+    if (!today.isValid() || windowDays <= 0) {
+        return 0.0;
+    }
+
+    const qint64 windowEnd = today.toJulianDay();
+    const qint64 windowStart = windowEnd - windowDays + 1;
+    int covered = 0;
+
+    for (auto it = m_runs.crbegin(); it != m_runs.crend(); ++it) {
+        if (it->endDay() < windowStart) {
+            break;
+        }
+        const qint64 first = std::max(it->startDay, windowStart);
+        const qint64 last = std::min(it->endDay(), windowEnd);
+        if (last >= first) {
+            covered += int(last - first + 1);
+        }
+    }
+
+    return double(covered) / windowDays;
+}
+
+void StreakHistory::rebuild(QVector<qint64> days)
+{
+    clear();
+
+    std::sort(days.begin(), days.end());
+    days.erase(std::unique(days.begin(), days.end()), days.end());
+
+    for (qint64 jd : std::as_const(days)) {
+        if (!m_runs.isEmpty() && jd == m_runs.last().endDay() + 1) {
+            m_runs.last().length++;
+        } else {
+            if (!m_runs.isEmpty()) {
+                m_longestGap = std::max(m_longestGap, int(jd - m_runs.last().endDay() - 1));
+            }
+            m_runs.append({jd, 1});
+        }
+    }
+
+    for (const StreakRun &run : std::as_const(m_runs)) {
+        addRunLength(run.length);
+    }
+    m_totalCheckIns = days.size();
+}
+
+void StreakHistory::addRunLength(int length)
+{
+    m_histogram[length]++;
+}
+
+void StreakHistory::removeRunLength(int length)
+{
+    auto it = m_histogram.find(length);
+    if (it == m_histogram.end()) {
+        return;
+    }
+    if (--it.value() == 0) {
+        m_histogram.erase(it);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef STREAKHISTORY_H
+#define STREAKHISTORY_H
+
+#include <QDate>
+#include <QMap>
+#include <QVector>
+
+// One unbroken run of consecutive check-in days.
+struct StreakRun
+{
+    qint64 startDay;   // Julian day of the first check-in in the run
+    int length;        // Number of consecutive days
+
+    qint64 endDay() const { return startDay + length - 1; }
+};
+
+// Run-length encoded check-in history of a single streak.
+// Aggregates (histogram, sum, longest gap) are maintained on every
+// check-in so reading the metrics never walks the raw day list.
+class StreakHistory
+{
+public:
+    StreakHistory();
+
+    void clear();
+    void setCheckIns(const QVector<QDate> &days);
+    bool addCheckIn(const QDate &day);
+    bool contains(const QDate &day) const;
+
+    const QVector<StreakRun> &runs() const;
+    QMap<int, int> histogram() const;
+
+    int totalCheckIns() const;
+    int runCount() const;
+    int longestRun() const;
+    int longestGap() const;
+    double meanRun() const;
+    double medianRun() const;
+    double consistency(const QDate &today, int windowDays = 30) const;
+
+private:
+    QVector<StreakRun> m_runs;
+    QMap<int, int> m_histogram;   // run length -> number of runs
+    int m_totalCheckIns;
+    int m_longestGap;
+
+    void rebuild(QVector<qint64> days);
+    void addRunLength(int length);
+    void removeRunLength(int length);
+};
+
+#endif // STREAKHISTORY_H
@@ -1,4 +1,5 @@
 #include "streaks.h"
+#include "../clock/clock.h"
 
 #include <QObject>
 #include <QDateTime>
@@ -39,7 +40,7 @@ void Streaks::setTitle(const QString &title){
 
 void Streaks::incrementStreakDuration(){
     m_streakDuration++;
-    m_lastActivity = QDateTime::currentDateTime();
+    m_lastActivity = Clock::instance()->now();
     updateBestStreak();
     emit streakDurationChanged();
 }
@@ -67,7 +68,7 @@ bool Streaks::isActiveToday() const{
     if(!m_lastActivity.isValid()){
         return false;
     }
-    QDate today = QDate::currentDate();
+    QDate today = Clock::instance()->today();
     QDate lastActive = m_lastActivity.date();
 
     return today == lastActive;
@@ -79,7 +80,7 @@ bool Streaks::isStreakBroken() const {
         return true;
     }
 
-    QDate today = QDate::currentDate();
+    QDate today = Clock::instance()->today();
     QDate lastActive = m_lastActivity.date();
 
     int difference = lastActive.daysTo(today);
@@ -93,7 +94,7 @@ int Streaks::daysSinceLastActivity() const{
         return -1;
     }
 
-    QDate today = QDate::currentDate();
+    QDate today = Clock::instance()->today();
     QDate lastActive = m_lastActivity.date();
 
     int difference = lastActive.daysTo(today);
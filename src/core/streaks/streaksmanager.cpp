@@ -46,6 +46,8 @@ QVariant streaksManager::data(const QModelIndex &index, int role) const
         return streak->daysSinceLastActivity();
     case IsBestStreakZeroRole:
         return streak->isBestStreakZero();
+    case IdRole:
+        return streak->id();
     default:
         return QVariant();
     }
@@ -102,6 +104,7 @@ QHash<int, QByteArray> streaksManager::roleNames() const
     roles[IsStreakBrokenRole] = "isStreakBroken";
     roles[DaysSinceLastActivityRole] = "daysSinceLastActivity";
     roles[IsBestStreakZeroRole] = "isBestStreakZero";
+    roles[IdRole] = "streakId";
     return roles;
 }
 
@@ -175,10 +178,41 @@ void streaksManager::incrementStreak(int index)
         streak->lastActivity()
         );
 
+    const QDate day = streak->lastActivity().date();
+    bool newCheckin = false;
+    DatabaseManager::instance().recordStreakCheckin(streak->id(), day, &newCheckin);
+
     QModelIndex modelIndex = createIndex(index, 0);
     emit dataChanged(modelIndex, modelIndex);
     emit streakUpdated();
     emit activeStreaksChanged();
+    if (newCheckin) {
+        emit streakCheckedIn(streak->id(), day);
+    }
+}
+
+void streaksManager::recordActivity(const QString &title)
+{
+    int row = -1;
+    for (int i = 0; i < m_streaks.size(); ++i) {
+        if (m_streaks.at(i)->title() == title) {
+            row = i;
+            break;
+        }
+    }
+
+    if (row < 0) {
+        addStreak(title);
+        row = m_streaks.size() - 1;
+        if (row < 0 || m_streaks.at(row)->title() != title) {
+            return;
+        }
+    }
+
+    // Activity feeds the streak, it does not count twice in a day.
+    if (!m_streaks.at(row)->isActiveToday()) {
+        incrementStreak(row);
+    }
 }
 
 void streaksManager::resetStreak(int index)
@@ -236,6 +270,87 @@ void streaksManager::updateStats()
 
 
 
+void streaksManager::reloadFromDatabase()
+{
+    loadStreaksFromDatabase();
+    emit totalStreaksChanged();
+    emit activeStreaksChanged();
+}
+
+void streaksManager::applyExternalChanges(const QVector<int> &ids)
+{
+    bool countChanged = false;
+    bool anyChanged = false;
+
+    for (int id : ids) {
+        const QVariantMap data = DatabaseManager::instance().loadStreak(id);
+        const int row = rowForId(id);
+
+        if (data.isEmpty()) {
+            if (row >= 0) {
+                beginRemoveRows(QModelIndex(), row, row);
+                delete m_streaks.takeAt(row);
+                endRemoveRows();
+                emit streakRemoved();
+                countChanged = true;
+            }
+            continue;
+        }
+
+        if (row < 0) {
+            beginInsertRows(QModelIndex(), m_streaks.size(), m_streaks.size());
+            Streaks *streak = new Streaks(data["title"].toString(), this);
+            streak->setId(id);
+            streak->setStreakDuration(data["streakDuration"].toInt());
+            streak->setLastActivity(data["lastActivity"].toDateTime());
+            streak->setBestStreak(data["bestStreak"].toInt());
+            m_streaks.append(streak);
+            endInsertRows();
+            emit streakAdded();
+            countChanged = true;
+            continue;
+        }
+
+        Streaks *streak = m_streaks.at(row);
+        const QString title = data["title"].toString();
+        const int duration = data["streakDuration"].toInt();
+        const int best = data["bestStreak"].toInt();
+        const QDateTime lastActivity = data["lastActivity"].toDateTime();
+
+        if (streak->title() == title && streak->streakDuration() == duration
+            && streak->bestStreak() == best && streak->lastActivity() == lastActivity) {
+            continue;
+        }
+
+        streak->setTitle(title);
+        streak->setStreakDuration(duration);
+        streak->setBestStreak(best);
+        streak->setLastActivity(lastActivity);
+
+        QModelIndex modelIndex = createIndex(row, 0);
+        emit dataChanged(modelIndex, modelIndex);
+        emit streakUpdated();
+        anyChanged = true;
+    }
+
+    if (countChanged) {
+        emit totalStreaksChanged();
+    }
+    if (countChanged || anyChanged) {
+        emit activeStreaksChanged();
+    }
+}
+
+int streaksManager::rowForId(int id) const
+{
+    for (int i = 0; i < m_streaks.size(); ++i) {
+        if (m_streaks.at(i)->id() == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void streaksManager::loadStreaksFromDatabase()
 {
     beginResetModel();
@@ -353,11 +468,11 @@ void streaksManager::deleteStreakFromDatabase(int id)
 
 
 void streaksManager::setupDailyResetTimer() {
-    m_dailyResetTimer = new QTimer(this);
+    m_dailyResetTimer = Clock::instance()->createTimer(this);
 
     m_dailyResetTimer->setInterval(3600000);
 
-    connect(m_dailyResetTimer, &QTimer::timeout,
+    connect(m_dailyResetTimer, &ClockTimer::timeout,
             this, &streaksManager::checkAndResetExpiredStreaks);
 
     m_dailyResetTimer->start();
@@ -366,12 +481,12 @@ void streaksManager::setupDailyResetTimer() {
 }
 
 void streaksManager::checkAndResetExpiredStreaks() {
-    QDateTime now = QDateTime::currentDateTime();
-
     for (int i = 0; i < m_streaks.size(); ++i) {
         Streaks *streak = m_streaks[i];
 
-        if (streak->lastActivity().secsTo(now) > 86400) { // 86400 seconds = 24 hours
+        // Same calendar-day rule the UI uses, so a check-in at 9:00 followed by
+        // one at 10:00 the next day does not reset the streak in between.
+        if (streak->isStreakBroken()) {
             if (streak->streakDuration() > 0) {
                 streak->setStreakDuration(0);  // Reset to 0
                 updateStreakInDatabase(streak);
@@ -9,6 +9,8 @@
 #include <QDateTime>
 #include <QTimer>
 
+#include "../clock/clock.h"
+
 #include "streaks.h"
 
 class streaksManager: public QAbstractListModel
@@ -21,7 +23,7 @@ class streaksManager: public QAbstractListModel
 
 private:
     QVector<Streaks*> m_streaks;
-    QTimer *m_dailyResetTimer;
+    ClockTimer *m_dailyResetTimer;
 
     void updateStats();
     void loadStreaksFromDatabase();
@@ -30,6 +32,7 @@ private:
     void deleteStreakFromDatabase(int id);
     void setupDailyResetTimer();
     void checkAndResetExpiredStreaks();
+    int rowForId(int id) const;
 
 public:
     explicit streaksManager(QObject *parent = nullptr);
@@ -42,7 +45,8 @@ public:
         IsActiveTodayRole,
         IsStreakBrokenRole,
         DaysSinceLastActivityRole,
-        IsBestStreakZeroRole
+        IsBestStreakZeroRole,
+        IdRole
     };
 
     // REQUIRED METHODS FOR QAbstractListModel
@@ -56,12 +60,18 @@ public:
     Q_INVOKABLE void removeStreak(int index);
     Q_INVOKABLE void incrementStreak(int index);
     Q_INVOKABLE void resetStreak(int index);
+    // Checks in the streak with this title once per day, creating it if needed.
+    Q_INVOKABLE void recordActivity(const QString &title);
     Q_INVOKABLE int count() const;
     Q_INVOKABLE void killStreaksView();
 
     int totalStreaks() const;
     int activeStreaks() const;
 
+public slots:
+    void applyExternalChanges(const QVector<int> &ids);
+    void reloadFromDatabase();
+
 signals:
     void streakAdded();
     void streakRemoved();
@@ -69,6 +79,7 @@ signals:
     void totalStreaksChanged();
     void activeStreaksChanged();
     void closeStreaksView();
+    void streakCheckedIn(int streakId, const QDate &day);
 
 
 
@@ -0,0 +1,89 @@
+#include "hybridlogicalclock.h"
+#include "../clock/clock.h"
+
+#include <algorithm>
+
+QString HlcTimestamp::toString() const
+{
+    return QString("%1-%2-%3")
+        .arg(wallMs, 15, 10, QChar('0'))
+        .arg(counter, 8, 16, QChar('0'))
+        .arg(node);
+}
+
+HlcTimestamp HlcTimestamp::fromString(const QString &text)
+{
+    HlcTimestamp timestamp;
+    const int first = text.indexOf('-');
+    const int second = first < 0 ? -1 : text.indexOf('-', first + 1);
+    if (second < 0) {
+        return timestamp;
+    }
+
+    timestamp.wallMs = text.left(first).toLongLong();
+    timestamp.counter = text.mid(first + 1, second - first - 1).toUInt(nullptr, 16);
+    timestamp.node = text.mid(second + 1);
+    return timestamp;
+}
+
+bool HlcTimestamp::operator<(const HlcTimestamp &other) const
+{
+    if (wallMs != other.wallMs) {
+        return wallMs < other.wallMs;
+    }
+    if (counter != other.counter) {
+        return counter < other.counter;
+    }
+    return node < other.node;
+}
+
+bool HlcTimestamp::operator==(const HlcTimestamp &other) const
+{
+    return wallMs == other.wallMs && counter == other.counter && node == other.node;
+}
+
+HybridLogicalClock::HybridLogicalClock(const QString &node)
+{
+    m_last.node = node;
+}
+
+void HybridLogicalClock::setNode(const QString &node)
+{
+    m_last.node = node;
+}
+
+QString HybridLogicalClock::node() const
+{
+    return m_last.node;
+}
+
+HlcTimestamp HybridLogicalClock::now()
+{
+    const qint64 physical = Clock::instance()->now().toMSecsSinceEpoch();
+
+    if (physical > m_last.wallMs) {
+        m_last.wallMs = physical;
+        m_last.counter = 0;
+    } else {
+        // Wall clock stalled or went backwards: keep ordering with the counter.
+        m_last.counter++;
+    }
+    return m_last;
+}
+
+void HybridLogicalClock::receive(const HlcTimestamp &remote)
+{
+    const qint64 physical = Clock::instance()->now().toMSecsSinceEpoch();
+    const qint64 wall = std::max({m_last.wallMs, remote.wallMs, physical});
+
+    if (wall == m_last.wallMs && wall == remote.wallMs) {
+        m_last.counter = std::max(m_last.counter, remote.counter) + 1;
+    } else if (wall == m_last.wallMs) {
+        m_last.counter++;
+    } else if (wall == remote.wallMs) {
+        m_last.counter = remote.counter + 1;
+    } else {
+        m_last.counter = 0;
+    }
+    m_last.wallMs = wall;
+}
@@ -0,0 +1,42 @@
+#ifndef HYBRIDLOGICALCLOCK_H
+#define HYBRIDLOGICALCLOCK_H
+
+#include <QString>
+
+// Hybrid logical clock timestamp: physical milliseconds, a logical counter
+// for events within the same millisecond, and the originating device as a
+// final tie-breaker. The string form is fixed-width so timestamps compare
+// correctly as plain strings (and in SQL).
+struct HlcTimestamp
+{
+    qint64 wallMs = 0;
+    quint32 counter = 0;
+    QString node;
+
+    bool isValid() const { return wallMs > 0; }
+
+    QString toString() const;
+    static HlcTimestamp fromString(const QString &text);
+
+    bool operator<(const HlcTimestamp &other) const;
+    bool operator==(const HlcTimestamp &other) const;
+};
+
+class HybridLogicalClock
+{
+public:
+    explicit HybridLogicalClock(const QString &node = QString());
+
+    void setNode(const QString &node);
+    QString node() const;
+
+    // Timestamp for a local event.
+    HlcTimestamp now();
+    // Merge a timestamp seen in a remote event so later local events order after it.
+    void receive(const HlcTimestamp &remote);
+
+private:
+    HlcTimestamp m_last;
+};
+
+#endif // HYBRIDLOGICALCLOCK_H
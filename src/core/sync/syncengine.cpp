@@ -0,0 +1,572 @@
+#include "syncengine.h"
+#include "../clock/clock.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QUuid>
+#include <QDebug>
+
+namespace {
+
+const QString kDeletedField = "_deleted";
+const QString kCheckinEntity = "streak_checkin";
+
+QJsonValue jsonFromSql(const QVariant &value)
+{
+    return value.isNull() ? QJsonValue(QJsonValue::Null) : QJsonValue::fromVariant(value);
+}
+
+} // namespace
+
+SyncEngine::SyncEngine(QObject *parent)
+    : QObject(parent),
+    m_timer(Clock::instance()->createTimer(this))
+{
+    DatabaseManager::instance().createSyncTables();
+
+    m_deviceId = meta("device_id");
+    if (m_deviceId.isEmpty()) {
+        m_deviceId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        setMeta("device_id", m_deviceId);
+    }
+    m_hlc.setNode(m_deviceId);
+    m_directory = meta("sync_directory");
+
+    connect(m_timer, &ClockTimer::timeout, this, &SyncEngine::syncNow);
+    m_timer->start(30000);
+}
+
+QString SyncEngine::syncDirectory() const
+{
+    return m_directory;
+}
+
+void SyncEngine::setSyncDirectory(const QString &directory)
+{
+    if (m_directory == directory) {
+        return;
+    }
+
+    m_directory = directory;
+    setMeta("sync_directory", directory);
+    emit syncDirectoryChanged();
+    syncNow();
+}
+
+void SyncEngine::setSyncDirectoryUrl(const QUrl &url)
+{
+    if (!url.isLocalFile()) {
+        qDebug() << "Sync folder must be a local path:" << url;
+        return;
+    }
+    setSyncDirectory(url.toLocalFile());
+}
+
+QString SyncEngine::deviceId() const
+{
+    return m_deviceId;
+}
+
+QDateTime SyncEngine::lastSync() const
+{
+    return m_lastSync;
+}
+
+void SyncEngine::syncNow()
+{
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    // Export first so unsynced local edits get their HLC before remote
+    // writes to the same fields are compared against them.
+    const int exported = exportLocalChanges();
+    const int applied = applyRemoteChanges();
+
+    SyncLog(m_directory, m_deviceId).compact();
+
+    m_lastSync = Clock::instance()->now();
+    emit syncFinished(exported, applied);
+}
+
+int SyncEngine::exportLocalChanges()
+{
+    SyncLog log(m_directory, m_deviceId);
+    if (!log.isValid()) {
+        return 0;
+    }
+
+    qint64 oldestSequence = 0;
+    qint64 newestSequence = 0;
+    QSqlQuery bounds("SELECT COALESCE(MIN(seq), 0), COALESCE(MAX(seq), 0) FROM change_log");
+    if (bounds.next()) {
+        oldestSequence = bounds.value(0).toLongLong();
+        newestSequence = bounds.value(1).toLongLong();
+    }
+
+    // Table name -> local row ids touched since the last export.
+    QHash<QString, QSet<int>> changedRows;
+    const QString cursorText = meta("local_seq");
+    const qint64 cursor = cursorText.toLongLong();
+
+    if (cursorText.isEmpty() || cursor < oldestSequence - 1) {
+        // First export, or the change log was pruned past us: diff everything.
+        const QStringList scans = {
+            "SELECT 'todo_lists', id FROM todo_lists",
+            "SELECT 'todos', id FROM todos",
+            "SELECT 'streaks', id FROM streaks",
+            "SELECT DISTINCT 'streak_checkins', streak_id FROM streak_checkins"
+        };
+        for (const QString &scan : scans) {
+            QSqlQuery query(scan);
+            while (query.next()) {
+                changedRows[query.value(0).toString()].insert(query.value(1).toInt());
+            }
+        }
+    } else {
+        QSqlQuery query;
+        query.prepare("SELECT table_name, row_id FROM change_log "
+                      "WHERE seq > :cursor AND seq <= :newest GROUP BY table_name, row_id");
+        query.bindValue(":cursor", cursor);
+        query.bindValue(":newest", newestSequence);
+        if (!query.exec()) {
+            qDebug() << "Error reading change log for sync:" << query.lastError().text();
+            return 0;
+        }
+        while (query.next()) {
+            changedRows[query.value(0).toString()].insert(query.value(1).toInt());
+        }
+    }
+
+    QVector<SyncOp> ops;
+    for (const QString &entity : {QString("todo_list"), QString("todo"), QString("streak")}) {
+        const EntitySpec *entitySpec = spec(entity);
+        for (int id : changedRows.value(entitySpec->table)) {
+            diffRow(*entitySpec, id, ops);
+        }
+    }
+    for (int streakId : changedRows.value("streak_checkins")) {
+        diffCheckins(streakId, ops);
+    }
+    collectTombstones(ops);
+
+    if (!log.append(ops)) {
+        return 0;
+    }
+
+    // Only record what was exported once it is safely in the log.
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    QSqlQuery clearTombstone;
+    clearTombstone.prepare("DELETE FROM sync_tombstones WHERE entity = :entity AND uid = :uid");
+    for (const SyncOp &op : std::as_const(ops)) {
+        storeFieldState(op);
+        if (op.field == kDeletedField) {
+            clearTombstone.bindValue(":entity", op.entity);
+            clearTombstone.bindValue(":uid", op.uid);
+            clearTombstone.exec();
+        }
+    }
+    setMeta("local_seq", QString::number(newestSequence));
+
+    db.commit();
+    return ops.size();
+}
+
+int SyncEngine::applyRemoteChanges()
+{
+    SyncLog log(m_directory, m_deviceId);
+    if (!log.isValid()) {
+        return 0;
+    }
+
+    QHash<QString, QSet<int>> changed;
+    int applied = 0;
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    for (const QString &device : log.remoteDevices()) {
+        QHash<QString, qint64> cursors;
+        QSqlQuery cursorQuery;
+        cursorQuery.prepare("SELECT segment, byte_offset FROM sync_cursors WHERE device = :device");
+        cursorQuery.bindValue(":device", device);
+        if (cursorQuery.exec()) {
+            while (cursorQuery.next()) {
+                cursors.insert(cursorQuery.value(0).toString(), cursorQuery.value(1).toLongLong());
+            }
+        }
+
+        const QStringList segments = log.segments(device);
+        for (const QString &segment : segments) {
+            qint64 offset = cursors.value(segment, 0);
+            const qint64 before = offset;
+
+            const QVector<SyncOp> ops = SyncLog::readSegment(log.segmentPath(device, segment), offset);
+            for (const SyncOp &op : ops) {
+                if (applyOp(op, changed)) {
+                    applied++;
+                }
+            }
+
+            if (offset != before) {
+                QSqlQuery save;
+                save.prepare("INSERT OR REPLACE INTO sync_cursors (device, segment, byte_offset) "
+                             "VALUES (:device, :segment, :offset)");
+                save.bindValue(":device", device);
+                save.bindValue(":segment", segment);
+                save.bindValue(":offset", offset);
+                save.exec();
+            }
+            cursors.remove(segment);
+        }
+
+        // Segments that disappeared were compacted by their owner.
+        for (auto it = cursors.cbegin(); it != cursors.cend(); ++it) {
+            QSqlQuery drop;
+            drop.prepare("DELETE FROM sync_cursors WHERE device = :device AND segment = :segment");
+            drop.bindValue(":device", device);
+            drop.bindValue(":segment", it.key());
+            drop.exec();
+        }
+    }
+
+    db.commit();
+
+    auto toVector = [](const QSet<int> &ids) { return QVector<int>(ids.cbegin(), ids.cend()); };
+    if (changed.contains("todo_lists")) {
+        emit todoListsChanged();
+    }
+    if (changed.contains("todos")) {
+        emit todosChanged(toVector(changed.value("todos")));
+    }
+    if (changed.contains("streaks")) {
+        emit streaksChanged(toVector(changed.value("streaks")));
+    }
+    if (changed.contains("streak_checkins")) {
+        emit streakCheckinsChanged(toVector(changed.value("streak_checkins")));
+    }
+    return applied;
+}
+
+QString SyncEngine::meta(const QString &key) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT value FROM sync_meta WHERE key = :key");
+    query.bindValue(":key", key);
+    if (query.exec() && query.next()) {
+        return query.value(0).toString();
+    }
+    return QString();
+}
+
+void SyncEngine::setMeta(const QString &key, const QString &value)
+{
+    QSqlQuery query;
+    query.prepare("INSERT OR REPLACE INTO sync_meta (key, value) VALUES (:key, :value)");
+    query.bindValue(":key", key);
+    query.bindValue(":value", value);
+    if (!query.exec()) {
+        qDebug() << "Error saving sync state:" << query.lastError().text();
+    }
+}
+
+const SyncEngine::EntitySpec *SyncEngine::spec(const QString &entity) const
+{
+    static const QVector<EntitySpec> specs = {
+        {"todo_list", "todo_lists", {"name"}, {}},
+        {"todo", "todos", {"title", "description", "completed", "priority", "due_date", "estimated_pomodoros", "sort_key",
+                           "recurrence", "recurrence_start"},
+         {{"parent", "parent_id", "todo"}, {"list", "list_id", "todo_list"}}},
+        {"streak", "streaks", {"title", "streak_duration", "best_streak", "last_activity"}, {}}
+    };
+
+    for (const EntitySpec &candidate : specs) {
+        if (candidate.entity == entity) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+const SyncEngine::Reference *SyncEngine::reference(const EntitySpec &spec, const QString &field)
+{
+    for (const Reference &candidate : spec.references) {
+        if (candidate.field == field) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+QHash<QString, SyncEngine::FieldState> SyncEngine::loadFieldStates(const QString &entity, const QString &uid) const
+{
+    QHash<QString, FieldState> states;
+    QSqlQuery query;
+    query.prepare("SELECT field, hlc, value FROM sync_fields WHERE entity = :entity AND uid = :uid");
+    query.bindValue(":entity", entity);
+    query.bindValue(":uid", uid);
+    if (query.exec()) {
+        while (query.next()) {
+            states.insert(query.value(0).toString(),
+                          {query.value(1).toString(), query.value(2).toString()});
+        }
+    }
+    return states;
+}
+
+void SyncEngine::storeFieldState(const SyncOp &op)
+{
+    QSqlQuery query;
+    query.prepare("INSERT OR REPLACE INTO sync_fields (entity, uid, field, hlc, value) "
+                  "VALUES (:entity, :uid, :field, :hlc, :value)");
+    query.bindValue(":entity", op.entity);
+    query.bindValue(":uid", op.uid);
+    query.bindValue(":field", op.field);
+    query.bindValue(":hlc", op.hlc.toString());
+    query.bindValue(":value", encodeValue(op.value));
+    if (!query.exec()) {
+        qDebug() << "Error saving sync field state:" << query.lastError().text();
+    }
+}
+
+void SyncEngine::diffRow(const EntitySpec &spec, int id, QVector<SyncOp> &ops)
+{
+    // Plain columns, then each reference resolved to the referenced row's uid
+    QStringList fields = spec.fields;
+    QStringList columns = spec.fields;
+    for (const Reference &ref : spec.references) {
+        fields.append(ref.field);
+        columns.append(QString("(SELECT r.uid FROM %1 r WHERE r.id = %2.%3)")
+                           .arg(this->spec(ref.entity)->table, spec.table, ref.column));
+    }
+
+    QSqlQuery query;
+    query.prepare(QString("SELECT uid, %1 FROM %2 WHERE id = :id").arg(columns.join(", "), spec.table));
+    query.bindValue(":id", id);
+    if (!query.exec() || !query.next()) {
+        return;   // deleted rows are exported from sync_tombstones
+    }
+
+    const QString uid = query.value(0).toString();
+    if (uid.isEmpty()) {
+        return;
+    }
+
+    const QHash<QString, FieldState> states = loadFieldStates(spec.entity, uid);
+    if (states.contains(kDeletedField)) {
+        return;
+    }
+
+    for (int i = 0; i < fields.size(); ++i) {
+        const QJsonValue value = jsonFromSql(query.value(i + 1));
+        auto it = states.constFind(fields.at(i));
+        if (it != states.cend() && it->value == encodeValue(value)) {
+            continue;
+        }
+        ops.append({m_hlc.now(), spec.entity, uid, fields.at(i), value});
+    }
+}
+
+void SyncEngine::diffCheckins(int streakId, QVector<SyncOp> &ops)
+{
+    QSqlQuery uidQuery;
+    uidQuery.prepare("SELECT uid FROM streaks WHERE id = :id");
+    uidQuery.bindValue(":id", streakId);
+    if (!uidQuery.exec() || !uidQuery.next()) {
+        return;
+    }
+    const QString uid = uidQuery.value(0).toString();
+
+    // Check-ins form a grow-only set per streak: one field per day.
+    const QHash<QString, FieldState> states = loadFieldStates(kCheckinEntity, uid);
+    QSqlQuery query;
+    query.prepare("SELECT checkin_date FROM streak_checkins WHERE streak_id = :id");
+    query.bindValue(":id", streakId);
+    if (!query.exec()) {
+        return;
+    }
+    while (query.next()) {
+        const QString day = query.value(0).toString();
+        if (!states.contains(day)) {
+            ops.append({m_hlc.now(), kCheckinEntity, uid, day, QJsonValue(true)});
+        }
+    }
+}
+
+void SyncEngine::collectTombstones(QVector<SyncOp> &ops)
+{
+    QSqlQuery query("SELECT entity, uid FROM sync_tombstones");
+    while (query.next()) {
+        ops.append({m_hlc.now(), query.value(0).toString(), query.value(1).toString(),
+                    kDeletedField, QJsonValue(true)});
+    }
+}
+
+bool SyncEngine::applyOp(const SyncOp &op, QHash<QString, QSet<int>> &changed)
+{
+    m_hlc.receive(op.hlc);
+
+    const bool isCheckin = op.entity == kCheckinEntity;
+    const EntitySpec *entitySpec = spec(isCheckin ? QString("streak") : op.entity);
+    if (!entitySpec) {
+        return false;
+    }
+    if (!isCheckin && op.field != kDeletedField && !entitySpec->fields.contains(op.field)
+        && !reference(*entitySpec, op.field)) {
+        return false;
+    }
+
+    // Last writer wins: ignore anything not newer than what we already hold.
+    const QHash<QString, FieldState> states = loadFieldStates(op.entity, op.uid);
+    auto it = states.constFind(op.field);
+    if (it != states.cend() && it->hlc >= op.hlc.toString()) {
+        return false;
+    }
+
+    // Deletes win over concurrent edits.
+    const bool deleted = isCheckin
+        ? loadFieldStates(entitySpec->entity, op.uid).contains(kDeletedField)
+        : states.contains(kDeletedField);
+    if (deleted) {
+        return false;
+    }
+
+    if (op.field == kDeletedField) {
+        QSqlQuery find;
+        find.prepare(QString("SELECT id FROM %1 WHERE uid = :uid").arg(entitySpec->table));
+        find.bindValue(":uid", op.uid);
+        if (find.exec() && find.next()) {
+            deleteRow(*entitySpec, find.value(0).toInt(), changed);
+        }
+
+        // The delete trigger queued a tombstone; this delete came from elsewhere.
+        QSqlQuery clear;
+        clear.prepare("DELETE FROM sync_tombstones WHERE entity = :entity AND uid = :uid");
+        clear.bindValue(":entity", op.entity);
+        clear.bindValue(":uid", op.uid);
+        clear.exec();
+    } else if (isCheckin) {
+        const int streakId = ensureRow(*entitySpec, op.uid);
+        if (streakId < 0) {
+            return false;
+        }
+        QSqlQuery insert;
+        insert.prepare("INSERT OR IGNORE INTO streak_checkins (streak_id, checkin_date) "
+                       "VALUES (:streak_id, :checkin_date)");
+        insert.bindValue(":streak_id", streakId);
+        insert.bindValue(":checkin_date", op.field);
+        insert.exec();
+        changed["streaks"].insert(streakId);
+        changed["streak_checkins"].insert(streakId);
+    } else {
+        const int id = ensureRow(*entitySpec, op.uid);
+        if (id < 0) {
+            return false;
+        }
+        QString column = op.field;
+        QVariant value = op.value.isNull() ? QVariant() : op.value.toVariant();
+        if (const Reference *ref = reference(*entitySpec, op.field)) {
+            // The referenced row may not have arrived yet; its fields follow
+            column = ref->column;
+            if (!op.value.isNull()) {
+                const int target = ensureRow(*spec(ref->entity), op.value.toString());
+                if (target < 0 || target == id) {
+                    return false;
+                }
+                value = target;
+            }
+        }
+
+        QSqlQuery update;
+        update.prepare(QString("UPDATE %1 SET %2 = :value WHERE id = :id").arg(entitySpec->table, column));
+        update.bindValue(":value", value);
+        update.bindValue(":id", id);
+        if (!update.exec()) {
+            qDebug() << "Error applying synced field:" << update.lastError().text();
+            return false;
+        }
+        changed[entitySpec->table].insert(id);
+    }
+
+    storeFieldState(op);
+    return true;
+}
+
+int SyncEngine::ensureRow(const EntitySpec &spec, const QString &uid)
+{
+    QSqlQuery find;
+    find.prepare(QString("SELECT id FROM %1 WHERE uid = :uid").arg(spec.table));
+    find.bindValue(":uid", uid);
+    if (find.exec() && find.next()) {
+        return find.value(0).toInt();
+    }
+
+    // Fields arrive one op at a time; start from an empty title (or name).
+    QSqlQuery insert;
+    insert.prepare(QString("INSERT INTO %1 (uid, %2) VALUES (:uid, '')").arg(spec.table, spec.fields.first()));
+    insert.bindValue(":uid", uid);
+    if (!insert.exec()) {
+        qDebug() << "Error creating synced row:" << insert.lastError().text();
+        return -1;
+    }
+    return insert.lastInsertId().toInt();
+}
+
+void SyncEngine::deleteRow(const EntitySpec &spec, int id, QHash<QString, QSet<int>> &changed)
+{
+    if (spec.entity == "streak") {
+        DatabaseManager::instance().deleteStreak(id);
+        changed["streaks"].insert(id);
+        return;
+    }
+
+    // Subtasks go with their todo and todos with their list, as in a local delete
+    const bool list = spec.entity == "todo_list";
+    const QString subtree = QString("WITH RECURSIVE subtree(id) AS (%1 UNION ALL "
+                                    "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) ")
+                                .arg(list ? "SELECT id FROM todos WHERE list_id = :id" : "SELECT :id");
+    QSqlQuery query;
+    query.prepare(subtree + "SELECT id FROM subtree");
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error finding synced delete:" << query.lastError().text();
+        return;
+    }
+    QSet<int> todoIds;
+    while (query.next()) {
+        todoIds.insert(query.value(0).toInt());
+    }
+
+    query.prepare(subtree + "DELETE FROM todos WHERE id IN (SELECT id FROM subtree)");
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qDebug() << "Error applying synced delete:" << query.lastError().text();
+        return;
+    }
+    if (!todoIds.isEmpty()) {
+        changed["todos"].unite(todoIds);
+    }
+
+    if (list) {
+        query.prepare("DELETE FROM todo_lists WHERE id = :id");
+        query.bindValue(":id", id);
+        if (!query.exec()) {
+            qDebug() << "Error applying synced list delete:" << query.lastError().text();
+            return;
+        }
+        // There is always somewhere to put a todo
+        query.exec("INSERT INTO todo_lists (name) SELECT 'Inbox' WHERE NOT EXISTS (SELECT 1 FROM todo_lists)");
+        changed["todo_lists"].insert(id);
+    }
+}
+
+QString SyncEngine::encodeValue(const QJsonValue &value)
+{
+    return QString::fromUtf8(QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,104 @@
+#ifndef SYNCENGINE_H
+#define SYNCENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QUrl>
+
+#include "hybridlogicalclock.h"
+#include "synclog.h"
+
+class ClockTimer;
+
+// Folder-based sync of todo lists, todos and streaks between devices.
+//
+// Local edits are found through change_log, diffed field by field against
+// the last known value in sync_fields, and appended to this device's log
+// segment. Other devices' segments are read from their stored byte offsets
+// and merged with per-field last-writer-wins on HLC timestamps, so every
+// device converges regardless of the order segments arrive in. Deletes
+// are tombstones and win over concurrent edits; deleting a todo deletes
+// its subtasks. Columns pointing at other synced rows (a subtask's parent)
+// travel as that row's uid and are mapped back to a local id on apply.
+class SyncEngine : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString syncDirectory READ syncDirectory WRITE setSyncDirectory NOTIFY syncDirectoryChanged)
+    Q_PROPERTY(QString deviceId READ deviceId CONSTANT)
+    Q_PROPERTY(QDateTime lastSync READ lastSync NOTIFY syncFinished)
+
+public:
+    explicit SyncEngine(QObject *parent = nullptr);
+
+    QString syncDirectory() const;
+    void setSyncDirectory(const QString &directory);
+    // For folder dialogs, which hand back file: URLs.
+    Q_INVOKABLE void setSyncDirectoryUrl(const QUrl &url);
+
+    QString deviceId() const;
+    QDateTime lastSync() const;
+
+    Q_INVOKABLE void syncNow();
+
+    int exportLocalChanges();
+    int applyRemoteChanges();
+
+signals:
+    void syncDirectoryChanged();
+    void syncFinished(int exported, int applied);
+    void todoListsChanged();
+    void todosChanged(const QVector<int> &ids);
+    void streaksChanged(const QVector<int> &ids);
+    void streakCheckinsChanged(const QVector<int> &streakIds);
+
+private:
+    // A column holding another synced row's local id. Local ids differ
+    // between devices, so it is synced as that row's uid under field.
+    struct Reference {
+        QString field;
+        QString column;
+        QString entity;
+    };
+
+    struct EntitySpec {
+        QString entity;
+        QString table;
+        QStringList fields;
+        QVector<Reference> references;
+    };
+
+    struct FieldState {
+        QString hlc;
+        QString value;
+    };
+
+    ClockTimer *m_timer;
+    HybridLogicalClock m_hlc;
+    QString m_deviceId;
+    QString m_directory;
+    QDateTime m_lastSync;
+
+    QString meta(const QString &key) const;
+    void setMeta(const QString &key, const QString &value);
+
+    const EntitySpec *spec(const QString &entity) const;
+    static const Reference *reference(const EntitySpec &spec, const QString &field);
+    QHash<QString, FieldState> loadFieldStates(const QString &entity, const QString &uid) const;
+    void storeFieldState(const SyncOp &op);
+
+    void diffRow(const EntitySpec &spec, int id, QVector<SyncOp> &ops);
+    void diffCheckins(int streakId, QVector<SyncOp> &ops);
+    void collectTombstones(QVector<SyncOp> &ops);
+
+    bool applyOp(const SyncOp &op, QHash<QString, QSet<int>> &changed);
+    int ensureRow(const EntitySpec &spec, const QString &uid);
+    void deleteRow(const EntitySpec &spec, int id, QHash<QString, QSet<int>> &changed);
+
+    static QString encodeValue(const QJsonValue &value);
+};
+
+#endif // SYNCENGINE_H
@@ -0,0 +1,223 @@
+#include "synclog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QDebug>
+#include <algorithm>
+
+QJsonObject SyncOp::toJson() const
+{
+    QJsonObject object;
+    object["hlc"] = hlc.toString();
+    object["entity"] = entity;
+    object["uid"] = uid;
+    object["field"] = field;
+    object["value"] = value;
+    return object;
+}
+
+SyncOp SyncOp::fromJson(const QJsonObject &object)
+{
+    SyncOp op;
+    op.hlc = HlcTimestamp::fromString(object["hlc"].toString());
+    op.entity = object["entity"].toString();
+    op.uid = object["uid"].toString();
+    op.field = object["field"].toString();
+    op.value = object["value"];
+    return op;
+}
+
+SyncLog::SyncLog(const QString &directory, const QString &deviceId)
+    : m_directory(directory),
+    m_deviceId(deviceId)
+{
+}
+
+bool SyncLog::isValid() const
+{
+    return !m_directory.isEmpty() && !m_deviceId.isEmpty() && QDir(m_directory).exists();
+}
+
+QString SyncLog::directory() const
+{
+    return m_directory;
+}
+
+QString SyncLog::deviceId() const
+{
+    return m_deviceId;
+}
+
+bool SyncLog::append(const QVector<SyncOp> &ops)
+{
+    if (ops.isEmpty()) {
+        return true;
+    }
+
+    if (!QDir().mkpath(ownDirectory())) {
+        qDebug() << "Error creating sync directory:" << ownDirectory();
+        return false;
+    }
+
+    // Seal the current segment once it is large enough and start a new one.
+    const QStringList existing = segments(m_deviceId);
+    int number = existing.isEmpty() ? 1 : segmentNumber(existing.last());
+    if (!existing.isEmpty()
+        && QFileInfo(segmentPath(m_deviceId, existing.last())).size() >= kSegmentBytes) {
+        number++;
+    }
+
+    QFile file(segmentPath(m_deviceId, segmentName(number)));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Error opening sync segment:" << file.errorString();
+        return false;
+    }
+
+    QByteArray buffer;
+    for (const SyncOp &op : ops) {
+        buffer += QJsonDocument(op.toJson()).toJson(QJsonDocument::Compact);
+        buffer += '\n';
+    }
+
+    // One write per batch so a reader never sees half a batch of lines.
+    if (file.write(buffer) != buffer.size()) {
+        qDebug() << "Error writing sync segment:" << file.errorString();
+        return false;
+    }
+    return file.flush();
+}
+
+QStringList SyncLog::remoteDevices() const
+{
+    QStringList devices = QDir(m_directory).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    devices.removeAll(m_deviceId);
+    return devices;
+}
+
+QStringList SyncLog::segments(const QString &deviceId) const
+{
+    return QDir(m_directory + "/" + deviceId)
+        .entryList(QStringList() << "*.jsonl", QDir::Files, QDir::Name);
+}
+
+QString SyncLog::segmentPath(const QString &deviceId, const QString &segment) const
+{
+    return m_directory + "/" + deviceId + "/" + segment;
+}
+
+QVector<SyncOp> SyncLog::readSegment(const QString &path, qint64 &offset)
+{
+    QVector<SyncOp> ops;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return ops;
+    }
+
+    // A segment shorter than our offset was rewritten; ops are idempotent,
+    // so reading it again from the start is safe.
+    if (offset > file.size()) {
+        offset = 0;
+    }
+    if (!file.seek(offset)) {
+        return ops;
+    }
+
+    const QByteArray data = file.readAll();
+    const int end = data.lastIndexOf('\n');
+    if (end < 0) {
+        return ops;   // no complete line yet
+    }
+
+    const QList<QByteArray> lines = data.left(end).split('\n');
+    ops.reserve(lines.size());
+    for (const QByteArray &line : lines) {
+        if (line.trimmed().isEmpty()) {
+            continue;
+        }
+        const QJsonDocument document = QJsonDocument::fromJson(line);
+        if (!document.isObject()) {
+            qDebug() << "Skipping malformed sync line in" << path;
+            continue;
+        }
+        SyncOp op = SyncOp::fromJson(document.object());
+        if (op.hlc.isValid() && !op.uid.isEmpty()) {
+            ops.append(op);
+        }
+    }
+
+    offset += end + 1;
+    return ops;
+}
+
+int SyncLog::compact(int maxSegments)
+{
+    const QStringList existing = segments(m_deviceId);
+    if (existing.size() <= maxSegments) {
+        return 0;
+    }
+
+    // Latest op per (entity, uid, field) wins; everything older is dead weight.
+    QHash<QString, SyncOp> latest;
+    for (const QString &segment : existing) {
+        qint64 offset = 0;
+        const QVector<SyncOp> ops = readSegment(segmentPath(m_deviceId, segment), offset);
+        for (const SyncOp &op : ops) {
+            const QString key = op.entity + QChar(0x1f) + op.uid + QChar(0x1f) + op.field;
+            auto it = latest.find(key);
+            if (it == latest.end() || it->hlc < op.hlc) {
+                latest.insert(key, op);
+            }
+        }
+    }
+
+    QVector<SyncOp> merged(latest.cbegin(), latest.cend());
+    std::sort(merged.begin(), merged.end(), [](const SyncOp &a, const SyncOp &b) {
+        return a.hlc < b.hlc;
+    });
+
+    QByteArray buffer;
+    for (const SyncOp &op : std::as_const(merged)) {
+        buffer += QJsonDocument(op.toJson()).toJson(QJsonDocument::Compact);
+        buffer += '\n';
+    }
+
+    // Write under a name readers ignore, then rename into place.
+    const QString tempPath = ownDirectory() + "/compact.tmp";
+    QFile::remove(tempPath);
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(buffer) != buffer.size()) {
+        qDebug() << "Error writing compacted sync segment:" << file.errorString();
+        return 0;
+    }
+    file.close();
+
+    const QString target = segmentPath(m_deviceId, segmentName(segmentNumber(existing.last()) + 1));
+    if (!QFile::rename(tempPath, target)) {
+        qDebug() << "Error installing compacted sync segment:" << target;
+        QFile::remove(tempPath);
+        return 0;
+    }
+
+    for (const QString &segment : existing) {
+        QFile::remove(segmentPath(m_deviceId, segment));
+    }
+    return existing.size();
+}
+
+QString SyncLog::ownDirectory() const
+{
+    return m_directory + "/" + m_deviceId;
+}
+
+int SyncLog::segmentNumber(const QString &segment) const
+{
+    return segment.section('.', 0, 0).toInt();
+}
+
+QString SyncLog::segmentName(int number) const
+{
+    return QString("%1.jsonl").arg(number, 6, 10, QChar('0'));
+}
@@ -0,0 +1,62 @@
+#ifndef SYNCLOG_H
+#define SYNCLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QJsonValue>
+#include <QJsonObject>
+
+#include "hybridlogicalclock.h"
+
+// A single field assignment: "entity/uid.field = value at hlc".
+struct SyncOp
+{
+    HlcTimestamp hlc;
+    QString entity;
+    QString uid;
+    QString field;
+    QJsonValue value;
+
+    QJsonObject toJson() const;
+    static SyncOp fromJson(const QJsonObject &object);
+};
+
+// Append-only change log in a shared directory. Every device writes only
+// under <directory>/<deviceId>/ as numbered JSON-lines segments, so sync
+// tools never see two writers on one file. Readers remember a byte offset
+// per segment and only parse what was appended since.
+class SyncLog
+{
+public:
+    SyncLog(const QString &directory, const QString &deviceId);
+
+    bool isValid() const;
+    QString directory() const;
+    QString deviceId() const;
+
+    bool append(const QVector<SyncOp> &ops);
+
+    QStringList remoteDevices() const;
+    QStringList segments(const QString &deviceId) const;
+    QString segmentPath(const QString &deviceId, const QString &segment) const;
+
+    // Reads complete lines after offset and advances it past them.
+    static QVector<SyncOp> readSegment(const QString &path, qint64 &offset);
+
+    // Folds this device's segments into one holding only the latest op per
+    // field. Returns the number of segments removed.
+    int compact(int maxSegments = 8);
+
+    static constexpr qint64 kSegmentBytes = 256 * 1024;
+
+private:
+    QString m_directory;
+    QString m_deviceId;
+
+    QString ownDirectory() const;
+    int segmentNumber(const QString &segment) const;
+    QString segmentName(int number) const;
+};
+
+#endif // SYNCLOG_H
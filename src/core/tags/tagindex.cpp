@@ -0,0 +1,270 @@
+#include "tagindex.h"
+
+#include <QtAlgorithms>
+
+int TagIndex::Selection::count() const
+{
+    if (m_all) {
+        return m_keys.size();
+    }
+    int total = 0;
+    for (const quint64 word : m_words) {
+        total += qPopulationCount(word);
+    }
+    return total;
+}
+
+QVector<quint64> TagIndex::Selection::keys() const
+{
+    if (m_all) {
+        return m_keys;
+    }
+    QVector<quint64> keys;
+    for (int w = 0; w < int(m_words.size()); w++) {
+        for (quint64 bits = m_words[w]; bits; bits &= bits - 1) {
+            keys.append(m_keys.at(w * 64 + qCountTrailingZeroBits(bits)));
+        }
+    }
+    return keys;
+}
+
+void TagIndex::insert(quint64 key)
+{
+    if (m_slots.contains(key)) {
+        return;
+    }
+
+    m_slots.insert(key, m_keys.size());
+    m_keys.append(key);
+    m_rows.resize(m_rows.size() + m_rowWords, 0);
+
+    const int words = wordCount();
+    for (std::vector<quint64> &column : m_columns) {
+        column.resize(words, 0);
+    }
+}
+
+void TagIndex::remove(quint64 key)
+{
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd()) {
+        return;
+    }
+    const int slot = it.value();
+    const int last = m_keys.size() - 1;
+    const quint64 lastBit = quint64(1) << (last & 63);
+    const quint64 slotBit = quint64(1) << (slot & 63);
+
+    // Clear the item's column bits, then move the last item into its slot
+    for (int w = 0; w < m_rowWords; w++) {
+        for (quint64 bits = m_rows[size_t(slot) * m_rowWords + w]; bits; bits &= bits - 1) {
+            m_columns[w * 64 + qCountTrailingZeroBits(bits)][slot >> 6] &= ~slotBit;
+        }
+    }
+    if (slot != last) {
+        for (int w = 0; w < m_rowWords; w++) {
+            const quint64 row = m_rows[size_t(last) * m_rowWords + w];
+            for (quint64 bits = row; bits; bits &= bits - 1) {
+                std::vector<quint64> &column = m_columns[w * 64 + qCountTrailingZeroBits(bits)];
+                column[last >> 6] &= ~lastBit;
+                column[slot >> 6] |= slotBit;
+            }
+            m_rows[size_t(slot) * m_rowWords + w] = row;
+        }
+        const quint64 moved = m_keys.at(last);
+        m_keys[slot] = moved;
+        m_slots[moved] = slot;
+    }
+
+    m_slots.remove(key);
+    m_keys.removeLast();
+    m_rows.resize(size_t(last) * m_rowWords);
+
+    const int words = wordCount();
+    for (std::vector<quint64> &column : m_columns) {
+        column.resize(words);
+    }
+}
+
+void TagIndex::clear()
+{
+    m_rowWords = 0;
+    m_rows.clear();
+    m_columns.clear();
+    m_keys.clear();
+    m_slots.clear();
+}
+
+int TagIndex::size() const
+{
+    return m_keys.size();
+}
+
+bool TagIndex::contains(quint64 key) const
+{
+    return m_slots.contains(key);
+}
+
+void TagIndex::setTag(quint64 key, int bit, bool on)
+{
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd() || bit < 0) {
+        return;
+    }
+    const int slot = it.value();
+
+    widenRows(bit);
+    if (bit >= int(m_columns.size())) {
+        m_columns.resize(bit + 1, std::vector<quint64>(wordCount(), 0));
+    }
+
+    quint64 &row = m_rows[size_t(slot) * m_rowWords + (bit >> 6)];
+    quint64 &column = m_columns[bit][slot >> 6];
+    if (on) {
+        row |= quint64(1) << (bit & 63);
+        column |= quint64(1) << (slot & 63);
+    } else {
+        row &= ~(quint64(1) << (bit & 63));
+        column &= ~(quint64(1) << (slot & 63));
+    }
+}
+
+bool TagIndex::hasTag(quint64 key, int bit) const
+{
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd() || bit < 0 || bit >= m_rowWords * 64) {
+        return false;
+    }
+    return (m_rows[size_t(it.value()) * m_rowWords + (bit >> 6)] >> (bit & 63)) & 1;
+}
+
+QVector<int> TagIndex::tags(quint64 key) const
+{
+    QVector<int> bits;
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd()) {
+        return bits;
+    }
+    for (int w = 0; w < m_rowWords; w++) {
+        for (quint64 word = m_rows[size_t(it.value()) * m_rowWords + w]; word; word &= word - 1) {
+            bits.append(w * 64 + qCountTrailingZeroBits(word));
+        }
+    }
+    return bits;
+}
+
+void TagIndex::clearTag(int bit)
+{
+    if (bit < 0 || bit >= int(m_columns.size())) {
+        return;
+    }
+
+    std::vector<quint64> &column = m_columns[bit];
+    const quint64 rowBit = quint64(1) << (bit & 63);
+    for (int w = 0; w < int(column.size()); w++) {
+        for (quint64 slots = column[w]; slots; slots &= slots - 1) {
+            const int slot = w * 64 + qCountTrailingZeroBits(slots);
+            m_rows[size_t(slot) * m_rowWords + (bit >> 6)] &= ~rowBit;
+        }
+        column[w] = 0;
+    }
+}
+
+int TagIndex::countWithTag(int bit) const
+{
+    if (bit < 0 || bit >= int(m_columns.size())) {
+        return 0;
+    }
+    int total = 0;
+    for (const quint64 word : m_columns[bit]) {
+        total += qPopulationCount(word);
+    }
+    return total;
+}
+
+TagIndex::Selection TagIndex::select(const TagQuery &query) const
+{
+    Selection selection;
+    if (query.isEmpty()) {
+        selection.m_keys = m_keys;
+        return selection;
+    }
+
+    const size_t words = size_t(wordCount());
+    const int tail = m_keys.size() & 63;
+    const quint64 tailMask = tail == 0 ? ~quint64(0) : (quint64(1) << tail) - 1;
+
+    // Postfix evaluation; each operator is one pass over the words
+    std::vector<std::vector<quint64>> stack;
+    for (const TagQuery::Step &step : query.steps()) {
+        switch (step.op) {
+        case TagQuery::Tag:
+            if (step.bit >= 0 && step.bit < int(m_columns.size())) {
+                stack.push_back(m_columns[step.bit]);
+            } else {
+                stack.emplace_back(words, 0);
+            }
+            break;
+        case TagQuery::NoTag:
+            stack.emplace_back(words, 0);
+            break;
+        case TagQuery::Not:
+            if (!stack.empty()) {
+                std::vector<quint64> &top = stack.back();
+                for (size_t i = 0; i < words; i++) {
+                    top[i] = ~top[i];
+                }
+                if (words > 0) {
+                    top[words - 1] &= tailMask;
+                }
+            }
+            break;
+        case TagQuery::And:
+        case TagQuery::Or:
+            if (stack.size() >= 2) {
+                const std::vector<quint64> rhs = std::move(stack.back());
+                stack.pop_back();
+                std::vector<quint64> &lhs = stack.back();
+                if (step.op == TagQuery::And) {
+                    for (size_t i = 0; i < words; i++) {
+                        lhs[i] &= rhs[i];
+                    }
+                } else {
+                    for (size_t i = 0; i < words; i++) {
+                        lhs[i] |= rhs[i];
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    selection.m_all = false;
+    selection.m_words = stack.empty() ? std::vector<quint64>(words, 0) : std::move(stack.back());
+    selection.m_slots = m_slots;
+    selection.m_keys = m_keys;
+    return selection;
+}
+
+int TagIndex::wordCount() const
+{
+    return (m_keys.size() + 63) / 64;
+}
+
+void TagIndex::widenRows(int bit)
+{
+    const int needed = bit / 64 + 1;
+    if (needed <= m_rowWords) {
+        return;
+    }
+
+    // More tags than the rows have room for: restride every row
+    std::vector<quint64> rows(size_t(m_keys.size()) * needed, 0);
+    for (int slot = 0; slot < m_keys.size(); slot++) {
+        for (int w = 0; w < m_rowWords; w++) {
+            rows[size_t(slot) * needed + w] = m_rows[size_t(slot) * m_rowWords + w];
+        }
+    }
+    m_rows.swap(rows);
+    m_rowWords = needed;
+}
@@ -0,0 +1,77 @@
+#ifndef TAGINDEX_H
+#define TAGINDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <vector>
+
+#include "tagquery.h"
+
+// Which caller-keyed items carry which tags, as bitsets kept both ways:
+// each item has a row of tag bits, and each tag has a column with one bit
+// per item slot. A TagQuery runs over the columns, so every AND, OR and
+// NOT handles 64 items per machine word; 100k items are about 1.6k words
+// per operator. Items sit in dense slots and removal swaps the last item
+// into the hole, so the columns never have gaps.
+class TagIndex
+{
+public:
+    // Result of select(): the matching items, frozen at the time of the
+    // query. The default one matches everything.
+    class Selection
+    {
+    public:
+        bool matchesAll() const { return m_all; }
+
+        bool contains(quint64 key) const
+        {
+            if (m_all) {
+                return true;
+            }
+            const auto it = m_slots.constFind(key);
+            if (it == m_slots.constEnd()) {
+                return false;
+            }
+            const int slot = it.value();
+            return (m_words[slot >> 6] >> (slot & 63)) & 1;
+        }
+
+        int count() const;
+        QVector<quint64> keys() const;
+
+    private:
+        friend class TagIndex;
+
+        bool m_all = true;
+        std::vector<quint64> m_words;
+        QHash<quint64, int> m_slots;
+        QVector<quint64> m_keys;
+    };
+
+    void insert(quint64 key);
+    void remove(quint64 key);
+    void clear();
+    int size() const;
+    bool contains(quint64 key) const;
+
+    void setTag(quint64 key, int bit, bool on = true);
+    bool hasTag(quint64 key, int bit) const;
+    QVector<int> tags(quint64 key) const;
+    // Takes bit off every item, e.g. when its tag is deleted.
+    void clearTag(int bit);
+    int countWithTag(int bit) const;
+
+    Selection select(const TagQuery &query) const;
+
+private:
+    int wordCount() const;
+    void widenRows(int bit);
+
+    int m_rowWords = 0;                             // words per item row
+    std::vector<quint64> m_rows;                    // size() * m_rowWords
+    std::vector<std::vector<quint64>> m_columns;    // per tag bit, wordCount() each
+    QVector<quint64> m_keys;
+    QHash<quint64, int> m_slots;
+};
+
+#endif // TAGINDEX_H
@@ -0,0 +1,549 @@
+#include "tagmanager.h"
+#include "../todo/todomanager.h"
+#include "../todo/todosortfiltermodel.h"
+#include "../streaks/streaksmanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+
+const int kDoneBit = 0;
+const QString kDoneName = QStringLiteral("done");
+
+} // namespace
+
+TagManager::TagManager(todoManager *todos, streaksManager *streaks, QObject *parent)
+    : QAbstractListModel(parent),
+    m_todos(todos),
+    m_streaks(streaks),
+    m_nextBit(kDoneBit + 1),
+    m_revision(0)
+{
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this, &TagManager::onTodoRowsInserted);
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TagManager::onTodoRowsRemoved);
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &TagManager::onTodoRowsChanged);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, &TagManager::reload);
+
+    connect(m_streaks, &QAbstractItemModel::rowsInserted, this, &TagManager::onStreakRowsInserted);
+    connect(m_streaks, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TagManager::onStreakRowsRemoved);
+    connect(m_streaks, &QAbstractItemModel::dataChanged, this, &TagManager::onStreakRowsChanged);
+    connect(m_streaks, &QAbstractItemModel::modelReset, this, &TagManager::reload);
+
+    reload();
+}
+
+int TagManager::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_tags.size();
+}
+
+QVariant TagManager::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_tags.size())
+        return QVariant();
+
+    const Tag &tag = m_tags.at(index.row());
+
+    switch (role) {
+    case IdRole:
+        return tag.id;
+    case Qt::DisplayRole:
+    case NameRole:
+        return tag.name;
+    case TodoCountRole:
+        return m_todoIndex.countWithTag(tag.bit);
+    case StreakCountRole:
+        return m_streakIndex.countWithTag(tag.bit);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TagManager::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[IdRole] = "tagId";
+    roles[NameRole] = "name";
+    roles[TodoCountRole] = "todoCount";
+    roles[StreakCountRole] = "streakCount";
+    return roles;
+}
+
+int TagManager::createTag(const QString &name)
+{
+    const QString trimmed = name.trimmed();
+    const QString folded = TagQuery::fold(trimmed);
+    if (trimmed.isEmpty() || folded == kDoneName) {
+        qDebug() << "Invalid tag name:" << name;
+        return -1;
+    }
+
+    const int existing = rowForName(trimmed);
+    if (existing >= 0) {
+        return m_tags.at(existing).id;
+    }
+
+    QSqlQuery query;
+    query.prepare("INSERT INTO tags (name) VALUES (:name)");
+    query.bindValue(":name", trimmed);
+
+    if (!query.exec()) {
+        qDebug() << "Error creating tag:" << query.lastError().text();
+        return -1;
+    }
+
+    Tag tag;
+    tag.id = query.lastInsertId().toInt();
+    tag.name = trimmed;
+    tag.bit = m_freeBits.isEmpty() ? m_nextBit++ : m_freeBits.takeLast();
+
+    const int row = insertRowFor(trimmed);
+    beginInsertRows(QModelIndex(), row, row);
+    m_tags.insert(row, tag);
+    m_bits.insert(folded, tag.bit);
+    endInsertRows();
+
+    // A query may already name it
+    applyTodoFilters();
+    applyStreakFilter();
+    return tag.id;
+}
+
+bool TagManager::renameTag(int tagId, const QString &name)
+{
+    const int row = rowForTag(tagId);
+    const QString trimmed = name.trimmed();
+    const QString folded = TagQuery::fold(trimmed);
+    if (row < 0 || trimmed.isEmpty() || folded == kDoneName) {
+        return false;
+    }
+    const int clash = rowForName(trimmed);
+    if (clash >= 0 && clash != row) {
+        qDebug() << "A tag named" << trimmed << "already exists";
+        return false;
+    }
+
+    QSqlQuery query;
+    query.prepare("UPDATE tags SET name = :name WHERE id = :id");
+    query.bindValue(":name", trimmed);
+    query.bindValue(":id", tagId);
+
+    if (!query.exec()) {
+        qDebug() << "Error renaming tag:" << query.lastError().text();
+        return false;
+    }
+
+    Tag tag = m_tags.at(row);
+    m_bits.remove(TagQuery::fold(tag.name));
+    m_bits.insert(folded, tag.bit);
+    tag.name = trimmed;
+
+    const int before = insertRowFor(trimmed, row);
+    const int to = before > row ? before - 1 : before;
+    if (to != row) {
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), before > row ? before : to);
+        m_tags.remove(row);
+        m_tags.insert(to, tag);
+        endMoveRows();
+    } else {
+        m_tags[row] = tag;
+    }
+    const QModelIndex changed = index(to, 0);
+    emit dataChanged(changed, changed, QVector<int>() << NameRole);
+
+    assignmentsUpdated();
+    return true;
+}
+
+bool TagManager::deleteTag(int tagId)
+{
+    const int row = rowForTag(tagId);
+    if (row < 0) {
+        return false;
+    }
+
+    // The tags_cleanup trigger drops the assignments
+    QSqlQuery query;
+    query.prepare("DELETE FROM tags WHERE id = :id");
+    query.bindValue(":id", tagId);
+
+    if (!query.exec()) {
+        qDebug() << "Error deleting tag:" << query.lastError().text();
+        return false;
+    }
+
+    const Tag tag = m_tags.at(row);
+    m_todoIndex.clearTag(tag.bit);
+    m_streakIndex.clearTag(tag.bit);
+    m_bits.remove(TagQuery::fold(tag.name));
+    m_freeBits.append(tag.bit);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_tags.remove(row);
+    endRemoveRows();
+
+    assignmentsUpdated();
+    return true;
+}
+
+bool TagManager::tagTodo(int todoId, const QString &name)
+{
+    return assign("todo_tags", "todo_id", m_todoIndex, todoId, name, true);
+}
+
+bool TagManager::untagTodo(int todoId, const QString &name)
+{
+    return assign("todo_tags", "todo_id", m_todoIndex, todoId, name, false);
+}
+
+bool TagManager::tagStreak(int streakId, const QString &name)
+{
+    return assign("streak_tags", "streak_id", m_streakIndex, streakId, name, true);
+}
+
+bool TagManager::untagStreak(int streakId, const QString &name)
+{
+    return assign("streak_tags", "streak_id", m_streakIndex, streakId, name, false);
+}
+
+QStringList TagManager::todoTags(int todoId) const
+{
+    return tagsOf(m_todoIndex, todoId);
+}
+
+QStringList TagManager::streakTags(int streakId) const
+{
+    return tagsOf(m_streakIndex, streakId);
+}
+
+void TagManager::filterTodos(TodoSortFilterModel *view, const QString &query)
+{
+    if (!view) {
+        return;
+    }
+
+    for (int i = m_todoFilters.size() - 1; i >= 0; i--) {
+        if (m_todoFilters.at(i).view.isNull() || m_todoFilters.at(i).view == view) {
+            m_todoFilters.remove(i);
+        }
+    }
+
+    if (query.trimmed().isEmpty()) {
+        view->setTagSelection(TagIndex::Selection());
+        return;
+    }
+
+    m_todoFilters.append({view, query});
+    view->setTagSelection(selectTodos(query));
+}
+
+TagIndex::Selection TagManager::selectTodos(const QString &query) const
+{
+    return m_todoIndex.select(TagQuery::parse(query, m_bits));
+}
+
+TagIndex::Selection TagManager::selectStreaks(const QString &query) const
+{
+    return m_streakIndex.select(TagQuery::parse(query, m_bits));
+}
+
+QString TagManager::streakQuery() const
+{
+    return m_streakQuery;
+}
+
+void TagManager::setStreakQuery(const QString &query)
+{
+    if (m_streakQuery == query) {
+        return;
+    }
+    m_streakQuery = query;
+    applyStreakFilter();
+}
+
+bool TagManager::streakVisible(int streakId) const
+{
+    return m_streakSelection.contains(quint64(streakId));
+}
+
+int TagManager::revision() const
+{
+    return m_revision;
+}
+
+void TagManager::reload()
+{
+    beginResetModel();
+
+    m_tags.clear();
+    m_bits.clear();
+    m_freeBits.clear();
+    m_todoIndex.clear();
+    m_streakIndex.clear();
+    m_bits.insert(kDoneName, kDoneBit);
+    m_nextBit = kDoneBit + 1;
+
+    QSqlQuery query("SELECT id, name FROM tags ORDER BY name COLLATE NOCASE");
+    if (!query.exec()) {
+        qDebug() << "Error loading tags:" << query.lastError().text();
+    }
+    while (query.next()) {
+        Tag tag;
+        tag.id = query.value(0).toInt();
+        tag.name = query.value(1).toString();
+        tag.bit = m_nextBit++;
+        m_tags.append(tag);
+        m_bits.insert(TagQuery::fold(tag.name), tag.bit);
+    }
+
+    for (int row = 0; row < m_todos->rowCount(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        const quint64 key = index.data(todoManager::IdRole).toInt();
+        m_todoIndex.insert(key);
+        m_todoIndex.setTag(key, kDoneBit, index.data(todoManager::CompletedRole).toBool());
+    }
+    for (int row = 0; row < m_streaks->rowCount(); row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        const quint64 key = index.data(streaksManager::IdRole).toInt();
+        m_streakIndex.insert(key);
+        m_streakIndex.setTag(key, kDoneBit, index.data(streaksManager::IsActiveTodayRole).toBool());
+    }
+    loadAssignments("todo_tags", "todo_id", m_todoIndex);
+    loadAssignments("streak_tags", "streak_id", m_streakIndex);
+
+    endResetModel();
+
+    m_revision++;
+    emit assignmentsChanged();
+    applyTodoFilters();
+    applyStreakFilter();
+}
+
+int TagManager::rowForTag(int tagId) const
+{
+    for (int i = 0; i < m_tags.size(); ++i) {
+        if (m_tags.at(i).id == tagId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int TagManager::rowForName(const QString &name) const
+{
+    const QString folded = TagQuery::fold(name);
+    for (int i = 0; i < m_tags.size(); ++i) {
+        if (TagQuery::fold(m_tags.at(i).name) == folded) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int TagManager::insertRowFor(const QString &name, int skipRow) const
+{
+    int row = 0;
+    for (int i = 0; i < m_tags.size(); ++i) {
+        if (i != skipRow && QString::compare(m_tags.at(i).name, name, Qt::CaseInsensitive) < 0) {
+            row = i + 1;
+        }
+    }
+    return row;
+}
+
+void TagManager::loadAssignments(const QString &table, const QString &column, TagIndex &index, int onlyId)
+{
+    QHash<int, int> bitForTag;
+    for (const Tag &tag : std::as_const(m_tags)) {
+        bitForTag.insert(tag.id, tag.bit);
+    }
+
+    QSqlQuery query;
+    query.prepare(QString("SELECT %1, tag_id FROM %2%3")
+                      .arg(column, table, onlyId > 0 ? QString(" WHERE %1 = :id").arg(column) : QString()));
+    if (onlyId > 0) {
+        query.bindValue(":id", onlyId);
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Error loading tag assignments:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next()) {
+        const int bit = bitForTag.value(query.value(1).toInt(), -1);
+        if (bit > kDoneBit) {
+            index.setTag(query.value(0).toInt(), bit);
+        }
+    }
+}
+
+bool TagManager::assign(const QString &table, const QString &column, TagIndex &index,
+                        int itemId, const QString &name, bool on)
+{
+    int row = rowForName(name);
+    if (row < 0) {
+        if (!on) {
+            return false;
+        }
+        row = rowForTag(createTag(name));
+        if (row < 0) {
+            return false;
+        }
+    }
+    const Tag tag = m_tags.at(row);
+
+    QSqlQuery query;
+    if (on) {
+        query.prepare(QString("INSERT OR IGNORE INTO %1 (%2, tag_id) VALUES (:item, :tag)").arg(table, column));
+    } else {
+        query.prepare(QString("DELETE FROM %1 WHERE %2 = :item AND tag_id = :tag").arg(table, column));
+    }
+    query.bindValue(":item", itemId);
+    query.bindValue(":tag", tag.id);
+
+    if (!query.exec()) {
+        qDebug() << "Error updating tag assignment:" << query.lastError().text();
+        return false;
+    }
+
+    index.setTag(itemId, tag.bit, on);
+    const QModelIndex changed = this->index(row, 0);
+    emit dataChanged(changed, changed, QVector<int>() << TodoCountRole << StreakCountRole);
+
+    m_revision++;
+    emit assignmentsChanged();
+    if (&index == &m_todoIndex) {
+        applyTodoFilters();
+    } else {
+        applyStreakFilter();
+    }
+    return true;
+}
+
+QStringList TagManager::tagsOf(const TagIndex &index, int itemId) const
+{
+    QStringList names;
+    for (const Tag &tag : m_tags) {
+        if (index.hasTag(itemId, tag.bit)) {
+            names << tag.name;
+        }
+    }
+    return names;
+}
+
+void TagManager::assignmentsUpdated()
+{
+    if (!m_tags.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_tags.size() - 1, 0),
+                         QVector<int>() << TodoCountRole << StreakCountRole);
+    }
+    m_revision++;
+    emit assignmentsChanged();
+    applyTodoFilters();
+    applyStreakFilter();
+}
+
+void TagManager::applyTodoFilters()
+{
+    for (int i = m_todoFilters.size() - 1; i >= 0; i--) {
+        const TodoFilter &filter = m_todoFilters.at(i);
+        if (filter.view.isNull()) {
+            m_todoFilters.remove(i);
+        } else {
+            filter.view->setTagSelection(selectTodos(filter.query));
+        }
+    }
+}
+
+void TagManager::applyStreakFilter()
+{
+    m_streakSelection = m_streakQuery.trimmed().isEmpty() ? TagIndex::Selection()
+                                                          : selectStreaks(m_streakQuery);
+    emit streakFilterChanged();
+}
+
+void TagManager::onTodoRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        const int id = index.data(todoManager::IdRole).toInt();
+        m_todoIndex.insert(id);
+        m_todoIndex.setTag(id, kDoneBit, index.data(todoManager::CompletedRole).toBool());
+        // New todos have none, but one made top-level again may
+        loadAssignments("todo_tags", "todo_id", m_todoIndex, id);
+    }
+    assignmentsUpdated();
+}
+
+void TagManager::onTodoRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; row++) {
+        m_todoIndex.remove(m_todos->index(row, 0).data(todoManager::IdRole).toInt());
+    }
+    assignmentsUpdated();
+}
+
+void TagManager::onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                   const QList<int> &roles)
+{
+    if (!roles.isEmpty() && !roles.contains(todoManager::CompletedRole))
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_todos->index(row, 0);
+        m_todoIndex.setTag(index.data(todoManager::IdRole).toInt(), kDoneBit,
+                           index.data(todoManager::CompletedRole).toBool());
+    }
+    applyTodoFilters();
+}
+
+void TagManager::onStreakRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        const int id = index.data(streaksManager::IdRole).toInt();
+        m_streakIndex.insert(id);
+        m_streakIndex.setTag(id, kDoneBit, index.data(streaksManager::IsActiveTodayRole).toBool());
+        loadAssignments("streak_tags", "streak_id", m_streakIndex, id);
+    }
+    assignmentsUpdated();
+}
+
+void TagManager::onStreakRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; row++) {
+        m_streakIndex.remove(m_streaks->index(row, 0).data(streaksManager::IdRole).toInt());
+    }
+    assignmentsUpdated();
+}
+
+void TagManager::onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                     const QList<int> &roles)
+{
+    if (!roles.isEmpty() && !roles.contains(streaksManager::IsActiveTodayRole))
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        const QModelIndex index = m_streaks->index(row, 0);
+        m_streakIndex.setTag(index.data(streaksManager::IdRole).toInt(), kDoneBit,
+                             index.data(streaksManager::IsActiveTodayRole).toBool());
+    }
+    applyStreakFilter();
+}
@@ -0,0 +1,118 @@
+#ifndef TAGMANAGER_H
+#define TAGMANAGER_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QStringList>
+
+#include "tagindex.h"
+
+class todoManager;
+class streaksManager;
+class TodoSortFilterModel;
+
+// Tags on todos and streaks (by course, exam, ...) and the list of tags.
+// Assignments live in the todo_tags and streak_tags tables; in memory each
+// side is a TagIndex that follows the todo and streak models' row signals,
+// so a tag query such as "math AND NOT done" is a few word-wide passes
+// rather than a join. "done" is built in: completed todos, and streaks
+// already checked in today.
+class TagManager : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString streakQuery READ streakQuery WRITE setStreakQuery NOTIFY streakFilterChanged)
+    Q_PROPERTY(int revision READ revision NOTIFY assignmentsChanged)
+
+public:
+    enum TagRoles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        TodoCountRole,
+        StreakCountRole
+    };
+
+    explicit TagManager(todoManager *todos, streaksManager *streaks, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Returns the tag's id; an existing tag with the same name (ignoring
+    // case) is reused. -1 for empty or reserved names.
+    Q_INVOKABLE int createTag(const QString &name);
+    Q_INVOKABLE bool renameTag(int tagId, const QString &name);
+    Q_INVOKABLE bool deleteTag(int tagId);
+
+    // Tagging creates the tag if needed.
+    Q_INVOKABLE bool tagTodo(int todoId, const QString &name);
+    Q_INVOKABLE bool untagTodo(int todoId, const QString &name);
+    Q_INVOKABLE bool tagStreak(int streakId, const QString &name);
+    Q_INVOKABLE bool untagStreak(int streakId, const QString &name);
+    Q_INVOKABLE QStringList todoTags(int todoId) const;
+    Q_INVOKABLE QStringList streakTags(int streakId) const;
+
+    // Keeps view filtered to the todos matching query (see TagQuery) as
+    // tags and todos change; an empty query shows every todo again.
+    Q_INVOKABLE void filterTodos(TodoSortFilterModel *view, const QString &query);
+    TagIndex::Selection selectTodos(const QString &query) const;
+    TagIndex::Selection selectStreaks(const QString &query) const;
+
+    // Streak list filter, for delegates to check against.
+    QString streakQuery() const;
+    void setStreakQuery(const QString &query);
+    Q_INVOKABLE bool streakVisible(int streakId) const;
+
+    int revision() const;
+
+public slots:
+    void reload();
+
+signals:
+    void assignmentsChanged();
+    void streakFilterChanged();
+
+private:
+    struct Tag {
+        int id;
+        QString name;
+        int bit;
+    };
+
+    struct TodoFilter {
+        QPointer<TodoSortFilterModel> view;
+        QString query;
+    };
+
+    int rowForTag(int tagId) const;
+    int rowForName(const QString &name) const;
+    int insertRowFor(const QString &name, int skipRow = -1) const;
+    void loadAssignments(const QString &table, const QString &column, TagIndex &index, int onlyId = 0);
+    bool assign(const QString &table, const QString &column, TagIndex &index,
+                int itemId, const QString &name, bool on);
+    QStringList tagsOf(const TagIndex &index, int itemId) const;
+    void assignmentsUpdated();
+    void applyTodoFilters();
+    void applyStreakFilter();
+
+    void onTodoRowsInserted(const QModelIndex &parent, int first, int last);
+    void onTodoRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onTodoRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onStreakRowsInserted(const QModelIndex &parent, int first, int last);
+    void onStreakRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onStreakRowsChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+    todoManager *m_todos;
+    streaksManager *m_streaks;
+    QVector<Tag> m_tags;            // by name
+    QHash<QString, int> m_bits;     // folded name -> bit, "done" included
+    QVector<int> m_freeBits;        // bits of deleted tags, reused first
+    int m_nextBit;
+    TagIndex m_todoIndex;
+    TagIndex m_streakIndex;
+    QVector<TodoFilter> m_todoFilters;
+    QString m_streakQuery;
+    TagIndex::Selection m_streakSelection;
+    int m_revision;
+};
+
+#endif // TAGMANAGER_H
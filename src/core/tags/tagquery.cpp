@@ -0,0 +1,202 @@
+#include "tagquery.h"
+
+namespace {
+
+enum TokenType { Name, AndToken, OrToken, NotToken, OpenToken, CloseToken };
+
+struct Token {
+    TokenType type;
+    QString name;
+};
+
+bool isSymbol(QChar c)
+{
+    return c == '(' || c == ')' || c == '&' || c == '|' || c == '!' || c == '"';
+}
+
+QVector<Token> tokenize(const QString &text)
+{
+    QVector<Token> tokens;
+    int i = 0;
+    while (i < text.size()) {
+        const QChar c = text.at(i);
+        if (c.isSpace()) {
+            i++;
+        } else if (c == '(') {
+            tokens.append({OpenToken, QString()});
+            i++;
+        } else if (c == ')') {
+            tokens.append({CloseToken, QString()});
+            i++;
+        } else if (c == '&') {
+            tokens.append({AndToken, QString()});
+            i++;
+        } else if (c == '|') {
+            tokens.append({OrToken, QString()});
+            i++;
+        } else if (c == '!') {
+            tokens.append({NotToken, QString()});
+            i++;
+        } else if (c == '"') {
+            // Quoted names may hold spaces and keywords; the closing quote is optional
+            const int end = text.indexOf('"', i + 1);
+            const int stop = end < 0 ? text.size() : end;
+            const QString name = text.mid(i + 1, stop - i - 1).trimmed();
+            if (!name.isEmpty()) {
+                tokens.append({Name, name});
+            }
+            i = end < 0 ? stop : stop + 1;
+        } else {
+            const int start = i;
+            while (i < text.size() && !text.at(i).isSpace() && !isSymbol(text.at(i))) {
+                i++;
+            }
+            const QString word = text.mid(start, i - start);
+            const QString lower = word.toLower();
+            if (lower == "and") {
+                tokens.append({AndToken, QString()});
+            } else if (lower == "or") {
+                tokens.append({OrToken, QString()});
+            } else if (lower == "not") {
+                tokens.append({NotToken, QString()});
+            } else {
+                tokens.append({Name, word});
+            }
+        }
+    }
+    return tokens;
+}
+
+// Recursive descent; every successful parse leaves exactly one value on
+// the evaluation stack and a failed one leaves nothing.
+class Parser
+{
+public:
+    Parser(const QVector<Token> &tokens, const QHash<QString, int> &bits, QVector<TagQuery::Step> &steps)
+        : m_tokens(tokens), m_bits(bits), m_steps(steps), m_pos(0)
+    {
+    }
+
+    void parse()
+    {
+        bool have = false;
+        while (m_pos < m_tokens.size()) {
+            if (parseOr()) {
+                if (have) {
+                    emitOp(TagQuery::And);
+                }
+                have = true;
+            } else {
+                m_pos++;    // stray ')' or operator
+            }
+        }
+    }
+
+private:
+    bool at(TokenType type) const
+    {
+        return m_pos < m_tokens.size() && m_tokens.at(m_pos).type == type;
+    }
+
+    bool startsOperand() const
+    {
+        return at(Name) || at(NotToken) || at(OpenToken);
+    }
+
+    void emitOp(TagQuery::Op op, int bit = -1)
+    {
+        m_steps.append({op, bit});
+    }
+
+    bool parseOr()
+    {
+        if (!parseAnd()) {
+            return false;
+        }
+        while (at(OrToken)) {
+            m_pos++;
+            if (parseAnd()) {
+                emitOp(TagQuery::Or);
+            }
+        }
+        return true;
+    }
+
+    bool parseAnd()
+    {
+        if (!parseUnary()) {
+            return false;
+        }
+        for (;;) {
+            if (at(AndToken)) {
+                m_pos++;
+            } else if (!startsOperand()) {
+                break;
+            }
+            if (parseUnary()) {
+                emitOp(TagQuery::And);
+            }
+        }
+        return true;
+    }
+
+    bool parseUnary()
+    {
+        if (at(NotToken)) {
+            m_pos++;
+            if (!parseUnary()) {
+                return false;
+            }
+            emitOp(TagQuery::Not);
+            return true;
+        }
+        if (at(OpenToken)) {
+            m_pos++;
+            const bool ok = parseOr();
+            if (at(CloseToken)) {
+                m_pos++;
+            }
+            return ok;
+        }
+        if (at(Name)) {
+            const auto it = m_bits.constFind(TagQuery::fold(m_tokens.at(m_pos).name));
+            if (it == m_bits.constEnd()) {
+                emitOp(TagQuery::NoTag);
+            } else {
+                emitOp(TagQuery::Tag, it.value());
+            }
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    const QVector<Token> &m_tokens;
+    const QHash<QString, int> &m_bits;
+    QVector<TagQuery::Step> &m_steps;
+    int m_pos;
+};
+
+} // namespace
+
+TagQuery TagQuery::parse(const QString &text, const QHash<QString, int> &bits)
+{
+    TagQuery query;
+    Parser(tokenize(text), bits, query.m_steps).parse();
+    return query;
+}
+
+QString TagQuery::fold(const QString &name)
+{
+    return name.trimmed().toCaseFolded();
+}
+
+bool TagQuery::isEmpty() const
+{
+    return m_steps.isEmpty();
+}
+
+const QVector<TagQuery::Step> &TagQuery::steps() const
+{
+    return m_steps;
+}
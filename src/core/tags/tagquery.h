@@ -0,0 +1,43 @@
+#ifndef TAGQUERY_H
+#define TAGQUERY_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// A boolean expression over tags, such as "math AND NOT done",
+// "exam & !(math | physics)" or "math physics" (implicit AND), compiled to
+// a postfix program that TagIndex runs over whole bitsets. Operators are
+// AND/OR/NOT in any case or & | !, names may be quoted, and NOT binds
+// tightest, then AND, then OR. A half-typed query still compiles: a
+// dangling operator or an unclosed bracket is dropped, so the filter can
+// follow every keystroke.
+class TagQuery
+{
+public:
+    enum Op {
+        Tag,        // push the items with bit
+        NoTag,      // push nothing; the name is not a known tag
+        Not,
+        And,
+        Or
+    };
+
+    struct Step {
+        Op op;
+        int bit;
+    };
+
+    // bits maps folded tag names (see fold) to their bit.
+    static TagQuery parse(const QString &text, const QHash<QString, int> &bits);
+    static QString fold(const QString &name);
+
+    // An empty query matches every item.
+    bool isEmpty() const;
+    const QVector<Step> &steps() const;
+
+private:
+    QVector<Step> m_steps;
+};
+
+#endif // TAGQUERY_H
@@ -0,0 +1,177 @@
+#include "namedtimer.h"
+#include "timerscheduler.h"
+#include "../clock/clock.h"
+
+NamedTimer::NamedTimer(TimerScheduler *scheduler, Mode mode, const QString &name, QObject *parent)
+    : QObject(parent),
+    m_scheduler(scheduler),
+    m_mode(mode),
+    m_name(name),
+    m_state(Idle),
+    m_durationMs(0),
+    m_accumulatedMs(0),
+    m_runningSinceMs(0),
+    m_shownSeconds(0)
+{
+}
+
+NamedTimer::~NamedTimer()
+{
+    m_scheduler->detach(this);
+}
+
+QString NamedTimer::name() const
+{
+    return m_name;
+}
+
+void NamedTimer::setName(const QString &name)
+{
+    if (m_name != name) {
+        m_name = name;
+        emit nameChanged();
+    }
+}
+
+NamedTimer::Mode NamedTimer::mode() const
+{
+    return m_mode;
+}
+
+NamedTimer::State NamedTimer::state() const
+{
+    return m_state;
+}
+
+int NamedTimer::seconds() const
+{
+    return m_shownSeconds;
+}
+
+int NamedTimer::durationSeconds() const
+{
+    return int(m_durationMs / 1000);
+}
+
+void NamedTimer::setDurationSeconds(int seconds)
+{
+    const qint64 duration = qint64(qMax(0, seconds)) * 1000;
+    if (duration == m_durationMs) {
+        return;
+    }
+
+    m_durationMs = duration;
+    emit durationChanged();
+
+    const qint64 now = Clock::instance()->monotonicMs();
+    if (m_state == Running) {
+        m_scheduler->reschedule();
+    }
+    updateSeconds(now);
+}
+
+qint64 NamedTimer::elapsedMs() const
+{
+    return elapsedAt(Clock::instance()->monotonicMs());
+}
+
+qint64 NamedTimer::remainingMs() const
+{
+    return m_mode == Countdown ? qMax<qint64>(0, m_durationMs - elapsedMs()) : 0;
+}
+
+qint64 NamedTimer::nextDeadline() const
+{
+    if (m_mode != Countdown || m_state != Running) {
+        return -1;
+    }
+    return m_runningSinceMs + (m_durationMs - m_accumulatedMs);
+}
+
+void NamedTimer::start()
+{
+    if (m_state == Running) {
+        return;
+    }
+    if (m_state == Finished) {
+        m_accumulatedMs = 0;
+    }
+
+    const qint64 now = Clock::instance()->monotonicMs();
+    m_runningSinceMs = now;
+    // Attach first so runningCount() already includes this timer when
+    // stateChanged fires, then re-arm for the deadline Running gives it.
+    m_scheduler->attach(this);
+    setState(Running);
+    m_scheduler->reschedule();
+    service(now);   // a zero-length countdown finishes straight away
+}
+
+void NamedTimer::pause()
+{
+    if (m_state != Running) {
+        return;
+    }
+
+    const qint64 now = Clock::instance()->monotonicMs();
+    m_accumulatedMs = elapsedAt(now);
+    m_scheduler->detach(this);
+    setState(Paused);
+    updateSeconds(now);
+}
+
+void NamedTimer::reset()
+{
+    m_scheduler->detach(this);
+    m_accumulatedMs = 0;
+    setState(Idle);
+    updateSeconds(Clock::instance()->monotonicMs());
+}
+
+void NamedTimer::service(qint64 nowMs)
+{
+    if (m_state != Running) {
+        return;
+    }
+
+    if (m_mode == Countdown && elapsedAt(nowMs) >= m_durationMs) {
+        m_accumulatedMs = m_durationMs;
+        m_scheduler->detach(this);
+        setState(Finished);
+        updateSeconds(nowMs);
+        emit finished();
+        return;
+    }
+
+    updateSeconds(nowMs);
+}
+
+qint64 NamedTimer::elapsedAt(qint64 nowMs) const
+{
+    return m_accumulatedMs + (m_state == Running ? nowMs - m_runningSinceMs : 0);
+}
+
+void NamedTimer::setState(State state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged();
+    }
+}
+
+void NamedTimer::updateSeconds(qint64 nowMs)
+{
+    const qint64 elapsed = elapsedAt(nowMs);
+    int seconds;
+    if (m_mode == Countdown) {
+        const qint64 remaining = qMax<qint64>(0, m_durationMs - elapsed);
+        seconds = int((remaining + 999) / 1000);
+    } else {
+        seconds = int(elapsed / 1000);
+    }
+
+    if (seconds != m_shownSeconds) {
+        m_shownSeconds = seconds;
+        emit secondsChanged();
+    }
+}
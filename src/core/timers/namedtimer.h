@@ -0,0 +1,75 @@
+#ifndef NAMEDTIMER_H
+#define NAMEDTIMER_H
+
+#include <QObject>
+#include <QString>
+
+class TimerScheduler;
+
+// A countdown or stopwatch with its own name and state. Time is kept as
+// accumulated milliseconds plus the monotonic start of the current run,
+// so it stays exact however late the shared scheduler wakes it.
+class NamedTimer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(Mode mode READ mode CONSTANT)
+    Q_PROPERTY(State state READ state NOTIFY stateChanged)
+    Q_PROPERTY(int seconds READ seconds NOTIFY secondsChanged)
+    Q_PROPERTY(int durationSeconds READ durationSeconds WRITE setDurationSeconds NOTIFY durationChanged)
+
+public:
+    enum Mode { Countdown, Stopwatch };
+    Q_ENUM(Mode)
+
+    enum State { Idle, Running, Paused, Finished };
+    Q_ENUM(State)
+
+    NamedTimer(TimerScheduler *scheduler, Mode mode, const QString &name, QObject *parent = nullptr);
+    ~NamedTimer() override;
+
+    QString name() const;
+    void setName(const QString &name);
+    Mode mode() const;
+    State state() const;
+
+    // Remaining seconds for a countdown, elapsed seconds for a stopwatch.
+    int seconds() const;
+    int durationSeconds() const;
+    void setDurationSeconds(int seconds);
+
+    qint64 elapsedMs() const;
+    qint64 remainingMs() const;
+    // Monotonic ms at which a running countdown expires, or -1.
+    qint64 nextDeadline() const;
+
+    Q_INVOKABLE void start();
+    Q_INVOKABLE void pause();
+    Q_INVOKABLE void reset();
+
+    // Called by the scheduler on each shared tick.
+    void service(qint64 nowMs);
+
+signals:
+    void nameChanged();
+    void stateChanged();
+    void secondsChanged();
+    void durationChanged();
+    void finished();
+
+private:
+    TimerScheduler *m_scheduler;
+    Mode m_mode;
+    QString m_name;
+    State m_state;
+    qint64 m_durationMs;
+    qint64 m_accumulatedMs;
+    qint64 m_runningSinceMs;
+    int m_shownSeconds;
+
+    qint64 elapsedAt(qint64 nowMs) const;
+    void setState(State state);
+    void updateSeconds(qint64 nowMs);
+};
+
+#endif // NAMEDTIMER_H
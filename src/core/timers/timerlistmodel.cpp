@@ -0,0 +1,189 @@
+#include "timerlistmodel.h"
+#include "timerscheduler.h"
+
+TimerListModel::TimerListModel(QObject *parent)
+    : QAbstractListModel(parent),
+    m_scheduler(new TimerScheduler(this))
+{
+}
+
+TimerListModel::~TimerListModel()
+{
+    // Timers detach from the scheduler as they go, so it must outlive them.
+    qDeleteAll(m_timers);
+    m_timers.clear();
+}
+
+int TimerListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_timers.size();
+}
+
+QVariant TimerListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_timers.size()) {
+        return QVariant();
+    }
+
+    NamedTimer *timer = m_timers.at(index.row());
+
+    switch (role) {
+    case NameRole:
+        return timer->name();
+    case ModeRole:
+        return timer->mode();
+    case StateRole:
+        return timer->state();
+    case SecondsRole:
+        return timer->seconds();
+    case DurationSecondsRole:
+        return timer->durationSeconds();
+    case TimerRole:
+        return QVariant::fromValue(timer);
+    default:
+        return QVariant();
+    }
+}
+
+bool TimerListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_timers.size()) {
+        return false;
+    }
+
+    NamedTimer *timer = m_timers.at(index.row());
+
+    // The timer's own change signals emit dataChanged.
+    switch (role) {
+    case NameRole:
+        timer->setName(value.toString());
+        return true;
+    case DurationSecondsRole:
+        timer->setDurationSeconds(value.toInt());
+        return true;
+    default:
+        return false;
+    }
+}
+
+Qt::ItemFlags TimerListModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+QHash<int, QByteArray> TimerListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[ModeRole] = "mode";
+    roles[StateRole] = "timerState";
+    roles[SecondsRole] = "seconds";
+    roles[DurationSecondsRole] = "durationSeconds";
+    roles[TimerRole] = "timer";
+    return roles;
+}
+
+int TimerListModel::addCountdown(const QString &name, int seconds)
+{
+    NamedTimer *timer = new NamedTimer(m_scheduler, NamedTimer::Countdown, name, this);
+    timer->setDurationSeconds(seconds);
+    return addTimer(timer);
+}
+
+int TimerListModel::addStopwatch(const QString &name)
+{
+    return addTimer(new NamedTimer(m_scheduler, NamedTimer::Stopwatch, name, this));
+}
+
+void TimerListModel::removeTimer(int row)
+{
+    if (row < 0 || row >= m_timers.size()) {
+        return;
+    }
+
+    const bool wasRunning = m_timers.at(row)->state() == NamedTimer::Running;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    delete m_timers.takeAt(row);
+    endRemoveRows();
+
+    if (wasRunning) {
+        emit runningCountChanged();
+    }
+}
+
+void TimerListModel::start(int row)
+{
+    if (NamedTimer *timer = timerAt(row)) {
+        timer->start();
+    }
+}
+
+void TimerListModel::pause(int row)
+{
+    if (NamedTimer *timer = timerAt(row)) {
+        timer->pause();
+    }
+}
+
+void TimerListModel::reset(int row)
+{
+    if (NamedTimer *timer = timerAt(row)) {
+        timer->reset();
+    }
+}
+
+NamedTimer *TimerListModel::timerAt(int row) const
+{
+    return row >= 0 && row < m_timers.size() ? m_timers.at(row) : nullptr;
+}
+
+int TimerListModel::runningCount() const
+{
+    return m_scheduler->activeCount();
+}
+
+TimerScheduler *TimerListModel::scheduler() const
+{
+    return m_scheduler;
+}
+
+int TimerListModel::addTimer(NamedTimer *timer)
+{
+    connect(timer, &NamedTimer::nameChanged, this, [this, timer]() {
+        notifyRow(timer, {NameRole});
+    });
+    connect(timer, &NamedTimer::secondsChanged, this, [this, timer]() {
+        notifyRow(timer, {SecondsRole});
+    });
+    connect(timer, &NamedTimer::durationChanged, this, [this, timer]() {
+        notifyRow(timer, {DurationSecondsRole});
+    });
+    connect(timer, &NamedTimer::stateChanged, this, [this, timer]() {
+        notifyRow(timer, {StateRole});
+        emit runningCountChanged();
+    });
+    connect(timer, &NamedTimer::finished, this, [this, timer]() {
+        emit timerFinished(m_timers.indexOf(timer), timer->name());
+    });
+
+    const int row = m_timers.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_timers.append(timer);
+    endInsertRows();
+    return row;
+}
+
+void TimerListModel::notifyRow(NamedTimer *timer, const QVector<int> &roles)
+{
+    const int row = m_timers.indexOf(timer);
+    if (row >= 0) {
+        emit dataChanged(index(row), index(row), roles);
+    }
+}
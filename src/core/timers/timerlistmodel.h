@@ -0,0 +1,60 @@
+#ifndef TIMERLISTMODEL_H
+#define TIMERLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include "namedtimer.h"
+
+class TimerScheduler;
+
+// Any number of concurrent countdowns and stopwatches, all driven by one
+// TimerScheduler. A timer ticking only refreshes its own row's Seconds role.
+class TimerListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int runningCount READ runningCount NOTIFY runningCountChanged)
+
+public:
+    enum TimerRoles {
+        NameRole = Qt::UserRole + 1,
+        ModeRole,
+        StateRole,
+        SecondsRole,
+        DurationSecondsRole,
+        TimerRole
+    };
+
+    explicit TimerListModel(QObject *parent = nullptr);
+    ~TimerListModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE int addCountdown(const QString &name, int seconds);
+    Q_INVOKABLE int addStopwatch(const QString &name);
+    Q_INVOKABLE void removeTimer(int row);
+    Q_INVOKABLE void start(int row);
+    Q_INVOKABLE void pause(int row);
+    Q_INVOKABLE void reset(int row);
+    Q_INVOKABLE NamedTimer *timerAt(int row) const;
+
+    int runningCount() const;
+    TimerScheduler *scheduler() const;
+
+signals:
+    void runningCountChanged();
+    void timerFinished(int row, const QString &name);
+
+private:
+    TimerScheduler *m_scheduler;
+    QVector<NamedTimer *> m_timers;
+
+    int addTimer(NamedTimer *timer);
+    void notifyRow(NamedTimer *timer, const QVector<int> &roles);
+};
+
+#endif // TIMERLISTMODEL_H
@@ -0,0 +1,84 @@
+#include "timerscheduler.h"
+#include "namedtimer.h"
+#include "../clock/clock.h"
+
+TimerScheduler::TimerScheduler(QObject *parent)
+    : QObject(parent),
+    m_timer(Clock::instance()->createTimer(this)),
+    m_wakeups(0),
+    m_servicing(false)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &ClockTimer::timeout, this, &TimerScheduler::onWakeup);
+}
+
+void TimerScheduler::attach(NamedTimer *timer)
+{
+    if (!m_active.contains(timer)) {
+        m_active.append(timer);
+    }
+    reschedule();
+}
+
+void TimerScheduler::detach(NamedTimer *timer)
+{
+    m_active.removeOne(timer);
+    reschedule();
+}
+
+void TimerScheduler::reschedule()
+{
+    // onWakeup re-arms once every timer has been serviced.
+    if (!m_servicing) {
+        arm();
+    }
+}
+
+int TimerScheduler::activeCount() const
+{
+    return m_active.size();
+}
+
+quint64 TimerScheduler::wakeups() const
+{
+    return m_wakeups;
+}
+
+void TimerScheduler::onWakeup()
+{
+    m_wakeups++;
+    const qint64 now = Clock::instance()->monotonicMs();
+
+    // Timers detach themselves when they finish, so walk a copy.
+    m_servicing = true;
+    const QVector<NamedTimer *> active = m_active;
+    for (NamedTimer *timer : active) {
+        timer->service(now);
+    }
+    m_servicing = false;
+
+    arm();
+}
+
+void TimerScheduler::arm()
+{
+    if (m_active.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+
+    const qint64 now = Clock::instance()->monotonicMs();
+    const qint64 nextSecond = (now / 1000 + 1) * 1000;
+
+    qint64 wake = nextSecond;
+    for (const NamedTimer *timer : std::as_const(m_active)) {
+        const qint64 deadline = timer->nextDeadline();
+        if (deadline >= 0 && deadline < wake) {
+            wake = deadline;
+        }
+    }
+
+    // Grid ticks only refresh displays; expiries deserve a precise timer.
+    m_timer->setTimerType(wake == nextSecond ? Qt::CoarseTimer : Qt::PreciseTimer);
+    m_timer->start(int(qMax<qint64>(0, wake - now)));
+}
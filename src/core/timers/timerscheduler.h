@@ -0,0 +1,41 @@
+#ifndef TIMERSCHEDULER_H
+#define TIMERSCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+
+class ClockTimer;
+class NamedTimer;
+
+// One wakeup source shared by every running NamedTimer. Display refreshes
+// for all timers land on a common 1 Hz grid of the monotonic clock, and
+// the only extra wakeups are countdown expiries, so N timers cost one tick
+// per second instead of N.
+class TimerScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimerScheduler(QObject *parent = nullptr);
+
+    void attach(NamedTimer *timer);
+    void detach(NamedTimer *timer);
+    // Call when an attached timer's deadline moved.
+    void reschedule();
+
+    int activeCount() const;
+    quint64 wakeups() const;
+
+private slots:
+    void onWakeup();
+
+private:
+    ClockTimer *m_timer;
+    QVector<NamedTimer *> m_active;
+    quint64 m_wakeups;
+    bool m_servicing;
+
+    void arm();
+};
+
+#endif // TIMERSCHEDULER_H
@@ -0,0 +1,128 @@
+#include "recurrencerule.h"
+
+#include <QRegularExpression>
+
+namespace {
+
+const int kMaxInterval = 999;
+const QString kUnitLetters = QStringLiteral("dwm");
+
+} // namespace
+
+RecurrenceRule::RecurrenceRule(Unit unit, int interval, const QDateTime &start)
+    : m_unit(unit),
+    m_interval(interval),
+    m_start(start)
+{
+}
+
+RecurrenceRule RecurrenceRule::parse(const QString &text, const QDateTime &start)
+{
+    static const QRegularExpression pattern("^\\s*(\\d{1,3})\\s*([dwm])\\s*$",
+                                            QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = pattern.match(text);
+    if (!match.hasMatch()) {
+        return RecurrenceRule();
+    }
+
+    const int unit = kUnitLetters.indexOf(match.captured(2).toLower());
+    return RecurrenceRule(static_cast<Unit>(unit + 1), match.captured(1).toInt(), start);
+}
+
+QString RecurrenceRule::toString() const
+{
+    if (!isValid()) {
+        return QString();
+    }
+    return QString::number(m_interval) + kUnitLetters.at(m_unit - 1);
+}
+
+bool RecurrenceRule::isValid() const
+{
+    return m_unit != None && m_interval >= 1 && m_interval <= kMaxInterval && m_start.isValid();
+}
+
+RecurrenceRule::Unit RecurrenceRule::unit() const
+{
+    return m_unit;
+}
+
+int RecurrenceRule::interval() const
+{
+    return m_interval;
+}
+
+QDateTime RecurrenceRule::start() const
+{
+    return m_start;
+}
+
+QDateTime RecurrenceRule::occurrence(qint64 n) const
+{
+    if (!isValid() || n < 0) {
+        return QDateTime();
+    }
+
+    switch (m_unit) {
+    case Daily:
+        return m_start.addDays(n * m_interval);
+    case Weekly:
+        return m_start.addDays(n * m_interval * 7);
+    case Monthly:
+        // From start each time, so a 31st doesn't drift to the 28th
+        return m_start.addMonths(int(n * m_interval));
+    default:
+        return QDateTime();
+    }
+}
+
+QDateTime RecurrenceRule::nextAfter(const QDateTime &time) const
+{
+    return occurrence(indexAfter(time));
+}
+
+QVector<QDateTime> RecurrenceRule::occurrencesBetween(const QDateTime &from, const QDateTime &to, int limit) const
+{
+    QVector<QDateTime> occurrences;
+    if (!isValid() || from >= to) {
+        return occurrences;
+    }
+
+    // Jump straight to the window, then walk it
+    for (qint64 n = indexAfter(from.addMSecs(-1)); occurrences.size() < limit; n++) {
+        const QDateTime next = occurrence(n);
+        if (next >= to) {
+            break;
+        }
+        occurrences.append(next);
+    }
+    return occurrences;
+}
+
+qint64 RecurrenceRule::indexAfter(const QDateTime &time) const
+{
+    if (!isValid()) {
+        return -1;
+    }
+    if (time < m_start) {
+        return 0;
+    }
+
+    // Estimate from the calendar distance; at most a step or two off
+    qint64 n;
+    if (m_unit == Monthly) {
+        const QDate from = m_start.date();
+        const QDate to = time.date();
+        n = (qint64(to.year() - from.year()) * 12 + to.month() - from.month()) / m_interval;
+    } else {
+        n = m_start.date().daysTo(time.date()) / (m_unit == Weekly ? m_interval * 7 : m_interval);
+    }
+
+    while (n > 0 && occurrence(n) > time) {
+        n--;
+    }
+    while (occurrence(n) <= time) {
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,51 @@
+#ifndef RECURRENCERULE_H
+#define RECURRENCERULE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+// How a repeating todo repeats: every interval days, weeks or months,
+// counted from start. Occurrences are worked out from the rule when asked
+// for, so a series that never ends is just the rule plus the one row for
+// its current occurrence. Written as "3d", "1w", "2m".
+class RecurrenceRule
+{
+public:
+    enum Unit {
+        None,
+        Daily,
+        Weekly,
+        Monthly
+    };
+
+    RecurrenceRule() = default;
+    RecurrenceRule(Unit unit, int interval, const QDateTime &start);
+
+    // Anything that isn't a rule gives an invalid one.
+    static RecurrenceRule parse(const QString &text, const QDateTime &start);
+    QString toString() const;
+
+    bool isValid() const;
+    Unit unit() const;
+    int interval() const;
+    QDateTime start() const;
+
+    // The n-th occurrence, start being the 0th. Monthly rules keep start's
+    // day of the month, or the month's last day when it is shorter.
+    QDateTime occurrence(qint64 n) const;
+    // First occurrence strictly after time. Constant time, however far
+    // into the series time is.
+    QDateTime nextAfter(const QDateTime &time) const;
+    // Occurrences in [from, to), at most limit of them.
+    QVector<QDateTime> occurrencesBetween(const QDateTime &from, const QDateTime &to, int limit = 100) const;
+
+private:
+    qint64 indexAfter(const QDateTime &time) const;
+
+    Unit m_unit = None;
+    int m_interval = 0;
+    QDateTime m_start;
+};
+
+#endif // RECURRENCERULE_H
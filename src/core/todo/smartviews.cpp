@@ -0,0 +1,65 @@
+#include "smartviews.h"
+#include "todo.h"
+#include "../clock/clock.h"
+
+SmartViews::SmartViews(QAbstractItemModel *todos, QObject *parent)
+    : QObject(parent),
+    m_overdue(createView(todos)),
+    m_dueToday(createView(todos)),
+    m_thisWeek(createView(todos)),
+    m_highPriority(createView(todos)),
+    m_midnightTimer(Clock::instance()->createTimer(this))
+{
+    m_highPriority->setPriorityFilter(TodoItem::High);
+
+    m_midnightTimer->setSingleShot(true);
+    m_midnightTimer->setTimerType(Qt::CoarseTimer);
+    connect(m_midnightTimer, &ClockTimer::timeout, this, &SmartViews::refreshDay);
+
+    refreshDay();
+}
+
+TodoSortFilterModel *SmartViews::overdue() const
+{
+    return m_overdue;
+}
+
+TodoSortFilterModel *SmartViews::dueToday() const
+{
+    return m_dueToday;
+}
+
+TodoSortFilterModel *SmartViews::thisWeek() const
+{
+    return m_thisWeek;
+}
+
+TodoSortFilterModel *SmartViews::highPriority() const
+{
+    return m_highPriority;
+}
+
+void SmartViews::refreshDay()
+{
+    const QDateTime now = Clock::instance()->now();
+    m_today = now.date();
+
+    const QDateTime today = m_today.startOfDay();
+    const QDateTime tomorrow = m_today.addDays(1).startOfDay();
+    const QDateTime nextMonday = m_today.addDays(8 - m_today.dayOfWeek()).startOfDay();
+
+    m_overdue->setDueRange(QDateTime(), today);
+    m_dueToday->setDueRange(today, tomorrow);
+    m_thisWeek->setDueRange(today, nextMonday);
+
+    m_midnightTimer->start(int(now.msecsTo(tomorrow)));
+}
+
+TodoSortFilterModel *SmartViews::createView(QAbstractItemModel *todos)
+{
+    TodoSortFilterModel *view = new TodoSortFilterModel(this);
+    view->setSortMode(TodoSortFilterModel::DueDate);
+    view->setHideCompleted(true);
+    view->setSourceModel(todos);
+    return view;
+}
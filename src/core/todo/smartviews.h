@@ -0,0 +1,47 @@
+#ifndef SMARTVIEWS_H
+#define SMARTVIEWS_H
+
+#include <QObject>
+#include <QDate>
+
+#include "todosortfiltermodel.h"
+
+class ClockTimer;
+
+// The built-in smart lists: Overdue, Due Today, This Week (through Sunday)
+// and High Priority, open todos only and soonest first. Each is a
+// TodoSortFilterModel over the same todo model, so edits reach them as
+// single-row updates; at midnight their due-date windows slide forward a
+// day, which only touches todos due on the days that changed sides.
+class SmartViews : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(TodoSortFilterModel *overdue READ overdue CONSTANT)
+    Q_PROPERTY(TodoSortFilterModel *dueToday READ dueToday CONSTANT)
+    Q_PROPERTY(TodoSortFilterModel *thisWeek READ thisWeek CONSTANT)
+    Q_PROPERTY(TodoSortFilterModel *highPriority READ highPriority CONSTANT)
+
+public:
+    explicit SmartViews(QAbstractItemModel *todos, QObject *parent = nullptr);
+
+    TodoSortFilterModel *overdue() const;
+    TodoSortFilterModel *dueToday() const;
+    TodoSortFilterModel *thisWeek() const;
+    TodoSortFilterModel *highPriority() const;
+
+public slots:
+    // Re-anchors the date windows on today; runs by itself at midnight.
+    void refreshDay();
+
+private:
+    TodoSortFilterModel *createView(QAbstractItemModel *todos);
+
+    TodoSortFilterModel *m_overdue;
+    TodoSortFilterModel *m_dueToday;
+    TodoSortFilterModel *m_thisWeek;
+    TodoSortFilterModel *m_highPriority;
+    ClockTimer *m_midnightTimer;
+    QDate m_today;
+};
+
+#endif // SMARTVIEWS_H
@@ -0,0 +1,108 @@
+#include "sortkey.h"
+
+namespace {
+
+// ASCII order, so comparing keys as strings compares the fractions.
+const char kDigits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+const int kBase = 62;
+
+int digitValue(QChar c)
+{
+    const char16_t u = c.unicode();
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    }
+    if (u >= 'A' && u <= 'Z') {
+        return 10 + (u - 'A');
+    }
+    if (u >= 'a' && u <= 'z') {
+        return 36 + (u - 'a');
+    }
+    return -1;
+}
+
+// after may be empty, meaning 1.0; before may be empty, meaning 0.
+QString midpoint(const QString &before, const QString &after)
+{
+    if (!after.isEmpty()) {
+        // Shared leading digits stay as they are; "0" pads a short before.
+        int n = 0;
+        while (n < after.size() && (n < before.size() ? before.at(n) : QChar('0')) == after.at(n)) {
+            n++;
+        }
+        if (n > 0) {
+            return after.left(n) + midpoint(before.mid(n), after.mid(n));
+        }
+    }
+
+    const int low = before.isEmpty() ? 0 : digitValue(before.at(0));
+    const int high = after.isEmpty() ? kBase : digitValue(after.at(0));
+    if (high - low > 1) {
+        return QString(QChar(kDigits[(low + high + 1) / 2]));
+    }
+    // Adjacent first digits: after's first digit alone is in between when
+    // after continues, otherwise keep before's digit and go one deeper.
+    if (after.size() > 1) {
+        return after.left(1);
+    }
+    return QChar(kDigits[low]) + midpoint(before.mid(1), QString());
+}
+
+} // namespace
+
+namespace SortKey {
+
+QString between(const QString &before, const QString &after)
+{
+    if (!after.isEmpty() && !before.isEmpty() && before >= after) {
+        return QString();
+    }
+    return midpoint(before, after);
+}
+
+QStringList spread(int count)
+{
+    QStringList keys;
+    if (count <= 0) {
+        return keys;
+    }
+
+    // Shortest length with at least one free slot either side of each key.
+    int length = 1;
+    quint64 slots = kBase;
+    while (slots <= quint64(count) + 1) {
+        slots *= kBase;
+        length++;
+    }
+
+    const quint64 step = slots / quint64(count + 1);
+    keys.reserve(count);
+    for (int i = 1; i <= count; i++) {
+        quint64 value = step * quint64(i);
+        QString key(length, QChar('0'));
+        for (int d = length - 1; d >= 0; d--) {
+            key[d] = QChar(kDigits[value % kBase]);
+            value /= kBase;
+        }
+        while (key.endsWith(QChar('0'))) {
+            key.chop(1);
+        }
+        keys.append(key);
+    }
+    return keys;
+}
+
+bool isValid(const QString &key)
+{
+    if (key.isEmpty() || key.endsWith(QChar('0'))) {
+        return false;
+    }
+    for (const QChar c : key) {
+        if (digitValue(c) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace SortKey
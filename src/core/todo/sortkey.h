@@ -0,0 +1,25 @@
+#ifndef SORTKEY_H
+#define SORTKEY_H
+
+#include <QString>
+#include <QStringList>
+
+// Fractional ordering keys for manually ordered lists. A key is a string
+// of base-62 digits read as a fraction (0.xyz...), compared as plain
+// strings, so there is always room for a key between any two others and
+// moving an item rewrites only that item's key. Keys never end in '0'.
+namespace SortKey {
+
+// Key that sorts strictly between before and after; an empty bound means
+// the start or the end of the list.
+QString between(const QString &before, const QString &after);
+
+// count evenly spaced keys of the shortest length that fits them; used to
+// rebalance a list whose keys have grown long.
+QStringList spread(int count);
+
+bool isValid(const QString &key);
+
+} // namespace SortKey
+
+#endif // SORTKEY_H
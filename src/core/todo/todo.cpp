@@ -12,7 +12,8 @@ TodoItem::TodoItem(QObject *parent)
     m_dueDate(QDateTime()),
     m_completed(false),
     m_priority(Medium),
-    m_id(-1)
+    m_id(-1),
+    m_estimatedPomodoros(1)
 {
 }
 
@@ -25,7 +26,8 @@ TodoItem::TodoItem(const QString &title, const QString &description,
     m_dueDate(dueDate),
     m_completed(completed),
     m_priority(priority),
-    m_id(id)
+    m_id(id),
+    m_estimatedPomodoros(1)
 {
 }
 
@@ -107,3 +109,55 @@ void TodoItem::setId(int id)
     }
 }
 
+int TodoItem::estimatedPomodoros() const
+{
+    return m_estimatedPomodoros;
+}
+
+void TodoItem::setEstimatedPomodoros(int pomodoros)
+{
+    if (m_estimatedPomodoros != pomodoros) {
+        m_estimatedPomodoros = pomodoros;
+        emit estimatedPomodorosChanged();
+    }
+}
+
+QString TodoItem::sortKey() const
+{
+    return m_sortKey;
+}
+
+void TodoItem::setSortKey(const QString &sortKey)
+{
+    if (m_sortKey != sortKey) {
+        m_sortKey = sortKey;
+        emit sortKeyChanged();
+    }
+}
+
+
+QString TodoItem::recurrence() const
+{
+    return m_recurrence;
+}
+
+void TodoItem::setRecurrence(const QString &recurrence)
+{
+    if (m_recurrence != recurrence) {
+        m_recurrence = recurrence;
+        emit recurrenceChanged();
+    }
+}
+
+QDateTime TodoItem::recurrenceStart() const
+{
+    return m_recurrenceStart;
+}
+
+void TodoItem::setRecurrenceStart(const QDateTime &start)
+{
+    if (m_recurrenceStart != start) {
+        m_recurrenceStart = start;
+        emit recurrenceChanged();
+    }
+}
@@ -17,6 +17,10 @@ class TodoItem : public QObject
     Q_PROPERTY(bool completed READ completed WRITE setCompleted NOTIFY completedChanged)
     Q_PROPERTY(Priority priority READ priority WRITE setPriority NOTIFY priorityChanged)
     Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)  // Add this property
+    Q_PROPERTY(int estimatedPomodoros READ estimatedPomodoros WRITE setEstimatedPomodoros NOTIFY estimatedPomodorosChanged)
+    Q_PROPERTY(QString sortKey READ sortKey WRITE setSortKey NOTIFY sortKeyChanged)
+    Q_PROPERTY(QString recurrence READ recurrence WRITE setRecurrence NOTIFY recurrenceChanged)
+    Q_PROPERTY(QDateTime recurrenceStart READ recurrenceStart WRITE setRecurrenceStart NOTIFY recurrenceChanged)
 
 public:
     enum Priority {
@@ -49,6 +53,19 @@ public:
     int id() const;
     void setId(int id);
 
+    int estimatedPomodoros() const;
+    void setEstimatedPomodoros(int pomodoros);
+
+    QString sortKey() const;
+    void setSortKey(const QString &sortKey);
+
+    // Repeat rule (see RecurrenceRule), empty for a one-off todo.
+    QString recurrence() const;
+    void setRecurrence(const QString &recurrence);
+
+    QDateTime recurrenceStart() const;
+    void setRecurrenceStart(const QDateTime &start);
+
 signals:
     void titleChanged();
     void descriptionChanged();
@@ -56,6 +73,9 @@ signals:
     void completedChanged();
     void priorityChanged();
     void idChanged();
+    void estimatedPomodorosChanged();
+    void sortKeyChanged();
+    void recurrenceChanged();
 private:
     QString m_title;
     QString m_description;
@@ -63,6 +83,10 @@ private:
     bool m_completed;
     Priority m_priority;
     int m_id;
+    int m_estimatedPomodoros;
+    QString m_sortKey;
+    QString m_recurrence;
+    QDateTime m_recurrenceStart;
 };
 
 
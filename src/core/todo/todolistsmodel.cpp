@@ -0,0 +1,527 @@
+#include "todolistsmodel.h"
+#include "todomanager.h"
+#include "sortkey.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QPair>
+#include <QDebug>
+#include <utility>
+
+namespace {
+
+// Lists kept loaded; the open one is never dropped
+const int kDefaultCapacity = 3;
+
+} // namespace
+
+TodoListsModel::TodoListsModel(todoManager *allTodos, QObject *parent)
+    : QAbstractListModel(parent),
+    m_all(allTodos),
+    m_capacity(kDefaultCapacity),
+    m_currentListId(0),
+    m_forwarding(false)
+{
+    watch(m_all);
+    connect(m_all, &QAbstractItemModel::modelReset, this, &TodoListsModel::reload);
+
+    loadLists();
+    if (!m_lists.isEmpty()) {
+        m_currentListId = m_lists.first().id;
+    }
+}
+
+int TodoListsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_lists.size();
+}
+
+QVariant TodoListsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_lists.size())
+        return QVariant();
+
+    const List &list = m_lists.at(index.row());
+
+    switch (role) {
+    case IdRole:
+        return list.id;
+    case Qt::DisplayRole:
+    case NameRole:
+        return list.name;
+    case OpenCountRole:
+        return list.open;
+    case CompletedCountRole:
+        return list.completed;
+    case LoadedRole:
+        return isLoaded(list.id);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TodoListsModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[IdRole] = "listId";
+    roles[NameRole] = "name";
+    roles[OpenCountRole] = "openCount";
+    roles[CompletedCountRole] = "completedCount";
+    roles[LoadedRole] = "loaded";
+    return roles;
+}
+
+int TodoListsModel::createList(const QString &name)
+{
+    const QString trimmed = name.trimmed();
+    if (trimmed.isEmpty()) {
+        return -1;
+    }
+
+    QSqlQuery query;
+    query.prepare("INSERT INTO todo_lists (name) VALUES (:name)");
+    query.bindValue(":name", trimmed);
+
+    if (!query.exec()) {
+        qDebug() << "Error creating todo list:" << query.lastError().text();
+        return -1;
+    }
+
+    List list;
+    list.id = query.lastInsertId().toInt();
+    list.name = trimmed;
+    list.open = 0;
+    list.completed = 0;
+
+    beginInsertRows(QModelIndex(), m_lists.size(), m_lists.size());
+    m_lists.append(list);
+    endInsertRows();
+    return list.id;
+}
+
+bool TodoListsModel::renameList(int listId, const QString &name)
+{
+    const int row = rowForList(listId);
+    const QString trimmed = name.trimmed();
+    if (row < 0 || trimmed.isEmpty()) {
+        return false;
+    }
+
+    QSqlQuery query;
+    query.prepare("UPDATE todo_lists SET name = :name WHERE id = :id");
+    query.bindValue(":name", trimmed);
+    query.bindValue(":id", listId);
+
+    if (!query.exec()) {
+        qDebug() << "Error renaming todo list:" << query.lastError().text();
+        return false;
+    }
+
+    m_lists[row].name = trimmed;
+    const QModelIndex modelIndex = index(row, 0);
+    emit dataChanged(modelIndex, modelIndex, QVector<int>() << NameRole);
+    return true;
+}
+
+bool TodoListsModel::deleteList(int listId)
+{
+    const int row = rowForList(listId);
+    if (row < 0 || m_lists.size() < 2) {
+        return false;
+    }
+
+    // The all-lists model drops these once they are gone
+    QVector<int> removed;
+    QSqlQuery select;
+    select.prepare("SELECT id FROM todos WHERE list_id = :list_id AND parent_id IS NULL");
+    select.bindValue(":list_id", listId);
+    if (!select.exec()) {
+        qDebug() << "Error reading todo list:" << select.lastError().text();
+        return false;
+    }
+    while (select.next()) {
+        removed.append(select.value(0).toInt());
+    }
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+
+    QSqlQuery query;
+    query.prepare("WITH RECURSIVE subtree(id) AS ("
+                  "SELECT id FROM todos WHERE list_id = :list_id UNION ALL "
+                  "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                  "DELETE FROM todos WHERE id IN (SELECT id FROM subtree)");
+    query.bindValue(":list_id", listId);
+    bool ok = query.exec();
+
+    if (ok) {
+        query.prepare("DELETE FROM todo_lists WHERE id = :id");
+        query.bindValue(":id", listId);
+        ok = query.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qDebug() << "Error deleting todo list:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    for (int i = 0; i < m_loaded.size(); i++) {
+        if (m_loaded.at(i).listId == listId) {
+            unload(i);
+            break;
+        }
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_lists.removeAt(row);
+    endRemoveRows();
+
+    if (m_currentListId == listId) {
+        m_currentListId = m_lists.first().id;
+        emit currentListChanged();
+    }
+
+    m_all->applyExternalChanges(removed);
+    return true;
+}
+
+bool TodoListsModel::moveTodoToList(int todoId, int listId)
+{
+    const int from = listOf(todoId);
+    if (from < 0 || rowForList(listId) < 0) {
+        return false;
+    }
+    if (from == listId) {
+        return true;
+    }
+
+    // After the last todo of the target list
+    QSqlQuery last;
+    last.prepare("SELECT MAX(sort_key) FROM todos WHERE list_id = :list_id AND parent_id IS NULL");
+    last.bindValue(":list_id", listId);
+    if (!last.exec() || !last.next()) {
+        qDebug() << "Error reading todo list order:" << last.lastError().text();
+        return false;
+    }
+    const QString sortKey = SortKey::between(last.value(0).toString(), QString());
+
+    QSqlQuery query;
+    query.prepare("WITH RECURSIVE subtree(id) AS ("
+                  "SELECT :id UNION ALL "
+                  "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                  "UPDATE todos SET list_id = :list_id, "
+                  "sort_key = CASE WHEN id = :top THEN :sort_key ELSE sort_key END "
+                  "WHERE id IN (SELECT id FROM subtree)");
+    query.bindValue(":id", todoId);
+    query.bindValue(":list_id", listId);
+    query.bindValue(":top", todoId);
+    query.bindValue(":sort_key", sortKey);
+
+    if (!query.exec()) {
+        qDebug() << "Error moving todo to list:" << query.lastError().text();
+        return false;
+    }
+
+    const QVector<int> ids = QVector<int>() << todoId;
+    m_all->applyExternalChanges(ids);
+    applyExternalChanges(ids);
+    return true;
+}
+
+int TodoListsModel::listOf(int todoId) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT list_id FROM todos WHERE id = :id AND parent_id IS NULL");
+    query.bindValue(":id", todoId);
+
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+int TodoListsModel::rowForList(int listId) const
+{
+    for (int i = 0; i < m_lists.size(); ++i) {
+        if (m_lists.at(i).id == listId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int TodoListsModel::openCount(int listId) const
+{
+    const int row = rowForList(listId);
+    return row < 0 ? 0 : m_lists.at(row).open;
+}
+
+int TodoListsModel::completedCount(int listId) const
+{
+    const int row = rowForList(listId);
+    return row < 0 ? 0 : m_lists.at(row).completed;
+}
+
+todoManager *TodoListsModel::model(int listId)
+{
+    if (rowForList(listId) < 0) {
+        return nullptr;
+    }
+
+    for (int i = 0; i < m_loaded.size(); i++) {
+        if (m_loaded.at(i).listId == listId) {
+            m_loaded.move(i, 0);
+            return m_loaded.first().model;
+        }
+    }
+
+    todoManager *listModel = new todoManager(listId, this);
+    watch(listModel);
+    m_loaded.prepend({listId, listModel});
+    emitLoadedChanged(listId);
+
+    evict();
+    return listModel;
+}
+
+bool TodoListsModel::isLoaded(int listId) const
+{
+    for (const Loaded &loaded : m_loaded) {
+        if (loaded.listId == listId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int TodoListsModel::loadedCount() const
+{
+    return m_loaded.size();
+}
+
+int TodoListsModel::capacity() const
+{
+    return m_capacity;
+}
+
+void TodoListsModel::setCapacity(int lists)
+{
+    m_capacity = qMax(1, lists);
+    evict();
+}
+
+int TodoListsModel::currentListId() const
+{
+    return m_currentListId;
+}
+
+void TodoListsModel::setCurrentListId(int listId)
+{
+    if (listId == m_currentListId || rowForList(listId) < 0) {
+        return;
+    }
+    m_currentListId = listId;
+    emit currentListChanged();
+}
+
+todoManager *TodoListsModel::currentModel()
+{
+    // Loaded when the list page first asks for it
+    return model(m_currentListId);
+}
+
+void TodoListsModel::releaseMemory()
+{
+    for (int i = m_loaded.size() - 1; i >= 0; i--) {
+        if (m_loaded.at(i).listId != m_currentListId) {
+            unload(i);
+        }
+    }
+}
+
+void TodoListsModel::applyExternalChanges(const QVector<int> &ids)
+{
+    // The all-lists model gets these from the same source
+    m_forwarding = true;
+    const QVector<Loaded> loaded = m_loaded;
+    for (const Loaded &list : loaded) {
+        list.model->applyExternalChanges(ids);
+    }
+    m_forwarding = false;
+
+    refreshCounts();
+}
+
+void TodoListsModel::reload()
+{
+    const int current = m_currentListId;
+    loadLists();
+
+    for (int i = m_loaded.size() - 1; i >= 0; i--) {
+        if (rowForList(m_loaded.at(i).listId) < 0) {
+            unload(i);
+        } else {
+            m_loaded.at(i).model->reloadFromDatabase();
+        }
+    }
+
+    if (rowForList(current) < 0) {
+        m_currentListId = m_lists.isEmpty() ? 0 : m_lists.first().id;
+    }
+    if (m_currentListId != current) {
+        emit currentListChanged();
+    }
+}
+
+void TodoListsModel::loadLists()
+{
+    beginResetModel();
+    m_lists.clear();
+
+    QSqlQuery query;
+    if (!query.exec("SELECT id, name FROM todo_lists ORDER BY id")) {
+        qDebug() << "Error loading todo lists:" << query.lastError().text();
+        endResetModel();
+        return;
+    }
+
+    while (query.next()) {
+        List list;
+        list.id = query.value(0).toInt();
+        list.name = query.value(1).toString();
+        list.open = 0;
+        list.completed = 0;
+        m_lists.append(list);
+    }
+
+    endResetModel();
+    refreshCounts();
+}
+
+void TodoListsModel::refreshCounts(int listId)
+{
+    // Top-level todos only; idx_todos_list covers the whole query
+    QSqlQuery query;
+    query.prepare(QString("SELECT list_id, COUNT(*), TOTAL(completed) FROM todos "
+                          "WHERE parent_id IS NULL %1GROUP BY list_id")
+                      .arg(listId > 0 ? "AND list_id = :list_id " : ""));
+    if (listId > 0) {
+        query.bindValue(":list_id", listId);
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Error counting todo lists:" << query.lastError().text();
+        return;
+    }
+
+    QHash<int, QPair<int, int>> counts;
+    while (query.next()) {
+        const int total = query.value(1).toInt();
+        const int completed = query.value(2).toInt();
+        counts.insert(query.value(0).toInt(), qMakePair(total - completed, completed));
+    }
+
+    for (int row = 0; row < m_lists.size(); row++) {
+        List &list = m_lists[row];
+        if (listId > 0 && list.id != listId) {
+            continue;
+        }
+        const QPair<int, int> count = counts.value(list.id, qMakePair(0, 0));
+        if (list.open != count.first || list.completed != count.second) {
+            list.open = count.first;
+            list.completed = count.second;
+            const QModelIndex modelIndex = index(row, 0);
+            emit dataChanged(modelIndex, modelIndex, QVector<int>() << OpenCountRole << CompletedCountRole);
+        }
+    }
+}
+
+void TodoListsModel::evict()
+{
+    // Least recently opened first; the open list and the one just opened stay
+    for (int i = m_loaded.size() - 1; i > 0 && m_loaded.size() > m_capacity; i--) {
+        if (m_loaded.at(i).listId != m_currentListId) {
+            unload(i);
+        }
+    }
+}
+
+void TodoListsModel::unload(int at)
+{
+    const Loaded loaded = m_loaded.takeAt(at);
+    loaded.model->disconnect(this);
+    // Possibly still in the middle of emitting
+    loaded.model->deleteLater();
+    emitLoadedChanged(loaded.listId);
+}
+
+void TodoListsModel::emitLoadedChanged(int listId)
+{
+    const int row = rowForList(listId);
+    if (row >= 0) {
+        const QModelIndex modelIndex = index(row, 0);
+        emit dataChanged(modelIndex, modelIndex, QVector<int>() << LoadedRole);
+    }
+}
+
+void TodoListsModel::watch(todoManager *model)
+{
+    connect(model, &QAbstractItemModel::rowsInserted, this,
+            [this, model](const QModelIndex &, int first, int last) {
+                forward(model, idsIn(model, first, last));
+            });
+    connect(model, &QAbstractItemModel::dataChanged, this,
+            [this, model](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                forward(model, idsIn(model, topLeft.row(), bottomRight.row()));
+            });
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+            [this, model](const QModelIndex &, int first, int last) {
+                if (!m_forwarding) {
+                    m_removing += idsIn(model, first, last);
+                }
+            });
+    connect(model, &QAbstractItemModel::rowsRemoved, this, [this, model]() {
+        forward(model, std::exchange(m_removing, QVector<int>()));
+    });
+
+    if (model != m_all) {
+        connect(model, &todoManager::completionChanged, this, &TodoListsModel::completionChanged);
+    }
+}
+
+void TodoListsModel::forward(todoManager *source, const QVector<int> &ids)
+{
+    // The rows are already written; the other models re-read just these.
+    // Changes they make in turn are not sent back.
+    if (m_forwarding || ids.isEmpty()) {
+        return;
+    }
+
+    m_forwarding = true;
+    if (source == m_all) {
+        // Edited from elsewhere: the smart views, the tree, reminders, ...
+        const QVector<Loaded> loaded = m_loaded;
+        for (const Loaded &list : loaded) {
+            list.model->applyExternalChanges(ids);
+        }
+    } else {
+        m_all->applyExternalChanges(ids);
+    }
+    m_forwarding = false;
+
+    refreshCounts(source == m_all ? 0 : source->listId());
+}
+
+QVector<int> TodoListsModel::idsIn(todoManager *model, int first, int last) const
+{
+    QVector<int> ids;
+    for (int row = first; row <= last; row++) {
+        ids.append(model->data(model->index(row, 0), todoManager::IdRole).toInt());
+    }
+    return ids;
+}
@@ -0,0 +1,105 @@
+#ifndef TODOLISTSMODEL_H
+#define TODOLISTSMODEL_H
+
+#include <QAbstractListModel>
+#include <QDate>
+#include <QVector>
+
+class todoManager;
+
+// The user's todo lists (one per course, project, ...) with their open
+// and completed counts. Counts come from a grouped query over the list_id
+// index, so a list never has to be loaded to be counted. A list's todos
+// load into their own todoManager when it is opened; beyond capacity()
+// lists, and on releaseMemory(), the least recently opened ones are
+// dropped again. Edits made through a list's model reach the all-lists
+// todoManager the rest of the app watches, and the other way round.
+class TodoListsModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int currentListId READ currentListId WRITE setCurrentListId NOTIFY currentListChanged)
+    Q_PROPERTY(todoManager *currentModel READ currentModel NOTIFY currentListChanged)
+
+public:
+    enum ListRoles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        OpenCountRole,
+        CompletedCountRole,
+        LoadedRole
+    };
+
+    explicit TodoListsModel(todoManager *allTodos, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Returns the new list's id, or -1.
+    Q_INVOKABLE int createList(const QString &name);
+    Q_INVOKABLE bool renameList(int listId, const QString &name);
+    // Deletes the list and its todos. The last list cannot be deleted.
+    Q_INVOKABLE bool deleteList(int listId);
+    // Moves a top-level todo and its subtasks to the end of another list.
+    Q_INVOKABLE bool moveTodoToList(int todoId, int listId);
+    // List of a top-level todo, or -1.
+    Q_INVOKABLE int listOf(int todoId) const;
+    Q_INVOKABLE int rowForList(int listId) const;
+    Q_INVOKABLE int openCount(int listId) const;
+    Q_INVOKABLE int completedCount(int listId) const;
+
+    // The list's todos, loaded on first use. Owned by this model and
+    // deleted once evicted, so don't hold on to it.
+    Q_INVOKABLE todoManager *model(int listId);
+    bool isLoaded(int listId) const;
+    int loadedCount() const;
+    int capacity() const;
+    void setCapacity(int lists);
+
+    int currentListId() const;
+    void setCurrentListId(int listId);
+    todoManager *currentModel();
+
+public slots:
+    // Drops every loaded list except the current one.
+    void releaseMemory();
+    void applyExternalChanges(const QVector<int> &ids);
+    void reload();
+
+signals:
+    void currentListChanged();
+    // Completions recorded through a list's model.
+    void completionChanged(const QDate &day, int delta);
+
+private:
+    struct List {
+        int id;
+        QString name;
+        int open;
+        int completed;
+    };
+
+    struct Loaded {
+        int listId;
+        todoManager *model;
+    };
+
+    void loadLists();
+    void refreshCounts(int listId = 0);
+    void evict();
+    void unload(int at);
+    void emitLoadedChanged(int listId);
+    void watch(todoManager *model);
+    void forward(todoManager *source, const QVector<int> &ids);
+    QVector<int> idsIn(todoManager *model, int first, int last) const;
+
+    todoManager *m_all;
+    QVector<List> m_lists;          // by id
+    QVector<Loaded> m_loaded;       // most recently opened first
+    int m_capacity;
+    int m_currentListId;
+    bool m_forwarding;
+    QVector<int> m_removing;
+};
+
+#endif // TODOLISTSMODEL_H
@@ -4,12 +4,49 @@
 #include <QSqlDatabase>
 #include <QDebug>
 #include <QVariant>
+#include <QVariantMap>
+#include <QPair>
+#include "../clock/clock.h"
+#include "../database/databasemanager.h"
+#include "sortkey.h"
+#include "recurrencerule.h"
+#include <algorithm>
+
+namespace {
+
+// Keys longer than this get the whole list re-spread shortly afterwards.
+const int kMaxSortKeyLength = 12;
+const int kRebalanceDelayMs = 2000;
+
+} // namespace
 
 // Constructor for todoManager class
 todoManager::todoManager(QObject *parent)
-    : QAbstractListModel(parent)
+    : todoManager(0, parent)
+{
+}
+
+todoManager::todoManager(int listId, QObject *parent)
+    : QAbstractListModel(parent),
+    m_listId(listId),
+    m_searchResults(new TodoSearchModel(listId, this)),
+    m_rebalanceTimer(Clock::instance()->createTimer(this))
 {
+    m_rebalanceTimer->setSingleShot(true);
+    m_rebalanceTimer->setTimerType(Qt::CoarseTimer);
+    connect(m_rebalanceTimer, &ClockTimer::timeout, this, &todoManager::rebalanceSortKeys);
+
     loadTodosFromDatabase();
+
+    // Keep visible search results current; the index itself is trigger-maintained.
+    auto refreshSearch = [this]() {
+        if (!m_searchResults->query().isEmpty()) {
+            m_searchResults->refresh();
+        }
+    };
+    connect(this, &todoManager::todoAdded, m_searchResults, refreshSearch);
+    connect(this, &todoManager::todoRemoved, m_searchResults, refreshSearch);
+    connect(this, &todoManager::todoUpdated, m_searchResults, refreshSearch);
 }
 
 int todoManager::rowCount(const QModelIndex &parent) const
@@ -37,6 +74,14 @@ QVariant todoManager::data(const QModelIndex &index, int role) const
         return item->completed();
     case PriorityRole:
         return item->priority();
+    case IdRole:
+        return item->id();
+    case EstimatedPomodorosRole:
+        return item->estimatedPomodoros();
+    case SortKeyRole:
+        return item->sortKey();
+    case RecurrenceRole:
+        return item->recurrence();
     default:
         return QVariant();
     }
@@ -71,6 +116,18 @@ bool todoManager::setData(const QModelIndex &index, const QVariant &value, int r
         item->setPriority(static_cast<TodoItem::Priority>(value.toInt()));
         changed = true;
         break;
+    case EstimatedPomodorosRole:
+        item->setEstimatedPomodoros(value.toInt());
+        changed = true;
+        break;
+    case SortKeyRole:
+        item->setSortKey(value.toString());
+        changed = true;
+        break;
+    case RecurrenceRole:
+        item->setRecurrence(value.toString());
+        changed = true;
+        break;
     default:
         break;
     }
@@ -98,19 +155,29 @@ QHash<int, QByteArray> todoManager::roleNames() const
     roles[DueDateRole] = "dueDate";
     roles[CompletedRole] = "completed";
     roles[PriorityRole] = "priority";
+    roles[IdRole] = "todoId";
+    roles[EstimatedPomodorosRole] = "estimatedPomodoros";
+    roles[SortKeyRole] = "sortKey";
+    roles[RecurrenceRole] = "recurrence";
     return roles;
 }
 
 void todoManager::addTodo(const QString &title, const QString &description,
                           const QDateTime &dueDate, int priority)
 {
+    // New todos go to the end of the manual order
+    const QString sortKey = SortKey::between(m_todos.isEmpty() ? QString() : m_todos.last()->sortKey(), QString());
+
+    // Without a list the database puts it in the first one
     QSqlQuery query;
-    query.prepare("INSERT INTO todos (title, description, due_date, priority) "
-                  "VALUES (:title, :description, :due_date, :priority)");
+    query.prepare("INSERT INTO todos (title, description, due_date, priority, sort_key, list_id) "
+                  "VALUES (:title, :description, :due_date, :priority, :sort_key, :list_id)");
     query.bindValue(":title", title);
     query.bindValue(":description", description);
     query.bindValue(":due_date", dueDate.isValid() ? dueDate : QVariant());
     query.bindValue(":priority", priority);
+    query.bindValue(":sort_key", sortKey);
+    query.bindValue(":list_id", m_listId > 0 ? QVariant(m_listId) : QVariant());
 
     if (!query.exec()) {
         qDebug() << "Error adding todo:" << query.lastError().text();
@@ -130,10 +197,12 @@ void todoManager::addTodo(const QString &title, const QString &description,
         newId,
         this
         );
+    newItem->setSortKey(sortKey);
     m_todos.append(newItem);
     endInsertRows();
 
     emit todoAdded();
+    scheduleRebalance(sortKey);
 }
 
 void todoManager::removeTodo(int index)
@@ -144,8 +213,12 @@ void todoManager::removeTodo(int index)
     TodoItem *item = m_todos.at(index);
     int todoId = item->id();
 
+    // Subtasks go with their todo
     QSqlQuery query;
-    query.prepare("DELETE FROM todos WHERE id = :id");
+    query.prepare("WITH RECURSIVE subtree(id) AS ("
+                  "SELECT :id UNION ALL "
+                  "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                  "DELETE FROM todos WHERE id IN (SELECT id FROM subtree)");
     query.bindValue(":id", todoId);
 
     if (!query.exec()) {
@@ -169,6 +242,11 @@ void todoManager::markAsCompleted(int index, bool completed)
     TodoItem *item = m_todos.at(index);
     int todoId = item->id();
 
+    if (completed && !item->completed() && !item->recurrence().isEmpty()) {
+        completeOccurrence(index);
+        return;
+    }
+
     QSqlQuery query;
     query.prepare("UPDATE todos SET completed = :completed WHERE id = :id");
     query.bindValue(":completed", completed);
@@ -179,6 +257,20 @@ void todoManager::markAsCompleted(int index, bool completed)
         return;
     }
 
+    if (item->completed() != completed) {
+        if (completed) {
+            const QDateTime now = Clock::instance()->now();
+            if (DatabaseManager::instance().recordTodoCompletion(todoId, now)) {
+                emit completionChanged(now.date(), 1);
+            }
+        } else {
+            const QDate day = DatabaseManager::instance().removeTodoCompletion(todoId);
+            if (day.isValid()) {
+                emit completionChanged(day, -1);
+            }
+        }
+    }
+
     QModelIndex modelIndex = createIndex(index, 0);
     setData(modelIndex, completed, CompletedRole);
 }
@@ -192,13 +284,20 @@ void todoManager::updateTodo(int index, const QString &title, const QString &des
     TodoItem *item = m_todos.at(index);
     int todoId = item->id();
 
+    // Moving a repeating todo's date moves the whole series
+    QDateTime recurrenceStart = item->recurrenceStart();
+    if (!item->recurrence().isEmpty() && dueDate.isValid() && dueDate != item->dueDate()) {
+        recurrenceStart = dueDate;
+    }
+
     QSqlQuery query;
     query.prepare("UPDATE todos SET title = :title, description = :description, "
-                  "due_date = :due_date, priority = :priority WHERE id = :id");
+                  "due_date = :due_date, priority = :priority, recurrence_start = :start WHERE id = :id");
     query.bindValue(":title", title);
     query.bindValue(":description", description);
     query.bindValue(":due_date", dueDate.isValid() ? dueDate : QVariant());
     query.bindValue(":priority", priority);
+    query.bindValue(":start", recurrenceStart.isValid() ? recurrenceStart : QVariant());
     query.bindValue(":id", todoId);
 
     if (!query.exec()) {
@@ -206,6 +305,7 @@ void todoManager::updateTodo(int index, const QString &title, const QString &des
         return;
     }
 
+    item->setRecurrenceStart(recurrenceStart);
     QModelIndex modelIndex = createIndex(index, 0);
     setData(modelIndex, title, TitleRole);
     setData(modelIndex, description, DescriptionRole);
@@ -213,6 +313,162 @@ void todoManager::updateTodo(int index, const QString &title, const QString &des
     setData(modelIndex, priority, PriorityRole);
 }
 
+void todoManager::setEstimatedPomodoros(int index, int pomodoros)
+{
+    if (index < 0 || index >= m_todos.size() || pomodoros < 1)
+        return;
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET estimated_pomodoros = :pomodoros WHERE id = :id");
+    query.bindValue(":pomodoros", pomodoros);
+    query.bindValue(":id", m_todos.at(index)->id());
+
+    if (!query.exec()) {
+        qDebug() << "Error updating todo estimate:" << query.lastError().text();
+        return;
+    }
+
+    setData(createIndex(index, 0), pomodoros, EstimatedPomodorosRole);
+}
+
+bool todoManager::setRecurrence(int index, const QString &rule)
+{
+    if (index < 0 || index >= m_todos.size())
+        return false;
+
+    TodoItem *item = m_todos.at(index);
+
+    // The series counts from the due date; an undated todo starts now
+    const QDateTime start = item->dueDate().isValid() ? item->dueDate() : Clock::instance()->now();
+    const RecurrenceRule parsed = RecurrenceRule::parse(rule, start);
+    if (!rule.trimmed().isEmpty() && !parsed.isValid()) {
+        qDebug() << "Invalid repeat rule:" << rule;
+        return false;
+    }
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET recurrence = :recurrence, recurrence_start = :start, "
+                  "due_date = :due_date WHERE id = :id");
+    query.bindValue(":recurrence", parsed.isValid() ? parsed.toString() : QVariant());
+    query.bindValue(":start", parsed.isValid() ? start : QVariant());
+    query.bindValue(":due_date", parsed.isValid() ? start : (item->dueDate().isValid() ? item->dueDate() : QVariant()));
+    query.bindValue(":id", item->id());
+
+    if (!query.exec()) {
+        qDebug() << "Error updating todo repeat:" << query.lastError().text();
+        return false;
+    }
+
+    const QModelIndex modelIndex = createIndex(index, 0);
+    item->setRecurrenceStart(parsed.isValid() ? start : QDateTime());
+    setData(modelIndex, parsed.toString(), RecurrenceRole);
+    if (parsed.isValid() && item->dueDate() != start) {
+        setData(modelIndex, start, DueDateRole);
+    }
+    return true;
+}
+
+QVariantList todoManager::occurrences(const QDateTime &from, const QDateTime &to) const
+{
+    QVector<QPair<QDateTime, QVariantMap>> found;
+    for (TodoItem *item : std::as_const(m_todos)) {
+        if (item->recurrence().isEmpty() || item->completed()) {
+            continue;
+        }
+        // Nothing before the current occurrence: those are done or skipped
+        const RecurrenceRule rule = RecurrenceRule::parse(item->recurrence(), item->recurrenceStart());
+        const QDateTime windowStart = item->dueDate().isValid() ? qMax(from, item->dueDate()) : from;
+        for (const QDateTime &due : rule.occurrencesBetween(windowStart, to)) {
+            QVariantMap occurrence;
+            occurrence.insert("todoId", item->id());
+            occurrence.insert("title", item->title());
+            occurrence.insert("dueDate", due);
+            found.append(qMakePair(due, occurrence));
+        }
+    }
+
+    std::stable_sort(found.begin(), found.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    QVariantList list;
+    for (const auto &entry : std::as_const(found)) {
+        list.append(entry.second);
+    }
+    return list;
+}
+
+void todoManager::completeOccurrence(int row)
+{
+    TodoItem *item = m_todos.at(row);
+    const RecurrenceRule rule = RecurrenceRule::parse(item->recurrence(), item->recurrenceStart());
+    if (!rule.isValid()) {
+        return;
+    }
+
+    // The series stays one row: log this occurrence as done and move the
+    // due date on to the next one. Occurrences already past are skipped
+    // rather than piled up.
+    const QDateTime now = Clock::instance()->now();
+    const QDateTime due = item->dueDate();
+    const QDateTime next = rule.nextAfter(due.isValid() && due > now ? due : now);
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET due_date = :due_date WHERE id = :id");
+    query.bindValue(":due_date", next);
+    query.bindValue(":id", item->id());
+
+    if (!query.exec()) {
+        qDebug() << "Error advancing repeating todo:" << query.lastError().text();
+        return;
+    }
+
+    if (DatabaseManager::instance().recordTodoCompletion(item->id(), now)) {
+        emit completionChanged(now.date(), 1);
+    }
+
+    setData(createIndex(row, 0), next, DueDateRole);
+}
+
+bool todoManager::moveTodo(int from, int to)
+{
+    if (from < 0 || from >= m_todos.size() || to < 0 || to >= m_todos.size())
+        return false;
+    if (from == to)
+        return true;
+
+    // Neighbours at the destination once the todo is taken out
+    const auto keyAt = [this, from](int row) {
+        return m_todos.at(row < from ? row : row + 1)->sortKey();
+    };
+    const auto keyFor = [this, &keyAt, to]() {
+        return SortKey::between(to > 0 ? keyAt(to - 1) : QString(),
+                                to < m_todos.size() - 1 ? keyAt(to) : QString());
+    };
+
+    QString key = keyFor();
+    if (key.isEmpty()) {
+        // Equal neighbouring keys (e.g. from a sync merge); spread them first
+        rebalanceSortKeys();
+        key = keyFor();
+    }
+    if (key.isEmpty() || !writeSortKey(m_todos.at(from)->id(), key)) {
+        return false;
+    }
+
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+    m_todos.move(from, to);
+    endMoveRows();
+
+    m_todos.at(to)->setSortKey(key);
+    const QModelIndex moved = createIndex(to, 0);
+    emit dataChanged(moved, moved, QVector<int>() << SortKeyRole);
+    emit todoUpdated();
+
+    scheduleRebalance(key);
+    return true;
+}
+
 int todoManager::count() const
 {
     return m_todos.size();
@@ -239,8 +495,17 @@ void todoManager::loadTodosFromDatabase()
     qDeleteAll(m_todos);
     m_todos.clear();
 
-    QSqlQuery query("SELECT id, title, description, due_date, priority, completed "
-                    "FROM todos ORDER BY created_date DESC");
+    // Top-level todos in manual order; rows without a key yet (older
+    // databases, other writers) follow, newest first, and are given keys
+    // below. Subtasks live in the todo tree model.
+    QSqlQuery query;
+    query.prepare(QString("SELECT id, title, description, due_date, priority, completed, estimated_pomodoros, sort_key, "
+                          "recurrence, recurrence_start FROM todos WHERE parent_id IS NULL %1"
+                          "ORDER BY sort_key IS NULL, sort_key, created_date DESC")
+                      .arg(m_listId > 0 ? "AND list_id = :list_id " : ""));
+    if (m_listId > 0) {
+        query.bindValue(":list_id", m_listId);
+    }
 
     if (!query.exec()) {
         qDebug() << "Error loading todos from database:" << query.lastError().text();
@@ -265,17 +530,253 @@ void todoManager::loadTodosFromDatabase()
             id,
             this
             );
+        item->setEstimatedPomodoros(query.value(6).toInt());
+        item->setSortKey(query.value(7).toString());
+        item->setRecurrence(query.value(8).toString());
+        item->setRecurrenceStart(query.value(9).toDateTime());
 
         m_todos.append(item);
     }
 
+    // Key the unkeyed rows in one transaction
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+    QString previous;
+    for (TodoItem *item : std::as_const(m_todos)) {
+        if (item->sortKey().isEmpty()) {
+            const QString key = SortKey::between(previous, QString());
+            if (writeSortKey(item->id(), key)) {
+                item->setSortKey(key);
+            }
+        }
+        previous = item->sortKey();
+    }
+    if (!db.commit()) {
+        qDebug() << "Error saving todo sort keys:" << db.lastError().text();
+        db.rollback();
+    }
+
     endResetModel();
+
+    if (!m_todos.isEmpty()) {
+        scheduleRebalance(m_todos.last()->sortKey());
+    }
+}
+
+void todoManager::reloadFromDatabase()
+{
+    loadTodosFromDatabase();
+}
+
+void todoManager::applyExternalChanges(const QVector<int> &ids)
+{
+    // Apply rows written by another connection without resetting the model.
+    for (int id : ids) {
+        QSqlQuery query;
+        query.prepare("SELECT title, description, due_date, priority, completed, estimated_pomodoros, sort_key, parent_id, list_id, "
+                      "recurrence, recurrence_start FROM todos WHERE id = :id");
+        query.bindValue(":id", id);
+
+        if (!query.exec()) {
+            qDebug() << "Error fetching changed todo:" << query.lastError().text();
+            continue;
+        }
+
+        const int row = rowForId(id);
+
+        // Gone, now a subtask of another todo, or moved to another list
+        if (!query.next() || !query.value(7).isNull()
+            || (m_listId > 0 && query.value(8).toInt() != m_listId)) {
+            if (row >= 0) {
+                beginRemoveRows(QModelIndex(), row, row);
+                delete m_todos.takeAt(row);
+                endRemoveRows();
+                emit todoRemoved();
+            }
+            continue;
+        }
+
+        const QString title = query.value(0).toString();
+        const QString description = query.value(1).toString();
+        const QDateTime dueDate = query.value(2).toDateTime();
+        const auto priority = static_cast<TodoItem::Priority>(query.value(3).toInt());
+        const bool completed = query.value(4).toBool();
+        const int estimate = query.value(5).toInt();
+        QString sortKey = query.value(6).toString();
+        const QString recurrence = query.value(9).toString();
+        const QDateTime recurrenceStart = query.value(10).toDateTime();
+
+        if (sortKey.isEmpty()) {
+            // Written by something that does not order todos; append it
+            QString last;
+            for (int r = m_todos.size() - 1; r >= 0 && last.isEmpty(); r--) {
+                if (r != row) {
+                    last = m_todos.at(r)->sortKey();
+                }
+            }
+            sortKey = SortKey::between(last, QString());
+            writeSortKey(id, sortKey);
+        }
+
+        if (row < 0) {
+            const int at = rowForSortKey(sortKey);
+            beginInsertRows(QModelIndex(), at, at);
+            TodoItem *added = new TodoItem(title, description, dueDate, priority, completed, id, this);
+            added->setEstimatedPomodoros(estimate);
+            added->setSortKey(sortKey);
+            added->setRecurrence(recurrence);
+            added->setRecurrenceStart(recurrenceStart);
+            m_todos.insert(at, added);
+            endInsertRows();
+            emit todoAdded();
+            continue;
+        }
+
+        TodoItem *item = m_todos.at(row);
+        QVector<int> roles;
+        if (item->title() != title) {
+            item->setTitle(title);
+            roles << TitleRole;
+        }
+        if (item->description() != description) {
+            item->setDescription(description);
+            roles << DescriptionRole;
+        }
+        if (item->dueDate() != dueDate) {
+            item->setDueDate(dueDate);
+            roles << DueDateRole;
+        }
+        if (item->priority() != priority) {
+            item->setPriority(priority);
+            roles << PriorityRole;
+        }
+        if (item->completed() != completed) {
+            item->setCompleted(completed);
+            roles << CompletedRole;
+        }
+        if (item->estimatedPomodoros() != estimate) {
+            item->setEstimatedPomodoros(estimate);
+            roles << EstimatedPomodorosRole;
+        }
+        if (item->recurrence() != recurrence || item->recurrenceStart() != recurrenceStart) {
+            item->setRecurrence(recurrence);
+            item->setRecurrenceStart(recurrenceStart);
+            roles << RecurrenceRole;
+        }
+        int at = row;
+        if (item->sortKey() != sortKey) {
+            // Reordered elsewhere: move just this row to its new place
+            at = rowForSortKey(sortKey, row);
+            if (at != row) {
+                beginMoveRows(QModelIndex(), row, row, QModelIndex(), at > row ? at + 1 : at);
+                m_todos.move(row, at);
+                endMoveRows();
+            }
+            item->setSortKey(sortKey);
+            roles << SortKeyRole;
+        }
+
+        if (!roles.isEmpty()) {
+            QModelIndex modelIndex = createIndex(at, 0);
+            emit dataChanged(modelIndex, modelIndex, roles);
+            emit todoUpdated();
+        }
+    }
+}
+
+int todoManager::rowForId(int id) const
+{
+    for (int i = 0; i < m_todos.size(); ++i) {
+        if (m_todos.at(i)->id() == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int todoManager::listId() const
+{
+    return m_listId;
+}
+
+int todoManager::rowForSortKey(const QString &key, int skipRow) const
+{
+    // Lower bound over the rows as if skipRow were not there
+    int low = 0;
+    int high = skipRow >= 0 ? m_todos.size() - 1 : m_todos.size();
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        const int actual = skipRow >= 0 && mid >= skipRow ? mid + 1 : mid;
+        if (m_todos.at(actual)->sortKey() < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool todoManager::writeSortKey(int id, const QString &key)
+{
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET sort_key = :sort_key WHERE id = :id");
+    query.bindValue(":sort_key", key);
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        qDebug() << "Error updating todo order:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void todoManager::scheduleRebalance(const QString &newKey)
+{
+    if (newKey.size() > kMaxSortKeyLength && !m_rebalanceTimer->isActive()) {
+        m_rebalanceTimer->start(kRebalanceDelayMs);
+    }
+}
+
+void todoManager::rebalanceSortKeys()
+{
+    m_rebalanceTimer->stop();
+    if (m_todos.isEmpty()) {
+        return;
+    }
+
+    // Same order, evenly spaced short keys
+    const QStringList keys = SortKey::spread(m_todos.size());
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+    bool ok = true;
+    for (int row = 0; row < m_todos.size() && ok; row++) {
+        ok = writeSortKey(m_todos.at(row)->id(), keys.at(row));
+    }
+    if (!ok || !db.commit()) {
+        qDebug() << "Error rebalancing todo order:" << db.lastError().text();
+        db.rollback();
+        return;
+    }
+
+    for (int row = 0; row < m_todos.size(); row++) {
+        m_todos.at(row)->setSortKey(keys.at(row));
+    }
+    emit dataChanged(createIndex(0, 0), createIndex(m_todos.size() - 1, 0), QVector<int>() << SortKeyRole);
 }
 
 void todoManager::clearCompleted()
 {
     QSqlQuery query;
-    query.prepare("DELETE FROM todos WHERE completed = 1");
+    // Completed todos of this model's list and everything under them
+    query.prepare(QString("WITH RECURSIVE subtree(id) AS ("
+                          "SELECT id FROM todos WHERE completed = 1 AND parent_id IS NULL %1UNION ALL "
+                          "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                          "DELETE FROM todos WHERE id IN (SELECT id FROM subtree)")
+                      .arg(m_listId > 0 ? "AND list_id = :list_id " : ""));
+    if (m_listId > 0) {
+        query.bindValue(":list_id", m_listId);
+    }
 
     if (!query.exec()) {
         qDebug() << "Error clearing completed todos:" << query.lastError().text();
@@ -294,6 +795,16 @@ void todoManager::clearCompleted()
     emit todoRemoved();
 }
 
+void todoManager::search(const QString &text)
+{
+    m_searchResults->setQuery(text);
+}
+
+TodoSearchModel *todoManager::searchResults() const
+{
+    return m_searchResults;
+}
+
 void todoManager::killTodoView()
 {
     emit closeTodoView();
@@ -5,22 +5,34 @@
 #include <QAbstractListModel>
 #include <QObject>
 #include <QDateTime>
+#include <QVariantList>
 #include "todo.h"
+#include "todosearchmodel.h"
+
+class ClockTimer;
+
 class todoManager : public QAbstractListModel
 {
 
     Q_OBJECT
-
+    Q_PROPERTY(TodoSearchModel *searchResults READ searchResults CONSTANT)
 
 public:
     todoManager(QObject *parent = nullptr);
+    // Only the todos of one list (see TodoListsModel); the default
+    // constructor covers every list.
+    explicit todoManager(int listId, QObject *parent = nullptr);
 
     enum TodoRoles {
         TitleRole = Qt::UserRole + 1,
         DescriptionRole,
         DueDateRole,
         CompletedRole,
-        PriorityRole
+        PriorityRole,
+        IdRole,
+        EstimatedPomodorosRole,
+        SortKeyRole,
+        RecurrenceRole
     };
 
 
@@ -39,21 +51,55 @@ public:
     Q_INVOKABLE void markAsCompleted(int index, bool completed = true);
     Q_INVOKABLE void updateTodo(int index, const QString &title, const QString &description,
                                 const QDateTime &dueDate, int priority);
+    Q_INVOKABLE void setEstimatedPomodoros(int index, int pomodoros);
+    // Makes the todo repeat by rule ("1d", "2w", "1m", ...), counting from
+    // its due date; an empty rule makes it a one-off again. Completing a
+    // repeating todo records the occurrence and moves the due date on to
+    // the next one instead.
+    Q_INVOKABLE bool setRecurrence(int index, const QString &rule);
+    // Occurrences of the repeating todos in [from, to), worked out from
+    // their rules for just that window; maps with todoId, title, dueDate.
+    Q_INVOKABLE QVariantList occurrences(const QDateTime &from, const QDateTime &to) const;
+    // Manual reordering: the todo at from ends up at row to. Only its
+    // sort_key is rewritten.
+    Q_INVOKABLE bool moveTodo(int from, int to);
     Q_INVOKABLE int count() const;
+    // Row of the top-level todo with this id, or -1.
+    Q_INVOKABLE int rowForId(int id) const;
+    // 0 when the model covers every list.
+    int listId() const;
     Q_INVOKABLE void saveTodos(const QString &filename);
     Q_INVOKABLE void loadTodos(const QString &filename);
     Q_INVOKABLE void clearCompleted();
     Q_INVOKABLE void killTodoView();
 
+    // Full-text search; results land in searchResults.
+    Q_INVOKABLE void search(const QString &text);
+    TodoSearchModel *searchResults() const;
+
+    public slots:
+        void applyExternalChanges(const QVector<int> &ids);
+        void reloadFromDatabase();
+
     signals:
         void todoAdded();
         void todoRemoved();
         void todoUpdated();
+        // A completion was recorded (+1) or retracted (-1) on day.
+        void completionChanged(const QDate &day, int delta);
         void closeTodoView();
 
     private:
+        int m_listId;
         QVector<TodoItem*> m_todos;
+        TodoSearchModel *m_searchResults;
+        ClockTimer *m_rebalanceTimer;
         void loadTodosFromDatabase();  // Add this private method
+        int rowForSortKey(const QString &key, int skipRow = -1) const;
+        bool writeSortKey(int id, const QString &key);
+        void scheduleRebalance(const QString &newKey);
+        void rebalanceSortKeys();
+        void completeOccurrence(int row);
 
 
 
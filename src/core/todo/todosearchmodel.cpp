@@ -0,0 +1,160 @@
+#include "todosearchmodel.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QRegularExpression>
+#include <QDebug>
+
+namespace {
+
+// Match markers that cannot occur in typed text; swapped for <b> tags
+// after the rest of the text has been HTML-escaped.
+const QString kOpen = QStringLiteral("\x02");
+const QString kClose = QStringLiteral("\x03");
+
+QString markedToHtml(const QString &marked)
+{
+    return marked.toHtmlEscaped().replace(kOpen, "<b>").replace(kClose, "</b>");
+}
+
+} // namespace
+
+TodoSearchModel::TodoSearchModel(QObject *parent)
+    : TodoSearchModel(0, parent)
+{
+}
+
+TodoSearchModel::TodoSearchModel(int listId, QObject *parent)
+    : QAbstractListModel(parent),
+    m_listId(listId),
+    m_limit(50)
+{
+}
+
+int TodoSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_hits.size();
+}
+
+QVariant TodoSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_hits.size())
+        return QVariant();
+
+    const Hit &hit = m_hits.at(index.row());
+
+    switch (role) {
+    case IdRole:
+        return hit.id;
+    case TitleRole:
+        return hit.title;
+    case HighlightedTitleRole:
+        return hit.highlightedTitle;
+    case SnippetRole:
+        return hit.snippet;
+    case CompletedRole:
+        return hit.completed;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TodoSearchModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[IdRole] = "todoId";
+    roles[TitleRole] = "title";
+    roles[HighlightedTitleRole] = "highlightedTitle";
+    roles[SnippetRole] = "snippet";
+    roles[CompletedRole] = "completed";
+    return roles;
+}
+
+QString TodoSearchModel::query() const
+{
+    return m_query;
+}
+
+void TodoSearchModel::setQuery(const QString &query)
+{
+    if (m_query == query) {
+        return;
+    }
+    m_query = query;
+    emit queryChanged();
+    refresh();
+}
+
+int TodoSearchModel::limit() const
+{
+    return m_limit;
+}
+
+void TodoSearchModel::setLimit(int limit)
+{
+    if (m_limit == limit || limit < 1) {
+        return;
+    }
+    m_limit = limit;
+    emit limitChanged();
+    refresh();
+}
+
+QString TodoSearchModel::toMatchExpression(const QString &text)
+{
+    static const QRegularExpression separators("[^\\w]+", QRegularExpression::UseUnicodePropertiesOption);
+
+    QStringList terms;
+    const QStringList words = text.split(separators, Qt::SkipEmptyParts);
+    for (const QString &word : words) {
+        terms.append("\"" + word + "\"*");
+    }
+    return terms.join(' ');
+}
+
+void TodoSearchModel::refresh()
+{
+    QVector<Hit> hits;
+    const QString match = toMatchExpression(m_query);
+
+    if (!match.isEmpty()) {
+        // bm25 weights: a title hit counts ten times a description hit.
+        QSqlQuery query;
+        query.prepare(QString("SELECT t.id, t.title, t.completed, "
+                              "highlight(todos_fts, 0, :open, :close), "
+                              "snippet(todos_fts, 1, :open, :close, '…', 12) "
+                              "FROM todos_fts JOIN todos t ON t.id = todos_fts.rowid "
+                              "WHERE todos_fts MATCH :match %1"
+                              "ORDER BY bm25(todos_fts, 10.0, 1.0) LIMIT :limit")
+                          .arg(m_listId > 0 ? "AND t.list_id = :list_id " : ""));
+        if (m_listId > 0) {
+            query.bindValue(":list_id", m_listId);
+        }
+        query.bindValue(":open", kOpen);
+        query.bindValue(":close", kClose);
+        query.bindValue(":match", match);
+        query.bindValue(":limit", m_limit);
+
+        if (query.exec()) {
+            while (query.next()) {
+                hits.append({query.value(0).toInt(),
+                             query.value(1).toString(),
+                             markedToHtml(query.value(3).toString()),
+                             markedToHtml(query.value(4).toString()),
+                             query.value(2).toBool()});
+            }
+        } else {
+            qDebug() << "Error searching todos:" << query.lastError().text();
+        }
+    }
+
+    const bool countChanging = hits.size() != m_hits.size();
+    beginResetModel();
+    m_hits = hits;
+    endResetModel();
+    if (countChanging) {
+        emit countChanged();
+    }
+}
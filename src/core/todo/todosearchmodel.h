@@ -0,0 +1,69 @@
+#ifndef TODOSEARCHMODEL_H
+#define TODOSEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+
+// Ranked full-text matches over todo titles and descriptions, read from
+// the todos_fts index. Every word typed matches as a prefix, so results
+// narrow as the user types; rows carry only what a results list shows
+// (the title and a snippet, with matches in <b>), not full TodoItems.
+// A model for one list only returns that list's todos.
+class TodoSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum SearchRoles {
+        IdRole = Qt::UserRole + 1,
+        TitleRole,
+        HighlightedTitleRole,
+        SnippetRole,
+        CompletedRole
+    };
+
+    explicit TodoSearchModel(QObject *parent = nullptr);
+    // listId 0 searches every list.
+    explicit TodoSearchModel(int listId, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString query() const;
+    void setQuery(const QString &query);
+    int limit() const;
+    void setLimit(int limit);
+
+    // User text to an FTS5 query: each word quoted and prefix-matched.
+    static QString toMatchExpression(const QString &text);
+
+public slots:
+    // Re-runs the current query, e.g. after todos changed.
+    void refresh();
+
+signals:
+    void queryChanged();
+    void limitChanged();
+    void countChanged();
+
+private:
+    struct Hit {
+        int id;
+        QString title;
+        QString highlightedTitle;
+        QString snippet;
+        bool completed;
+    };
+
+    int m_listId;
+    QString m_query;
+    int m_limit;
+    QVector<Hit> m_hits;
+};
+
+#endif // TODOSEARCHMODEL_H
@@ -0,0 +1,539 @@
+#include "todosortfiltermodel.h"
+#include "todomanager.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const qint64 kOpenFrom = std::numeric_limits<qint64>::min();
+const qint64 kOpenBefore = std::numeric_limits<qint64>::max();
+
+} // namespace
+
+TodoSortFilterModel::TodoSortFilterModel(QObject *parent)
+    : QAbstractListModel(parent),
+    m_source(nullptr),
+    m_sortMode(Newest),
+    m_reversed(false),
+    m_hideCompleted(false),
+    m_priorityFilter(-1),
+    m_dueFromMs(kOpenFrom),
+    m_dueBeforeMs(kOpenBefore)
+{
+}
+
+int TodoSortFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_visible.size();
+}
+
+QVariant TodoSortFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (!m_source || !index.isValid() || index.row() < 0 || index.row() >= m_visible.size())
+        return QVariant();
+
+    return m_source->data(m_sources.value(m_visible.at(index.row()).id), role);
+}
+
+QHash<int, QByteArray> TodoSortFilterModel::roleNames() const
+{
+    return m_source ? m_source->roleNames() : QHash<int, QByteArray>();
+}
+
+QAbstractItemModel *TodoSortFilterModel::sourceModel() const
+{
+    return m_source;
+}
+
+void TodoSortFilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    if (m_source == model) {
+        return;
+    }
+
+    beginResetModel();
+    if (m_source) {
+        disconnect(m_source, nullptr, this, nullptr);
+    }
+    m_source = model;
+    if (m_source) {
+        connect(m_source, &QAbstractItemModel::rowsInserted, this, &TodoSortFilterModel::onRowsInserted);
+        connect(m_source, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TodoSortFilterModel::onRowsAboutToBeRemoved);
+        connect(m_source, &QAbstractItemModel::dataChanged, this, &TodoSortFilterModel::onDataChanged);
+        connect(m_source, &QAbstractItemModel::modelAboutToBeReset, this, &TodoSortFilterModel::onModelAboutToBeReset);
+        connect(m_source, &QAbstractItemModel::modelReset, this, &TodoSortFilterModel::onModelReset);
+        connect(m_source, &QObject::destroyed, this, [this]() { setSourceModel(nullptr); });
+    }
+    load();
+    endResetModel();
+
+    emit sourceModelChanged();
+    emit countChanged();
+}
+
+TodoSortFilterModel::SortMode TodoSortFilterModel::sortMode() const
+{
+    return m_sortMode;
+}
+
+void TodoSortFilterModel::setSortMode(SortMode mode)
+{
+    if (m_sortMode == mode) {
+        return;
+    }
+    m_sortMode = mode;
+
+    // Keys depend on the mode, so they are recomputed before sorting.
+    beginResetModel();
+    load();
+    endResetModel();
+    emit sortModeChanged();
+}
+
+bool TodoSortFilterModel::reversed() const
+{
+    return m_reversed;
+}
+
+void TodoSortFilterModel::setReversed(bool reversed)
+{
+    if (m_reversed == reversed) {
+        return;
+    }
+    m_reversed = reversed;
+
+    beginResetModel();
+    resort();
+    endResetModel();
+    emit reversedChanged();
+}
+
+bool TodoSortFilterModel::hideCompleted() const
+{
+    return m_hideCompleted;
+}
+
+void TodoSortFilterModel::setHideCompleted(bool hide)
+{
+    if (m_hideCompleted == hide) {
+        return;
+    }
+    m_hideCompleted = hide;
+
+    const int before = m_visible.size();
+    beginResetModel();
+    refilter();
+    endResetModel();
+    emit hideCompletedChanged();
+    if (m_visible.size() != before) {
+        emit countChanged();
+    }
+}
+
+int TodoSortFilterModel::priorityFilter() const
+{
+    return m_priorityFilter;
+}
+
+void TodoSortFilterModel::setPriorityFilter(int priority)
+{
+    if (m_priorityFilter == priority) {
+        return;
+    }
+    m_priorityFilter = priority;
+
+    const int before = m_visible.size();
+    beginResetModel();
+    refilter();
+    endResetModel();
+    emit priorityFilterChanged();
+    if (m_visible.size() != before) {
+        emit countChanged();
+    }
+}
+
+void TodoSortFilterModel::setTagSelection(const TagIndex::Selection &selection)
+{
+    if (m_tagSelection.matchesAll() && selection.matchesAll()) {
+        return;
+    }
+    m_tagSelection = selection;
+
+    const int before = m_visible.size();
+    beginResetModel();
+    refilter();
+    endResetModel();
+    if (m_visible.size() != before) {
+        emit countChanged();
+    }
+}
+
+QDateTime TodoSortFilterModel::dueFrom() const
+{
+    return m_dueFrom;
+}
+
+void TodoSortFilterModel::setDueFrom(const QDateTime &from)
+{
+    setDueRange(from, m_dueBefore);
+}
+
+QDateTime TodoSortFilterModel::dueBefore() const
+{
+    return m_dueBefore;
+}
+
+void TodoSortFilterModel::setDueBefore(const QDateTime &before)
+{
+    setDueRange(m_dueFrom, before);
+}
+
+void TodoSortFilterModel::setDueRange(const QDateTime &from, const QDateTime &before)
+{
+    const qint64 fromMs = from.isValid() ? from.toMSecsSinceEpoch() : kOpenFrom;
+    const qint64 beforeMs = before.isValid() ? before.toMSecsSinceEpoch() : kOpenBefore;
+    if (fromMs == m_dueFromMs && beforeMs == m_dueBeforeMs) {
+        return;
+    }
+
+    const qint64 oldFrom = m_dueFromMs;
+    const qint64 oldBefore = m_dueBeforeMs;
+    const int countBefore = m_visible.size();
+    m_dueFrom = from;
+    m_dueBefore = before;
+    m_dueFromMs = fromMs;
+    m_dueBeforeMs = beforeMs;
+
+    if (m_sortMode != DueDate) {
+        beginResetModel();
+        refilter();
+        endResetModel();
+    } else {
+        // Only todos due between an old and a new bound can change sides.
+        qint64 lows[2] = {qMin(oldFrom, fromMs), qMin(oldBefore, beforeMs)};
+        qint64 highs[2] = {qMax(oldFrom, fromMs), qMax(oldBefore, beforeMs)};
+        int spans = 2;
+        if (lows[1] <= highs[0]) {
+            highs[0] = qMax(highs[0], highs[1]);
+            spans = 1;
+        }
+
+        // Dated todos come first, in due order (descending when reversed).
+        const auto begin = m_all.cbegin();
+        const auto datedEnd = std::partition_point(begin, m_all.cend(),
+                                                   [](const Entry &e) { return e.dated; });
+        for (int i = 0; i < spans; i++) {
+            const qint64 lo = lows[i];
+            const qint64 hi = highs[i];
+            auto first = begin;
+            auto last = begin;
+            if (!m_reversed) {
+                first = std::partition_point(begin, datedEnd, [lo](const Entry &e) { return e.due < lo; });
+                last = std::partition_point(first, datedEnd, [hi](const Entry &e) { return e.due < hi; });
+            } else {
+                first = std::partition_point(begin, datedEnd, [hi](const Entry &e) { return e.due >= hi; });
+                last = std::partition_point(first, datedEnd, [lo](const Entry &e) { return e.due >= lo; });
+            }
+            refreshSpan(int(first - begin), int(last - begin), oldFrom, oldBefore);
+        }
+
+        // Undated todos only switch sides when the window opens or closes.
+        const bool wasOpen = oldFrom == kOpenFrom && oldBefore == kOpenBefore;
+        const bool isOpen = fromMs == kOpenFrom && beforeMs == kOpenBefore;
+        if (wasOpen != isOpen) {
+            refreshSpan(int(datedEnd - begin), m_all.size(), oldFrom, oldBefore);
+        }
+    }
+
+    emit dueRangeChanged();
+    if (m_visible.size() != countBefore) {
+        emit countChanged();
+    }
+}
+
+int TodoSortFilterModel::mapToSource(int row) const
+{
+    if (row < 0 || row >= m_visible.size()) {
+        return -1;
+    }
+    return m_sources.value(m_visible.at(row).id).row();
+}
+
+int TodoSortFilterModel::mapFromSource(int sourceRow) const
+{
+    if (!m_source || sourceRow < 0 || sourceRow >= m_source->rowCount()) {
+        return -1;
+    }
+    const int id = m_source->index(sourceRow, 0).data(todoManager::IdRole).toInt();
+    const auto it = m_entries.constFind(id);
+    if (it == m_entries.constEnd() || !accepts(it.value())) {
+        return -1;
+    }
+    return lowerBound(m_visible, it.value());
+}
+
+void TodoSortFilterModel::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        const QModelIndex index = m_source->index(row, 0);
+        const Entry entry = makeEntry(index);
+        m_sources.insert(entry.id, QPersistentModelIndex(index));
+        insertEntry(entry);
+    }
+}
+
+void TodoSortFilterModel::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    for (int row = first; row <= last; row++) {
+        removeEntry(m_source->index(row, 0).data(todoManager::IdRole).toInt());
+    }
+}
+
+void TodoSortFilterModel::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        updateEntry(makeEntry(m_source->index(row, 0)), roles);
+    }
+}
+
+void TodoSortFilterModel::onModelAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void TodoSortFilterModel::onModelReset()
+{
+    const int before = m_visible.size();
+    load();
+    endResetModel();
+    if (m_visible.size() != before) {
+        emit countChanged();
+    }
+}
+
+TodoSortFilterModel::Entry TodoSortFilterModel::makeEntry(const QModelIndex &index) const
+{
+    Entry entry;
+    entry.id = index.data(todoManager::IdRole).toInt();
+    entry.missing = false;
+    entry.primary = 0;
+    entry.completed = index.data(todoManager::CompletedRole).toBool();
+    entry.priority = index.data(todoManager::PriorityRole).toInt();
+    const QDateTime due = index.data(todoManager::DueDateRole).toDateTime();
+    entry.dated = due.isValid();
+    entry.due = entry.dated ? due.toMSecsSinceEpoch() : 0;
+
+    switch (m_sortMode) {
+    case Newest:
+        // Ids grow with insertion, so the newest todo has the largest.
+        entry.primary = -qint64(entry.id);
+        break;
+    case Priority:
+        entry.primary = -qint64(entry.priority);
+        break;
+    case DueDate:
+        entry.missing = !entry.dated;
+        entry.primary = entry.due;
+        break;
+    case Title:
+        entry.title = index.data(todoManager::TitleRole).toString().toCaseFolded();
+        break;
+    case Manual:
+        entry.title = index.data(todoManager::SortKeyRole).toString();
+        break;
+    }
+    return entry;
+}
+
+bool TodoSortFilterModel::lessThan(const Entry &a, const Entry &b) const
+{
+    if (a.missing != b.missing) {
+        return b.missing;
+    }
+    if (a.primary != b.primary) {
+        return m_reversed ? a.primary > b.primary : a.primary < b.primary;
+    }
+    const int byTitle = a.title.compare(b.title);
+    if (byTitle != 0) {
+        return m_reversed ? byTitle > 0 : byTitle < 0;
+    }
+    // Ties keep the source's newest-first order whichever way we sort.
+    return a.id > b.id;
+}
+
+bool TodoSortFilterModel::accepts(const Entry &entry) const
+{
+    return accepts(entry, m_dueFromMs, m_dueBeforeMs);
+}
+
+bool TodoSortFilterModel::accepts(const Entry &entry, qint64 dueFrom, qint64 dueBefore) const
+{
+    if (m_hideCompleted && entry.completed) {
+        return false;
+    }
+    if (m_priorityFilter >= 0 && entry.priority != m_priorityFilter) {
+        return false;
+    }
+    if (!m_tagSelection.contains(quint64(entry.id))) {
+        return false;
+    }
+    if (dueFrom == kOpenFrom && dueBefore == kOpenBefore) {
+        return true;
+    }
+    return entry.dated && entry.due >= dueFrom && entry.due < dueBefore;
+}
+
+int TodoSortFilterModel::lowerBound(const QVector<Entry> &entries, const Entry &entry) const
+{
+    const auto it = std::lower_bound(entries.cbegin(), entries.cend(), entry,
+                                     [this](const Entry &a, const Entry &b) { return lessThan(a, b); });
+    return int(it - entries.cbegin());
+}
+
+void TodoSortFilterModel::load()
+{
+    m_all.clear();
+    m_entries.clear();
+    m_sources.clear();
+
+    if (m_source) {
+        const int rows = m_source->rowCount();
+        m_all.reserve(rows);
+        for (int row = 0; row < rows; row++) {
+            const QModelIndex index = m_source->index(row, 0);
+            const Entry entry = makeEntry(index);
+            m_all.append(entry);
+            m_entries.insert(entry.id, entry);
+            m_sources.insert(entry.id, QPersistentModelIndex(index));
+        }
+    }
+    resort();
+}
+
+void TodoSortFilterModel::resort()
+{
+    std::sort(m_all.begin(), m_all.end(),
+              [this](const Entry &a, const Entry &b) { return lessThan(a, b); });
+    refilter();
+}
+
+void TodoSortFilterModel::refilter()
+{
+    m_visible.clear();
+    for (const Entry &entry : std::as_const(m_all)) {
+        if (accepts(entry)) {
+            m_visible.append(entry);
+        }
+    }
+}
+
+void TodoSortFilterModel::insertEntry(const Entry &entry)
+{
+    m_entries.insert(entry.id, entry);
+    m_all.insert(lowerBound(m_all, entry), entry);
+
+    if (accepts(entry)) {
+        const int row = lowerBound(m_visible, entry);
+        beginInsertRows(QModelIndex(), row, row);
+        m_visible.insert(row, entry);
+        endInsertRows();
+        emit countChanged();
+    }
+}
+
+void TodoSortFilterModel::removeEntry(int id)
+{
+    const auto it = m_entries.constFind(id);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+    const Entry entry = it.value();
+    m_entries.erase(it);
+    m_sources.remove(id);
+    m_all.remove(lowerBound(m_all, entry));
+
+    if (accepts(entry)) {
+        const int row = lowerBound(m_visible, entry);
+        beginRemoveRows(QModelIndex(), row, row);
+        m_visible.remove(row);
+        endRemoveRows();
+        emit countChanged();
+    }
+}
+
+void TodoSortFilterModel::updateEntry(const Entry &entry, const QList<int> &roles)
+{
+    const auto it = m_entries.find(entry.id);
+    if (it == m_entries.end()) {
+        return;
+    }
+    const Entry old = it.value();
+    it.value() = entry;
+
+    const int allFrom = lowerBound(m_all, old);
+    m_all.remove(allFrom);
+    m_all.insert(lowerBound(m_all, entry), entry);
+
+    const bool was = accepts(old);
+    const bool is = accepts(entry);
+
+    if (was && is) {
+        const int from = lowerBound(m_visible, old);
+        // Position with the old entry still in place, then as if it were gone.
+        const int before = lowerBound(m_visible, entry);
+        const int to = before > from ? before - 1 : before;
+        if (to != from) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), before > from ? before : to);
+            m_visible.remove(from);
+            m_visible.insert(to, entry);
+            endMoveRows();
+        } else {
+            m_visible[from] = entry;
+        }
+        const QModelIndex changed = index(to, 0);
+        emit dataChanged(changed, changed, roles);
+    } else if (was) {
+        const int row = lowerBound(m_visible, old);
+        beginRemoveRows(QModelIndex(), row, row);
+        m_visible.remove(row);
+        endRemoveRows();
+        emit countChanged();
+    } else if (is) {
+        const int row = lowerBound(m_visible, entry);
+        beginInsertRows(QModelIndex(), row, row);
+        m_visible.insert(row, entry);
+        endInsertRows();
+        emit countChanged();
+    }
+}
+
+void TodoSortFilterModel::refreshSpan(int first, int last, qint64 oldFrom, qint64 oldBefore)
+{
+    for (int i = first; i < last; i++) {
+        const Entry &entry = m_all.at(i);
+        const bool was = accepts(entry, oldFrom, oldBefore);
+        const bool is = accepts(entry);
+        if (was == is) {
+            continue;
+        }
+        const int row = lowerBound(m_visible, entry);
+        if (is) {
+            beginInsertRows(QModelIndex(), row, row);
+            m_visible.insert(row, entry);
+            endInsertRows();
+        } else {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_visible.remove(row);
+            endRemoveRows();
+        }
+    }
+}
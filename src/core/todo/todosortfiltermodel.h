@@ -0,0 +1,137 @@
+#ifndef TODOSORTFILTERMODEL_H
+#define TODOSORTFILTERMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QVector>
+
+#include "../tags/tagindex.h"
+
+// Sorted, filtered view of a todoManager. Sort keys and filter fields are
+// computed once per todo and kept in an array ordered by the current sort,
+// so an edited todo is found and re-placed by binary search (O(log n)
+// comparisons) and moved with a single row move, rather than re-sorting the
+// whole list the way QSortFilterProxyModel does on dataChanged. Moving the
+// entry within the QVector still shifts the elements in between, which is
+// O(n) but a plain memmove of small structs. Changing a filter is one pass
+// over that array; only changing the sort itself re-sorts. When sorted by
+// due date, moving the due-date window only visits the todos between the
+// old and new bounds.
+class TodoSortFilterModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QAbstractItemModel *sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(SortMode sortMode READ sortMode WRITE setSortMode NOTIFY sortModeChanged)
+    Q_PROPERTY(bool reversed READ reversed WRITE setReversed NOTIFY reversedChanged)
+    Q_PROPERTY(bool hideCompleted READ hideCompleted WRITE setHideCompleted NOTIFY hideCompletedChanged)
+    Q_PROPERTY(int priorityFilter READ priorityFilter WRITE setPriorityFilter NOTIFY priorityFilterChanged)
+    Q_PROPERTY(QDateTime dueFrom READ dueFrom WRITE setDueFrom NOTIFY dueRangeChanged)
+    Q_PROPERTY(QDateTime dueBefore READ dueBefore WRITE setDueBefore NOTIFY dueRangeChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum SortMode {
+        Newest,     // most recently added first
+        Priority,   // high priority first
+        DueDate,    // soonest first, undated last
+        Title,      // A to Z
+        Manual      // the user's drag-and-drop order (sort_key)
+    };
+    Q_ENUM(SortMode)
+
+    explicit TodoSortFilterModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QAbstractItemModel *sourceModel() const;
+    void setSourceModel(QAbstractItemModel *model);
+    SortMode sortMode() const;
+    void setSortMode(SortMode mode);
+    // Flips the sort direction; undated todos stay last either way.
+    bool reversed() const;
+    void setReversed(bool reversed);
+    bool hideCompleted() const;
+    void setHideCompleted(bool hide);
+    // A TodoItem::Priority value, or -1 for all priorities.
+    int priorityFilter() const;
+    void setPriorityFilter(int priority);
+    // Only todos due in [dueFrom, dueBefore); an invalid bound is open.
+    // Undated todos are hidden while either bound is set.
+    QDateTime dueFrom() const;
+    void setDueFrom(const QDateTime &from);
+    QDateTime dueBefore() const;
+    void setDueBefore(const QDateTime &before);
+    void setDueRange(const QDateTime &from, const QDateTime &before);
+    // Only todos in selection, e.g. from TagManager::filterTodos; the
+    // default selection keeps every todo.
+    void setTagSelection(const TagIndex::Selection &selection);
+
+    // Row in the source model, for calls like todoManager::removeTodo,
+    // and back; -1 when the todo is filtered out.
+    Q_INVOKABLE int mapToSource(int row) const;
+    Q_INVOKABLE int mapFromSource(int sourceRow) const;
+
+signals:
+    void sourceModelChanged();
+    void sortModeChanged();
+    void reversedChanged();
+    void hideCompletedChanged();
+    void priorityFilterChanged();
+    void dueRangeChanged();
+    void countChanged();
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onModelAboutToBeReset();
+    void onModelReset();
+
+private:
+    struct Entry {
+        int id;
+        bool missing;      // no sort key (undated); always sorts last
+        qint64 primary;
+        QString title;     // case-folded title, or the sort key in Manual mode
+        bool completed;
+        int priority;
+        bool dated;
+        qint64 due;
+    };
+
+    Entry makeEntry(const QModelIndex &index) const;
+    bool lessThan(const Entry &a, const Entry &b) const;
+    bool accepts(const Entry &entry) const;
+    bool accepts(const Entry &entry, qint64 dueFrom, qint64 dueBefore) const;
+    int lowerBound(const QVector<Entry> &entries, const Entry &entry) const;
+
+    void load();
+    void resort();
+    void refilter();
+    void insertEntry(const Entry &entry);
+    void removeEntry(int id);
+    void updateEntry(const Entry &entry, const QList<int> &roles);
+    void refreshSpan(int first, int last, qint64 oldFrom, qint64 oldBefore);
+
+    QAbstractItemModel *m_source;
+    SortMode m_sortMode;
+    bool m_reversed;
+    bool m_hideCompleted;
+    int m_priorityFilter;
+    QDateTime m_dueFrom;
+    QDateTime m_dueBefore;
+    qint64 m_dueFromMs;
+    qint64 m_dueBeforeMs;
+    TagIndex::Selection m_tagSelection;
+
+    QVector<Entry> m_all;      // every todo, in sort order
+    QVector<Entry> m_visible;  // the accepted subsequence; one per row
+    QHash<int, Entry> m_entries;
+    QHash<int, QPersistentModelIndex> m_sources;
+};
+
+#endif // TODOSORTFILTERMODEL_H
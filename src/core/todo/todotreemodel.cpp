@@ -0,0 +1,636 @@
+#include "todotreemodel.h"
+#include "todomanager.h"
+#include "sortkey.h"
+#include "../database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+TodoTreeModel::TodoTreeModel(todoManager *todos, QObject *parent)
+    : QAbstractItemModel(parent),
+    m_todos(todos),
+    m_root(new Node),
+    m_detachId(0),
+    m_detached(nullptr)
+{
+    m_root->fetched = true;
+
+    connect(m_todos, &QAbstractItemModel::rowsInserted, this, &TodoTreeModel::onTodosInserted);
+    connect(m_todos, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TodoTreeModel::onTodosAboutToBeRemoved);
+    connect(m_todos, &QAbstractItemModel::rowsMoved, this, &TodoTreeModel::onTodosMoved);
+    connect(m_todos, &QAbstractItemModel::dataChanged, this, &TodoTreeModel::onTodosChanged);
+    connect(m_todos, &QAbstractItemModel::modelReset, this, &TodoTreeModel::reload);
+    connect(m_todos, &QAbstractItemModel::layoutChanged, this, &TodoTreeModel::reload);
+
+    reload();
+}
+
+TodoTreeModel::~TodoTreeModel()
+{
+    delete m_detached;
+    delete m_root;
+}
+
+QModelIndex TodoTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Node *node = nodeFor(parent);
+    if (column != 0 || row < 0 || row >= node->children.size())
+        return QModelIndex();
+    return createIndex(row, 0, node->children.at(row));
+}
+
+QModelIndex TodoTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+    return indexFor(nodeFor(child)->parent);
+}
+
+int TodoTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+    return nodeFor(parent)->children.size();
+}
+
+int TodoTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool TodoTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    Node *node = nodeFor(parent);
+    return node == m_root ? !node->children.isEmpty() : node->childCount > 0;
+}
+
+bool TodoTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    Node *node = nodeFor(parent);
+    return !node->fetched && node->childCount > 0;
+}
+
+void TodoTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    Node *node = nodeFor(parent);
+    const QVector<Node *> children = queryChildren(node);
+    node->fetched = true;
+    if (children.isEmpty())
+        return;
+
+    beginInsertRows(parent, 0, children.size() - 1);
+    node->children = children;
+    for (Node *child : children) {
+        m_nodes.insert(child->id, child);
+    }
+    endInsertRows();
+}
+
+QVariant TodoTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    Node *node = nodeFor(index);
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TitleRole:
+        return node->title;
+    case CompletedRole:
+        return node->completed;
+    case PriorityRole:
+        return node->priority;
+    case DueDateRole:
+        return node->dueDate;
+    case IdRole:
+        return node->id;
+    case ParentIdRole:
+        return node->parent == m_root ? 0 : node->parent->id;
+    case SubtaskCountRole:
+        return node->subtreeTotal;
+    case CompletedSubtaskCountRole:
+        return node->subtreeDone;
+    case ProgressRole:
+        if (node->subtreeTotal == 0)
+            return node->completed ? 1.0 : 0.0;
+        return double(node->subtreeDone) / node->subtreeTotal;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TodoTreeModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[TitleRole] = "title";
+    roles[CompletedRole] = "completed";
+    roles[PriorityRole] = "priority";
+    roles[DueDateRole] = "dueDate";
+    roles[IdRole] = "todoId";
+    roles[ParentIdRole] = "parentId";
+    roles[SubtaskCountRole] = "subtaskCount";
+    roles[CompletedSubtaskCountRole] = "completedSubtaskCount";
+    roles[ProgressRole] = "progress";
+    return roles;
+}
+
+QModelIndex TodoTreeModel::indexForId(int id) const
+{
+    Node *node = m_nodes.value(id);
+    return node ? indexFor(node) : QModelIndex();
+}
+
+int TodoTreeModel::parentIdOf(int id) const
+{
+    Node *node = m_nodes.value(id);
+    if (!node)
+        return -1;
+    return node->parent == m_root ? 0 : node->parent->id;
+}
+
+int TodoTreeModel::addSubtask(int parentId, const QString &title)
+{
+    Node *parent = m_nodes.value(parentId);
+    if (!parent || title.trimmed().isEmpty())
+        return -1;
+
+    const QString sortKey = SortKey::between(lastChildKey(parent), QString());
+
+    // Subtasks stay in their parent's list
+    QSqlQuery query;
+    query.prepare("INSERT INTO todos (title, parent_id, sort_key, list_id) "
+                  "VALUES (:title, :parent_id, :sort_key, (SELECT list_id FROM todos WHERE id = :list_parent))");
+    query.bindValue(":title", title);
+    query.bindValue(":parent_id", parentId);
+    query.bindValue(":sort_key", sortKey);
+    query.bindValue(":list_parent", parentId);
+
+    if (!query.exec()) {
+        qDebug() << "Error adding subtask:" << query.lastError().text();
+        return -1;
+    }
+
+    const int id = query.lastInsertId().toInt();
+
+    // A childless node has nothing left to fetch; otherwise an unexpanded
+    // parent picks the subtask up when it is fetched
+    if (parent->childCount == 0) {
+        parent->fetched = true;
+    }
+    parent->childCount++;
+
+    if (parent->fetched) {
+        const int row = parent->children.size();
+        beginInsertRows(indexFor(parent), row, row);
+        Node *node = new Node;
+        node->id = id;
+        node->title = title;
+        node->sortKey = sortKey;
+        node->fetched = true;
+        node->parent = parent;
+        parent->children.append(node);
+        m_nodes.insert(id, node);
+        endInsertRows();
+    }
+
+    adjustAncestors(parent, 1, 0);
+    return id;
+}
+
+bool TodoTreeModel::setCompleted(int id, bool completed)
+{
+    Node *node = m_nodes.value(id);
+    if (!node)
+        return false;
+
+    // Top-level completions go through todoManager so they are counted in
+    // the daily stats; the change comes back through dataChanged.
+    if (node->parent == m_root) {
+        const int row = m_todos->rowForId(id);
+        if (row < 0)
+            return false;
+        m_todos->markAsCompleted(row, completed);
+        return true;
+    }
+
+    if (node->completed == completed)
+        return true;
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET completed = :completed WHERE id = :id");
+    query.bindValue(":completed", completed);
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        qDebug() << "Error updating subtask:" << query.lastError().text();
+        return false;
+    }
+
+    node->completed = completed;
+    const QModelIndex changed = indexFor(node);
+    emit dataChanged(changed, changed, QVector<int>() << CompletedRole << ProgressRole);
+    adjustAncestors(node->parent, 0, completed ? 1 : -1);
+    return true;
+}
+
+bool TodoTreeModel::removeTodo(int id)
+{
+    Node *node = m_nodes.value(id);
+    if (!node)
+        return false;
+
+    if (node->parent == m_root) {
+        const int row = m_todos->rowForId(id);
+        if (row < 0)
+            return false;
+        m_todos->removeTodo(row);
+        return true;
+    }
+
+    QSqlQuery query;
+    query.prepare("WITH RECURSIVE subtree(id) AS ("
+                  "SELECT :id UNION ALL "
+                  "SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                  "DELETE FROM todos WHERE id IN (SELECT id FROM subtree)");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        qDebug() << "Error removing subtask:" << query.lastError().text();
+        return false;
+    }
+
+    Node *parent = node->parent;
+    const int row = parent->children.indexOf(node);
+    beginRemoveRows(indexFor(parent), row, row);
+    parent->children.removeAt(row);
+    forget(node);
+    endRemoveRows();
+
+    parent->childCount--;
+    adjustAncestors(parent, -(1 + node->subtreeTotal), -((node->completed ? 1 : 0) + node->subtreeDone));
+    delete node;
+    return true;
+}
+
+bool TodoTreeModel::moveSubtree(int id, int newParentId)
+{
+    Node *node = m_nodes.value(id);
+    Node *target = newParentId == 0 ? m_root : m_nodes.value(newParentId);
+    if (!node || !target)
+        return false;
+
+    // Not under itself or one of its own subtasks
+    for (Node *n = target; n; n = n->parent) {
+        if (n == node)
+            return false;
+    }
+
+    Node *from = node->parent;
+    if (from == target)
+        return true;
+
+    const QString sortKey = SortKey::between(lastChildKey(target), QString());
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET parent_id = :parent_id, sort_key = :sort_key WHERE id = :id");
+    query.bindValue(":parent_id", target == m_root ? QVariant() : QVariant(newParentId));
+    query.bindValue(":sort_key", sortKey);
+    query.bindValue(":id", id);
+    bool ok = query.exec();
+
+    if (ok && target != m_root) {
+        // Subtasks live in their top-level todo's list, so the whole subtree follows the new parent
+        query.prepare("WITH RECURSIVE subtree(id) AS ("
+                      "SELECT :id UNION ALL SELECT t.id FROM todos t JOIN subtree s ON t.parent_id = s.id) "
+                      "UPDATE todos SET list_id = (SELECT list_id FROM todos WHERE id = :parent_id) "
+                      "WHERE id IN (SELECT id FROM subtree)");
+        query.bindValue(":id", id);
+        query.bindValue(":parent_id", newParentId);
+        ok = query.exec();
+    }
+
+    if (!ok || !db.commit()) {
+        qDebug() << "Error moving subtask:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    if (target->childCount == 0) {
+        target->fetched = true;
+    }
+
+    const int total = 1 + node->subtreeTotal;
+    const int done = (node->completed ? 1 : 0) + node->subtreeDone;
+    node->sortKey = sortKey;
+
+    if (from == m_root) {
+        // todoManager drops the row; its removal hands us the subtree back
+        m_detachId = id;
+        m_todos->applyExternalChanges(QVector<int>() << id);
+        m_detachId = 0;
+        node = m_detached;
+        m_detached = nullptr;
+    } else if (target == m_root || !target->fetched) {
+        const int row = from->children.indexOf(node);
+        beginRemoveRows(indexFor(from), row, row);
+        from->children.removeAt(row);
+        endRemoveRows();
+    } else {
+        const int row = from->children.indexOf(node);
+        beginMoveRows(indexFor(from), row, row, indexFor(target), target->children.size());
+        from->children.removeAt(row);
+        target->children.append(node);
+        node->parent = target;
+        endMoveRows();
+        const QModelIndex moved = indexFor(node);
+        emit dataChanged(moved, moved, QVector<int>() << ParentIdRole);
+        node = nullptr;
+    }
+
+    if (node && target == m_root) {
+        // ...and todoManager inserting it as a top-level row re-attaches it
+        m_detached = node;
+        m_todos->applyExternalChanges(QVector<int>() << id);
+        if (m_detached) {
+            forget(m_detached);
+            delete m_detached;
+            m_detached = nullptr;
+        }
+    } else if (node && target->fetched) {
+        const int row = target->children.size();
+        beginInsertRows(indexFor(target), row, row);
+        target->children.append(node);
+        node->parent = target;
+        endInsertRows();
+    } else if (node) {
+        forget(node);
+        delete node;
+    }
+
+    from->childCount--;
+    target->childCount++;
+    adjustAncestors(from, -total, -done);
+    adjustAncestors(target, total, done);
+    return true;
+}
+
+void TodoTreeModel::reload()
+{
+    beginResetModel();
+
+    delete m_detached;
+    m_detached = nullptr;
+    qDeleteAll(m_root->children);
+    m_root->children.clear();
+    m_nodes.clear();
+
+    const QHash<int, Counts> counts = queryCounts("t.parent_id IS NULL");
+    for (int row = 0; row < m_todos->rowCount(); row++) {
+        Node *node = new Node;
+        node->parent = m_root;
+        readTopLevel(node, row);
+        const Counts c = counts.value(node->id);
+        node->childCount = c.children;
+        node->subtreeTotal = c.total;
+        node->subtreeDone = c.done;
+        m_root->children.append(node);
+        m_nodes.insert(node->id, node);
+    }
+
+    endResetModel();
+}
+
+QHash<int, TodoTreeModel::Counts> TodoTreeModel::queryCounts(const QString &condition, const QVariant &value) const
+{
+    // Walk each matching todo's subtree down the parent_id index
+    QSqlQuery query;
+    query.prepare(QString("WITH RECURSIVE sub(root, id, parent, completed) AS ("
+                          "SELECT t.id, t.id, t.parent_id, t.completed FROM todos t WHERE %1 "
+                          "UNION ALL "
+                          "SELECT sub.root, c.id, c.parent_id, c.completed "
+                          "FROM todos c JOIN sub ON c.parent_id = sub.id) "
+                          "SELECT root, SUM(parent IS root), SUM(id <> root), "
+                          "SUM(id <> root AND completed) "
+                          "FROM sub GROUP BY root").arg(condition));
+    if (value.isValid()) {
+        query.bindValue(":value", value);
+    }
+
+    QHash<int, Counts> counts;
+    if (!query.exec()) {
+        qDebug() << "Error counting subtasks:" << query.lastError().text();
+        return counts;
+    }
+
+    while (query.next()) {
+        Counts &c = counts[query.value(0).toInt()];
+        c.children = query.value(1).toInt();
+        c.total = query.value(2).toInt();
+        c.done = query.value(3).toInt();
+    }
+    return counts;
+}
+
+QVector<TodoTreeModel::Node *> TodoTreeModel::queryChildren(Node *parent) const
+{
+    QVector<Node *> children;
+
+    QSqlQuery query;
+    query.prepare("SELECT id, title, completed, priority, due_date, sort_key "
+                  "FROM todos WHERE parent_id = :parent "
+                  "ORDER BY sort_key IS NULL, sort_key, id");
+    query.bindValue(":parent", parent->id);
+
+    if (!query.exec()) {
+        qDebug() << "Error loading subtasks:" << query.lastError().text();
+        return children;
+    }
+
+    while (query.next()) {
+        Node *node = new Node;
+        node->id = query.value(0).toInt();
+        node->title = query.value(1).toString();
+        node->completed = query.value(2).toBool();
+        node->priority = query.value(3).toInt();
+        node->dueDate = query.value(4).toDateTime();
+        node->sortKey = query.value(5).toString();
+        node->parent = parent;
+        children.append(node);
+    }
+
+    if (!children.isEmpty()) {
+        const QHash<int, Counts> counts = queryCounts("t.parent_id = :value", parent->id);
+        for (Node *node : std::as_const(children)) {
+            const Counts c = counts.value(node->id);
+            node->childCount = c.children;
+            node->subtreeTotal = c.total;
+            node->subtreeDone = c.done;
+        }
+    }
+    return children;
+}
+
+QVector<int> TodoTreeModel::readTopLevel(Node *node, int row) const
+{
+    const QModelIndex source = m_todos->index(row, 0);
+    const QString title = source.data(todoManager::TitleRole).toString();
+    const bool completed = source.data(todoManager::CompletedRole).toBool();
+    const int priority = source.data(todoManager::PriorityRole).toInt();
+    const QDateTime dueDate = source.data(todoManager::DueDateRole).toDateTime();
+
+    QVector<int> roles;
+    node->id = source.data(todoManager::IdRole).toInt();
+    node->sortKey = source.data(todoManager::SortKeyRole).toString();
+    if (node->title != title) {
+        node->title = title;
+        roles << TitleRole;
+    }
+    if (node->completed != completed) {
+        node->completed = completed;
+        roles << CompletedRole << ProgressRole;
+    }
+    if (node->priority != priority) {
+        node->priority = priority;
+        roles << PriorityRole;
+    }
+    if (node->dueDate != dueDate) {
+        node->dueDate = dueDate;
+        roles << DueDateRole;
+    }
+    return roles;
+}
+
+TodoTreeModel::Node *TodoTreeModel::nodeFor(const QModelIndex &index) const
+{
+    return index.isValid() ? static_cast<Node *>(index.internalPointer()) : m_root;
+}
+
+QModelIndex TodoTreeModel::indexFor(Node *node) const
+{
+    if (!node || node == m_root || !node->parent)
+        return QModelIndex();
+    return createIndex(node->parent->children.indexOf(node), 0, node);
+}
+
+void TodoTreeModel::forget(Node *node)
+{
+    m_nodes.remove(node->id);
+    for (Node *child : std::as_const(node->children)) {
+        forget(child);
+    }
+}
+
+void TodoTreeModel::adjustAncestors(Node *from, int total, int done)
+{
+    if (total == 0 && done == 0)
+        return;
+
+    const QVector<int> roles = QVector<int>() << SubtaskCountRole << CompletedSubtaskCountRole << ProgressRole;
+    for (Node *node = from; node && node != m_root; node = node->parent) {
+        node->subtreeTotal += total;
+        node->subtreeDone += done;
+        const QModelIndex changed = indexFor(node);
+        emit dataChanged(changed, changed, roles);
+    }
+}
+
+QString TodoTreeModel::lastChildKey(Node *parent) const
+{
+    if (parent->fetched)
+        return parent->children.isEmpty() ? QString() : parent->children.last()->sortKey;
+
+    QSqlQuery query;
+    query.prepare("SELECT MAX(sort_key) FROM todos WHERE parent_id = :parent");
+    query.bindValue(":parent", parent->id);
+    if (!query.exec() || !query.next()) {
+        qDebug() << "Error reading subtask order:" << query.lastError().text();
+        return QString();
+    }
+    return query.value(0).toString();
+}
+
+void TodoTreeModel::onTodosInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    beginInsertRows(QModelIndex(), first, last);
+    for (int row = first; row <= last; row++) {
+        const int id = m_todos->index(row, 0).data(todoManager::IdRole).toInt();
+        Node *node = nullptr;
+        if (m_detached && m_detached->id == id) {
+            node = m_detached;
+            m_detached = nullptr;
+        } else {
+            // New, or a subtask made top-level elsewhere: it may bring children
+            node = new Node;
+            const Counts c = queryCounts("t.id = :value", id).value(id);
+            node->childCount = c.children;
+            node->subtreeTotal = c.total;
+            node->subtreeDone = c.done;
+        }
+        node->parent = m_root;
+        readTopLevel(node, row);
+        m_root->children.insert(row, node);
+        m_nodes.insert(node->id, node);
+    }
+    endInsertRows();
+}
+
+void TodoTreeModel::onTodosAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    beginRemoveRows(QModelIndex(), first, last);
+    for (int row = last; row >= first; row--) {
+        Node *node = m_root->children.takeAt(row);
+        if (node->id == m_detachId) {
+            node->parent = nullptr;
+            m_detached = node;
+        } else {
+            forget(node);
+            delete node;
+        }
+    }
+    endRemoveRows();
+}
+
+void TodoTreeModel::onTodosMoved(const QModelIndex &parent, int start, int end,
+                                 const QModelIndex &destination, int row)
+{
+    if (parent.isValid() || destination.isValid())
+        return;
+
+    beginMoveRows(QModelIndex(), start, end, QModelIndex(), row);
+    const QVector<Node *> moving = m_root->children.mid(start, end - start + 1);
+    m_root->children.remove(start, moving.size());
+    const int at = row > start ? row - moving.size() : row;
+    for (int i = 0; i < moving.size(); i++) {
+        m_root->children.insert(at + i, moving.at(i));
+    }
+    endMoveRows();
+}
+
+void TodoTreeModel::onTodosChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        Node *node = m_root->children.value(row);
+        if (!node)
+            continue;
+        const QVector<int> roles = readTopLevel(node, row);
+        if (!roles.isEmpty()) {
+            const QModelIndex changed = index(row, 0);
+            emit dataChanged(changed, changed, roles);
+        }
+    }
+}
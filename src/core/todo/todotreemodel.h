@@ -0,0 +1,112 @@
+#ifndef TODOTREEMODEL_H
+#define TODOTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QDateTime>
+#include <QHash>
+#include <QVector>
+
+class todoManager;
+
+// Todos with their subtasks, for breaking large assignments down. The top
+// level follows todoManager row for row; below that, a node's children are
+// read from the database (one indexed query on parent_id) only when it is
+// expanded. Every loaded node keeps the total and completed counts of its
+// whole subtree, so a completion, add, remove or move updates the counts
+// along one path to the root instead of recounting.
+class TodoTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum TreeRoles {
+        TitleRole = Qt::UserRole + 1,
+        CompletedRole,
+        PriorityRole,
+        DueDateRole,
+        IdRole,
+        ParentIdRole,
+        SubtaskCountRole,
+        CompletedSubtaskCountRole,
+        ProgressRole
+    };
+
+    explicit TodoTreeModel(todoManager *todos, QObject *parent = nullptr);
+    ~TodoTreeModel() override;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Index of a loaded todo, or an invalid index.
+    Q_INVOKABLE QModelIndex indexForId(int id) const;
+    // Parent of a loaded todo; 0 for top-level todos, -1 if not loaded.
+    Q_INVOKABLE int parentIdOf(int id) const;
+
+    // Returns the new subtask's id, or -1.
+    Q_INVOKABLE int addSubtask(int parentId, const QString &title);
+    Q_INVOKABLE bool setCompleted(int id, bool completed);
+    // Deletes the todo and everything under it.
+    Q_INVOKABLE bool removeTodo(int id);
+    // Moves the todo and its subtree to the end of newParentId's children
+    // (0 for the top level). One UPDATE: descendants keep their parent_id.
+    Q_INVOKABLE bool moveSubtree(int id, int newParentId);
+
+public slots:
+    void reload();
+
+private:
+    struct Node {
+        ~Node() { qDeleteAll(children); }
+
+        int id = 0;
+        QString title;
+        bool completed = false;
+        int priority = 1;
+        QDateTime dueDate;
+        QString sortKey;
+        int childCount = 0;         // direct children in the database
+        int subtreeTotal = 0;       // all descendants
+        int subtreeDone = 0;        // completed descendants
+        bool fetched = false;
+        Node *parent = nullptr;
+        QVector<Node *> children;
+    };
+
+    // Direct children and subtree sizes, keyed by todo id.
+    struct Counts {
+        int children = 0;
+        int total = 0;
+        int done = 0;
+    };
+
+    QHash<int, Counts> queryCounts(const QString &condition, const QVariant &value = QVariant()) const;
+    QVector<Node *> queryChildren(Node *parent) const;
+    QVector<int> readTopLevel(Node *node, int row) const;
+    Node *nodeFor(const QModelIndex &index) const;
+    QModelIndex indexFor(Node *node) const;
+    void forget(Node *node);
+    void adjustAncestors(Node *from, int total, int done);
+    QString lastChildKey(Node *parent) const;
+
+    void onTodosInserted(const QModelIndex &parent, int first, int last);
+    void onTodosAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onTodosMoved(const QModelIndex &parent, int start, int end,
+                      const QModelIndex &destination, int row);
+    void onTodosChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    todoManager *m_todos;
+    Node *m_root;
+    QHash<int, Node *> m_nodes;
+    // A subtree on its way between the top level and a parent todo
+    int m_detachId;
+    Node *m_detached;
+};
+
+#endif // TODOTREEMODEL_H
@@ -0,0 +1,325 @@
+#include "heatmapcalendar.h"
+#include "../../core/clock/clock.h"
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <algorithm>
+
+namespace {
+
+void setCellColor(QSGGeometry::ColoredPoint2D *cell, const QColor &color)
+{
+    // QSGVertexColorMaterial expects premultiplied colours.
+    const float alpha = color.alphaF();
+    const uchar r = uchar(color.red() * alpha);
+    const uchar g = uchar(color.green() * alpha);
+    const uchar b = uchar(color.blue() * alpha);
+    const uchar a = uchar(color.alpha());
+
+    for (int v = 0; v < 6; ++v) {
+        cell[v].r = r;
+        cell[v].g = g;
+        cell[v].b = b;
+        cell[v].a = a;
+    }
+}
+
+} // namespace
+
+HeatmapCalendar::HeatmapCalendar(QQuickItem *parent)
+    : QQuickItem(parent),
+    m_endDate(Clock::instance()->today()),
+    m_weeks(53),
+    m_maxValue(1.0),
+    m_cellSpacing(2.0),
+    m_emptyColor("#ebedf0"),
+    m_fullColor("#27ae60"),
+    m_fullRebuild(true)
+{
+    setFlag(ItemHasContents, true);
+    m_values.resize(cellCount());
+}
+
+QDate HeatmapCalendar::endDate() const
+{
+    return m_endDate;
+}
+
+void HeatmapCalendar::setEndDate(const QDate &date)
+{
+    if (!date.isValid() || m_endDate == date) {
+        return;
+    }
+
+    const QDate oldStart = startDate();
+    m_endDate = date;
+    remapValues(oldStart);
+
+    scheduleFullRebuild();
+    emit endDateChanged();
+    emit layoutChanged();
+    emit valuesChanged();
+}
+
+int HeatmapCalendar::weeks() const
+{
+    return m_weeks;
+}
+
+void HeatmapCalendar::setWeeks(int weeks)
+{
+    weeks = std::max(1, weeks);
+    if (m_weeks == weeks) {
+        return;
+    }
+
+    const QDate oldStart = startDate();
+    m_weeks = weeks;
+    remapValues(oldStart);
+    scheduleFullRebuild();
+    emit weeksChanged();
+    emit layoutChanged();
+}
+
+QDate HeatmapCalendar::startDate() const
+{
+    return m_endDate.addDays(-7 * (m_weeks - 1) - (m_endDate.dayOfWeek() - 1));
+}
+
+int HeatmapCalendar::cellCount() const
+{
+    return 7 * (m_weeks - 1) + m_endDate.dayOfWeek();
+}
+
+QVariantList HeatmapCalendar::values() const
+{
+    QVariantList list;
+    list.reserve(m_values.size());
+    for (qreal value : m_values) {
+        list.append(value);
+    }
+    return list;
+}
+
+void HeatmapCalendar::setValues(const QVariantList &values)
+{
+    const int count = std::min<int>(values.size(), m_values.size());
+    for (int i = 0; i < m_values.size(); ++i) {
+        m_values[i] = i < count ? values.at(i).toReal() : 0.0;
+    }
+
+    scheduleFullRebuild();
+    emit valuesChanged();
+}
+
+qreal HeatmapCalendar::maxValue() const
+{
+    return m_maxValue;
+}
+
+void HeatmapCalendar::setMaxValue(qreal maxValue)
+{
+    if (maxValue <= 0.0 || qFuzzyCompare(m_maxValue, maxValue)) {
+        return;
+    }
+
+    m_maxValue = maxValue;
+    scheduleFullRebuild();
+    emit maxValueChanged();
+}
+
+qreal HeatmapCalendar::cellSpacing() const
+{
+    return m_cellSpacing;
+}
+
+void HeatmapCalendar::setCellSpacing(qreal spacing)
+{
+    if (qFuzzyCompare(m_cellSpacing, spacing)) {
+        return;
+    }
+
+    m_cellSpacing = std::max<qreal>(0.0, spacing);
+    scheduleFullRebuild();
+    emit cellSpacingChanged();
+}
+
+QColor HeatmapCalendar::emptyColor() const
+{
+    return m_emptyColor;
+}
+
+void HeatmapCalendar::setEmptyColor(const QColor &color)
+{
+    if (m_emptyColor == color) {
+        return;
+    }
+
+    m_emptyColor = color;
+    scheduleFullRebuild();
+    emit colorsChanged();
+}
+
+QColor HeatmapCalendar::fullColor() const
+{
+    return m_fullColor;
+}
+
+void HeatmapCalendar::setFullColor(const QColor &color)
+{
+    if (m_fullColor == color) {
+        return;
+    }
+
+    m_fullColor = color;
+    scheduleFullRebuild();
+    emit colorsChanged();
+}
+
+void HeatmapCalendar::setDayValue(const QDate &date, qreal value)
+{
+    const int index = cellIndex(date);
+    if (index < 0 || qFuzzyCompare(m_values.at(index) + 1.0, value + 1.0)) {
+        return;
+    }
+
+    m_values[index] = value;
+
+    // Only the one cell is recoloured on the next sync.
+    if (!m_fullRebuild) {
+        m_dirtyCells.append(index);
+    }
+    update();
+    emit valuesChanged();
+}
+
+qreal HeatmapCalendar::dayValue(const QDate &date) const
+{
+    const int index = cellIndex(date);
+    return index < 0 ? 0.0 : m_values.at(index);
+}
+
+QSGNode *HeatmapCalendar::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+    const int cells = m_values.size();
+    const int vertexCount = cells * 6;
+
+    if (!node) {
+        node = new QSGGeometryNode;
+
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), vertexCount);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+
+        m_fullRebuild = true;
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    if (geometry->vertexCount() != vertexCount) {
+        geometry->allocate(vertexCount);
+        m_fullRebuild = true;
+    }
+
+    QSGGeometry::ColoredPoint2D *vertices = geometry->vertexDataAsColoredPoint2D();
+
+    if (m_fullRebuild) {
+        const qreal spacing = m_cellSpacing;
+        const qreal cellSize = std::max<qreal>(0.0, std::min(
+            (width() - (m_weeks - 1) * spacing) / m_weeks,
+            (height() - 6 * spacing) / 7));
+
+        for (int i = 0; i < cells; ++i) {
+            const float x = float((i / 7) * (cellSize + spacing));
+            const float y = float((i % 7) * (cellSize + spacing));
+            const float s = float(cellSize);
+
+            QSGGeometry::ColoredPoint2D *cell = vertices + i * 6;
+            cell[0].x = x;     cell[0].y = y;
+            cell[1].x = x + s; cell[1].y = y;
+            cell[2].x = x;     cell[2].y = y + s;
+            cell[3].x = x + s; cell[3].y = y;
+            cell[4].x = x + s; cell[4].y = y + s;
+            cell[5].x = x;     cell[5].y = y + s;
+
+            setCellColor(cell, colorFor(m_values.at(i)));
+        }
+    } else {
+        for (int i : std::as_const(m_dirtyCells)) {
+            if (i < cells) {
+                setCellColor(vertices + i * 6, colorFor(m_values.at(i)));
+            }
+        }
+    }
+
+    m_dirtyCells.clear();
+    m_fullRebuild = false;
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
+
+void HeatmapCalendar::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        scheduleFullRebuild();
+    }
+}
+
+int HeatmapCalendar::cellIndex(const QDate &date) const
+{
+    if (!date.isValid()) {
+        return -1;
+    }
+
+    const qint64 index = startDate().daysTo(date);
+    if (index < 0 || index >= m_values.size()) {
+        return -1;
+    }
+    return int(index);
+}
+
+QColor HeatmapCalendar::colorFor(qreal value) const
+{
+    if (value <= 0.0) {
+        return m_emptyColor;
+    }
+
+    // Never blend all the way back to the empty colour for a non-zero day.
+    const qreal t = 0.25 + 0.75 * std::clamp(value / m_maxValue, 0.0, 1.0);
+    return QColor::fromRgbF(
+        float(m_emptyColor.redF() + (m_fullColor.redF() - m_emptyColor.redF()) * t),
+        float(m_emptyColor.greenF() + (m_fullColor.greenF() - m_emptyColor.greenF()) * t),
+        float(m_emptyColor.blueF() + (m_fullColor.blueF() - m_emptyColor.blueF()) * t),
+        float(m_emptyColor.alphaF() + (m_fullColor.alphaF() - m_emptyColor.alphaF()) * t));
+}
+
+void HeatmapCalendar::remapValues(const QDate &oldStart)
+{
+    // Keep existing values attached to their dates when the window moves.
+    const QVector<qreal> oldValues = m_values;
+    m_values = QVector<qreal>(cellCount(), 0.0);
+
+    const QDate newStart = startDate();
+    for (int i = 0; i < m_values.size(); ++i) {
+        const qint64 oldIndex = oldStart.daysTo(newStart.addDays(i));
+        if (oldIndex >= 0 && oldIndex < oldValues.size()) {
+            m_values[i] = oldValues.at(int(oldIndex));
+        }
+    }
+}
+
+void HeatmapCalendar::scheduleFullRebuild()
+{
+    m_fullRebuild = true;
+    m_dirtyCells.clear();
+    update();
+}
@@ -0,0 +1,89 @@
+#ifndef HEATMAPCALENDAR_H
+#define HEATMAPCALENDAR_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QDate>
+#include <QVector>
+#include <QVariantList>
+
+// GitHub-style year heatmap drawn as a single vertex-coloured geometry node.
+// Cells are laid out one column per week (Monday at the top); values[i]
+// belongs to startDate + i days.
+class HeatmapCalendar : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QDate endDate READ endDate WRITE setEndDate NOTIFY endDateChanged)
+    Q_PROPERTY(int weeks READ weeks WRITE setWeeks NOTIFY weeksChanged)
+    Q_PROPERTY(QDate startDate READ startDate NOTIFY layoutChanged)
+    Q_PROPERTY(int cellCount READ cellCount NOTIFY layoutChanged)
+    Q_PROPERTY(QVariantList values READ values WRITE setValues NOTIFY valuesChanged)
+    Q_PROPERTY(qreal maxValue READ maxValue WRITE setMaxValue NOTIFY maxValueChanged)
+    Q_PROPERTY(qreal cellSpacing READ cellSpacing WRITE setCellSpacing NOTIFY cellSpacingChanged)
+    Q_PROPERTY(QColor emptyColor READ emptyColor WRITE setEmptyColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor fullColor READ fullColor WRITE setFullColor NOTIFY colorsChanged)
+
+public:
+    explicit HeatmapCalendar(QQuickItem *parent = nullptr);
+
+    QDate endDate() const;
+    void setEndDate(const QDate &date);
+
+    int weeks() const;
+    void setWeeks(int weeks);
+
+    QDate startDate() const;
+    int cellCount() const;
+
+    QVariantList values() const;
+    void setValues(const QVariantList &values);
+
+    qreal maxValue() const;
+    void setMaxValue(qreal maxValue);
+
+    qreal cellSpacing() const;
+    void setCellSpacing(qreal spacing);
+
+    QColor emptyColor() const;
+    void setEmptyColor(const QColor &color);
+
+    QColor fullColor() const;
+    void setFullColor(const QColor &color);
+
+    Q_INVOKABLE void setDayValue(const QDate &date, qreal value);
+    Q_INVOKABLE qreal dayValue(const QDate &date) const;
+
+signals:
+    void endDateChanged();
+    void weeksChanged();
+    void layoutChanged();
+    void valuesChanged();
+    void maxValueChanged();
+    void cellSpacingChanged();
+    void colorsChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    QDate m_endDate;
+    int m_weeks;
+    QVector<qreal> m_values;
+    qreal m_maxValue;
+    qreal m_cellSpacing;
+    QColor m_emptyColor;
+    QColor m_fullColor;
+
+    // Cells whose colour changed since the last sync; a full rebuild
+    // (layout, size or palette change) supersedes the list.
+    QVector<int> m_dirtyCells;
+    bool m_fullRebuild;
+
+    int cellIndex(const QDate &date) const;
+    QColor colorFor(qreal value) const;
+    void remapValues(const QDate &oldStart);
+    void scheduleFullRebuild();
+};
+
+#endif // HEATMAPCALENDAR_H
@@ -0,0 +1,135 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QtEndian>
+#include "../src/core/audio/audiocuepool.h"
+#include "../src/core/audio/audiomixer.h"
+
+class TestAudioCues : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDecodeSkipsUnknownChunks();
+    void testRejectsCompressedWav();
+    void testResampleAndUpmix();
+    void testOverlappingCuesMix();
+    void testMixClampsAndRetiresVoices();
+
+private:
+    static QByteArray makeWav(const QVector<qint16> &samples, int sampleRate, int channels,
+                              const QByteArray &extraChunk = QByteArray(), quint16 format = 1);
+    static QVector<qint16> readFrames(AudioMixer &mixer, int frames, int channels);
+};
+
+QByteArray TestAudioCues::makeWav(const QVector<qint16> &samples, int sampleRate, int channels,
+                                  const QByteArray &extraChunk, quint16 format)
+{
+    auto u16 = [](quint16 v) { QByteArray b(2, 0); qToLittleEndian(v, b.data()); return b; };
+    auto u32 = [](quint32 v) { QByteArray b(4, 0); qToLittleEndian(v, b.data()); return b; };
+
+    QByteArray fmt = u16(format) + u16(channels) + u32(sampleRate)
+        + u32(sampleRate * channels * 2) + u16(channels * 2) + u16(16);
+    QByteArray pcm;
+    for (qint16 s : samples) {
+        pcm += u16(quint16(s));
+    }
+
+    QByteArray body = "WAVE" + QByteArray("fmt ") + u32(fmt.size()) + fmt;
+    if (!extraChunk.isEmpty()) {
+        // Odd-sized chunk followed by its pad byte
+        body += "bext" + u32(extraChunk.size()) + extraChunk;
+        if (extraChunk.size() & 1) {
+            body += '\0';
+        }
+    }
+    body += "data" + u32(pcm.size()) + pcm;
+    return "RIFF" + u32(body.size()) + body;
+}
+
+QVector<qint16> TestAudioCues::readFrames(AudioMixer &mixer, int frames, int channels)
+{
+    QVector<qint16> out(frames * channels);
+    mixer.read(reinterpret_cast<char *>(out.data()), out.size() * qint64(sizeof(qint16)));
+    return out;
+}
+
+void TestAudioCues::testDecodeSkipsUnknownChunks()
+{
+    const QVector<qint16> samples = {100, -100, 200, -200, 300, -300};
+    QVector<qint16> decoded;
+    int rate = 0;
+    int channels = 0;
+
+    QVERIFY(AudioCuePool::decodeWav(makeWav(samples, 48000, 2, "odd"), decoded, rate, channels));
+    QCOMPARE(rate, 48000);
+    QCOMPARE(channels, 2);
+    QCOMPARE(decoded, samples);
+}
+
+void TestAudioCues::testRejectsCompressedWav()
+{
+    QVector<qint16> decoded;
+    int rate = 0;
+    int channels = 0;
+    QVERIFY(!AudioCuePool::decodeWav(makeWav({1, 2}, 8000, 1, QByteArray(), 2), decoded, rate, channels));
+    QVERIFY(!AudioCuePool::decodeWav("not a wav file", decoded, rate, channels));
+}
+
+void TestAudioCues::testResampleAndUpmix()
+{
+    AudioCuePool pool(48000, 2);
+
+    QVector<qint16> mono(4410, 1000);
+    QVERIFY(pool.addCueFromWav("tick", makeWav(mono, 44100, 1)));
+
+    const int cue = pool.cueId("tick");
+    QCOMPARE(pool.frameCount(cue), qint64(4800));   // 0.1 s either way
+    QCOMPARE(pool.samples(cue)[0], qint16(1000));
+    QCOMPARE(pool.samples(cue)[1], qint16(1000));   // copied to both channels
+    QCOMPARE(pool.totalBytes(), qint64(4800 * 2 * 2));
+    QCOMPARE(pool.cueId("missing"), -1);
+}
+
+void TestAudioCues::testOverlappingCuesMix()
+{
+    AudioCuePool pool(8000, 1);
+    QVERIFY(pool.addCueFromWav("a", makeWav(QVector<qint16>(100, 1000), 8000, 1)));
+    QVERIFY(pool.addCueFromWav("b", makeWav(QVector<qint16>(50, 500), 8000, 1)));
+
+    AudioMixer mixer(&pool);
+    QVERIFY(mixer.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+
+    QVERIFY(mixer.play(pool.cueId("a")));
+    QVector<qint16> out = readFrames(mixer, 20, 1);
+    QCOMPARE(out.at(0), qint16(1000));
+
+    // The second cue starts while the first is still playing
+    QVERIFY(mixer.play(pool.cueId("b")));
+    QCOMPARE(mixer.activeVoices(), 2);
+    out = readFrames(mixer, 20, 1);
+    QCOMPARE(out.at(0), qint16(1500));
+    QCOMPARE(out.at(19), qint16(1500));
+}
+
+void TestAudioCues::testMixClampsAndRetiresVoices()
+{
+    AudioCuePool pool(8000, 1);
+    QVERIFY(pool.addCueFromWav("loud", makeWav(QVector<qint16>(10, 30000), 8000, 1)));
+
+    AudioMixer mixer(&pool);
+    QVERIFY(mixer.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    QVERIFY(mixer.play(pool.cueId("loud")));
+    QVERIFY(mixer.play(pool.cueId("loud")));
+    QVERIFY(mixer.play(pool.cueId("loud"), 0.5));
+
+    QVector<qint16> out = readFrames(mixer, 16, 1);
+    QCOMPARE(out.at(0), qint16(32767));
+    QCOMPARE(out.at(9), qint16(32767));
+    QCOMPARE(out.at(10), qint16(0));   // cue over, rest is silence
+    QCOMPARE(mixer.activeVoices(), 0);
+
+    QVERIFY(!mixer.play(-1));
+}
+
+QTEST_MAIN(TestAudioCues)
+#include "test_audioCues.moc"
@@ -0,0 +1,171 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include "../src/core/flashcards/flashcardmanager.h"
+#include "../src/core/database/databasemanager.h"
+#include "../src/core/clock/virtualclock.h"
+
+class TestFlashcards : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testSm2Intervals();
+    void testLapseResetsRepetitions();
+    void testDueQueueAndAnswers();
+    void testDueQueryUsesIndex();
+
+private:
+    VirtualClock *m_clock = nullptr;
+};
+
+void TestFlashcards::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_flashcards.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createFlashcardTables());
+
+    QSqlQuery pragma;
+    pragma.exec("PRAGMA synchronous = OFF");
+}
+
+void TestFlashcards::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_flashcards.db");
+}
+
+void TestFlashcards::init()
+{
+    QSqlQuery query;
+    query.exec("DELETE FROM decks");
+    query.exec("DELETE FROM cards");
+    query.exec("DELETE FROM card_reviews");
+
+    m_clock = new VirtualClock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(m_clock);
+}
+
+void TestFlashcards::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+void TestFlashcards::testSm2Intervals()
+{
+    Sm2State state;
+    QList<int> intervals;
+    for (int i = 0; i < 4; i++) {
+        state = FlashcardManager::schedule(state, 5);
+        intervals << state.intervalDays;
+    }
+
+    // 1, 6, then the previous interval times the ease (2.7, then 2.8)
+    QCOMPARE(intervals, QList<int>({1, 6, 16, 45}));
+    QCOMPARE(state.repetitions, 4);
+    QVERIFY(qAbs(state.ease - 2.9) < 1e-9);
+
+    // Hard recalls wear the ease down, but never below 1.3
+    Sm2State hard;
+    for (int i = 0; i < 20; i++) {
+        hard = FlashcardManager::schedule(hard, 3);
+    }
+    QVERIFY(qAbs(hard.ease - 1.3) < 1e-9);
+}
+
+void TestFlashcards::testLapseResetsRepetitions()
+{
+    Sm2State state;
+    state = FlashcardManager::schedule(state, 4);
+    state = FlashcardManager::schedule(state, 4);
+    const double ease = state.ease;
+
+    state = FlashcardManager::schedule(state, 1);
+    QCOMPARE(state.repetitions, 0);
+    QCOMPARE(state.intervalDays, 1);
+    QCOMPARE(state.lapses, 1);
+    QCOMPARE(state.ease, ease);
+}
+
+void TestFlashcards::testDueQueueAndAnswers()
+{
+    FlashcardManager cards;
+    QSignalSpy studiedSpy(&cards, &FlashcardManager::studiedOn);
+
+    const int deck = cards.addDeck("Biology");
+    const int first = cards.addCard(deck, "Mitochondria", "Powerhouse of the cell");
+    cards.addCard(deck, "Ribosome", "Protein synthesis");
+    const int third = cards.addCard(deck, "Nucleus", "Holds the DNA");
+    QCOMPARE(cards.dueCount(), 3);
+    QCOMPARE(cards.currentCard().value("id").toInt(), first);
+
+    QVERIFY(cards.answer(5));
+    QCOMPARE(cards.dueCount(), 2);
+    QCOMPARE(cards.reviewedToday(), 1);
+    QCOMPARE(studiedSpy.count(), 1);
+
+    QVERIFY(cards.answer(2));
+    QCOMPARE(cards.currentCard().value("id").toInt(), third);
+    QCOMPARE(studiedSpy.count(), 1);   // once per day
+    QVERIFY(!cards.answer(6));
+
+    // Next morning both answered cards are back, next to the untouched one
+    m_clock->advanceDays(1);
+    QCOMPARE(cards.dueCount(), 3);
+    QCOMPARE(cards.reviewedToday(), 0);
+    QCOMPARE(cards.dueCards().size(), 3);
+
+    QVERIFY(cards.answer(4));
+    QCOMPARE(studiedSpy.count(), 2);
+
+    // A fresh manager counts the same state from the database
+    FlashcardManager reopened;
+    QCOMPARE(reopened.dueCount(), 2);
+    QCOMPARE(reopened.reviewedToday(), 1);
+
+    QVERIFY(cards.removeDeck(deck));
+    QCOMPARE(cards.dueCount(), 0);
+    QVERIFY(cards.currentCard().isEmpty());
+}
+
+void TestFlashcards::testDueQueryUsesIndex()
+{
+    // The queue must stay a bounded index range scan, never a table scan
+    // plus sort, however many cards there are.
+    const QStringList statements = {
+        "SELECT id, deck_id, front, back FROM cards WHERE due_day <= '2025-03-03' "
+        "ORDER BY due_day, id LIMIT 50",
+        "SELECT id, deck_id, front, back FROM cards WHERE deck_id = 1 AND due_day <= '2025-03-03' "
+        "ORDER BY due_day, id LIMIT 50"
+    };
+
+    for (const QString &statement : statements) {
+        QSqlQuery plan;
+        QVERIFY(plan.exec("EXPLAIN QUERY PLAN " + statement));
+        QString details;
+        while (plan.next()) {
+            details += plan.value(3).toString() + '\n';
+        }
+        QVERIFY2(details.contains("USING INDEX idx_cards_"), qPrintable(details));
+        QVERIFY2(!details.contains("TEMP B-TREE"), qPrintable(details));
+    }
+}
+
+QTEST_MAIN(TestFlashcards)
+#include "test_flashcards.moc"
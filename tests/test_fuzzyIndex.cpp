@@ -0,0 +1,134 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include "../src/core/palette/fuzzyindex.h"
+
+class TestFuzzyIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFoldKeepsLength();
+    void testCharMask();
+    void testScoreRequiresSubsequence();
+    void testWordStartsAndRunsRankFirst();
+    void testIncrementalUpdates();
+    void testPositionsPointIntoOriginalText();
+    void testLargeIndexStaysFast();
+
+private:
+    QList<quint64> keys(const QVector<FuzzyIndex::Match> &matches) const;
+};
+
+QList<quint64> TestFuzzyIndex::keys(const QVector<FuzzyIndex::Match> &matches) const
+{
+    QList<quint64> list;
+    for (const FuzzyIndex::Match &match : matches) {
+        list << match.key;
+    }
+    return list;
+}
+
+void TestFuzzyIndex::testFoldKeepsLength()
+{
+    QCOMPARE(FuzzyIndex::fold("Révision Économie"), QString("revision economie"));
+    QCOMPARE(FuzzyIndex::fold("Straße").size(), QString("Straße").size());
+}
+
+void TestFuzzyIndex::testCharMask()
+{
+    const quint64 title = FuzzyIndex::charMask(FuzzyIndex::fold("Read ch. 3"));
+    QVERIFY(title & (quint64(1) << ('r' - 'a')));
+    QVERIFY(title & (quint64(1) << (26 + 3)));
+    QCOMPARE(FuzzyIndex::charMask("rd3") & ~title, quint64(0));
+    QVERIFY(FuzzyIndex::charMask("z") & ~title);
+    QCOMPARE(FuzzyIndex::charMask("   "), quint64(0));
+}
+
+void TestFuzzyIndex::testScoreRequiresSubsequence()
+{
+    QVERIFY(FuzzyIndex::score("alg", "linear algebra") > 0);
+    QVERIFY(FuzzyIndex::score("lnr", "linear algebra") > 0);
+    QCOMPARE(FuzzyIndex::score("gla", "linear algebra"), -1);
+    QCOMPARE(FuzzyIndex::score("algebras", "algebra"), -1);
+}
+
+void TestFuzzyIndex::testWordStartsAndRunsRankFirst()
+{
+    FuzzyIndex index;
+    index.upsert(1, "Read chapter on pomodoros");
+    index.upsert(2, "Start Pomodoro");
+    index.upsert(3, "Physics homework");
+    index.upsert(4, "Open Pomodoro timer");
+
+    // Runs at a word start beat the same letters scattered, and an
+    // earlier start beats a later one
+    QCOMPARE(keys(index.search("pomo", 10)), QList<quint64>({4, 2, 1, 3}));
+    // Word initials count as boundaries
+    QCOMPARE(keys(index.search("sp", 10)).first(), quint64(2));
+    QCOMPARE(keys(index.search("ph hw", 10)), QList<quint64>({3}));
+    QVERIFY(index.search("", 10).isEmpty());
+    QCOMPARE(index.search("o", 2).size(), 2);
+}
+
+void TestFuzzyIndex::testIncrementalUpdates()
+{
+    FuzzyIndex index;
+    index.upsert(1, "Biology notes");
+    index.upsert(2, "Chemistry lab");
+    index.upsert(3, "Calculus quiz");
+    QCOMPARE(index.size(), 3);
+
+    index.upsert(2, "Organic chemistry lab");
+    QCOMPARE(index.size(), 3);
+    QCOMPARE(index.text(2), QString("Organic chemistry lab"));
+    QCOMPARE(keys(index.search("org", 10)), QList<quint64>({2}));
+
+    // Removing from the middle moves the last entry into its slot
+    index.remove(1);
+    QCOMPARE(index.size(), 2);
+    QVERIFY(!index.contains(1));
+    QVERIFY(index.search("bio", 10).isEmpty());
+    QCOMPARE(keys(index.search("calc", 10)), QList<quint64>({3}));
+
+    index.remove(42);
+    QCOMPARE(index.size(), 2);
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    QVERIFY(index.search("lab", 10).isEmpty());
+}
+
+void TestFuzzyIndex::testPositionsPointIntoOriginalText()
+{
+    FuzzyIndex index;
+    index.upsert(7, "Économie: Chapitre 2");
+
+    const QVector<FuzzyIndex::Match> matches = index.search("eco ch", 1);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches.first().positions, QVector<int>({0, 1, 2, 10, 11}));
+}
+
+void TestFuzzyIndex::testLargeIndexStaysFast()
+{
+    const QStringList words = {"algebra", "biology", "chemistry", "history", "essay",
+                               "physics", "revise", "flashcards", "reading", "lab"};
+
+    FuzzyIndex index;
+    for (int i = 0; i < 50000; i++) {
+        index.upsert(quint64(i), QString("%1 %2 week %3")
+                                      .arg(words.at(i % words.size()), words.at((i / 10) % words.size()))
+                                      .arg(i % 52));
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const QVector<FuzzyIndex::Match> matches = index.search("chem lab", 20);
+    const qint64 ms = elapsed.elapsed();
+
+    QCOMPARE(matches.size(), 20);
+    // One frame is ~16 ms; generous for slow CI machines
+    QVERIFY2(ms < 50, qPrintable(QString::number(ms)));
+}
+
+QTEST_MAIN(TestFuzzyIndex)
+#include "test_fuzzyIndex.moc"
@@ -0,0 +1,237 @@
+#include <QtTest/QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include "../src/core/archive/historyarchive.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestHistoryArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testAggregatesMatchNaiveSums();
+    void testDictionarySpansSegments();
+    void testTornSegmentIgnored();
+    void testAppendAfterTornTail();
+    void testRefreshAppendsOnlyNewRows();
+};
+
+void TestHistoryArchive::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_archive.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createStreaksTable());
+    QVERIFY(dbManager.createSessionsTable());
+
+    QSqlQuery pragma;
+    pragma.exec("PRAGMA synchronous = OFF");
+}
+
+void TestHistoryArchive::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_archive.db");
+}
+
+void TestHistoryArchive::testAggregatesMatchNaiveSums()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("history.archive");
+
+    // Enough rows to be split into several parallel chunks
+    const QDate first(2023, 1, 1);
+    const QStringList names = {"work", "break", "habit: Read"};
+    QRandomGenerator random(42);
+    QStringList dictionary;
+    QVector<qint32> days, minutes, codes;
+
+    for (int segment = 0; segment < 3; segment++) {
+        ArchiveBatch batch;
+        for (int i = 0; i < 100000; i++) {
+            const QDate day = first.addDays(random.bounded(730));
+            const int category = random.bounded(names.size());
+            const qint32 value = random.bounded(60);
+            batch.append(day, value, names.at(category));
+            days.append(qint32(day.toJulianDay()));
+            minutes.append(value);
+            codes.append(category);
+        }
+        QVERIFY(HistoryArchive::appendSegment(path, batch, dictionary));
+    }
+
+    HistoryArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.rowCount(), qint64(300000));
+    QCOMPARE(archive.segmentCount(), 3);
+
+    const QDate from(2023, 6, 1);
+    const QDate to(2024, 2, 29);
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+
+    qint64 expectedTotal = 0;
+    qint64 expectedWork = 0;
+    qint64 expectedEvents = 0;
+    QVector<qint64> expectedPerDay(hi - lo + 1, 0);
+    for (int i = 0; i < days.size(); i++) {
+        if (days.at(i) < lo || days.at(i) > hi) {
+            continue;
+        }
+        expectedTotal += minutes.at(i);
+        expectedEvents++;
+        expectedPerDay[days.at(i) - lo] += minutes.at(i);
+        if (names.at(codes.at(i)) == "work") {
+            expectedWork += minutes.at(i);
+        }
+    }
+
+    QCOMPARE(archive.totalMinutes(from, to), expectedTotal);
+    QCOMPARE(archive.totalMinutes(from, to, archive.categoryCode("work")), expectedWork);
+    QCOMPARE(archive.eventCount(from, to), expectedEvents);
+    QCOMPARE(archive.minutesPerDay(from, to), expectedPerDay);
+    QCOMPARE(archive.minutesByCategory(from, to).value("work"), expectedWork);
+
+    // Outside the data: nothing
+    QCOMPARE(archive.totalMinutes(QDate(2030, 1, 1), QDate(2030, 12, 31)), qint64(0));
+}
+
+void TestHistoryArchive::testDictionarySpansSegments()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("history.archive");
+    const QDate day(2025, 5, 1);
+
+    QStringList dictionary;
+    ArchiveBatch early;
+    early.append(day, 25, "work");
+    early.append(day, 5, "break");
+    QVERIFY(HistoryArchive::appendSegment(path, early, dictionary));
+
+    ArchiveBatch late;
+    late.append(day, 25, "work");
+    late.append(day, 0, "habit: Stretch");
+    QVERIFY(HistoryArchive::appendSegment(path, late, dictionary));
+
+    HistoryArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.categories(), QStringList({"work", "break", "habit: Stretch"}));
+    QCOMPARE(archive.totalMinutes(day, day, archive.categoryCode("work")), qint64(50));
+    QCOMPARE(archive.eventCount(day, day, archive.categoryCode("habit: Stretch")), qint64(1));
+    QCOMPARE(archive.categoryCode("missing"), -1);
+}
+
+void TestHistoryArchive::testTornSegmentIgnored()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("history.archive");
+    const QDate day(2025, 5, 1);
+
+    QStringList dictionary;
+    ArchiveBatch sealed;
+    sealed.append(day, 30, "work");
+    QVERIFY(HistoryArchive::appendSegment(path, sealed, dictionary));
+    const qint64 sealedSize = QFileInfo(path).size();
+
+    ArchiveBatch torn;
+    torn.append(day, 45, "work");
+    QVERIFY(HistoryArchive::appendSegment(path, torn, dictionary));
+
+    // Lose the tail of the second segment, as if the write was interrupted
+    QVERIFY(QFile::resize(path, QFileInfo(path).size() - 4));
+
+    HistoryArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.segmentCount(), 1);
+    QCOMPARE(archive.rowCount(), qint64(1));
+    QCOMPARE(archive.totalMinutes(day, day), qint64(30));
+    QVERIFY(QFileInfo(path).size() > sealedSize);
+}
+
+void TestHistoryArchive::testAppendAfterTornTail()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("history.archive");
+    const QDate day(2025, 5, 1);
+
+    QStringList dictionary;
+    ArchiveBatch sealed;
+    sealed.append(day, 30, "work");
+    QVERIFY(HistoryArchive::appendSegment(path, sealed, dictionary));
+    const qint64 sealedSize = QFileInfo(path).size();
+
+    ArchiveBatch torn;
+    torn.append(day, 45, "torn");
+    QVERIFY(HistoryArchive::appendSegment(path, torn, dictionary));
+    QVERIFY(QFile::resize(path, QFileInfo(path).size() - 4));
+
+    HistoryArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.sealedBytes(), sealedSize);
+    QStringList known = archive.categories();
+    const qint64 sealedBytes = archive.sealedBytes();
+    archive.close();
+
+    // The next append replaces the torn bytes instead of landing after them
+    ArchiveBatch next;
+    next.append(day, 60, "break");
+    QVERIFY(HistoryArchive::appendSegment(path, next, known, sealedBytes));
+
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.segmentCount(), 2);
+    QCOMPARE(archive.rowCount(), qint64(2));
+    QCOMPARE(archive.totalMinutes(day, day), qint64(90));
+    QCOMPARE(archive.categories(), QStringList({"work", "break"}));
+    QCOMPARE(archive.sealedBytes(), QFileInfo(path).size());
+}
+
+void TestHistoryArchive::testRefreshAppendsOnlyNewRows()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DatabaseManager &db = DatabaseManager::instance();
+    const QDateTime start(QDate(2025, 4, 7), QTime(9, 0));
+
+    QVERIFY(db.insertPomodoroSession("work", start, 25 * 60000, 25 * 60, "completed"));
+    QVERIFY(db.insertPomodoroSession("break", start.addSecs(25 * 60), 5 * 60000, 5 * 60, "completed"));
+
+    HistoryArchive archive;
+    QVERIFY(archive.open(dir.filePath("history.archive")));
+    QSignalSpy changed(&archive, &HistoryArchive::archiveChanged);
+
+    QVERIFY(archive.refreshFromDatabase());
+    QCOMPARE(changed.count(), 1);
+    // Breaks are not study time
+    QCOMPARE(archive.rowCount(), qint64(1));
+    QCOMPARE(archive.categories(), QStringList({"focus"}));
+    QCOMPARE(archive.totalMinutes(start.date(), start.date()), qint64(25));
+
+    // Nothing new: no empty segment
+    QVERIFY(archive.refreshFromDatabase());
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(archive.segmentCount(), 1);
+
+    QVERIFY(db.insertPomodoroSession("work", start.addDays(1), 50 * 60000, 50 * 60, "completed"));
+    QVERIFY(archive.refreshFromDatabase());
+    QCOMPARE(archive.segmentCount(), 2);
+    QCOMPARE(archive.totalMinutes(start.date(), start.date().addDays(1), archive.categoryCode("focus")), qint64(75));
+}
+
+QTEST_MAIN(TestHistoryArchive)
+#include "test_historyArchive.moc"
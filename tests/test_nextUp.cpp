@@ -0,0 +1,267 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include <QRandomGenerator>
+#include "../src/core/nextup/indexedheap.h"
+#include "../src/core/nextup/nextupservice.h"
+#include "../src/core/todo/todomanager.h"
+#include "../src/core/clock/clock.h"
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/database/databasemanager.h"
+
+#include <algorithm>
+
+class TestNextUp : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testHeapMatchesSorting();
+    void testScoreSteps();
+
+    void testRanksOpenTodos();
+    void testFollowsModelChanges();
+    void testRescoresWhenADueStepPasses();
+    void testAgeFromCreatedDate();
+
+private:
+    int add(todoManager &todos, const QString &title, const QDateTime &due, int priority) const;
+    QList<int> topIds(const NextUpService &nextUp, int count) const;
+
+    VirtualClock *m_clock = nullptr;
+};
+
+void TestNextUp::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_nextup.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+    QVERIFY(dbManager.createRollupTables());
+}
+
+void TestNextUp::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_nextup.db");
+}
+
+void TestNextUp::init()
+{
+    m_clock = new VirtualClock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(m_clock);
+
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+}
+
+void TestNextUp::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+int TestNextUp::add(todoManager &todos, const QString &title, const QDateTime &due, int priority) const
+{
+    todos.addTodo(title, "", due, priority);
+    QSqlQuery query("SELECT MAX(id) FROM todos");
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+QList<int> TestNextUp::topIds(const NextUpService &nextUp, int count) const
+{
+    QList<int> ids;
+    for (const QVariant &item : nextUp.top(count)) {
+        ids.append(item.toMap().value("todoId").toInt());
+    }
+    return ids;
+}
+
+void TestNextUp::testHeapMatchesSorting()
+{
+    QRandomGenerator random(7);
+    IndexedHeap heap;
+    QHash<quint64, qint64> reference;
+
+    QVector<IndexedHeap::Item> initial;
+    for (quint64 key = 0; key < 500; key++) {
+        initial.append({key, random.bounded(100)});
+        reference.insert(key, initial.last().priority);
+    }
+    heap.assign(initial);
+
+    for (int step = 0; step < 5000; step++) {
+        const quint64 key = random.bounded(1000);
+        if (random.bounded(4) == 0) {
+            QCOMPARE(heap.remove(key), reference.remove(key));
+        } else {
+            const qint64 priority = random.bounded(100);
+            heap.set(key, priority);
+            reference.insert(key, priority);
+        }
+
+        if (step % 250 == 0) {
+            QVector<IndexedHeap::Item> sorted;
+            for (auto it = reference.cbegin(); it != reference.cend(); ++it) {
+                sorted.append({it.key(), it.value()});
+            }
+            std::sort(sorted.begin(), sorted.end(), [](const IndexedHeap::Item &a, const IndexedHeap::Item &b) {
+                return a.priority != b.priority ? a.priority > b.priority : a.key < b.key;
+            });
+
+            const QVector<quint64> top = heap.top(20);
+            QCOMPARE(top.size(), qMin(20, int(sorted.size())));
+            for (int i = 0; i < top.size(); i++) {
+                QCOMPARE(top.at(i), sorted.at(i).key);
+            }
+            QCOMPARE(heap.size(), int(reference.size()));
+            QCOMPARE(heap.topKey(), sorted.first().key);
+        }
+    }
+
+    QCOMPARE(heap.priority(12345, -1), qint64(-1));
+    QVERIFY(heap.top(0).isEmpty());
+}
+
+void TestNextUp::testScoreSteps()
+{
+    const QDateTime now = m_clock->now();
+    const qint64 day = 24 * 3600;
+    QDateTime next;
+
+    // High, no due date, just created: only the first week open is ahead
+    QCOMPARE(NextUpService::score(2, QDateTime(), now, now, &next), 30);
+    QCOMPARE(next, now.addSecs(7 * day));
+
+    // Low, due in two days: the next step is a day before it's due
+    QCOMPARE(NextUpService::score(0, now.addSecs(2 * day), now, now, &next), 30);
+    QCOMPARE(next, now.addSecs(day));
+
+    // Medium and overdue
+    QCOMPARE(NextUpService::score(1, now.addSecs(-3600), now, now, &next), 60);
+    QCOMPARE(next, now.addSecs(7 * day));
+
+    // Open for a month, due in ten days: age is capped, urgency starts in three
+    QCOMPARE(NextUpService::score(1, now.addSecs(10 * day), now.addSecs(-30 * day), now, &next), 28);
+    QCOMPARE(next, now.addSecs(3 * day));
+
+    // Nothing left to change
+    NextUpService::score(1, now.addSecs(-day), now.addSecs(-30 * day), now, &next);
+    QVERIFY(!next.isValid());
+}
+
+void TestNextUp::testRanksOpenTodos()
+{
+    const QDateTime now = m_clock->now();
+    todoManager todos;
+    const int essay = add(todos, "Essay", now.addDays(2), 1);
+    const int reading = add(todos, "Reading", QDateTime(), 2);
+    const int quiz = add(todos, "Quiz", now.addSecs(-3600), 1);
+    const int done = add(todos, "Done", QDateTime(), 0);
+    todos.markAsCompleted(todos.rowForId(done));
+
+    NextUpService nextUp(&todos);
+    QCOMPARE(nextUp.openCount(), 3);
+    QCOMPARE(topIds(nextUp, 3), QList<int>({quiz, essay, reading}));
+    QCOMPARE(nextUp.top(10).size(), 3);
+    QCOMPARE(nextUp.scoreOf(done), -1);
+
+    const QVariantMap first = nextUp.top(1).first().toMap();
+    QCOMPARE(first.value("title").toString(), QString("Quiz"));
+    QCOMPARE(first.value("score").toInt(), 60);
+    QCOMPARE(first.value("reason").toString(), QString("Overdue"));
+    QCOMPARE(nextUp.top(2).last().toMap().value("reason").toString(), QString("Due in 2 days"));
+    QCOMPARE(nextUp.topItems(), nextUp.top(3));
+}
+
+void TestNextUp::testFollowsModelChanges()
+{
+    const QDateTime now = m_clock->now();
+    todoManager todos;
+    NextUpService nextUp(&todos);
+    QSignalSpy ranking(&nextUp, &NextUpService::rankingChanged);
+
+    const int reading = add(todos, "Reading", QDateTime(), 2);
+    const int quiz = add(todos, "Quiz", now.addDays(5), 0);
+    QCOMPARE(nextUp.openCount(), 2);
+    QVERIFY(ranking.count() >= 2);
+    QCOMPARE(nextUp.scoreOf(quiz), 20);
+    QCOMPARE(topIds(nextUp, 1), QList<int>({reading}));
+
+    todos.updateTodo(todos.rowForId(quiz), "Quiz", "", now.addSecs(-2 * 3600), 0);
+    QCOMPARE(nextUp.scoreOf(quiz), 50);
+    QCOMPARE(topIds(nextUp, 2), QList<int>({quiz, reading}));
+
+    todos.markAsCompleted(todos.rowForId(quiz));
+    QCOMPARE(nextUp.scoreOf(quiz), -1);
+    QCOMPARE(nextUp.openCount(), 1);
+
+    todos.markAsCompleted(todos.rowForId(quiz), false);
+    QCOMPARE(nextUp.scoreOf(quiz), 50);
+
+    todos.removeTodo(todos.rowForId(reading));
+    QCOMPARE(nextUp.openCount(), 1);
+    QCOMPARE(topIds(nextUp, 3), QList<int>({quiz}));
+}
+
+void TestNextUp::testRescoresWhenADueStepPasses()
+{
+    const QDateTime now = m_clock->now();
+    todoManager todos;
+    const int essay = add(todos, "Essay", now.addSecs(49 * 3600), 0);
+    const int lab = add(todos, "Lab", now.addDays(6), 2);
+
+    NextUpService nextUp(&todos);
+    QSignalSpy ranking(&nextUp, &NextUpService::rankingChanged);
+    QCOMPARE(nextUp.scoreOf(essay), 30);
+    QCOMPARE(topIds(nextUp, 2), QList<int>({lab, essay}));
+
+    // Hourly re-checks alone don't change anything
+    m_clock->advance(3 * 3600 * 1000);
+    QCOMPARE(ranking.count(), 0);
+
+    // A day before it's due
+    m_clock->advance(23 * 3600 * 1000);
+    QCOMPARE(nextUp.scoreOf(essay), 40);
+    QCOMPARE(ranking.count(), 1);
+
+    // Overdue
+    m_clock->advance(24 * 3600 * 1000);
+    QCOMPARE(nextUp.scoreOf(essay), 50);
+    QCOMPARE(nextUp.scoreOf(lab), 40);
+    QCOMPARE(topIds(nextUp, 2), QList<int>({essay, lab}));
+}
+
+void TestNextUp::testAgeFromCreatedDate()
+{
+    todoManager todos;
+    const int old = add(todos, "Old", QDateTime(), 0);
+    const int fresh = add(todos, "Fresh", QDateTime(), 0);
+
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET created_date = '2025-01-20 09:00:00' WHERE id = :id");
+    query.bindValue(":id", old);
+    QVERIFY(query.exec());
+
+    NextUpService nextUp(&todos);
+    QCOMPARE(nextUp.scoreOf(old), 18);
+    QCOMPARE(nextUp.scoreOf(fresh), 10);
+    QCOMPARE(topIds(nextUp, 2), QList<int>({old, fresh}));
+}
+
+QTEST_MAIN(TestNextUp)
+#include "test_nextUp.moc"
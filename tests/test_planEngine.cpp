@@ -0,0 +1,176 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include "../src/core/planner/planengine.h"
+
+class TestPlanEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEarliestDueFirst();
+    void testLateAndUnplanned();
+    void testIncrementalMatchesFullPlan();
+    void testTenThousandTodos();
+
+private:
+    static PlanTask task(int id, const QDateTime &due, int priority, int pomodoros);
+    static QVector<StudyWindow> everyDay(int startHour, int endHour);
+};
+
+PlanTask TestPlanEngine::task(int id, const QDateTime &due, int priority, int pomodoros)
+{
+    PlanTask t;
+    t.id = id;
+    if (due.isValid()) {
+        t.dueMs = due.toMSecsSinceEpoch();
+    }
+    t.priority = priority;
+    t.pomodoros = pomodoros;
+    return t;
+}
+
+QVector<StudyWindow> TestPlanEngine::everyDay(int startHour, int endHour)
+{
+    QVector<StudyWindow> windows;
+    for (int weekday = 1; weekday <= 7; weekday++) {
+        windows.append({weekday, startHour * 60, endHour * 60});
+    }
+    return windows;
+}
+
+void TestPlanEngine::testEarliestDueFirst()
+{
+    const QDate monday(2025, 3, 3);
+    PlanEngine engine;
+    engine.setTimeline(QDateTime(monday, QTime(8, 0)), {{1, 9 * 60, 11 * 60}}, 25, 5);
+    engine.reset({task(1, QDateTime(monday.addDays(14), QTime(12, 0)), 1, 2),
+                  task(2, QDateTime(monday.addDays(2), QTime(12, 0)), 0, 1),
+                  task(3, QDateTime(), 2, 1)});
+
+    const QVector<PlannedSlot> plan = engine.plan();
+    QCOMPARE(plan.size(), 4);
+    QCOMPARE(plan.at(0).todoId, 2);
+    QCOMPARE(plan.at(1).todoId, 1);
+    QCOMPARE(plan.at(2).todoId, 1);
+    QCOMPARE(plan.at(3).todoId, 3);   // no due date: last, whatever its priority
+
+    // 25-minute slots with 5-minute breaks inside the 9:00-11:00 window
+    QCOMPARE(QDateTime::fromMSecsSinceEpoch(plan.at(0).startMs), QDateTime(monday, QTime(9, 0)));
+    QCOMPARE(QDateTime::fromMSecsSinceEpoch(plan.at(3).startMs), QDateTime(monday, QTime(10, 30)));
+    QCOMPARE(plan.at(3).endMs - plan.at(3).startMs, qint64(25 * 60000));
+
+    // Same due date: higher priority first
+    engine.upsert(task(4, QDateTime(monday.addDays(2), QTime(12, 0)), 2, 1));
+    QCOMPARE(engine.plan().first().todoId, 4);
+    QCOMPARE(engine.plan().at(1).todoId, 2);
+}
+
+void TestPlanEngine::testLateAndUnplanned()
+{
+    const QDate monday(2025, 3, 3);
+    PlanEngine engine;
+    engine.setTimeline(QDateTime(monday, QTime(8, 0)), {{1, 9 * 60, 10 * 60}}, 25, 5);
+
+    // Two slots per Monday; three Pomodoros due Monday noon cannot all fit
+    engine.reset({task(1, QDateTime(monday, QTime(12, 0)), 1, 3)});
+    const QVector<PlannedSlot> plan = engine.plan();
+    QCOMPARE(plan.size(), 3);
+    QVERIFY(!plan.at(1).late);
+    QVERIFY(plan.at(2).late);
+    QCOMPARE(QDateTime::fromMSecsSinceEpoch(plan.at(2).startMs).date(), monday.addDays(7));
+
+    // Planning starts at the anchor time, not at the window start
+    engine.setTimeline(QDateTime(monday, QTime(9, 10)), {{1, 9 * 60, 10 * 60}}, 25, 5);
+    QCOMPARE(QDateTime::fromMSecsSinceEpoch(engine.plan().first().startMs), QDateTime(monday, QTime(9, 10)));
+
+    // No availability at all: nothing planned, everything counted
+    engine.setTimeline(QDateTime(monday, QTime(8, 0)), {}, 25, 5);
+    QVERIFY(engine.plan().isEmpty());
+    QCOMPARE(engine.unplannedCount(), 3);
+}
+
+void TestPlanEngine::testIncrementalMatchesFullPlan()
+{
+    const QDateTime from(QDate(2025, 9, 1), QTime(7, 0));
+    const QVector<StudyWindow> windows = everyDay(8, 20);
+    QRandomGenerator random(7);
+
+    auto randomTask = [&](int id) {
+        const QDateTime due = random.bounded(5) == 0
+            ? QDateTime()
+            : from.addSecs(qint64(random.bounded(120 * 24)) * 3600);
+        return task(id, due, random.bounded(3), 1 + random.bounded(4));
+    };
+
+    QHash<int, PlanTask> tasks;
+    for (int id = 1; id <= 2000; id++) {
+        tasks.insert(id, randomTask(id));
+    }
+
+    PlanEngine incremental;
+    incremental.setTimeline(from, windows, 25, 5);
+    incremental.reset(tasks.values().toVector());
+    incremental.plan();
+
+    for (int edit = 0; edit < 300; edit++) {
+        const int id = 1 + random.bounded(2100);
+        if (random.bounded(4) == 0) {
+            tasks.remove(id);
+            incremental.remove(id);
+        } else {
+            const PlanTask changed = randomTask(id);
+            tasks.insert(id, changed);
+            incremental.upsert(changed);
+        }
+        if (edit % 3 == 0) {
+            incremental.plan();   // interleave planning with batches of edits
+        }
+    }
+
+    PlanEngine full;
+    full.setTimeline(from, windows, 25, 5);
+    full.reset(tasks.values().toVector());
+
+    const QVector<PlannedSlot> expected = full.plan();
+    const QVector<PlannedSlot> actual = incremental.plan();
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < expected.size(); i++) {
+        QCOMPARE(actual.at(i).todoId, expected.at(i).todoId);
+        QCOMPARE(actual.at(i).startMs, expected.at(i).startMs);
+        QCOMPARE(actual.at(i).late, expected.at(i).late);
+    }
+    QCOMPARE(incremental.taskCount(), tasks.size());
+}
+
+void TestPlanEngine::testTenThousandTodos()
+{
+    const QDateTime from(QDate(2025, 9, 1), QTime(7, 0));
+    QRandomGenerator random(11);
+
+    QVector<PlanTask> tasks;
+    for (int id = 1; id <= 10000; id++) {
+        tasks.append(task(id, from.addDays(random.bounded(140)), random.bounded(3), 1 + random.bounded(2)));
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    PlanEngine engine;
+    engine.setTimeline(from, everyDay(7, 23), 25, 5);
+    engine.reset(tasks);
+    const int planned = engine.plan().size();
+
+    engine.upsert(task(5000, from.addDays(1), 2, 3));
+    engine.remove(42);
+    engine.plan();
+
+    QVERIFY(planned > 10000);
+    QCOMPARE(engine.unplannedCount(), 0);
+    // A semester of todos plans interactively, even in a debug build
+    QVERIFY2(elapsed.elapsed() < 1000, qPrintable(QString::number(elapsed.elapsed())));
+}
+
+QTEST_MAIN(TestPlanEngine)
+#include "test_planEngine.moc"
@@ -0,0 +1,192 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/pomodoro/pomodorotimer.h"
+
+class TestPomodoroTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testWorkPhaseEndsExactlyOnDeadline();
+    void testFullSessionLength();
+    void testPauseResumeIsExact();
+    void testBreakStartsWhereWorkEnded();
+    void testIntervalsReportedForLogging();
+    void testDisplayText();
+    void testNotificationsSuspendedWithoutView();
+
+private:
+    VirtualClock *m_clock = nullptr;
+};
+
+void TestPomodoroTimer::init()
+{
+    m_clock = new VirtualClock();
+    Clock::setInstance(m_clock);
+}
+
+void TestPomodoroTimer::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+void TestPomodoroTimer::testWorkPhaseEndsExactlyOnDeadline()
+{
+    PomodoroTimer timer;
+    timer.startSession(25 * 60, 5 * 60);
+    QCOMPARE(timer.timeRemaining(), 25 * 60);
+
+    m_clock->advance(25 * 60 * 1000 - 1);
+    QCOMPARE(timer.currentState(), PomodoroTimer::Working);
+    QCOMPARE(timer.timeRemaining(), 1);
+
+    // No extra tick spent at zero: the break starts on the deadline itself
+    m_clock->advance(1);
+    QCOMPARE(timer.currentState(), PomodoroTimer::OnBreak);
+    QCOMPARE(timer.timeRemaining(), 5 * 60);
+}
+
+void TestPomodoroTimer::testFullSessionLength()
+{
+    PomodoroTimer timer;
+    // A visible view, so per-second notifications are on
+    timer.attachView();
+    timer.setWindowVisible(true);
+    QSignalSpy ended(&timer, &PomodoroTimer::sessionEnded);
+    QSignalSpy remaining(&timer, &PomodoroTimer::timeRemainingChanged);
+
+    timer.startSession(60, 30);
+    m_clock->advance(90 * 1000 - 1);
+    QCOMPARE(ended.count(), 0);
+
+    m_clock->advance(1);
+    QCOMPARE(ended.count(), 1);
+    QCOMPARE(timer.currentState(), PomodoroTimer::Idle);
+    QCOMPARE(timer.timeRemaining(), 0);
+
+    // One notification per displayed second, not per wakeup: 59 work
+    // seconds, the switch to the break, 29 break seconds and the final 0
+    QVERIFY(remaining.count() >= 60 + 30);
+    QVERIFY(remaining.count() <= 60 + 30 + 2);
+    QCOMPARE(m_clock->pendingTimers(), 0);
+}
+
+void TestPomodoroTimer::testPauseResumeIsExact()
+{
+    PomodoroTimer timer;
+    timer.startSession(10, 5);
+
+    m_clock->advance(3250);
+    timer.pause();
+    QVERIFY(timer.isPaused());
+    QCOMPARE(timer.remainingMs(), qint64(6750));
+
+    m_clock->advance(60 * 60 * 1000);   // an hour away from the desk
+    QCOMPARE(timer.remainingMs(), qint64(6750));
+    QCOMPARE(timer.currentState(), PomodoroTimer::Working);
+
+    timer.resume();
+    m_clock->advance(6749);
+    QCOMPARE(timer.currentState(), PomodoroTimer::Working);
+    m_clock->advance(1);
+    QCOMPARE(timer.currentState(), PomodoroTimer::OnBreak);
+}
+
+void TestPomodoroTimer::testBreakStartsWhereWorkEnded()
+{
+    PomodoroTimer timer;
+    QSignalSpy ended(&timer, &PomodoroTimer::sessionEnded);
+    timer.startSession(60, 30);
+
+    m_clock->advance(75 * 1000);
+
+    QCOMPARE(timer.currentState(), PomodoroTimer::OnBreak);
+    QCOMPARE(timer.remainingMs(), qint64(15 * 1000));
+    QCOMPARE(ended.count(), 0);
+}
+
+void TestPomodoroTimer::testIntervalsReportedForLogging()
+{
+    PomodoroTimer timer;
+    QSignalSpy intervals(&timer, &PomodoroTimer::intervalEnded);
+
+    timer.startSession(60, 30);
+    m_clock->advance(20 * 1000);
+    timer.pause();
+    m_clock->advance(5 * 60 * 1000);
+    timer.resume();
+    m_clock->advance(40 * 1000 + 10 * 1000);
+    timer.stop();
+
+    // work 20s paused, work 40s completed, break 10s stopped
+    QCOMPARE(intervals.count(), 3);
+    QCOMPARE(intervals.at(0).at(2).toLongLong(), qint64(20 * 1000));
+    QCOMPARE(intervals.at(0).at(4).toString(), QString("paused"));
+    QCOMPARE(intervals.at(1).at(2).toLongLong(), qint64(40 * 1000));
+    QCOMPARE(intervals.at(1).at(4).toString(), QString("completed"));
+    QCOMPARE(intervals.at(2).at(0).value<PomodoroTimer::State>(), PomodoroTimer::OnBreak);
+    QCOMPARE(intervals.at(2).at(2).toLongLong(), qint64(10 * 1000));
+    QCOMPARE(intervals.at(2).at(4).toString(), QString("stopped"));
+
+    // The resumed interval starts on the wall clock after the pause
+    QCOMPARE(intervals.at(0).at(1).toDateTime().secsTo(intervals.at(1).at(1).toDateTime()), 20 + 5 * 60);
+}
+
+void TestPomodoroTimer::testDisplayText()
+{
+    PomodoroTimer timer;
+    timer.attachView();
+    QSignalSpy text(&timer, &PomodoroTimer::displayTextChanged);
+
+    timer.startSession(25 * 60, 5 * 60);
+    QCOMPARE(timer.displayText(), QString("25:00"));
+
+    m_clock->advance(1);
+    QCOMPARE(timer.displayText(), QString("25:00"));   // still rounds up
+    m_clock->advance(999);
+    QCOMPARE(timer.displayText(), QString("24:59"));
+
+    m_clock->advance(9 * 1000);
+    QCOMPARE(timer.displayText(), QString("24:50"));
+
+    // One notification per visible change
+    QCOMPARE(text.count(), 11);
+}
+
+void TestPomodoroTimer::testNotificationsSuspendedWithoutView()
+{
+    PomodoroTimer timer;
+    QSignalSpy remaining(&timer, &PomodoroTimer::timeRemainingChanged);
+    QSignalSpy states(&timer, &PomodoroTimer::stateChanged);
+
+    timer.startSession(60, 30);
+    m_clock->advance(45 * 1000);
+
+    // No view: no per-second signals, but the countdown is still exact
+    QCOMPARE(remaining.count(), 0);
+    QCOMPARE(timer.timeRemaining(), 15);
+    QCOMPARE(timer.displayText(), QString("00:15"));
+
+    // Attaching catches the view up straight away
+    timer.attachView();
+    QCOMPARE(remaining.count(), 1);
+    m_clock->advance(5 * 1000);
+    QCOMPARE(remaining.count(), 6);
+
+    // Hidden window suspends again; phase changes still arrive on time
+    timer.setWindowVisible(false);
+    m_clock->advance(10 * 1000);
+    QCOMPARE(remaining.count(), 6);
+    QCOMPARE(timer.currentState(), PomodoroTimer::OnBreak);
+    QCOMPARE(states.count(), 3);   // Idle from stop(), Working, OnBreak
+}
+
+QTEST_MAIN(TestPomodoroTimer)
+#include "test_pomodoroTimer.moc"
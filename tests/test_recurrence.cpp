@@ -0,0 +1,263 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include "../src/core/todo/recurrencerule.h"
+#include "../src/core/todo/todomanager.h"
+#include "../src/core/clock/clock.h"
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestRecurrence : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testParse();
+    void testOccurrences();
+    void testMonthlyKeepsDayOfMonth();
+    void testNextAfterFarIntoTheSeries();
+    void testOccurrencesBetween();
+
+    void testCompletingMovesToNextOccurrence();
+    void testUndatedTodoStartsNow();
+    void testClearingTheRule();
+    void testOccurrencesOnlyInWindow();
+
+private:
+    int rowCount(const QString &table) const;
+
+    VirtualClock *m_clock = nullptr;
+};
+
+void TestRecurrence::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_recurrence.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+    QVERIFY(dbManager.createRollupTables());
+}
+
+void TestRecurrence::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_recurrence.db");
+}
+
+void TestRecurrence::init()
+{
+    // Monday
+    m_clock = new VirtualClock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(m_clock);
+
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+    query.exec("DELETE FROM todo_completions");
+}
+
+void TestRecurrence::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+int TestRecurrence::rowCount(const QString &table) const
+{
+    QSqlQuery query("SELECT COUNT(*) FROM " + table);
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+void TestRecurrence::testParse()
+{
+    const QDateTime start(QDate(2025, 3, 3), QTime(9, 0));
+
+    const RecurrenceRule daily = RecurrenceRule::parse("1d", start);
+    QVERIFY(daily.isValid());
+    QCOMPARE(daily.unit(), RecurrenceRule::Daily);
+    QCOMPARE(daily.interval(), 1);
+
+    const RecurrenceRule fortnightly = RecurrenceRule::parse(" 2W ", start);
+    QCOMPARE(fortnightly.unit(), RecurrenceRule::Weekly);
+    QCOMPARE(fortnightly.toString(), QString("2w"));
+    QCOMPARE(RecurrenceRule::parse("3m", start).unit(), RecurrenceRule::Monthly);
+
+    QVERIFY(!RecurrenceRule::parse("0d", start).isValid());
+    QVERIFY(!RecurrenceRule::parse("1y", start).isValid());
+    QVERIFY(!RecurrenceRule::parse("every tuesday", start).isValid());
+    QVERIFY(!RecurrenceRule::parse("", start).isValid());
+    QVERIFY(!RecurrenceRule::parse("1d", QDateTime()).isValid());
+    QCOMPARE(RecurrenceRule().toString(), QString());
+}
+
+void TestRecurrence::testOccurrences()
+{
+    const QDateTime start(QDate(2025, 3, 3), QTime(9, 0));
+
+    QCOMPARE(RecurrenceRule(RecurrenceRule::Weekly, 1, start).occurrence(2),
+             QDateTime(QDate(2025, 3, 17), QTime(9, 0)));
+    QCOMPARE(RecurrenceRule(RecurrenceRule::Daily, 3, start).occurrence(1),
+             QDateTime(QDate(2025, 3, 6), QTime(9, 0)));
+    QCOMPARE(RecurrenceRule(RecurrenceRule::Daily, 3, start).occurrence(0), start);
+    QVERIFY(!RecurrenceRule(RecurrenceRule::Daily, 3, start).occurrence(-1).isValid());
+}
+
+void TestRecurrence::testMonthlyKeepsDayOfMonth()
+{
+    const RecurrenceRule rule(RecurrenceRule::Monthly, 1, QDateTime(QDate(2025, 1, 31), QTime(10, 0)));
+
+    QCOMPARE(rule.occurrence(1), QDateTime(QDate(2025, 2, 28), QTime(10, 0)));
+    QCOMPARE(rule.occurrence(2), QDateTime(QDate(2025, 3, 31), QTime(10, 0)));
+    QCOMPARE(rule.nextAfter(QDateTime(QDate(2025, 2, 28), QTime(10, 0))),
+             QDateTime(QDate(2025, 3, 31), QTime(10, 0)));
+    QCOMPARE(rule.nextAfter(QDateTime(QDate(2025, 4, 15), QTime(8, 0))),
+             QDateTime(QDate(2025, 4, 30), QTime(10, 0)));
+}
+
+void TestRecurrence::testNextAfterFarIntoTheSeries()
+{
+    const QDateTime start(QDate(2025, 3, 3), QTime(9, 0));
+    const RecurrenceRule weekly(RecurrenceRule::Weekly, 1, start);
+
+    QCOMPARE(weekly.nextAfter(start.addDays(-1)), start);
+    QCOMPARE(weekly.nextAfter(start), start.addDays(7));
+    QCOMPARE(weekly.nextAfter(QDateTime(QDate(2025, 3, 17), QTime(10, 0))),
+             QDateTime(QDate(2025, 3, 24), QTime(9, 0)));
+
+    // A thousand years on is worked out, not walked to
+    const QDateTime later(QDate(3025, 6, 1), QTime(12, 0));
+    const QDateTime next = weekly.nextAfter(later);
+    QVERIFY(next > later);
+    QVERIFY(next.addDays(-7) <= later);
+    QCOMPARE(next.date().dayOfWeek(), 1);
+
+    const RecurrenceRule everyThirdDay(RecurrenceRule::Daily, 3, start);
+    const QDateTime day = everyThirdDay.nextAfter(later);
+    QVERIFY(day > later);
+    QVERIFY(day.addDays(-3) <= later);
+    QCOMPARE(start.date().daysTo(day.date()) % 3, 0);
+}
+
+void TestRecurrence::testOccurrencesBetween()
+{
+    const QDateTime start(QDate(2025, 3, 3), QTime(9, 0));
+    const RecurrenceRule daily(RecurrenceRule::Daily, 1, start);
+
+    const QVector<QDateTime> midweek = daily.occurrencesBetween(QDateTime(QDate(2025, 3, 5), QTime(0, 0)),
+                                                                QDateTime(QDate(2025, 3, 8), QTime(0, 0)));
+    QCOMPARE(midweek, QVector<QDateTime>({QDateTime(QDate(2025, 3, 5), QTime(9, 0)),
+                                          QDateTime(QDate(2025, 3, 6), QTime(9, 0)),
+                                          QDateTime(QDate(2025, 3, 7), QTime(9, 0))}));
+
+    // The window start is inclusive, its end exclusive
+    const QDateTime wednesday(QDate(2025, 3, 5), QTime(9, 0));
+    QCOMPARE(daily.occurrencesBetween(wednesday, wednesday.addMSecs(1)).size(), 1);
+    QCOMPARE(daily.occurrencesBetween(wednesday.addMSecs(-1), wednesday).size(), 0);
+
+    QCOMPARE(daily.occurrencesBetween(start, start.addDays(1000), 5).size(), 5);
+    QVERIFY(daily.occurrencesBetween(start.addDays(-10), start).isEmpty());
+
+    const QVector<QDateTime> farAway = RecurrenceRule(RecurrenceRule::Weekly, 1, start)
+                                           .occurrencesBetween(QDateTime(QDate(3025, 1, 1), QTime(0, 0)),
+                                                               QDateTime(QDate(3025, 1, 8), QTime(0, 0)));
+    QCOMPARE(farAway.size(), 1);
+    QCOMPARE(farAway.first().date().dayOfWeek(), 1);
+}
+
+void TestRecurrence::testCompletingMovesToNextOccurrence()
+{
+    todoManager todos;
+    QSignalSpy completions(&todos, &todoManager::completionChanged);
+
+    todos.addTodo("Problem set", "", QDateTime(QDate(2025, 3, 5), QTime(17, 0)), 1);
+    QVERIFY(todos.setRecurrence(0, "1w"));
+    const QModelIndex row = todos.index(0, 0);
+    QCOMPARE(row.data(todoManager::RecurrenceRole).toString(), QString("1w"));
+    QCOMPARE(row.data(todoManager::DueDateRole).toDateTime(), QDateTime(QDate(2025, 3, 5), QTime(17, 0)));
+
+    // Done early: the next one is a week on
+    todos.markAsCompleted(0, true);
+    QCOMPARE(row.data(todoManager::CompletedRole).toBool(), false);
+    QCOMPARE(row.data(todoManager::DueDateRole).toDateTime(), QDateTime(QDate(2025, 3, 12), QTime(17, 0)));
+    QCOMPARE(completions.count(), 1);
+    QCOMPARE(rowCount("todos"), 1);
+    QCOMPARE(rowCount("todo_completions"), 1);
+
+    // Done late: missed occurrences are skipped, not piled up
+    m_clock->advanceTo(QDateTime(QDate(2025, 3, 20), QTime(9, 0)));
+    todos.markAsCompleted(0, true);
+    QCOMPARE(row.data(todoManager::DueDateRole).toDateTime(), QDateTime(QDate(2025, 3, 26), QTime(17, 0)));
+    QCOMPARE(rowCount("todos"), 1);
+    QCOMPARE(rowCount("todo_completions"), 2);
+
+    todoManager reloaded;
+    QCOMPARE(reloaded.data(reloaded.index(0, 0), todoManager::RecurrenceRole).toString(), QString("1w"));
+    QCOMPARE(reloaded.data(reloaded.index(0, 0), todoManager::DueDateRole).toDateTime(),
+             QDateTime(QDate(2025, 3, 26), QTime(17, 0)));
+}
+
+void TestRecurrence::testUndatedTodoStartsNow()
+{
+    todoManager todos;
+    todos.addTodo("Reading", "", QDateTime(), 1);
+    QVERIFY(todos.setRecurrence(0, "1d"));
+    QCOMPARE(todos.data(todos.index(0, 0), todoManager::DueDateRole).toDateTime(), m_clock->now());
+
+    todos.markAsCompleted(0, true);
+    QCOMPARE(todos.data(todos.index(0, 0), todoManager::DueDateRole).toDateTime(),
+             QDateTime(QDate(2025, 3, 4), QTime(9, 0)));
+}
+
+void TestRecurrence::testClearingTheRule()
+{
+    todoManager todos;
+    todos.addTodo("Reading", "", QDateTime(QDate(2025, 3, 3), QTime(20, 0)), 1);
+    QVERIFY(!todos.setRecurrence(0, "every tuesday"));
+    QVERIFY(todos.setRecurrence(0, "2d"));
+    QVERIFY(todos.setRecurrence(0, ""));
+    QCOMPARE(todos.data(todos.index(0, 0), todoManager::RecurrenceRole).toString(), QString());
+
+    todos.markAsCompleted(0, true);
+    QCOMPARE(todos.data(todos.index(0, 0), todoManager::CompletedRole).toBool(), true);
+    QCOMPARE(todos.data(todos.index(0, 0), todoManager::DueDateRole).toDateTime(),
+             QDateTime(QDate(2025, 3, 3), QTime(20, 0)));
+}
+
+void TestRecurrence::testOccurrencesOnlyInWindow()
+{
+    todoManager todos;
+    todos.addTodo("Reading", "", QDateTime(QDate(2025, 3, 3), QTime(9, 0)), 1);
+    todos.addTodo("Problem set", "", QDateTime(QDate(2025, 3, 5), QTime(17, 0)), 1);
+    todos.addTodo("Essay", "", QDateTime(QDate(2025, 3, 4), QTime(12, 0)), 1);
+    QVERIFY(todos.setRecurrence(0, "1d"));
+    QVERIFY(todos.setRecurrence(1, "1w"));
+
+    const QVariantList week = todos.occurrences(QDateTime(QDate(2025, 3, 3), QTime(0, 0)),
+                                                QDateTime(QDate(2025, 3, 10), QTime(0, 0)));
+    QCOMPARE(week.size(), 8);
+    QCOMPARE(week.first().toMap().value("title").toString(), QString("Reading"));
+    QCOMPARE(week.at(3).toMap().value("title").toString(), QString("Problem set"));
+    QCOMPARE(week.at(3).toMap().value("dueDate").toDateTime(), QDateTime(QDate(2025, 3, 5), QTime(17, 0)));
+    QCOMPARE(week.last().toMap().value("dueDate").toDateTime(), QDateTime(QDate(2025, 3, 9), QTime(9, 0)));
+
+    // Expanding a window stores nothing
+    QCOMPARE(rowCount("todos"), 3);
+    QCOMPARE(todos.occurrences(QDateTime(QDate(2125, 3, 3), QTime(0, 0)),
+                               QDateTime(QDate(2125, 3, 4), QTime(0, 0))).size(), 1);
+}
+
+QTEST_MAIN(TestRecurrence)
+#include "test_recurrence.moc"
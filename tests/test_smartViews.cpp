@@ -0,0 +1,135 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include "../src/core/todo/smartviews.h"
+#include "../src/core/todo/todomanager.h"
+#include "../src/core/clock/clock.h"
+#include "../src/core/clock/virtualclock.h"
+
+class TestSmartViews : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testMembership();
+    void testMidnightSlidesWindows();
+    void testEditsUpdateCounts();
+
+private:
+    QStandardItem *makeTodo(int id, const QString &title, const QDateTime &due,
+                            int priority = TodoItem::Medium, bool completed = false) const;
+    QStringList titles(const QAbstractItemModel *model) const;
+
+    VirtualClock *m_clock = nullptr;
+    QStandardItemModel *m_todos = nullptr;
+};
+
+void TestSmartViews::init()
+{
+    // Monday
+    m_clock = new VirtualClock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(m_clock);
+
+    m_todos = new QStandardItemModel(this);
+    m_todos->appendRow(makeTodo(6, "Done", QDateTime(QDate(2025, 3, 3), QTime(12, 0)), TodoItem::Medium, true));
+    m_todos->appendRow(makeTodo(5, "Reading", QDateTime(), TodoItem::High));
+    m_todos->appendRow(makeTodo(4, "Project", QDateTime(QDate(2025, 3, 12), QTime(17, 0))));
+    m_todos->appendRow(makeTodo(3, "Lab report", QDateTime(QDate(2025, 3, 5), QTime(10, 0)), TodoItem::High));
+    m_todos->appendRow(makeTodo(2, "Quiz", QDateTime(QDate(2025, 3, 3), QTime(15, 0))));
+    m_todos->appendRow(makeTodo(1, "Late essay", QDateTime(QDate(2025, 3, 1), QTime(23, 0))));
+}
+
+void TestSmartViews::cleanup()
+{
+    delete m_todos;
+    m_todos = nullptr;
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+QStandardItem *TestSmartViews::makeTodo(int id, const QString &title, const QDateTime &due,
+                                        int priority, bool completed) const
+{
+    QStandardItem *item = new QStandardItem;
+    item->setData(id, todoManager::IdRole);
+    item->setData(title, todoManager::TitleRole);
+    item->setData(priority, todoManager::PriorityRole);
+    item->setData(due, todoManager::DueDateRole);
+    item->setData(completed, todoManager::CompletedRole);
+    return item;
+}
+
+QStringList TestSmartViews::titles(const QAbstractItemModel *model) const
+{
+    QStringList list;
+    for (int row = 0; row < model->rowCount(); row++) {
+        list << model->index(row, 0).data(todoManager::TitleRole).toString();
+    }
+    return list;
+}
+
+void TestSmartViews::testMembership()
+{
+    SmartViews views(m_todos);
+
+    QCOMPARE(titles(views.overdue()), QStringList({"Late essay"}));
+    QCOMPARE(titles(views.dueToday()), QStringList({"Quiz"}));
+    QCOMPARE(titles(views.thisWeek()), QStringList({"Quiz", "Lab report"}));
+    QCOMPARE(titles(views.highPriority()), QStringList({"Lab report", "Reading"}));
+}
+
+void TestSmartViews::testMidnightSlidesWindows()
+{
+    SmartViews views(m_todos);
+    QSignalSpy overdueReset(views.overdue(), &QAbstractItemModel::modelReset);
+    QSignalSpy todayReset(views.dueToday(), &QAbstractItemModel::modelReset);
+    QSignalSpy overdueCount(views.overdue(), &TodoSortFilterModel::countChanged);
+
+    m_clock->advanceDays(1);
+    QCOMPARE(titles(views.overdue()), QStringList({"Late essay", "Quiz"}));
+    QCOMPARE(views.dueToday()->rowCount(), 0);
+    QCOMPARE(titles(views.thisWeek()), QStringList({"Lab report"}));
+    QCOMPARE(overdueCount.count(), 1);
+
+    m_clock->advanceDays(1);
+    QCOMPARE(titles(views.dueToday()), QStringList({"Lab report"}));
+
+    // Next Monday starts a new week
+    m_clock->advanceDays(5);
+    QCOMPARE(titles(views.overdue()), QStringList({"Late essay", "Quiz", "Lab report"}));
+    QCOMPARE(titles(views.thisWeek()), QStringList({"Project"}));
+
+    QCOMPARE(overdueReset.count(), 0);
+    QCOMPARE(todayReset.count(), 0);
+}
+
+void TestSmartViews::testEditsUpdateCounts()
+{
+    SmartViews views(m_todos);
+    QSignalSpy todayCount(views.dueToday(), &TodoSortFilterModel::countChanged);
+
+    // Completing the quiz drops it from every view
+    m_todos->item(4)->setData(true, todoManager::CompletedRole);
+    QCOMPARE(views.dueToday()->rowCount(), 0);
+    QCOMPARE(titles(views.thisWeek()), QStringList({"Lab report"}));
+    QCOMPARE(todayCount.count(), 1);
+
+    // Pulling the project in to today
+    m_todos->item(2)->setData(QDateTime(QDate(2025, 3, 3), QTime(18, 0)), todoManager::DueDateRole);
+    QCOMPARE(titles(views.dueToday()), QStringList({"Project"}));
+    QCOMPARE(titles(views.thisWeek()), QStringList({"Project", "Lab report"}));
+
+    m_todos->appendRow(makeTodo(7, "Revise", QDateTime(QDate(2025, 3, 2), QTime(8, 0)), TodoItem::High));
+    QCOMPARE(titles(views.overdue()), QStringList({"Late essay", "Revise"}));
+    QCOMPARE(titles(views.highPriority()), QStringList({"Revise", "Lab report", "Reading"}));
+
+    m_todos->removeRow(0);
+    QCOMPARE(views.overdue()->rowCount(), 2);
+}
+
+QTEST_MAIN(TestSmartViews)
+#include "test_smartViews.moc"
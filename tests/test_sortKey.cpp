@@ -0,0 +1,101 @@
+#include <QtTest/QtTest>
+#include <QRandomGenerator>
+#include "../src/core/todo/sortkey.h"
+
+class TestSortKey : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBetweenBounds();
+    void testBetweenNeighbours();
+    void testRandomInsertsStayOrderedAndShort();
+    void testAppendGrowsSlowly();
+    void testSpread();
+};
+
+void TestSortKey::testBetweenBounds()
+{
+    QCOMPARE(SortKey::between(QString(), QString()), QString("V"));
+    QCOMPARE(SortKey::between("V", QString()), QString("l"));
+    QCOMPARE(SortKey::between(QString(), "V"), QString("G"));
+    QCOMPARE(SortKey::between(QString(), "1"), QString("0V"));
+    // Refuses out-of-order bounds
+    QVERIFY(SortKey::between("b", "a").isEmpty());
+    QVERIFY(SortKey::between("a", "a").isEmpty());
+}
+
+void TestSortKey::testBetweenNeighbours()
+{
+    const QString a = "V";
+    const QString b = "W";
+    const QString mid = SortKey::between(a, b);
+    QVERIFY(a < mid && mid < b);
+    QVERIFY(SortKey::isValid(mid));
+
+    const QString tight = SortKey::between("Vz", "W");
+    QVERIFY(QString("Vz") < tight && tight < QString("W"));
+
+    const QString prefix = SortKey::between("V", "V1");
+    QVERIFY(QString("V") < prefix && prefix < QString("V1"));
+    QVERIFY(SortKey::isValid(prefix));
+}
+
+void TestSortKey::testRandomInsertsStayOrderedAndShort()
+{
+    QRandomGenerator random(7);
+    QStringList keys;
+    for (int i = 0; i < 5000; i++) {
+        const int at = random.bounded(keys.size() + 1);
+        const QString before = at > 0 ? keys.at(at - 1) : QString();
+        const QString after = at < keys.size() ? keys.at(at) : QString();
+        const QString key = SortKey::between(before, after);
+        QVERIFY(SortKey::isValid(key));
+        QVERIFY(before.isEmpty() || before < key);
+        QVERIFY(after.isEmpty() || key < after);
+        keys.insert(at, key);
+    }
+
+    int longest = 0;
+    for (const QString &key : std::as_const(keys)) {
+        longest = qMax(longest, int(key.size()));
+    }
+    QVERIFY2(longest <= 8, qPrintable(QString::number(longest)));
+}
+
+void TestSortKey::testAppendGrowsSlowly()
+{
+    // Always adding at the end is the worst case; it is what rebalancing is for
+    QString key;
+    for (int i = 0; i < 60; i++) {
+        key = SortKey::between(key, QString());
+    }
+    QVERIFY(key.size() <= 12);
+}
+
+void TestSortKey::testSpread()
+{
+    QVERIFY(SortKey::spread(0).isEmpty());
+    QCOMPARE(SortKey::spread(1), QStringList({"V"}));
+
+    const QStringList small = SortKey::spread(60);
+    QCOMPARE(small.size(), 60);
+    for (const QString &key : small) {
+        QCOMPARE(key.size(), 1);
+    }
+
+    const QStringList keys = SortKey::spread(10000);
+    QCOMPARE(keys.size(), 10000);
+    for (int i = 0; i < keys.size(); i++) {
+        QVERIFY(SortKey::isValid(keys.at(i)));
+        QVERIFY(keys.at(i).size() <= 3);
+        if (i > 0) {
+            QVERIFY(keys.at(i - 1) < keys.at(i));
+        }
+    }
+    // Room left for a drop between neighbours
+    QVERIFY(!SortKey::between(keys.at(0), keys.at(1)).isEmpty());
+}
+
+QTEST_MAIN(TestSortKey)
+#include "test_sortKey.moc"
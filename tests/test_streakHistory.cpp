@@ -0,0 +1,145 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDate>
+#include "../src/core/streaks/streakhistory.h"
+
+class TestStreakHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyHistory();
+    void testConsecutiveCheckInsExtendRun();
+    void testGapStartsNewRun();
+    void testDuplicateCheckInIgnored();
+    void testBackdatedCheckInMergesRuns();
+    void testHistogram();
+    void testMedianRun();
+    void testConsistency();
+};
+
+void TestStreakHistory::testEmptyHistory()
+{
+    StreakHistory history;
+
+    QCOMPARE(history.totalCheckIns(), 0);
+    QCOMPARE(history.runCount(), 0);
+    QCOMPARE(history.longestRun(), 0);
+    QCOMPARE(history.longestGap(), 0);
+    QCOMPARE(history.meanRun(), 0.0);
+    QCOMPARE(history.medianRun(), 0.0);
+    QCOMPARE(history.consistency(QDate(2025, 1, 1)), 0.0);
+}
+
+void TestStreakHistory::testConsecutiveCheckInsExtendRun()
+{
+    StreakHistory history;
+    QDate start(2025, 3, 1);
+
+    for (int i = 0; i < 5; i++) {
+        QVERIFY(history.addCheckIn(start.addDays(i)));
+    }
+
+    QCOMPARE(history.runCount(), 1);
+    QCOMPARE(history.totalCheckIns(), 5);
+    QCOMPARE(history.longestRun(), 5);
+    QCOMPARE(history.runs().first().startDay, start.toJulianDay());
+}
+
+void TestStreakHistory::testGapStartsNewRun()
+{
+    StreakHistory history;
+    QDate start(2025, 3, 1);
+
+    history.addCheckIn(start);
+    history.addCheckIn(start.addDays(1));
+    history.addCheckIn(start.addDays(5));   // 3 missed days
+
+    QCOMPARE(history.runCount(), 2);
+    QCOMPARE(history.longestGap(), 3);
+    QCOMPARE(history.meanRun(), 1.5);
+}
+
+void TestStreakHistory::testDuplicateCheckInIgnored()
+{
+    StreakHistory history;
+    QDate day(2025, 3, 1);
+
+    QVERIFY(history.addCheckIn(day));
+    QVERIFY(!history.addCheckIn(day));
+    QCOMPARE(history.totalCheckIns(), 1);
+}
+
+void TestStreakHistory::testBackdatedCheckInMergesRuns()
+{
+    StreakHistory history;
+    QDate start(2025, 3, 1);
+
+    history.addCheckIn(start);
+    history.addCheckIn(start.addDays(2));
+    QCOMPARE(history.runCount(), 2);
+
+    // Filling the hole joins both runs into one of length 3
+    QVERIFY(history.addCheckIn(start.addDays(1)));
+    QCOMPARE(history.runCount(), 1);
+    QCOMPARE(history.longestRun(), 3);
+    QCOMPARE(history.longestGap(), 0);
+    QVERIFY(history.contains(start.addDays(1)));
+}
+
+void TestStreakHistory::testHistogram()
+{
+    StreakHistory history;
+    QDate start(2025, 1, 1);
+
+    // Runs of 2, 1, 2
+    history.setCheckIns({start, start.addDays(1),
+                         start.addDays(3),
+                         start.addDays(6), start.addDays(7)});
+
+    QMap<int, int> histogram = history.histogram();
+    QCOMPARE(histogram.size(), 2);
+    QCOMPARE(histogram.value(1), 1);
+    QCOMPARE(histogram.value(2), 2);
+
+    // Extending the last run moves it from the 2-bucket to the 3-bucket
+    history.addCheckIn(start.addDays(8));
+    histogram = history.histogram();
+    QCOMPARE(histogram.value(2), 1);
+    QCOMPARE(histogram.value(3), 1);
+}
+
+void TestStreakHistory::testMedianRun()
+{
+    StreakHistory history;
+    QDate start(2025, 1, 1);
+
+    // Runs of 1, 3, 4 -> median 3
+    history.setCheckIns({start,
+                         start.addDays(2), start.addDays(3), start.addDays(4),
+                         start.addDays(6), start.addDays(7), start.addDays(8), start.addDays(9)});
+    QCOMPARE(history.medianRun(), 3.0);
+
+    // Add a run of 1 -> runs 1, 1, 3, 4 -> median 2
+    history.addCheckIn(start.addDays(20));
+    QCOMPARE(history.medianRun(), 2.0);
+}
+
+void TestStreakHistory::testConsistency()
+{
+    StreakHistory history;
+    QDate today(2025, 6, 30);
+
+    for (int i = 0; i < 15; i++) {
+        history.addCheckIn(today.addDays(-i));
+    }
+
+    QCOMPARE(history.consistency(today, 30), 0.5);
+    QCOMPARE(history.consistency(today, 10), 1.0);
+
+    // Check-ins outside the window do not count
+    QCOMPARE(history.consistency(today.addDays(30), 30), 0.0);
+}
+
+QTEST_MAIN(TestStreakHistory)
+#include "test_streakHistory.moc"
@@ -1,7 +1,9 @@
 #include <QtTest/QtTest>
 #include <QObject>
 #include <QDateTime>
+#include <QTimeZone>
 #include "../src/core/streaks/streaks.h"
+#include "../src/core/clock/virtualclock.h"
 
 class TestStreaks : public QObject
 {
@@ -19,6 +21,9 @@ private slots:
     void testBestStreak();
     void testUpdateBestStreak();
     void testRealisticStreakScenario();
+    void testVirtualClockDayBoundaries();
+    void testYearOfDailyCheckIns();
+    void testDstTransition();
 };
 
 void TestStreaks::testConstructor()
@@ -254,7 +259,71 @@ void TestStreaks::testRealisticStreakScenario() {
 }
 
 
+// Virtual clock: activity flags follow calendar days, not real time
+void TestStreaks::testVirtualClockDayBoundaries() {
+    VirtualClock clock(QDateTime(QDate(2025, 1, 1), QTime(21, 0)));
+    Clock::setInstance(&clock);
 
+    Streaks streak("Reading");
+    streak.incrementStreakDuration();
+    QCOMPARE(streak.lastActivity(), clock.now());
+    QVERIFY(streak.isActiveToday());
+
+    // Three hours later it is already tomorrow
+    clock.advance(3 * 60 * 60 * 1000);
+    QVERIFY(!streak.isActiveToday());
+    QVERIFY(!streak.isStreakBroken());
+    QCOMPARE(streak.daysSinceLastActivity(), 1);
+
+    clock.advanceDays(1);
+    QVERIFY(streak.isStreakBroken());
+    QCOMPARE(streak.daysSinceLastActivity(), 2);
+
+    Clock::setInstance(nullptr);
+}
+
+// A full year of daily check-ins, simulated without waiting
+void TestStreaks::testYearOfDailyCheckIns() {
+    VirtualClock clock;
+    Clock::setInstance(&clock);
+
+    Streaks streak("Daily Reading");
+    for (int day = 0; day < 365; day++) {
+        QVERIFY(!streak.isStreakBroken() || day == 0);
+        streak.incrementStreakDuration();
+        clock.advanceDays(1);
+    }
+
+    QCOMPARE(streak.streakDuration(), 365);
+    QCOMPARE(streak.bestStreak(), 365);
+    QCOMPARE(clock.today(), QDate(2026, 1, 1));
+    QVERIFY(!streak.isStreakBroken());
+
+    Clock::setInstance(nullptr);
+}
+
+// Advancing one calendar day across spring-forward is 23 hours of elapsed time
+void TestStreaks::testDstTransition() {
+    QTimeZone berlin("Europe/Berlin");
+    if (!berlin.isValid()) {
+        QSKIP("Time zone database not available");
+    }
+
+    VirtualClock clock(QDateTime(QDate(2025, 3, 29), QTime(23, 30), berlin));
+    Clock::setInstance(&clock);
+
+    Streaks streak("Exercise");
+    streak.incrementStreakDuration();
+
+    qint64 before = clock.monotonicMs();
+    clock.advanceDays(1);
+    QCOMPARE(clock.monotonicMs() - before, qint64(23) * 60 * 60 * 1000);
+    QCOMPARE(clock.now().time(), QTime(23, 30));
+    QCOMPARE(streak.daysSinceLastActivity(), 1);
+    QVERIFY(!streak.isStreakBroken());
+
+    Clock::setInstance(nullptr);
+}
 
 // This creates the main function for the test
 QTEST_MAIN(TestStreaks)
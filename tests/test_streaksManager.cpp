@@ -5,6 +5,8 @@
 #include <QFile>
 #include "../src/core/streaks/streaksmanager.h"
 #include "../src/core/database/databasemanager.h"
+#include "../src/core/database/databasewatcher.h"
+#include "../src/core/clock/virtualclock.h"
 
 class TeststreaksManager : public QObject
 {
@@ -30,6 +32,10 @@ private slots:
     void testSignalEmission();
     void testInvalidIndices();
     void testDatabasePersistence();
+    void testYearOfUsageWithVirtualClock();
+    void testExpiredStreakResetByTimer();
+    void testExternalChangesApplied();
+    void testRecordActivityOncePerDay();
 
 private:
     void clearDatabase();
@@ -53,6 +59,10 @@ void TeststreaksManager::initTestCase()
         QFAIL("Failed to create streaks table");
     }
 
+    // Year-long simulations write hundreds of rows; skip fsync in tests
+    QSqlQuery pragma;
+    pragma.exec("PRAGMA synchronous = OFF");
+
 }
 
 void TeststreaksManager::cleanupTestCase()
@@ -417,5 +427,144 @@ void TeststreaksManager::testDatabasePersistence()
     }
 }
 
+void TeststreaksManager::testYearOfUsageWithVirtualClock()
+{
+    VirtualClock clock(QDateTime(QDate(2025, 1, 1), QTime(9, 0)));
+    Clock::setInstance(&clock);
+
+    {
+        streaksManager manager(this);
+        manager.addStreak("Weekday Study");
+        QModelIndex index = manager.index(0, 0);
+
+        // Check in six days out of every seven for a whole year. The hourly
+        // reset timer runs in virtual time and breaks the streak after each
+        // skipped day.
+        for (int day = 0; day < 365; day++) {
+            if (day % 7 != 6) {
+                manager.incrementStreak(0);
+                QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), day % 7 + 1);
+            }
+            clock.advanceDays(1);
+        }
+
+        QCOMPARE(manager.data(index, streaksManager::BestStreakRole).toInt(), 6);
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 1);
+        QCOMPARE(manager.activeStreaks(), 0);
+        QCOMPARE(DatabaseManager::instance().loadStreakCheckins(
+                     manager.data(index, streaksManager::IdRole).toInt()).size(), 313);
+    }
+
+    Clock::setInstance(nullptr);
+}
+
+void TeststreaksManager::testExpiredStreakResetByTimer()
+{
+    VirtualClock clock(QDateTime(QDate(2025, 6, 1), QTime(23, 0)));
+    Clock::setInstance(&clock);
+
+    {
+        streaksManager manager(this);
+        manager.addStreak("Reading");
+        manager.incrementStreak(0);
+        manager.incrementStreak(0);
+
+        QModelIndex index = manager.index(0, 0);
+        QSignalSpy dataChangedSpy(&manager, &streaksManager::dataChanged);
+
+        // Next day: pending, not broken
+        clock.advance(2 * 60 * 60 * 1000);
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 2);
+        QCOMPARE(manager.data(index, streaksManager::IsStreakBrokenRole).toBool(), false);
+
+        // Day after that: the first hourly check past midnight resets it
+        clock.advanceTo(QDateTime(QDate(2025, 6, 3), QTime(0, 30)));
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 0);
+        QCOMPARE(manager.data(index, streaksManager::BestStreakRole).toInt(), 2);
+        QCOMPARE(dataChangedSpy.count(), 1);
+    }
+
+    Clock::setInstance(nullptr);
+}
+
+void TeststreaksManager::testExternalChangesApplied()
+{
+    m_manager->addStreak("Reading");
+    m_manager->addStreak("Exercise");
+
+    DatabaseWatcher watcher;
+    connect(&watcher, &DatabaseWatcher::streaksChanged,
+            m_manager, &streaksManager::applyExternalChanges);
+
+    QSignalSpy resetSpy(m_manager, &streaksManager::modelReset);
+    QSignalSpy insertSpy(m_manager, &streaksManager::rowsInserted);
+    QSignalSpy removeSpy(m_manager, &streaksManager::rowsRemoved);
+
+    // Nothing committed elsewhere yet
+    QSignalSpy changedSpy(&watcher, &DatabaseWatcher::streaksChanged);
+    watcher.poll();
+    QCOMPARE(changedSpy.count(), 0);
+
+    // Simulate a second instance writing through its own connection
+    {
+        QSqlDatabase external = QSqlDatabase::addDatabase("QSQLITE", "external");
+        external.setDatabaseName("test_lemonstudys.db");
+        QVERIFY(external.open());
+
+        QSqlQuery query(external);
+        QVERIFY(query.exec("UPDATE streaks SET title = 'Renamed', streak_duration = 4 WHERE id = 1"));
+        QVERIFY(query.exec("DELETE FROM streaks WHERE id = 2"));
+        QVERIFY(query.exec("INSERT INTO streaks (title) VALUES ('From script')"));
+        external.close();
+    }
+    QSqlDatabase::removeDatabase("external");
+
+    watcher.poll();
+
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(m_manager->rowCount(), 2);
+
+    QModelIndex first = m_manager->index(0, 0);
+    QModelIndex second = m_manager->index(1, 0);
+    QCOMPARE(m_manager->data(first, streaksManager::TitleRole).toString(), QString("Renamed"));
+    QCOMPARE(m_manager->data(first, streaksManager::StreakDurationRole).toInt(), 4);
+    QCOMPARE(m_manager->data(second, streaksManager::TitleRole).toString(), QString("From script"));
+}
+
+void TeststreaksManager::testRecordActivityOncePerDay()
+{
+    VirtualClock clock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(&clock);
+    QSqlQuery query;
+    query.exec("DELETE FROM streak_checkins");
+
+    {
+        streaksManager manager(this);
+        QSignalSpy checkinSpy(&manager, &streaksManager::streakCheckedIn);
+
+        // First activity creates the streak and checks it in
+        manager.recordActivity("Flashcard reviews");
+        QCOMPARE(manager.count(), 1);
+        QModelIndex index = manager.index(0, 0);
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 1);
+
+        // More activity the same day changes nothing
+        clock.advance(3 * 3600 * 1000);
+        manager.recordActivity("Flashcard reviews");
+        QCOMPARE(manager.count(), 1);
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 1);
+
+        clock.advanceDays(1);
+        manager.recordActivity("Flashcard reviews");
+        QCOMPARE(manager.data(index, streaksManager::StreakDurationRole).toInt(), 2);
+        QCOMPARE(checkinSpy.count(), 2);
+    }
+
+    Clock::setInstance(nullptr);
+}
+
 QTEST_MAIN(TeststreaksManager)
 #include "test_streaksManager.moc"
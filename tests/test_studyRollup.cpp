@@ -0,0 +1,179 @@
+#include <QtTest/QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/pomodoro/pomodorotimer.h"
+#include "../src/core/pomodoro/sessionlog.h"
+#include "../src/core/stats/studyrollup.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestStudyRollup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testIsoWeekKeys();
+    void testIncrementalMatchesRebuild();
+    void testRetractedCompletion();
+    void testSessionAcrossMidnightCountsOnce();
+    void testYearIsAFewHundredRows();
+
+private:
+    void addWorkSession(StudyRollup &rollup, const QDateTime &start, int minutes, const QString &reason);
+};
+
+void TestStudyRollup::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_rollup.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createStreaksTable());
+    QVERIFY(dbManager.createSessionsTable());
+    QVERIFY(dbManager.createRollupTables());
+
+    QSqlQuery pragma;
+    pragma.exec("PRAGMA synchronous = OFF");
+}
+
+void TestStudyRollup::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_rollup.db");
+}
+
+void TestStudyRollup::init()
+{
+    QSqlQuery query;
+    const QStringList tables = {"pomodoro_sessions", "todo_completions", "streak_checkins",
+                                "study_rollup_daily", "study_rollup_weekly"};
+    for (const QString &table : tables) {
+        query.exec("DELETE FROM " + table);
+    }
+}
+
+void TestStudyRollup::addWorkSession(StudyRollup &rollup, const QDateTime &start, int minutes, const QString &reason)
+{
+    const qint64 ms = qint64(minutes) * 60000;
+    QVERIFY(DatabaseManager::instance().insertPomodoroSession("work", start, ms, 25 * 60, reason));
+    rollup.recordFocus("work", start, ms, reason);
+}
+
+void TestStudyRollup::testIsoWeekKeys()
+{
+    QCOMPARE(StudyRollup::weekKey(QDate(2025, 2, 12)), QString("2025-W07"));
+    QCOMPARE(StudyRollup::weekKey(QDate(2024, 12, 30)), QString("2025-W01"));
+    QCOMPARE(StudyRollup::weekKey(QDate(2021, 1, 3)), QString("2020-W53"));
+}
+
+void TestStudyRollup::testIncrementalMatchesRebuild()
+{
+    StudyRollup rollup;
+    DatabaseManager &db = DatabaseManager::instance();
+    const QDate monday(2025, 3, 3);
+
+    addWorkSession(rollup, QDateTime(monday, QTime(9, 0)), 25, "completed");
+    addWorkSession(rollup, QDateTime(monday, QTime(10, 0)), 12, "stopped");
+    addWorkSession(rollup, QDateTime(monday.addDays(2), QTime(9, 0)), 25, "completed");
+    rollup.recordFocus("break", QDateTime(monday, QTime(9, 25)), 5 * 60000, "completed");
+
+    QVERIFY(db.recordTodoCompletion(1, QDateTime(monday, QTime(11, 0))));
+    rollup.recordTodoCompletion(monday, 1);
+
+    for (int streakId = 1; streakId <= 3; streakId++) {
+        QVERIFY(db.recordStreakCheckin(streakId, monday.addDays(1)));
+        rollup.recordHabitCheckin(streakId, monday.addDays(1));
+    }
+
+    const QVariantMap day = rollup.daySummary(monday);
+    QCOMPARE(day["focusMinutes"].toInt(), 37);
+    QCOMPARE(day["sessions"].toInt(), 1);
+    QCOMPARE(day["todosCompleted"].toInt(), 1);
+    QCOMPARE(rollup.daySummary(monday.addDays(1))["habitsChecked"].toInt(), 3);
+
+    const QVariantList daily = rollup.dailySummaries(monday, monday.addDays(6));
+    const QVariantList weekly = rollup.weeklySummaries(monday, monday.addDays(6));
+    QCOMPARE(daily.size(), 3);
+    QCOMPARE(weekly.size(), 1);
+    QCOMPARE(weekly.first().toMap()["focusMinutes"].toInt(), 62);
+
+    QVERIFY(rollup.rebuild());
+    QCOMPARE(rollup.dailySummaries(monday, monday.addDays(6)), daily);
+    QCOMPARE(rollup.weeklySummaries(monday, monday.addDays(6)), weekly);
+}
+
+void TestStudyRollup::testRetractedCompletion()
+{
+    StudyRollup rollup;
+    DatabaseManager &db = DatabaseManager::instance();
+    const QDate day(2025, 5, 1);
+
+    QVERIFY(db.recordTodoCompletion(7, QDateTime(day, QTime(8, 0))));
+    rollup.recordTodoCompletion(day, 1);
+    QCOMPARE(db.removeTodoCompletion(7), day);
+    rollup.recordTodoCompletion(day, -1);
+
+    QCOMPARE(rollup.daySummary(day)["todosCompleted"].toInt(), 0);
+    QVERIFY(rollup.rebuild());
+    QCOMPARE(rollup.daySummary(day)["todosCompleted"].toInt(), 0);
+}
+
+void TestStudyRollup::testSessionAcrossMidnightCountsOnce()
+{
+    const QDate day(2025, 3, 4);
+    VirtualClock clock(QDateTime(day, QTime(23, 50)));
+    Clock::setInstance(&clock);
+
+    {
+        StudyRollup rollup;
+        PomodoroTimer timer;
+        SessionLog log(&timer);
+        connect(&log, &SessionLog::intervalLogged, &rollup, &StudyRollup::recordFocus);
+
+        // 25 minutes of focus: ten before midnight, fifteen after
+        timer.startSession(25 * 60, 5 * 60);
+        clock.advance(25 * 60 * 1000);
+        QCOMPARE(timer.currentState(), PomodoroTimer::OnBreak);
+
+        const QVariantMap before = rollup.daySummary(day);
+        const QVariantMap after = rollup.daySummary(day.addDays(1));
+        QCOMPARE(before["focusMinutes"].toInt(), 10);
+        QCOMPARE(after["focusMinutes"].toInt(), 15);
+        QCOMPARE(before["sessions"].toInt() + after["sessions"].toInt(), 1);
+        QCOMPARE(after["sessions"].toInt(), 1);
+
+        QVERIFY(rollup.rebuild());
+        QCOMPARE(rollup.daySummary(day)["sessions"].toInt(), 0);
+        QCOMPARE(rollup.daySummary(day.addDays(1))["sessions"].toInt(), 1);
+        timer.stop();
+    }
+
+    Clock::setInstance(nullptr);
+}
+
+void TestStudyRollup::testYearIsAFewHundredRows()
+{
+    StudyRollup rollup;
+    const QDate start(2025, 1, 1);
+
+    for (int i = 0; i < 365; i++) {
+        rollup.recordFocus("work", QDateTime(start.addDays(i), QTime(9, 0)), 25 * 60000, "completed");
+    }
+
+    const QDate end = start.addDays(364);
+    QCOMPARE(rollup.dailySummaries(start, end).size(), 365);
+    QVERIFY(rollup.weeklySummaries(start, end).size() <= 53);
+}
+
+QTEST_MAIN(TestStudyRollup)
+#include "test_studyRollup.moc"
@@ -0,0 +1,373 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include <QTemporaryDir>
+#include "../src/core/sync/syncengine.h"
+#include "../src/core/sync/synclog.h"
+#include "../src/core/sync/hybridlogicalclock.h"
+#include "../src/core/clock/clock.h"
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestSyncEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testExportsParentByUid();
+    void testAppliesRemoteSubtask();
+    void testRemoteDeleteRemovesSubtree();
+    void testExportsListMembership();
+    void testAppliesRemoteList();
+    void testRemoteListDeleteRemovesItsTodos();
+    void testSyncsRecurrence();
+    void testDirectoryFromFolderUrl();
+
+private:
+    int addTodo(const QString &title, int parentId = 0, int listId = 0) const;
+    int addList(const QString &name) const;
+    int listIdOf(const QString &uid) const;
+    QString uidOf(int id) const;
+    int idOf(const QString &uid) const;
+    QVariant column(int id, const QString &name) const;
+    QVector<SyncOp> exported(const SyncEngine &engine) const;
+    SyncOp peerOp(const QString &uid, const QString &field, const QJsonValue &value,
+                  const QString &entity = "todo");
+
+    VirtualClock *m_clock = nullptr;
+    QTemporaryDir *m_dir = nullptr;
+    HybridLogicalClock m_peerHlc{"peer"};
+};
+
+void TestSyncEngine::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_syncengine.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+    QVERIFY(dbManager.createStreaksTable());
+    QVERIFY(dbManager.createSyncTables());
+}
+
+void TestSyncEngine::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_syncengine.db");
+}
+
+void TestSyncEngine::init()
+{
+    m_clock = new VirtualClock(QDateTime(QDate(2025, 3, 3), QTime(9, 0)));
+    Clock::setInstance(m_clock);
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+
+    // Tombstones last: clearing todos queues one per row
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+    query.exec("DELETE FROM todo_lists WHERE uid IS NOT 'inbox'");
+    query.exec("DELETE FROM sync_fields");
+    query.exec("DELETE FROM sync_cursors");
+    query.exec("DELETE FROM sync_meta");
+    query.exec("DELETE FROM sync_tombstones");
+}
+
+void TestSyncEngine::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+int TestSyncEngine::addTodo(const QString &title, int parentId, int listId) const
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todos (title, parent_id, list_id) VALUES (:title, :parent_id, :list_id)");
+    query.bindValue(":title", title);
+    query.bindValue(":parent_id", parentId > 0 ? QVariant(parentId) : QVariant());
+    query.bindValue(":list_id", listId > 0 ? QVariant(listId) : QVariant());
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+int TestSyncEngine::addList(const QString &name) const
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todo_lists (name) VALUES (:name)");
+    query.bindValue(":name", name);
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+int TestSyncEngine::listIdOf(const QString &uid) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT id FROM todo_lists WHERE uid = :uid");
+    query.bindValue(":uid", uid);
+    return query.exec() && query.next() ? query.value(0).toInt() : -1;
+}
+
+QString TestSyncEngine::uidOf(int id) const
+{
+    return column(id, "uid").toString();
+}
+
+int TestSyncEngine::idOf(const QString &uid) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT id FROM todos WHERE uid = :uid");
+    query.bindValue(":uid", uid);
+    return query.exec() && query.next() ? query.value(0).toInt() : -1;
+}
+
+QVariant TestSyncEngine::column(int id, const QString &name) const
+{
+    QSqlQuery query;
+    query.prepare(QString("SELECT %1 FROM todos WHERE id = :id").arg(name));
+    query.bindValue(":id", id);
+    return query.exec() && query.next() ? query.value(0) : QVariant();
+}
+
+QVector<SyncOp> TestSyncEngine::exported(const SyncEngine &engine) const
+{
+    QVector<SyncOp> ops;
+    SyncLog log(m_dir->path(), engine.deviceId());
+    for (const QString &segment : log.segments(engine.deviceId())) {
+        qint64 offset = 0;
+        ops += SyncLog::readSegment(log.segmentPath(engine.deviceId(), segment), offset);
+    }
+    return ops;
+}
+
+SyncOp TestSyncEngine::peerOp(const QString &uid, const QString &field, const QJsonValue &value,
+                              const QString &entity)
+{
+    return {m_peerHlc.now(), entity, uid, field, value};
+}
+
+void TestSyncEngine::testExportsParentByUid()
+{
+    const int parent = addTodo("Revise optics");
+    const int child = addTodo("Lenses", parent);
+
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+
+    bool found = false;
+    for (const SyncOp &op : exported(engine)) {
+        QVERIFY(op.field != "parent_id");
+        if (op.uid == uidOf(child) && op.field == "parent") {
+            QCOMPARE(op.value.toString(), uidOf(parent));
+            found = true;
+        }
+        if (op.uid == uidOf(parent) && op.field == "parent") {
+            QVERIFY(op.value.isNull());
+        }
+    }
+    QVERIFY(found);
+}
+
+void TestSyncEngine::testAppliesRemoteSubtask()
+{
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+
+    // The subtask's ops come first; its parent is created as it is referenced
+    SyncLog peer(m_dir->path(), "peer");
+    QVERIFY(peer.append({peerOp("c1", "title", "Lenses"),
+                         peerOp("c1", "parent", "p1"),
+                         peerOp("p1", "title", "Revise optics"),
+                         peerOp("p1", "parent", QJsonValue())}));
+    engine.syncNow();
+
+    const int parent = idOf("p1");
+    const int child = idOf("c1");
+    QVERIFY(parent > 0);
+    QVERIFY(child > 0);
+    QCOMPARE(column(parent, "title").toString(), QString("Revise optics"));
+    QCOMPARE(column(child, "parent_id").toInt(), parent);
+    QVERIFY(column(parent, "parent_id").isNull());
+
+    // Applied values are not echoed back as local edits
+    engine.syncNow();
+    for (const SyncOp &op : exported(engine)) {
+        QVERIFY(op.field != "parent" || (op.uid != "c1" && op.uid != "p1"));
+    }
+}
+
+void TestSyncEngine::testRemoteDeleteRemovesSubtree()
+{
+    const int parent = addTodo("Revise optics");
+    const int child = addTodo("Lenses", parent);
+    const int grandchild = addTodo("Focal length", child);
+    const QString parentUid = uidOf(parent);
+
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+    QSignalSpy changed(&engine, &SyncEngine::todosChanged);
+
+    SyncLog peer(m_dir->path(), "peer");
+    QVERIFY(peer.append({peerOp(parentUid, "_deleted", true)}));
+    engine.syncNow();
+
+    QCOMPARE(idOf(parentUid), -1);
+    QVERIFY(!column(child, "id").isValid());
+    QVERIFY(!column(grandchild, "id").isValid());
+
+    QCOMPARE(changed.count(), 1);
+    QVector<int> ids = changed.first().first().value<QVector<int>>();
+    std::sort(ids.begin(), ids.end());
+    QCOMPARE(ids, QVector<int>({parent, child, grandchild}));
+}
+
+void TestSyncEngine::testExportsListMembership()
+{
+    const int physics = addList("Physics");
+    const int inTodo = addTodo("Lab report", 0, physics);
+    const int inboxTodo = addTodo("Groceries");
+
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+
+    QSqlQuery query;
+    query.prepare("SELECT uid FROM todo_lists WHERE id = :id");
+    query.bindValue(":id", physics);
+    QVERIFY(query.exec() && query.next());
+    const QString physicsUid = query.value(0).toString();
+
+    QHash<QString, QJsonValue> lists;
+    QHash<QString, QJsonValue> names;
+    for (const SyncOp &op : exported(engine)) {
+        if (op.entity == "todo" && op.field == "list") {
+            lists.insert(op.uid, op.value);
+        } else if (op.entity == "todo_list" && op.field == "name") {
+            names.insert(op.uid, op.value);
+        }
+    }
+    QCOMPARE(lists.value(uidOf(inTodo)).toString(), physicsUid);
+    // The default list has the same uid on every device
+    QCOMPARE(lists.value(uidOf(inboxTodo)).toString(), QString("inbox"));
+    QCOMPARE(names.value(physicsUid).toString(), QString("Physics"));
+}
+
+void TestSyncEngine::testAppliesRemoteList()
+{
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+    QSignalSpy listsChanged(&engine, &SyncEngine::todoListsChanged);
+
+    SyncLog peer(m_dir->path(), "peer");
+    QVERIFY(peer.append({peerOp("t1", "title", "Titration"),
+                         peerOp("t1", "list", "l1"),
+                         peerOp("l1", "name", "Chemistry", "todo_list"),
+                         peerOp("t2", "title", "Groceries"),
+                         peerOp("t2", "list", "inbox")}));
+    engine.syncNow();
+
+    const int chemistry = listIdOf("l1");
+    QVERIFY(chemistry > 0);
+    QCOMPARE(column(idOf("t1"), "list_id").toInt(), chemistry);
+    QCOMPARE(column(idOf("t2"), "list_id").toInt(), listIdOf("inbox"));
+    QCOMPARE(listsChanged.count(), 1);
+
+    QSqlQuery query;
+    query.prepare("SELECT name FROM todo_lists WHERE id = :id");
+    query.bindValue(":id", chemistry);
+    QVERIFY(query.exec() && query.next());
+    QCOMPARE(query.value(0).toString(), QString("Chemistry"));
+}
+
+void TestSyncEngine::testRemoteListDeleteRemovesItsTodos()
+{
+    const int physics = addList("Physics");
+    const int parent = addTodo("Lab report", 0, physics);
+    const int child = addTodo("Plot data", parent, physics);
+    const int kept = addTodo("Groceries");
+
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+
+    QSqlQuery query;
+    query.prepare("SELECT uid FROM todo_lists WHERE id = :id");
+    query.bindValue(":id", physics);
+    QVERIFY(query.exec() && query.next());
+    const QString physicsUid = query.value(0).toString();
+
+    SyncLog peer(m_dir->path(), "peer");
+    QVERIFY(peer.append({peerOp(physicsUid, "_deleted", true, "todo_list")}));
+    engine.syncNow();
+
+    QCOMPARE(listIdOf(physicsUid), -1);
+    QVERIFY(!column(parent, "id").isValid());
+    QVERIFY(!column(child, "id").isValid());
+    QCOMPARE(column(kept, "id").toInt(), kept);
+}
+
+void TestSyncEngine::testSyncsRecurrence()
+{
+    const int local = addTodo("Weekly quiz");
+    QSqlQuery query;
+    query.prepare("UPDATE todos SET recurrence = '1w', recurrence_start = '2025-03-03T09:00:00' WHERE id = :id");
+    query.bindValue(":id", local);
+    QVERIFY(query.exec());
+
+    SyncEngine engine;
+    engine.setSyncDirectory(m_dir->path());
+
+    QHash<QString, QJsonValue> fields;
+    for (const SyncOp &op : exported(engine)) {
+        if (op.uid == uidOf(local)) {
+            fields.insert(op.field, op.value);
+        }
+    }
+    QCOMPARE(fields.value("recurrence").toString(), QString("1w"));
+    QCOMPARE(fields.value("recurrence_start").toString(), QString("2025-03-03T09:00:00"));
+
+    // A repeating todo from elsewhere keeps its rule
+    SyncLog peer(m_dir->path(), "peer");
+    QVERIFY(peer.append({peerOp("r1", "title", "Flashcards"),
+                         peerOp("r1", "recurrence", "1d"),
+                         peerOp("r1", "recurrence_start", "2025-03-04T08:00:00")}));
+    engine.syncNow();
+
+    const int remote = idOf("r1");
+    QCOMPARE(column(remote, "recurrence").toString(), QString("1d"));
+    QCOMPARE(column(remote, "recurrence_start").toDateTime(), QDateTime(QDate(2025, 3, 4), QTime(8, 0)));
+}
+
+void TestSyncEngine::testDirectoryFromFolderUrl()
+{
+    SyncEngine engine;
+    QSignalSpy changed(&engine, &SyncEngine::syncDirectoryChanged);
+
+    // Dialog URLs become native paths (file:///C:/... is C:/... on Windows)
+    engine.setSyncDirectoryUrl(QUrl::fromLocalFile(m_dir->path()));
+    QCOMPARE(engine.syncDirectory(), m_dir->path());
+    QCOMPARE(changed.count(), 1);
+
+    engine.setSyncDirectoryUrl(QUrl("https://example.com/shared"));
+    QCOMPARE(engine.syncDirectory(), m_dir->path());
+    QCOMPARE(changed.count(), 1);
+}
+
+QTEST_MAIN(TestSyncEngine)
+#include "test_syncEngine.moc"
@@ -0,0 +1,203 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QFile>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/sync/hybridlogicalclock.h"
+#include "../src/core/sync/synclog.h"
+
+class TestSyncLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testHlcOrderingWithinMillisecond();
+    void testHlcReceiveOrdersAfterRemote();
+    void testHlcStringRoundTrip();
+    void testIncrementalSegmentRead();
+    void testPartialLineNotConsumed();
+    void testCompactionKeepsLatestPerField();
+
+private:
+    VirtualClock *m_clock = nullptr;
+
+    SyncOp makeOp(HybridLogicalClock &hlc, const QString &uid, const QString &field, const QJsonValue &value);
+    void writeSegment(const QString &path, const QVector<SyncOp> &ops);
+};
+
+void TestSyncLog::init()
+{
+    m_clock = new VirtualClock();
+    Clock::setInstance(m_clock);
+}
+
+void TestSyncLog::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+SyncOp TestSyncLog::makeOp(HybridLogicalClock &hlc, const QString &uid, const QString &field, const QJsonValue &value)
+{
+    return {hlc.now(), "todo", uid, field, value};
+}
+
+void TestSyncLog::writeSegment(const QString &path, const QVector<SyncOp> &ops)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    for (const SyncOp &op : ops) {
+        file.write(QJsonDocument(op.toJson()).toJson(QJsonDocument::Compact) + '\n');
+    }
+}
+
+void TestSyncLog::testHlcOrderingWithinMillisecond()
+{
+    HybridLogicalClock hlc("a");
+
+    HlcTimestamp first = hlc.now();
+    HlcTimestamp second = hlc.now();   // same virtual millisecond
+    QCOMPARE(first.wallMs, second.wallMs);
+    QVERIFY(first < second);
+
+    m_clock->advance(5);
+    HlcTimestamp third = hlc.now();
+    QVERIFY(second < third);
+    QCOMPARE(third.counter, 0u);
+}
+
+void TestSyncLog::testHlcReceiveOrdersAfterRemote()
+{
+    HybridLogicalClock local("a");
+    HlcTimestamp remote;
+    remote.wallMs = m_clock->now().toMSecsSinceEpoch() + 60000;   // remote clock runs fast
+    remote.counter = 3;
+    remote.node = "b";
+
+    local.receive(remote);
+    HlcTimestamp next = local.now();
+    QVERIFY(remote < next);
+}
+
+void TestSyncLog::testHlcStringRoundTrip()
+{
+    HybridLogicalClock hlc("3f2a-device");
+    HlcTimestamp early = hlc.now();
+    m_clock->advance(1);
+    HlcTimestamp late = hlc.now();
+
+    QCOMPARE(HlcTimestamp::fromString(early.toString()), early);
+    QVERIFY(early.toString() < late.toString());
+
+    // Counter ordering must survive string comparison too
+    HlcTimestamp bumped = early;
+    bumped.counter = 0x10;
+    QVERIFY(early.toString() < bumped.toString());
+}
+
+void TestSyncLog::testIncrementalSegmentRead()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    HybridLogicalClock hlc("a");
+    SyncLog writer(dir.path(), "a");
+    SyncLog reader(dir.path(), "b");
+
+    QVERIFY(writer.append({makeOp(hlc, "u1", "title", "Read"), makeOp(hlc, "u1", "priority", 2)}));
+    QCOMPARE(reader.remoteDevices(), QStringList{"a"});
+
+    const QString path = reader.segmentPath("a", reader.segments("a").first());
+    qint64 offset = 0;
+    QVector<SyncOp> ops = SyncLog::readSegment(path, offset);
+    QCOMPARE(ops.size(), 2);
+    QCOMPARE(ops.at(0).field, QString("title"));
+    QCOMPARE(ops.at(1).value.toInt(), 2);
+
+    QVERIFY(writer.append({makeOp(hlc, "u1", "completed", true)}));
+    ops = SyncLog::readSegment(path, offset);
+    QCOMPARE(ops.size(), 1);
+    QCOMPARE(ops.first().field, QString("completed"));
+    QCOMPARE(offset, QFileInfo(path).size());
+
+    // Nothing new: nothing read
+    QVERIFY(SyncLog::readSegment(path, offset).isEmpty());
+}
+
+void TestSyncLog::testPartialLineNotConsumed()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("a"));
+
+    HybridLogicalClock hlc("a");
+    const QByteArray line = QJsonDocument(makeOp(hlc, "u1", "title", "Draft").toJson())
+                                .toJson(QJsonDocument::Compact);
+    const QString path = dir.path() + "/a/000001.jsonl";
+
+    // A sync tool has delivered only half of the line so far
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(line.left(line.size() / 2));
+    file.flush();
+
+    qint64 offset = 0;
+    QVERIFY(SyncLog::readSegment(path, offset).isEmpty());
+    QCOMPARE(offset, qint64(0));
+
+    file.write(line.mid(line.size() / 2) + '\n');
+    file.flush();
+
+    QVector<SyncOp> ops = SyncLog::readSegment(path, offset);
+    QCOMPARE(ops.size(), 1);
+    QCOMPARE(ops.first().value.toString(), QString("Draft"));
+}
+
+void TestSyncLog::testCompactionKeepsLatestPerField()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("a"));
+
+    HybridLogicalClock hlc("a");
+    for (int segment = 1; segment <= 4; segment++) {
+        m_clock->advance(1000);
+        writeSegment(QString("%1/a/%2.jsonl").arg(dir.path()).arg(segment, 6, 10, QChar('0')),
+                     {makeOp(hlc, "u1", "title", QString("v%1").arg(segment)),
+                      makeOp(hlc, QString("u%1").arg(segment + 1), "title", "other")});
+    }
+
+    SyncLog log(dir.path(), "a");
+    QCOMPARE(log.compact(8), 0);   // under the limit: untouched
+    QCOMPARE(log.compact(2), 4);
+
+    const QStringList segments = log.segments("a");
+    QCOMPARE(segments, QStringList{"000005.jsonl"});
+
+    qint64 offset = 0;
+    const QVector<SyncOp> ops = SyncLog::readSegment(log.segmentPath("a", segments.first()), offset);
+    QCOMPARE(ops.size(), 5);   // u1.title once, plus u2..u5
+
+    int u1Count = 0;
+    for (const SyncOp &op : ops) {
+        if (op.uid == "u1") {
+            u1Count++;
+            QCOMPARE(op.value.toString(), QString("v4"));
+        }
+    }
+    QCOMPARE(u1Count, 1);
+
+    // Compacted output stays in HLC order
+    for (int i = 1; i < ops.size(); i++) {
+        QVERIFY(ops.at(i - 1).hlc < ops.at(i).hlc);
+    }
+}
+
+QTEST_MAIN(TestSyncLog)
+#include "test_syncLog.moc"
@@ -0,0 +1,214 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <algorithm>
+#include "../src/core/tags/tagindex.h"
+
+class TestTagIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParse();
+    void testParseToleratesHalfTypedQueries();
+    void testSelect();
+    void testRemoveMovesLastItem();
+    void testHundredsOfTags();
+    void testHundredThousandItems();
+
+private:
+    QHash<QString, int> bits() const;
+    QList<quint64> sorted(const QVector<quint64> &keys) const;
+    QList<TagQuery::Op> ops(const TagQuery &query) const;
+};
+
+QHash<QString, int> TestTagIndex::bits() const
+{
+    QHash<QString, int> bits;
+    bits.insert("done", 0);
+    bits.insert("math", 1);
+    bits.insert("physics", 2);
+    bits.insert("exam prep", 3);
+    return bits;
+}
+
+QList<quint64> TestTagIndex::sorted(const QVector<quint64> &keys) const
+{
+    QList<quint64> list(keys.cbegin(), keys.cend());
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+QList<TagQuery::Op> TestTagIndex::ops(const TagQuery &query) const
+{
+    QList<TagQuery::Op> list;
+    for (const TagQuery::Step &step : query.steps()) {
+        list << step.op;
+    }
+    return list;
+}
+
+void TestTagIndex::testParse()
+{
+    const TagQuery query = TagQuery::parse("Math AND NOT done", bits());
+    QCOMPARE(ops(query), (QList<TagQuery::Op>() << TagQuery::Tag << TagQuery::Tag
+                                                << TagQuery::Not << TagQuery::And));
+    QCOMPARE(query.steps().at(0).bit, 1);
+    QCOMPARE(query.steps().at(1).bit, 0);
+
+    // AND binds tighter than OR; juxtaposition is AND
+    QCOMPARE(ops(TagQuery::parse("math | physics & done", bits())),
+             (QList<TagQuery::Op>() << TagQuery::Tag << TagQuery::Tag << TagQuery::Tag
+                                    << TagQuery::And << TagQuery::Or));
+    QCOMPARE(ops(TagQuery::parse("(math or physics) !done", bits())),
+             (QList<TagQuery::Op>() << TagQuery::Tag << TagQuery::Tag << TagQuery::Or
+                                    << TagQuery::Tag << TagQuery::Not << TagQuery::And));
+
+    const TagQuery quoted = TagQuery::parse("\"Exam Prep\" and chemistry", bits());
+    QCOMPARE(ops(quoted), (QList<TagQuery::Op>() << TagQuery::Tag << TagQuery::NoTag << TagQuery::And));
+    QCOMPARE(quoted.steps().at(0).bit, 3);
+
+    QVERIFY(TagQuery::parse("   ", bits()).isEmpty());
+}
+
+void TestTagIndex::testParseToleratesHalfTypedQueries()
+{
+    QCOMPARE(ops(TagQuery::parse("math AND", bits())), QList<TagQuery::Op>() << TagQuery::Tag);
+    QCOMPARE(ops(TagQuery::parse("math AND NOT", bits())), QList<TagQuery::Op>() << TagQuery::Tag);
+    QCOMPARE(ops(TagQuery::parse("(math OR phys", bits())),
+             (QList<TagQuery::Op>() << TagQuery::Tag << TagQuery::NoTag << TagQuery::Or));
+    QCOMPARE(ops(TagQuery::parse(") OR math )", bits())), QList<TagQuery::Op>() << TagQuery::Tag);
+    QVERIFY(TagQuery::parse("NOT (", bits()).isEmpty());
+}
+
+void TestTagIndex::testSelect()
+{
+    TagIndex index;
+    for (quint64 key = 1; key <= 5; key++) {
+        index.insert(key);
+    }
+    index.setTag(1, 1);             // math
+    index.setTag(2, 1);             // math, done
+    index.setTag(2, 0);
+    index.setTag(3, 2);             // physics
+    index.setTag(4, 2);             // physics, done
+    index.setTag(4, 0);
+    // 5 has no tags
+
+    auto select = [&index, this](const QString &text) {
+        return sorted(index.select(TagQuery::parse(text, bits())).keys());
+    };
+
+    QCOMPARE(select("math AND NOT done"), QList<quint64>() << 1);
+    QCOMPARE(select("NOT math"), QList<quint64>() << 3 << 4 << 5);
+    QCOMPARE(select("math OR physics"), QList<quint64>() << 1 << 2 << 3 << 4);
+    QCOMPARE(select("!(math | physics)"), QList<quint64>() << 5);
+    QCOMPARE(select("chemistry"), QList<quint64>());
+    QCOMPARE(select("NOT chemistry"), QList<quint64>() << 1 << 2 << 3 << 4 << 5);
+
+    const TagIndex::Selection all = index.select(TagQuery());
+    QVERIFY(all.matchesAll());
+    QVERIFY(all.contains(42));
+
+    const TagIndex::Selection open = index.select(TagQuery::parse("NOT done", bits()));
+    QCOMPARE(open.count(), 3);
+    QVERIFY(open.contains(5));
+    QVERIFY(!open.contains(2));
+    QVERIFY(!open.contains(42));
+
+    index.setTag(1, 1, false);
+    QVERIFY(!index.hasTag(1, 1));
+    QCOMPARE(index.countWithTag(1), 1);
+    QCOMPARE(select("math"), QList<quint64>() << 2);
+}
+
+void TestTagIndex::testRemoveMovesLastItem()
+{
+    TagIndex index;
+    for (quint64 key = 0; key < 130; key++) {
+        index.insert(key);
+        index.setTag(key, int(key % 3));
+    }
+
+    // Key 129 moves into 10's slot; the column loses a word when we cross 128
+    index.remove(10);
+    index.remove(11);
+    index.remove(200);
+    QCOMPARE(index.size(), 128);
+    QVERIFY(!index.contains(10));
+    QCOMPARE(index.tags(129), QVector<int>() << 0);
+    QCOMPARE(index.tags(128), QVector<int>() << 2);
+
+    const QVector<quint64> zeros = index.select(TagQuery::parse("done", bits())).keys();
+    QCOMPARE(zeros.size(), 44);
+    QVERIFY(zeros.contains(129));
+    QVERIFY(!zeros.contains(10));
+    QCOMPARE(index.countWithTag(1), 42);
+    QCOMPARE(index.countWithTag(2), 42);
+
+    index.clearTag(0);
+    QCOMPARE(index.countWithTag(0), 0);
+    QVERIFY(index.tags(129).isEmpty());
+}
+
+void TestTagIndex::testHundredsOfTags()
+{
+    TagIndex index;
+    index.insert(7);
+    index.insert(8);
+    index.setTag(7, 3);
+    index.setTag(8, 299);
+    index.setTag(7, 130);
+
+    QCOMPARE(index.tags(7), QVector<int>() << 3 << 130);
+    QCOMPARE(index.tags(8), QVector<int>() << 299);
+    QVERIFY(index.hasTag(8, 299));
+    QVERIFY(!index.hasTag(8, 500));
+
+    QHash<QString, int> names;
+    names.insert("t130", 130);
+    names.insert("t299", 299);
+    QCOMPARE(sorted(index.select(TagQuery::parse("t130 OR t299", names)).keys()),
+             QList<quint64>() << 7 << 8);
+}
+
+void TestTagIndex::testHundredThousandItems()
+{
+    const int items = 100000;
+    const int tagCount = 300;
+
+    TagIndex index;
+    QHash<QString, int> names;
+    names.insert("done", 0);
+    for (int bit = 1; bit < tagCount; bit++) {
+        names.insert(QString("t%1").arg(bit), bit);
+    }
+    for (int i = 0; i < items; i++) {
+        index.insert(quint64(i));
+        index.setTag(quint64(i), 1 + i % (tagCount - 1));
+        index.setTag(quint64(i), 1 + (i / 7) % (tagCount - 1));
+        if (i % 2 == 0) {
+            index.setTag(quint64(i), 0);
+        }
+    }
+
+    const QStringList queries = {"t", "t7", "t7 AND", "t7 AND NOT", "t7 AND NOT done",
+                                 "t7 AND NOT done OR t12", "t7 AND NOT done OR t12 t13"};
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    int matched = 0;
+    for (const QString &query : queries) {
+        matched = index.select(TagQuery::parse(query, names)).count();
+    }
+    const qint64 ms = elapsed.elapsed();
+
+    QVERIFY(matched > 0);
+    QCOMPARE(index.select(TagQuery::parse("t7 AND NOT done", names)).count()
+                 + index.select(TagQuery::parse("t7 AND done", names)).count(),
+             index.countWithTag(7));
+    // A query per keystroke, all of them inside one frame
+    QVERIFY2(ms < 16, qPrintable(QString::number(ms)));
+}
+
+QTEST_MAIN(TestTagIndex)
+#include "test_tagIndex.moc"
@@ -0,0 +1,131 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include "../src/core/clock/virtualclock.h"
+#include "../src/core/timers/timerscheduler.h"
+#include "../src/core/timers/timerlistmodel.h"
+
+class TestTimerScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testTimersShareOneTick();
+    void testCountdownsExpireOnTheirDeadlines();
+    void testPausedTimerKeepsItsTime();
+    void testModelReportsRowChanges();
+
+private:
+    VirtualClock *m_clock = nullptr;
+};
+
+void TestTimerScheduler::init()
+{
+    m_clock = new VirtualClock();
+    Clock::setInstance(m_clock);
+}
+
+void TestTimerScheduler::cleanup()
+{
+    Clock::setInstance(nullptr);
+    delete m_clock;
+    m_clock = nullptr;
+}
+
+void TestTimerScheduler::testTimersShareOneTick()
+{
+    TimerListModel model;
+    model.addStopwatch("Lab");
+    model.addStopwatch("Reading");
+    model.addStopwatch("Maths");
+
+    // Started at staggered sub-second offsets
+    model.start(0);
+    m_clock->advance(300);
+    model.start(1);
+    m_clock->advance(300);
+    model.start(2);
+
+    m_clock->advance(60 * 1000);
+
+    // One wakeup per second for all three, not one each
+    QVERIFY(model.scheduler()->wakeups() <= 61);
+    QCOMPARE(model.timerAt(0)->seconds(), 60);
+    QCOMPARE(model.timerAt(2)->elapsedMs(), qint64(60 * 1000));
+}
+
+void TestTimerScheduler::testCountdownsExpireOnTheirDeadlines()
+{
+    TimerListModel model;
+    model.addCountdown("Tea", 3);
+    model.addCountdown("Focus", 10);
+    QSignalSpy finished(&model, &TimerListModel::timerFinished);
+    QList<int> counts;
+    connect(&model, &TimerListModel::runningCountChanged, this,
+            [&model, &counts]() { counts.append(model.runningCount()); });
+
+    model.start(0);
+    // The count is already up to date when the signal arrives
+    QCOMPARE(counts, QList<int>({1}));
+    m_clock->advance(450);
+    model.start(1);
+    QCOMPARE(counts, QList<int>({1, 2}));
+
+    m_clock->advance(3000 - 450 - 1);
+    QCOMPARE(finished.count(), 0);
+    m_clock->advance(1);
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.first().at(1).toString(), QString("Tea"));
+    QCOMPARE(model.timerAt(0)->state(), NamedTimer::Finished);
+
+    m_clock->advance(10450 - 3000 - 1);
+    QCOMPARE(model.timerAt(1)->state(), NamedTimer::Running);
+    m_clock->advance(1);
+    QCOMPARE(model.timerAt(1)->state(), NamedTimer::Finished);
+    QCOMPARE(model.timerAt(1)->seconds(), 0);
+
+    QCOMPARE(model.runningCount(), 0);
+    QCOMPARE(m_clock->pendingTimers(), 0);
+}
+
+void TestTimerScheduler::testPausedTimerKeepsItsTime()
+{
+    TimerListModel model;
+    model.addCountdown("Essay", 60);
+
+    model.start(0);
+    m_clock->advance(12500);
+    model.pause(0);
+    m_clock->advance(10 * 60 * 1000);
+
+    QCOMPARE(model.timerAt(0)->remainingMs(), qint64(47500));
+    QCOMPARE(model.timerAt(0)->seconds(), 48);
+
+    model.start(0);
+    m_clock->advance(47500);
+    QCOMPARE(model.timerAt(0)->state(), NamedTimer::Finished);
+}
+
+void TestTimerScheduler::testModelReportsRowChanges()
+{
+    TimerListModel model;
+    model.addStopwatch("A");
+    model.addStopwatch("B");
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    model.start(1);
+    m_clock->advance(2000);
+
+    QVERIFY(changed.count() > 0);
+    for (const QList<QVariant> &args : changed) {
+        QCOMPARE(args.at(0).toModelIndex().row(), 1);
+    }
+    QCOMPARE(model.data(model.index(1), TimerListModel::SecondsRole).toInt(), 2);
+    QCOMPARE(model.data(model.index(0), TimerListModel::SecondsRole).toInt(), 0);
+}
+
+QTEST_MAIN(TestTimerScheduler)
+#include "test_timerScheduler.moc"
@@ -0,0 +1,121 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QMap>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "../src/core/reminders/timerwheel.h"
+
+class TestTimerWheel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testExpiresInDeadlineOrder();
+    void testCancelAndReinsert();
+    void testFarDeadlinesCascade();
+    void testPastDeadlineDueImmediately();
+    void testMatchesNaiveScheduler();
+};
+
+void TestTimerWheel::testExpiresInDeadlineOrder()
+{
+    TimerWheel wheel(0);
+    wheel.insert(1, 5000);
+    wheel.insert(2, 2000);
+    wheel.insert(3, 90000);
+
+    QVERIFY(wheel.advance(1999).isEmpty());
+    QCOMPARE(wheel.advance(6000), QVector<quint64>({2, 1}));
+    QCOMPARE(wheel.size(), 1);
+    QCOMPARE(wheel.advance(100000), QVector<quint64>({3}));
+    QCOMPARE(wheel.nextWakeMs(), qint64(-1));
+}
+
+void TestTimerWheel::testCancelAndReinsert()
+{
+    TimerWheel wheel(0);
+    wheel.insert(7, 10000);
+    QVERIFY(wheel.cancel(7));
+    QVERIFY(!wheel.cancel(7));
+    QVERIFY(!wheel.contains(7));
+
+    // Inserting an existing key moves it
+    wheel.insert(8, 10000);
+    wheel.insert(8, 40000);
+    QCOMPARE(wheel.size(), 1);
+    QVERIFY(wheel.advance(20000).isEmpty());
+    QCOMPARE(wheel.advance(40000), QVector<quint64>({8}));
+}
+
+void TestTimerWheel::testFarDeadlinesCascade()
+{
+    const qint64 start = QDateTime(QDate(2025, 1, 1), QTime(9, 0)).toMSecsSinceEpoch();
+    const qint64 day = 24 * 3600 * 1000;
+    TimerWheel wheel(start);
+    wheel.insert(1, start + 200 * day + 1234);
+    wheel.insert(2, start + 3 * day);
+
+    // Wakeups are cascade points, never past the earliest deadline
+    const qint64 wake = wheel.nextWakeMs();
+    QVERIFY(wake > start);
+    QVERIFY(wake <= start + 3 * day);
+
+    QCOMPARE(wheel.advance(start + 3 * day), QVector<quint64>({2}));
+    QVERIFY(wheel.advance(start + 200 * day + 1000).isEmpty());
+    QCOMPARE(wheel.advance(start + 200 * day + 2000), QVector<quint64>({1}));
+}
+
+void TestTimerWheel::testPastDeadlineDueImmediately()
+{
+    TimerWheel wheel(60000);
+    wheel.insert(4, 1000);
+    QCOMPARE(wheel.nextWakeMs(), qint64(60000));
+    QCOMPARE(wheel.advance(60000), QVector<quint64>({4}));
+}
+
+void TestTimerWheel::testMatchesNaiveScheduler()
+{
+    QRandomGenerator random(3);
+    qint64 now = 1700000000000;
+    TimerWheel wheel(now);
+    QMap<quint64, qint64> naive;
+
+    const QList<qint64> spans = {2000, 120000, 86400000, 86400000LL * 400};
+    const QList<qint64> steps = {1000, 30000, 3600000, 86400000LL * 30};
+
+    for (int step = 0; step < 5000; step++) {
+        const int action = random.bounded(10);
+        if (action < 5) {
+            const quint64 key = random.bounded(500);
+            const qint64 deadline = now - 5000 + qint64(random.bounded(double(spans.at(random.bounded(4)))));
+            wheel.insert(key, deadline);
+            naive.insert(key, deadline);
+        } else if (action < 6) {
+            const quint64 key = random.bounded(500);
+            QCOMPARE(wheel.cancel(key), naive.remove(key) > 0);
+        } else {
+            now += steps.at(random.bounded(4));
+            const QVector<quint64> expired = wheel.advance(now);
+
+            // The wheel rounds deadlines up to whole ticks
+            QList<QPair<qint64, quint64>> expected;
+            for (auto it = naive.begin(); it != naive.end();) {
+                if ((it.value() + 999) / 1000 <= now / 1000) {
+                    expected.append({(it.value() + 999) / 1000, it.key()});
+                    it = naive.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+            QCOMPARE(expired.size(), expected.size());
+            for (int i = 0; i < expected.size(); i++) {
+                QCOMPARE(expired.at(i), expected.at(i).second);
+            }
+        }
+        QCOMPARE(wheel.size(), naive.size());
+    }
+}
+
+QTEST_MAIN(TestTimerWheel)
+#include "test_timerWheel.moc"
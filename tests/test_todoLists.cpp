@@ -0,0 +1,281 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include "../src/core/todo/todolistsmodel.h"
+#include "../src/core/todo/todomanager.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestTodoLists : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testUnlistedTodosGoToFirstList();
+    void testCountsWithoutLoading();
+    void testListModelsLoadOnDemand();
+    void testEditsReachTheOtherModels();
+    void testEvictsLeastRecentlyOpened();
+    void testMoveTodoToList();
+    void testDeleteList();
+
+private:
+    int inboxId() const;
+    int createList(const QString &name) const;
+    int addTodo(const QString &title, int listId, bool completed = false, int parentId = 0) const;
+    int todoCount() const;
+};
+
+void TestTodoLists::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_lists.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+    QVERIFY(dbManager.createRollupTables());
+}
+
+void TestTodoLists::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_lists.db");
+}
+
+void TestTodoLists::init()
+{
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+    query.exec("DELETE FROM todo_lists WHERE id <> (SELECT MIN(id) FROM todo_lists)");
+}
+
+int TestTodoLists::inboxId() const
+{
+    QSqlQuery query("SELECT MIN(id) FROM todo_lists");
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+int TestTodoLists::createList(const QString &name) const
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todo_lists (name) VALUES (:name)");
+    query.bindValue(":name", name);
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+int TestTodoLists::addTodo(const QString &title, int listId, bool completed, int parentId) const
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todos (title, list_id, completed, parent_id) "
+                  "VALUES (:title, :list_id, :completed, :parent_id)");
+    query.bindValue(":title", title);
+    query.bindValue(":list_id", listId > 0 ? QVariant(listId) : QVariant());
+    query.bindValue(":completed", completed);
+    query.bindValue(":parent_id", parentId > 0 ? QVariant(parentId) : QVariant());
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+int TestTodoLists::todoCount() const
+{
+    QSqlQuery query("SELECT COUNT(*) FROM todos");
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+void TestTodoLists::testUnlistedTodosGoToFirstList()
+{
+    const int id = addTodo("From an older build", 0);
+    QSqlQuery query;
+    query.prepare("SELECT list_id FROM todos WHERE id = :id");
+    query.bindValue(":id", id);
+    QVERIFY(query.exec() && query.next());
+    QCOMPARE(query.value(0).toInt(), inboxId());
+}
+
+void TestTodoLists::testCountsWithoutLoading()
+{
+    const int calculus = createList("Calculus");
+    addTodo("a", calculus);
+    addTodo("b", calculus, true);
+    addTodo("c", calculus);
+    const int parent = addTodo("d", inboxId());
+    addTodo("d.1", inboxId(), false, parent);       // subtasks are not counted
+
+    todoManager all;
+    TodoListsModel lists(&all);
+
+    QCOMPARE(lists.rowCount(), 2);
+    QCOMPARE(lists.openCount(calculus), 2);
+    QCOMPARE(lists.completedCount(calculus), 1);
+    QCOMPARE(lists.openCount(inboxId()), 1);
+    QCOMPARE(lists.loadedCount(), 0);
+    QVERIFY(!lists.isLoaded(calculus));
+
+    const QModelIndex row = lists.index(lists.rowForList(calculus), 0);
+    QCOMPARE(lists.data(row, TodoListsModel::NameRole).toString(), QString("Calculus"));
+    QCOMPARE(lists.data(row, TodoListsModel::OpenCountRole).toInt(), 2);
+}
+
+void TestTodoLists::testListModelsLoadOnDemand()
+{
+    const int physics = createList("Physics");
+    addTodo("Lab report", physics);
+    addTodo("Inbox item", inboxId());
+
+    todoManager all;
+    TodoListsModel lists(&all);
+    QCOMPARE(all.rowCount(), 2);
+
+    todoManager *model = lists.model(physics);
+    QVERIFY(model);
+    QVERIFY(lists.isLoaded(physics));
+    QCOMPARE(model->listId(), physics);
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->data(model->index(0, 0), todoManager::TitleRole).toString(), QString("Lab report"));
+    QCOMPARE(lists.model(physics), model);
+    QVERIFY(!lists.model(12345));
+
+    // Lazily loaded current list for the page
+    QCOMPARE(lists.currentListId(), inboxId());
+    QCOMPARE(lists.currentModel()->rowCount(), 1);
+    QCOMPARE(lists.loadedCount(), 2);
+
+    model->addTodo("Problem set");
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(all.rowCount(), 3);
+    QCOMPARE(lists.openCount(physics), 2);
+    QCOMPARE(lists.listOf(model->data(model->index(1, 0), todoManager::IdRole).toInt()), physics);
+}
+
+void TestTodoLists::testEditsReachTheOtherModels()
+{
+    const int physics = createList("Physics");
+    const int id = addTodo("Lab report", physics);
+
+    todoManager all;
+    TodoListsModel lists(&all);
+    todoManager *model = lists.model(physics);
+    QSignalSpy completions(&lists, &TodoListsModel::completionChanged);
+
+    model->markAsCompleted(0, true);
+    QCOMPARE(all.data(all.index(all.rowForId(id), 0), todoManager::CompletedRole).toBool(), true);
+    QCOMPARE(lists.openCount(physics), 0);
+    QCOMPARE(lists.completedCount(physics), 1);
+    QCOMPARE(completions.count(), 1);
+
+    // And back, e.g. from a smart view over every list
+    all.updateTodo(all.rowForId(id), "Lab report v2", "", QDateTime(), 2);
+    QCOMPARE(model->data(model->index(0, 0), todoManager::TitleRole).toString(), QString("Lab report v2"));
+
+    all.removeTodo(all.rowForId(id));
+    QCOMPARE(model->rowCount(), 0);
+    QCOMPARE(lists.completedCount(physics), 0);
+}
+
+void TestTodoLists::testEvictsLeastRecentlyOpened()
+{
+    const int a = createList("A");
+    const int b = createList("B");
+    const int c = createList("C");
+
+    todoManager all;
+    TodoListsModel lists(&all);
+    lists.setCapacity(2);
+
+    lists.model(a);
+    lists.model(b);
+    QCOMPARE(lists.loadedCount(), 2);
+
+    lists.model(c);
+    QCOMPARE(lists.loadedCount(), 2);
+    QVERIFY(!lists.isLoaded(a));
+    QVERIFY(lists.isLoaded(b));
+    QVERIFY(lists.isLoaded(c));
+
+    // Reopening makes it the most recent again
+    lists.model(b);
+    lists.model(a);
+    QVERIFY(!lists.isLoaded(c));
+
+    // The open list survives both eviction and memory pressure
+    lists.setCurrentListId(b);
+    lists.setCapacity(1);
+    QVERIFY(lists.isLoaded(b));
+    lists.model(c);
+    lists.releaseMemory();
+    QCOMPARE(lists.loadedCount(), 1);
+    QVERIFY(lists.isLoaded(b));
+}
+
+void TestTodoLists::testMoveTodoToList()
+{
+    const int physics = createList("Physics");
+    const int id = addTodo("Revise optics", inboxId());
+    const int child = addTodo("Lenses", inboxId(), false, id);
+    addTodo("Lab report", physics);
+
+    todoManager all;
+    TodoListsModel lists(&all);
+    todoManager *inbox = lists.model(inboxId());
+    todoManager *physicsModel = lists.model(physics);
+
+    QVERIFY(lists.moveTodoToList(id, physics));
+    QCOMPARE(lists.listOf(id), physics);
+    QCOMPARE(inbox->rowCount(), 0);
+    QCOMPARE(physicsModel->rowCount(), 2);
+    // Goes to the end of its new list
+    QCOMPARE(physicsModel->rowForId(id), 1);
+    QCOMPARE(all.rowCount(), 2);
+    QCOMPARE(lists.openCount(physics), 2);
+    QCOMPARE(lists.openCount(inboxId()), 0);
+
+    QSqlQuery query;
+    query.prepare("SELECT list_id FROM todos WHERE id = :id");
+    query.bindValue(":id", child);
+    QVERIFY(query.exec() && query.next());
+    QCOMPARE(query.value(0).toInt(), physics);
+
+    QVERIFY(!lists.moveTodoToList(child, inboxId()));
+    QVERIFY(!lists.moveTodoToList(id, 12345));
+}
+
+void TestTodoLists::testDeleteList()
+{
+    const int physics = createList("Physics");
+    const int id = addTodo("Revise optics", physics);
+    addTodo("Lenses", physics, false, id);
+    addTodo("Inbox item", inboxId());
+
+    todoManager all;
+    TodoListsModel lists(&all);
+    lists.setCurrentListId(physics);
+    QVERIFY(lists.currentModel());
+
+    QVERIFY(lists.deleteList(physics));
+    QCOMPARE(lists.rowCount(), 1);
+    QCOMPARE(todoCount(), 1);
+    QCOMPARE(all.rowCount(), 1);
+    QVERIFY(!lists.isLoaded(physics));
+    QCOMPARE(lists.currentListId(), inboxId());
+
+    // There is always somewhere to put a todo
+    QVERIFY(!lists.deleteList(inboxId()));
+}
+
+QTEST_MAIN(TestTodoLists)
+#include "test_todoLists.moc"
@@ -0,0 +1,192 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QElapsedTimer>
+#include <QFile>
+#include "../src/core/todo/todosearchmodel.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestTodoSearch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testMatchExpression();
+    void testPrefixMatchAndRanking();
+    void testIndexFollowsEdits();
+    void testHighlightIsEscaped();
+    void testSearchStaysInItsList();
+    void testHundredThousandTodos();
+
+private:
+    int addTodo(const QString &title, const QString &description);
+    QStringList titles(const TodoSearchModel &model) const;
+};
+
+void TestTodoSearch::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_search.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+    QVERIFY(dbManager.createSearchIndex());
+
+    QSqlQuery pragma;
+    pragma.exec("PRAGMA synchronous = OFF");
+}
+
+void TestTodoSearch::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_search.db");
+}
+
+void TestTodoSearch::init()
+{
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+}
+
+int TestTodoSearch::addTodo(const QString &title, const QString &description)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todos (title, description) VALUES (:title, :description)");
+    query.bindValue(":title", title);
+    query.bindValue(":description", description);
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+QStringList TestTodoSearch::titles(const TodoSearchModel &model) const
+{
+    QStringList list;
+    for (int row = 0; row < model.rowCount(); row++) {
+        list << model.data(model.index(row, 0), TodoSearchModel::TitleRole).toString();
+    }
+    return list;
+}
+
+void TestTodoSearch::testMatchExpression()
+{
+    QCOMPARE(TodoSearchModel::toMatchExpression("  lin alg "), QString("\"lin\"* \"alg\"*"));
+    // FTS5 syntax in user text is treated as plain words
+    QCOMPARE(TodoSearchModel::toMatchExpression("\"NEAR(a b)\" OR -c"), QString("\"NEAR\"* \"a\"* \"b\"* \"OR\"* \"c\"*"));
+    QVERIFY(TodoSearchModel::toMatchExpression(" ,; ").isEmpty());
+}
+
+void TestTodoSearch::testPrefixMatchAndRanking()
+{
+    addTodo("Read chapter 3", "Linear algebra revision");
+    addTodo("Linear algebra problem set", "Due Friday");
+    addTodo("Buy groceries", "");
+
+    TodoSearchModel model;
+    QSignalSpy countSpy(&model, &TodoSearchModel::countChanged);
+
+    model.setQuery("lin alg");
+    // Title matches outrank description matches
+    QCOMPARE(titles(model), QStringList({"Linear algebra problem set", "Read chapter 3"}));
+    QCOMPARE(countSpy.count(), 1);
+
+    model.setQuery("groc");
+    QCOMPARE(titles(model), QStringList({"Buy groceries"}));
+
+    model.setQuery("");
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TestTodoSearch::testIndexFollowsEdits()
+{
+    const int id = addTodo("Draft essay", "History of Rome");
+
+    TodoSearchModel model;
+    model.setQuery("rome");
+    QCOMPARE(model.rowCount(), 1);
+
+    QSqlQuery query;
+    QVERIFY(query.exec(QString("UPDATE todos SET description = 'History of Carthage' WHERE id = %1").arg(id)));
+    model.refresh();
+    QCOMPARE(model.rowCount(), 0);
+    model.setQuery("carth");
+    QCOMPARE(model.rowCount(), 1);
+
+    QVERIFY(query.exec(QString("DELETE FROM todos WHERE id = %1").arg(id)));
+    model.refresh();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TestTodoSearch::testHighlightIsEscaped()
+{
+    addTodo("Fix <div> layout", "The <b>header</b> overlaps the layout grid");
+
+    TodoSearchModel model;
+    model.setQuery("layout");
+    QCOMPARE(model.rowCount(), 1);
+
+    const QModelIndex index = model.index(0, 0);
+    QCOMPARE(model.data(index, TodoSearchModel::HighlightedTitleRole).toString(),
+             QString("Fix &lt;div&gt; <b>layout</b>"));
+    QVERIFY(model.data(index, TodoSearchModel::SnippetRole).toString().contains("<b>layout</b> grid"));
+    QVERIFY(model.data(index, TodoSearchModel::SnippetRole).toString().contains("&lt;b&gt;header"));
+}
+
+void TestTodoSearch::testSearchStaysInItsList()
+{
+    QSqlQuery query;
+    QVERIFY(query.exec("INSERT INTO todo_lists (name) VALUES ('History')"));
+    const int history = query.lastInsertId().toInt();
+
+    const int rome = addTodo("Rome essay", "");
+    addTodo("Rome trip packing", "");
+    QVERIFY(query.exec(QString("UPDATE todos SET list_id = %1 WHERE id = %2").arg(history).arg(rome)));
+
+    TodoSearchModel everywhere;
+    everywhere.setQuery("rome");
+    QCOMPARE(everywhere.rowCount(), 2);
+
+    TodoSearchModel inList(history);
+    inList.setQuery("rome");
+    QCOMPARE(titles(inList), QStringList({"Rome essay"}));
+}
+
+void TestTodoSearch::testHundredThousandTodos()
+{
+    const QStringList subjects = {"algebra", "biology", "chemistry", "history", "literature",
+                                  "physics", "geography", "economics", "philosophy", "music"};
+
+    QSqlDatabase db = DatabaseManager::instance().database();
+    db.transaction();
+    QSqlQuery insert;
+    insert.prepare("INSERT INTO todos (title, description) VALUES (:title, :description)");
+    for (int i = 0; i < 100000; i++) {
+        insert.bindValue(":title", QString("%1 exercise %2").arg(subjects.at(i % subjects.size())).arg(i));
+        insert.bindValue(":description", QString("Worksheet %1 for week %2").arg(i % 97).arg(i % 52));
+        QVERIFY(insert.exec());
+    }
+    QVERIFY(db.commit());
+
+    TodoSearchModel model;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    model.setQuery("philo exercise 54328");
+    const qint64 ms = elapsed.elapsed();
+
+    QCOMPARE(model.rowCount(), 1);
+    QVERIFY2(ms < 250, qPrintable(QString::number(ms)));
+}
+
+QTEST_MAIN(TestTodoSearch)
+#include "test_todoSearch.moc"
@@ -0,0 +1,304 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include <QRandomGenerator>
+#include "../src/core/todo/todosortfiltermodel.h"
+#include "../src/core/todo/todomanager.h"
+
+class TestTodoSortFilter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testNewestFirstByDefault();
+    void testPrioritySortBreaksTiesByAge();
+    void testUndatedStayLast();
+    void testEditMovesOneRow();
+    void testFilters();
+    void testDueWindowSlidesIncrementally();
+    void testManualOrderFollowsSortKeys();
+    void testSourceInsertAndRemove();
+    void testRowMapping();
+    void testMatchesFreshSortAfterManyEdits();
+
+private:
+    QStandardItem *makeTodo(int id, const QString &title, int priority,
+                            const QDateTime &due = QDateTime(), bool completed = false) const;
+    QStringList titles(const QAbstractItemModel &model) const;
+
+    QStandardItemModel *m_source;
+};
+
+void TestTodoSortFilter::init()
+{
+    m_source = new QStandardItemModel(this);
+    // Source order as todoManager loads it: newest first
+    m_source->appendRow(makeTodo(5, "Essay", 1, QDateTime(QDate(2025, 3, 4), QTime(9, 0))));
+    m_source->appendRow(makeTodo(4, "algebra", 2));
+    m_source->appendRow(makeTodo(3, "Biology", 0, QDateTime(QDate(2025, 3, 1), QTime(9, 0)), true));
+    m_source->appendRow(makeTodo(2, "Chemistry", 2, QDateTime(QDate(2025, 3, 2), QTime(9, 0))));
+    m_source->appendRow(makeTodo(1, "Drawing", 1));
+}
+
+void TestTodoSortFilter::cleanup()
+{
+    delete m_source;
+}
+
+QStandardItem *TestTodoSortFilter::makeTodo(int id, const QString &title, int priority,
+                                            const QDateTime &due, bool completed) const
+{
+    QStandardItem *item = new QStandardItem;
+    item->setData(id, todoManager::IdRole);
+    item->setData(title, todoManager::TitleRole);
+    item->setData(priority, todoManager::PriorityRole);
+    item->setData(due, todoManager::DueDateRole);
+    item->setData(completed, todoManager::CompletedRole);
+    return item;
+}
+
+QStringList TestTodoSortFilter::titles(const QAbstractItemModel &model) const
+{
+    QStringList list;
+    for (int row = 0; row < model.rowCount(); row++) {
+        list << model.index(row, 0).data(todoManager::TitleRole).toString();
+    }
+    return list;
+}
+
+void TestTodoSortFilter::testNewestFirstByDefault()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    QCOMPARE(titles(proxy), QStringList({"Essay", "algebra", "Biology", "Chemistry", "Drawing"}));
+
+    proxy.setReversed(true);
+    QCOMPARE(titles(proxy), QStringList({"Drawing", "Chemistry", "Biology", "algebra", "Essay"}));
+}
+
+void TestTodoSortFilter::testPrioritySortBreaksTiesByAge()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Priority);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Chemistry", "Essay", "Drawing", "Biology"}));
+
+    proxy.setSortMode(TodoSortFilterModel::Title);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Biology", "Chemistry", "Drawing", "Essay"}));
+}
+
+void TestTodoSortFilter::testUndatedStayLast()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::DueDate);
+    QCOMPARE(titles(proxy), QStringList({"Biology", "Chemistry", "Essay", "algebra", "Drawing"}));
+
+    proxy.setReversed(true);
+    QCOMPARE(titles(proxy), QStringList({"Essay", "Chemistry", "Biology", "algebra", "Drawing"}));
+}
+
+void TestTodoSortFilter::testEditMovesOneRow()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Priority);
+
+    QSignalSpy moved(&proxy, &QAbstractItemModel::rowsMoved);
+    QSignalSpy reset(&proxy, &QAbstractItemModel::modelReset);
+    QSignalSpy changed(&proxy, &QAbstractItemModel::dataChanged);
+
+    // Biology: low -> high
+    m_source->item(2)->setData(2, todoManager::PriorityRole);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Biology", "Chemistry", "Essay", "Drawing"}));
+    QCOMPARE(moved.count(), 1);
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), 1);
+
+    // A change that leaves the sort key alone is only forwarded
+    m_source->item(0)->setData("Essay draft", todoManager::TitleRole);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Biology", "Chemistry", "Essay draft", "Drawing"}));
+    QCOMPARE(moved.count(), 1);
+    QCOMPARE(changed.count(), 2);
+
+    // Moving down past several rows
+    m_source->item(1)->setData(0, todoManager::PriorityRole);
+    QCOMPARE(titles(proxy), QStringList({"Biology", "Chemistry", "Essay draft", "Drawing", "algebra"}));
+    QCOMPARE(moved.count(), 2);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestTodoSortFilter::testFilters()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    QSignalSpy count(&proxy, &TodoSortFilterModel::countChanged);
+
+    proxy.setHideCompleted(true);
+    QCOMPARE(titles(proxy), QStringList({"Essay", "algebra", "Chemistry", "Drawing"}));
+    QCOMPARE(count.count(), 1);
+
+    proxy.setPriorityFilter(2);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Chemistry"}));
+
+    // Completing a visible todo removes its row
+    QSignalSpy removed(&proxy, &QAbstractItemModel::rowsRemoved);
+    m_source->item(3)->setData(true, todoManager::CompletedRole);
+    QCOMPARE(titles(proxy), QStringList({"algebra"}));
+    QCOMPARE(removed.count(), 1);
+
+    // And reopening it brings it back in place
+    QSignalSpy inserted(&proxy, &QAbstractItemModel::rowsInserted);
+    m_source->item(3)->setData(false, todoManager::CompletedRole);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Chemistry"}));
+    QCOMPARE(inserted.count(), 1);
+
+    proxy.setPriorityFilter(-1);
+    proxy.setHideCompleted(false);
+    QCOMPARE(proxy.rowCount(), 5);
+}
+
+void TestTodoSortFilter::testDueWindowSlidesIncrementally()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::DueDate);
+
+    QSignalSpy reset(&proxy, &QAbstractItemModel::modelReset);
+    QSignalSpy inserted(&proxy, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&proxy, &QAbstractItemModel::rowsRemoved);
+
+    proxy.setDueRange(QDate(2025, 3, 2).startOfDay(), QDate(2025, 3, 3).startOfDay());
+    QCOMPARE(titles(proxy), QStringList({"Chemistry"}));
+    QCOMPARE(removed.count(), 4);
+
+    removed.clear();
+    proxy.setDueRange(QDate(2025, 3, 3).startOfDay(), QDate(2025, 3, 5).startOfDay());
+    QCOMPARE(titles(proxy), QStringList({"Essay"}));
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(removed.count(), 1);
+
+    // Opening the window again brings the undated todos back too
+    proxy.setDueRange(QDateTime(), QDateTime());
+    QCOMPARE(titles(proxy), QStringList({"Biology", "Chemistry", "Essay", "algebra", "Drawing"}));
+    QCOMPARE(reset.count(), 0);
+
+    proxy.setReversed(true);
+    proxy.setDueBefore(QDate(2025, 3, 3).startOfDay());
+    QCOMPARE(titles(proxy), QStringList({"Chemistry", "Biology"}));
+    proxy.setDueFrom(QDate(2025, 3, 2).startOfDay());
+    QCOMPARE(titles(proxy), QStringList({"Chemistry"}));
+    QCOMPARE(reset.count(), 1);
+
+    // Edits inside a window keep it honest
+    m_source->item(1)->setData(QDateTime(QDate(2025, 3, 2), QTime(18, 0)), todoManager::DueDateRole);
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Chemistry"}));
+}
+
+void TestTodoSortFilter::testManualOrderFollowsSortKeys()
+{
+    const QStringList keys = {"V", "a", "G", "l", "W"};
+    for (int row = 0; row < keys.size(); row++) {
+        m_source->item(row)->setData(keys.at(row), todoManager::SortKeyRole);
+    }
+
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Manual);
+    QCOMPARE(titles(proxy), QStringList({"Biology", "Essay", "Drawing", "algebra", "Chemistry"}));
+
+    // A drag rewrites one key; the view moves one row
+    QSignalSpy moved(&proxy, &QAbstractItemModel::rowsMoved);
+    m_source->item(3)->setData("0V", todoManager::SortKeyRole);
+    QCOMPARE(titles(proxy), QStringList({"Chemistry", "Biology", "Essay", "Drawing", "algebra"}));
+    QCOMPARE(moved.count(), 1);
+}
+
+void TestTodoSortFilter::testSourceInsertAndRemove()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Title);
+
+    QSignalSpy inserted(&proxy, &QAbstractItemModel::rowsInserted);
+    m_source->appendRow(makeTodo(6, "Calculus", 1));
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Biology", "Calculus", "Chemistry", "Drawing", "Essay"}));
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 2);
+
+    QSignalSpy removed(&proxy, &QAbstractItemModel::rowsRemoved);
+    m_source->removeRow(2);  // Biology
+    QCOMPARE(titles(proxy), QStringList({"algebra", "Calculus", "Chemistry", "Drawing", "Essay"}));
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.first().at(1).toInt(), 1);
+
+    m_source->clear();
+    QCOMPARE(proxy.rowCount(), 0);
+}
+
+void TestTodoSortFilter::testRowMapping()
+{
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Title);
+
+    // algebra is source row 1, Drawing source row 4
+    QCOMPARE(proxy.mapToSource(0), 1);
+    QCOMPARE(proxy.mapToSource(3), 4);
+    QCOMPARE(proxy.mapFromSource(4), 3);
+    QCOMPARE(proxy.mapToSource(5), -1);
+
+    proxy.setHideCompleted(true);
+    QCOMPARE(proxy.mapFromSource(2), -1);
+
+    // Source rows shift under the proxy when rows above are removed
+    m_source->removeRow(0);
+    QCOMPARE(proxy.mapToSource(0), 0);
+    QCOMPARE(proxy.mapFromSource(3), 2);
+}
+
+void TestTodoSortFilter::testMatchesFreshSortAfterManyEdits()
+{
+    QRandomGenerator random(42);
+    for (int id = 6; id < 200; id++) {
+        m_source->appendRow(makeTodo(id, QString("Task %1").arg(random.bounded(50)), random.bounded(3)));
+    }
+
+    TodoSortFilterModel proxy;
+    proxy.setSourceModel(m_source);
+    proxy.setSortMode(TodoSortFilterModel::Priority);
+    proxy.setHideCompleted(true);
+
+    for (int i = 0; i < 500; i++) {
+        QStandardItem *item = m_source->item(random.bounded(m_source->rowCount()));
+        switch (random.bounded(3)) {
+        case 0:
+            item->setData(random.bounded(3), todoManager::PriorityRole);
+            break;
+        case 1:
+            item->setData(!item->data(todoManager::CompletedRole).toBool(), todoManager::CompletedRole);
+            break;
+        default:
+            item->setData(QString("Task %1").arg(random.bounded(50)), todoManager::TitleRole);
+            break;
+        }
+    }
+
+    TodoSortFilterModel fresh;
+    fresh.setSourceModel(m_source);
+    fresh.setSortMode(TodoSortFilterModel::Priority);
+    fresh.setHideCompleted(true);
+
+    QCOMPARE(proxy.rowCount(), fresh.rowCount());
+    for (int row = 0; row < fresh.rowCount(); row++) {
+        QCOMPARE(proxy.index(row, 0).data(todoManager::IdRole).toInt(),
+                 fresh.index(row, 0).data(todoManager::IdRole).toInt());
+    }
+}
+
+QTEST_MAIN(TestTodoSortFilter)
+#include "test_todoSortFilter.moc"
@@ -0,0 +1,350 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFile>
+#include "../src/core/todo/todotreemodel.h"
+#include "../src/core/todo/todomanager.h"
+#include "../src/core/database/databasemanager.h"
+
+class TestTodoTree : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testChildrenLoadWhenExpanded();
+    void testProgressRollsUp();
+    void testAddAndRemoveSubtasks();
+    void testMoveSubtreeWithOneUpdate();
+    void testMoveBetweenTopLevelAndSubtask();
+    void testMoveIntoAnotherListMovesSubtree();
+    void testRemovingTodoDeletesSubtree();
+
+private:
+    int addSubtask(int parentId, const QString &title, bool completed = false);
+    int parentIdInDatabase(int id) const;
+    int listIdInDatabase(int id) const;
+    int todoCount() const;
+    QModelIndex topLevel(const TodoTreeModel &tree, const QString &title) const;
+};
+
+void TestTodoTree::initTestCase()
+{
+    DatabaseManager &dbManager = DatabaseManager::instance();
+
+    QSqlDatabase db = dbManager.database();
+    db.close();
+    db.setDatabaseName("test_tree.db");
+
+    if (!dbManager.openDatabase()) {
+        QFAIL("failed to open database");
+    }
+    QVERIFY(dbManager.createTables());
+}
+
+void TestTodoTree::cleanupTestCase()
+{
+    DatabaseManager::instance().database().close();
+    QFile::remove("test_tree.db");
+}
+
+void TestTodoTree::init()
+{
+    QSqlQuery query;
+    query.exec("DELETE FROM todos");
+}
+
+int TestTodoTree::addSubtask(int parentId, const QString &title, bool completed)
+{
+    QSqlQuery query;
+    query.prepare("INSERT INTO todos (title, parent_id, completed) VALUES (:title, :parent_id, :completed)");
+    query.bindValue(":title", title);
+    query.bindValue(":parent_id", parentId);
+    query.bindValue(":completed", completed);
+    if (!query.exec()) {
+        return -1;
+    }
+    return query.lastInsertId().toInt();
+}
+
+int TestTodoTree::parentIdInDatabase(int id) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT parent_id FROM todos WHERE id = :id");
+    query.bindValue(":id", id);
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+int TestTodoTree::listIdInDatabase(int id) const
+{
+    QSqlQuery query;
+    query.prepare("SELECT list_id FROM todos WHERE id = :id");
+    query.bindValue(":id", id);
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+int TestTodoTree::todoCount() const
+{
+    QSqlQuery query("SELECT COUNT(*) FROM todos");
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+QModelIndex TestTodoTree::topLevel(const TodoTreeModel &tree, const QString &title) const
+{
+    for (int row = 0; row < tree.rowCount(); row++) {
+        const QModelIndex index = tree.index(row, 0);
+        if (index.data(TodoTreeModel::TitleRole).toString() == title) {
+            return index;
+        }
+    }
+    return QModelIndex();
+}
+
+void TestTodoTree::testChildrenLoadWhenExpanded()
+{
+    todoManager setup;
+    setup.addTodo("Essay");
+    const int essay = setup.data(setup.index(0, 0), todoManager::IdRole).toInt();
+    const int research = addSubtask(essay, "Research");
+    addSubtask(research, "Find sources", true);
+    addSubtask(essay, "Draft");
+
+    todoManager todos;
+    QCOMPARE(todos.count(), 1);
+
+    TodoTreeModel tree(&todos);
+    QCOMPARE(tree.rowCount(), 1);
+
+    // Counts cover the whole subtree before anything is loaded
+    const QModelIndex root = tree.index(0, 0);
+    QVERIFY(tree.hasChildren(root));
+    QCOMPARE(tree.rowCount(root), 0);
+    QCOMPARE(root.data(TodoTreeModel::SubtaskCountRole).toInt(), 3);
+    QCOMPARE(root.data(TodoTreeModel::CompletedSubtaskCountRole).toInt(), 1);
+
+    QVERIFY(tree.canFetchMore(root));
+    tree.fetchMore(root);
+    QVERIFY(!tree.canFetchMore(root));
+    QCOMPARE(tree.rowCount(root), 2);
+
+    const QModelIndex first = tree.index(0, 0, root);
+    QCOMPARE(first.data(TodoTreeModel::TitleRole).toString(), QString("Research"));
+    QCOMPARE(first.data(TodoTreeModel::ParentIdRole).toInt(), essay);
+    QCOMPARE(tree.parent(first), root);
+    QCOMPARE(tree.rowCount(first), 0);
+    QVERIFY(tree.canFetchMore(first));
+    QVERIFY(!tree.indexForId(research + 1).isValid());
+}
+
+void TestTodoTree::testProgressRollsUp()
+{
+    todoManager todos;
+    todos.addTodo("Project");
+    const int project = todos.data(todos.index(0, 0), todoManager::IdRole).toInt();
+
+    TodoTreeModel tree(&todos);
+    const int part = tree.addSubtask(project, "Part one");
+    const int step = tree.addSubtask(part, "Step");
+    tree.addSubtask(project, "Part two");
+
+    QModelIndex root = tree.indexForId(project);
+    QCOMPARE(root.data(TodoTreeModel::SubtaskCountRole).toInt(), 3);
+    QCOMPARE(root.data(TodoTreeModel::ProgressRole).toDouble(), 0.0);
+
+    // One completion touches the node and each ancestor once
+    QSignalSpy changed(&tree, &QAbstractItemModel::dataChanged);
+    QVERIFY(tree.setCompleted(step, true));
+    QCOMPARE(changed.count(), 3);
+
+    QCOMPARE(tree.indexForId(part).data(TodoTreeModel::ProgressRole).toDouble(), 1.0);
+    QCOMPARE(root.data(TodoTreeModel::CompletedSubtaskCountRole).toInt(), 1);
+    QCOMPARE(root.data(TodoTreeModel::ProgressRole).toDouble(), 1.0 / 3.0);
+
+    // Top-level completion goes through the flat list
+    QVERIFY(tree.setCompleted(project, true));
+    QVERIFY(todos.data(todos.index(0, 0), todoManager::CompletedRole).toBool());
+    QVERIFY(tree.indexForId(project).data(TodoTreeModel::CompletedRole).toBool());
+
+    // A fresh model agrees with the incremental counts
+    TodoTreeModel reloaded(&todos);
+    QCOMPARE(reloaded.index(0, 0).data(TodoTreeModel::CompletedSubtaskCountRole).toInt(), 1);
+}
+
+void TestTodoTree::testAddAndRemoveSubtasks()
+{
+    todoManager todos;
+    todos.addTodo("Revision");
+    const int revision = todos.data(todos.index(0, 0), todoManager::IdRole).toInt();
+
+    TodoTreeModel tree(&todos);
+    QCOMPARE(tree.addSubtask(revision, "   "), -1);
+    QCOMPARE(tree.addSubtask(12345, "Orphan"), -1);
+
+    const int chapter = tree.addSubtask(revision, "Chapter 1");
+    const int notes = tree.addSubtask(chapter, "Notes");
+    tree.addSubtask(chapter, "Questions");
+    QCOMPARE(todos.count(), 1);
+
+    // Childless nodes count as loaded, so new subtasks show up right away
+    QModelIndex root = tree.indexForId(revision);
+    QVERIFY(!tree.canFetchMore(root));
+    QCOMPARE(tree.rowCount(root), 1);
+    QCOMPARE(root.data(TodoTreeModel::SubtaskCountRole).toInt(), 3);
+
+    const QModelIndex chapterIndex = tree.indexForId(chapter);
+    QCOMPARE(tree.rowCount(chapterIndex), 2);
+    QCOMPARE(tree.index(0, 0, chapterIndex).data(TodoTreeModel::IdRole).toInt(), notes);
+
+    QVERIFY(tree.removeTodo(chapter));
+    QCOMPARE(tree.rowCount(root), 0);
+    QCOMPARE(root.data(TodoTreeModel::SubtaskCountRole).toInt(), 0);
+    QVERIFY(!tree.hasChildren(root));
+    QVERIFY(!tree.indexForId(notes).isValid());
+    QCOMPARE(todoCount(), 1);
+}
+
+void TestTodoTree::testMoveSubtreeWithOneUpdate()
+{
+    todoManager todos;
+    todos.addTodo("Maths");
+    todos.addTodo("Physics");
+    TodoTreeModel tree(&todos);
+
+    const int maths = tree.index(0, 0).data(TodoTreeModel::IdRole).toInt();
+    const int physics = tree.index(1, 0).data(TodoTreeModel::IdRole).toInt();
+    const int vectors = tree.addSubtask(maths, "Vectors");
+    const int dot = tree.addSubtask(vectors, "Dot product");
+    tree.addSubtask(vectors, "Cross product");
+    tree.addSubtask(physics, "Forces");
+    QVERIFY(tree.setCompleted(dot, true));
+
+    // Not under itself or its own subtasks
+    QVERIFY(!tree.moveSubtree(vectors, dot));
+    QVERIFY(!tree.moveSubtree(vectors, vectors));
+
+    QSignalSpy moved(&tree, &QAbstractItemModel::rowsMoved);
+    QVERIFY(tree.moveSubtree(vectors, physics));
+    QCOMPARE(moved.count(), 1);
+
+    QCOMPARE(parentIdInDatabase(vectors), physics);
+    QCOMPARE(parentIdInDatabase(dot), vectors);
+    QCOMPARE(tree.parentIdOf(vectors), physics);
+
+    const QModelIndex mathsIndex = tree.indexForId(maths);
+    const QModelIndex physicsIndex = tree.indexForId(physics);
+    QCOMPARE(tree.rowCount(mathsIndex), 0);
+    QCOMPARE(mathsIndex.data(TodoTreeModel::SubtaskCountRole).toInt(), 0);
+    QCOMPARE(tree.rowCount(physicsIndex), 2);
+    QCOMPARE(physicsIndex.data(TodoTreeModel::SubtaskCountRole).toInt(), 4);
+    QCOMPARE(physicsIndex.data(TodoTreeModel::CompletedSubtaskCountRole).toInt(), 1);
+    QCOMPARE(tree.rowCount(tree.indexForId(vectors)), 2);
+}
+
+void TestTodoTree::testMoveBetweenTopLevelAndSubtask()
+{
+    todoManager todos;
+    todos.addTodo("Biology");
+    todos.addTodo("Cells");
+    TodoTreeModel tree(&todos);
+
+    const int biology = tree.index(0, 0).data(TodoTreeModel::IdRole).toInt();
+    const int cells = tree.index(1, 0).data(TodoTreeModel::IdRole).toInt();
+    tree.addSubtask(cells, "Mitosis");
+
+    // Top-level todo becomes a subtask and leaves the flat list
+    QVERIFY(tree.moveSubtree(cells, biology));
+    QCOMPARE(todos.count(), 1);
+    QCOMPARE(tree.rowCount(), 1);
+    QCOMPARE(parentIdInDatabase(cells), biology);
+
+    const QModelIndex biologyIndex = tree.indexForId(biology);
+    QCOMPARE(tree.rowCount(biologyIndex), 1);
+    QCOMPARE(biologyIndex.data(TodoTreeModel::SubtaskCountRole).toInt(), 2);
+
+    // ...and back, bringing its subtask along
+    QVERIFY(tree.moveSubtree(cells, 0));
+    QCOMPARE(todos.count(), 2);
+    QCOMPARE(todos.rowForId(cells), 1);
+    QCOMPARE(tree.rowCount(), 2);
+    QVERIFY(topLevel(tree, "Cells").isValid());
+    QCOMPARE(topLevel(tree, "Cells").data(TodoTreeModel::SubtaskCountRole).toInt(), 1);
+    QCOMPARE(tree.indexForId(biology).data(TodoTreeModel::SubtaskCountRole).toInt(), 0);
+}
+
+void TestTodoTree::testMoveIntoAnotherListMovesSubtree()
+{
+    QSqlQuery query;
+    QVERIFY(query.exec("INSERT INTO todo_lists (name) VALUES ('Chemistry')"));
+    const int chemistry = query.lastInsertId().toInt();
+    QVERIFY(query.exec("INSERT INTO todo_lists (name) VALUES ('Physics')"));
+    const int physicsList = query.lastInsertId().toInt();
+
+    todoManager todos;
+    todos.addTodo("Acids");
+    todos.addTodo("Optics");
+    TodoTreeModel tree(&todos);
+
+    const int acids = tree.index(0, 0).data(TodoTreeModel::IdRole).toInt();
+    const int optics = tree.index(1, 0).data(TodoTreeModel::IdRole).toInt();
+    const int buffers = tree.addSubtask(acids, "Buffers");
+    const int titration = tree.addSubtask(buffers, "Titration");
+
+    query.prepare("UPDATE todos SET list_id = :list_id WHERE id IN (:a, :b, :c)");
+    query.bindValue(":list_id", chemistry);
+    query.bindValue(":a", acids);
+    query.bindValue(":b", buffers);
+    query.bindValue(":c", titration);
+    QVERIFY(query.exec());
+    query.prepare("UPDATE todos SET list_id = :list_id WHERE id = :id");
+    query.bindValue(":list_id", physicsList);
+    query.bindValue(":id", optics);
+    QVERIFY(query.exec());
+
+    // The moved subtree joins its new parent's list, all the way down
+    QVERIFY(tree.moveSubtree(buffers, optics));
+    QCOMPARE(listIdInDatabase(buffers), physicsList);
+    QCOMPARE(listIdInDatabase(titration), physicsList);
+    QCOMPARE(listIdInDatabase(acids), chemistry);
+
+    // Back to the top level it keeps the list it is in
+    QVERIFY(tree.moveSubtree(buffers, 0));
+    QCOMPARE(listIdInDatabase(buffers), physicsList);
+    QCOMPARE(listIdInDatabase(titration), physicsList);
+}
+
+void TestTodoTree::testRemovingTodoDeletesSubtree()
+{
+    todoManager todos;
+    todos.addTodo("Exam prep");
+    todos.addTodo("Done already");
+    const int prep = todos.data(todos.index(0, 0), todoManager::IdRole).toInt();
+    const int done = todos.data(todos.index(1, 0), todoManager::IdRole).toInt();
+    const int unit = addSubtask(prep, "Unit 1");
+    addSubtask(unit, "Past paper");
+    addSubtask(done, "Leftover");
+    QCOMPARE(todoCount(), 5);
+
+    TodoTreeModel tree(&todos);
+
+    todos.markAsCompleted(1, true);
+    todos.clearCompleted();
+    QCOMPARE(todoCount(), 3);
+    QCOMPARE(tree.rowCount(), 1);
+
+    todos.removeTodo(0);
+    QCOMPARE(todoCount(), 0);
+    QCOMPARE(tree.rowCount(), 0);
+}
+
+QTEST_MAIN(TestTodoTree)
+#include "test_todoTree.moc"